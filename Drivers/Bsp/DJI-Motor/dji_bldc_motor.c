@@ -133,6 +133,7 @@ uint8_t dji_motor_init(dji_motor_handle_t *motor, dji_motor_model_t motor_model,
     }
 
     motor->motor_model = motor_model;
+    motor->motor_id = can_id;
     motor->got_offset = false;
     motor->can_select = can_select;
     if (can_list_add_new_node(can_select, (void *)motor, can_id, 0x7FF,
@@ -157,8 +158,9 @@ uint8_t dji_motor_deinit(dji_motor_handle_t *motor) {
         return 1;
     }
 
-    if (can_list_del_node_by_id(motor->can_select, CAN_ID_STD,
-                                motor->motor_id) != 0) {
+    /* 只移除本电机的节点, 同一 ID 上其他模块的回调不受影响 */
+    if (can_list_del_node_by_data(motor->can_select, CAN_ID_STD,
+                                  motor->motor_id, motor) != 0) {
         return 2;
     }
 
@@ -195,7 +197,7 @@ void dji_motor_set_current(can_selected_t can_select, uint16_t can_identify,
     send_msg[5] = iq3 & 0xFF;
     send_msg[6] = (iq4 >> 8) & 0xFF;
     send_msg[7] = iq4 & 0xFF;
-    can_send_message(can_select, CAN_ID_STD, can_identify, 8, send_msg);
+    can_send_message_latest(can_select, CAN_ID_STD, can_identify, 8, send_msg);
 }
 
 #endif /* DJI_MOTOR_USE_M3508_2006 == 1 */
@@ -233,7 +235,7 @@ void dji_gm6020_voltage_control(can_selected_t can_select,
     send_msg[5] = voltage3 & 0xFF;
     send_msg[6] = (voltage4 >> 8) & 0xFF;
     send_msg[7] = voltage4 & 0xFF;
-    can_send_message(can_select, CAN_ID_STD, can_identify, 8, send_msg);
+    can_send_message_latest(can_select, CAN_ID_STD, can_identify, 8, send_msg);
 }
 
 /**
@@ -268,7 +270,7 @@ void dji_gm6020_current_control(can_selected_t can_select,
     send_msg[6] = (current4 >> 8) & 0xFF;
     send_msg[7] = current4 & 0xFF;
 
-    can_send_message(can_select, CAN_ID_STD, can_identify, 8, send_msg);
+    can_send_message_latest(can_select, CAN_ID_STD, can_identify, 8, send_msg);
 }
 
 #endif /* DJI_MOTOR_USE_GM6020 == 1 */
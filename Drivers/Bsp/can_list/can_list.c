@@ -2,39 +2,55 @@
  * @file    can_list.c
  * @author  Deadline039
  * @brief   CAN Receive list.
- * @version 1.0
- * @date    2024-11-24
+ * @version 1.1
+ * @date    2026-10-17
  */
 
 #include "can_list/can_list.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
-
-#define STD_ID_TABLE 0
-#define EXT_ID_TABLE 1
+#include <string.h>
+
+#define STD_ID_TABLE  0
+#define EXT_ID_TABLE  1
+
+#define STD_ID_NUMBER 0x800U
+#define EXT_ID_MASK   0x1FFFFFFFU
+
+/* Slots of the Ext ID hash, a power of 2 at least twice the index. */
+#if (CAN_LIST_EXT_INDEX_LEN <= 8)
+#define EXT_HASH_LEN 16U
+#elif (CAN_LIST_EXT_INDEX_LEN <= 16)
+#define EXT_HASH_LEN 32U
+#elif (CAN_LIST_EXT_INDEX_LEN <= 32)
+#define EXT_HASH_LEN 64U
+#elif (CAN_LIST_EXT_INDEX_LEN <= 64)
+#define EXT_HASH_LEN 128U
+#elif (CAN_LIST_EXT_INDEX_LEN <= 128)
+#define EXT_HASH_LEN 256U
+#else /* CAN_LIST_EXT_INDEX_LEN */
+#error "CAN_LIST_EXT_INDEX_LEN must be no more than 128! "
+#endif /* CAN_LIST_EXT_INDEX_LEN */
+
+/* Fibonacci hashing, the top 8 bits spread the IDs of one device. */
+#define EXT_HASH(id)  ((((id) * 0x9E3779B1U) >> 24) & (EXT_HASH_LEN - 1U))
+
+/* Filter banks shared by CAN1 and CAN2. */
+#define CAN_FILTER_BANK_NUMBER 28U
 
 #if CAN_LIST_USE_RTOS
 #include "FreeRTOS.h"
-#include "semphr.h"
 #include "task.h"
 
-static QueueHandle_t can_list_queue_handle;
+#include "ring_fifo/ring_fifo.h"
+
 static TaskHandle_t can_list_task_handle;
 void can_list_polling_task(void *args);
 
-/**
- * @brief Queue message data type.
- */
-typedef struct {
-#if CAN_LIST_USE_FDCAN
-    FDCAN_HandleTypeDef *hcan; /*!< The handle of FDCAN.     */
-#else                          /* CAN_LIST_USE_FDCAN */
-    CAN_HandleTypeDef *hcan; /*!< The handle of CAN.         */
-#endif                         /* CAN_LIST_USE_FDCAN */
-    uint32_t rx_fifo;          /*!< The FIFO which received. */
-} queue_msg_t;
-
-static queue_msg_t send_msg_from_isr;
+#if CAN_LIST_ENABLE_STATISTICS
+can_list_stat_t can_list_stat[CAN_LIST_MAX_CAN_NUMBER];
+#endif /* CAN_LIST_ENABLE_STATISTICS */
 
 #endif /* CAN_LIST_USE_RTOS */
 
@@ -47,11 +63,13 @@ static queue_msg_t send_msg_from_isr;
  * @brief CAN list node type.
  */
 typedef struct can_node {
-    void *can_data;          /*!< The CAN data of this node.    */
-    uint32_t id;             /*!< CAN ID.                       */
-    uint32_t id_mask;        /*!< CAN ID mask.                  */
-    can_callback_t callback; /*!< CAN callback function.        */
-    struct can_node *next;   /*!< Next CAN list node.           */
+    void *can_data;           /*!< The CAN data of this node.    */
+    uint32_t id;              /*!< CAN ID.                       */
+    uint32_t id_mask;         /*!< CAN ID mask.                  */
+    can_callback_t callback;  /*!< CAN callback function.        */
+    struct can_node *next;    /*!< Next CAN list node.           */
+    struct can_node *sibling; /*!< Next node of the same ID.     */
+    bool overlap;             /*!< Another ID's mask matches it. */
 } can_node_t;
 
 /**
@@ -62,16 +80,580 @@ typedef struct {
     uint32_t len;       /*!< Table size.                  */
 } hash_table_t;
 
+/**
+ * @brief A received frame.
+ */
+typedef struct {
+    can_rx_header_t header; /*!< Rx header.                          */
+#if CAN_LIST_USE_RTOS
+    uint32_t timestamp;     /*!< DWT cycle count when received.      */
+#endif                      /* CAN_LIST_USE_RTOS */
+#if CAN_LIST_USE_FDCAN
+    uint8_t data[64];       /*!< Frame data.                         */
+#else                       /* CAN_LIST_USE_FDCAN */
+    uint8_t data[8];        /*!< Frame data.                         */
+#endif                      /* CAN_LIST_USE_FDCAN */
+} can_frame_t;
+
 /**
  * @brief The CAN table struct, each ID type has an independent table.
  */
 typedef struct {
-    hash_table_t id_table[2]; /*!< Std and Ext ID table.   */
+    hash_table_t id_table[2]; /*!< Std and Ext ID table.                */
+    uint8_t *std_index;       /*!< Pool position + 1 of each Std ID.    */
+    uint32_t ext_exact;       /*!< Number of exact Ext IDs in index.    */
+    uint32_t ext_count;       /*!< Number of nodes in Ext ID index.     */
+
+    /* Ext ID index, exact IDs first, then the masked ones. The IDs are
+       copied out so the lookup does not load the nodes. */
+    can_node_t *ext_index[CAN_LIST_EXT_INDEX_LEN];
+    uint32_t ext_id[CAN_LIST_EXT_INDEX_LEN];
+    /* Index position + 1 of the exact IDs, open addressing by `EXT_HASH`. */
+    uint8_t ext_hash[EXT_HASH_LEN];
+
+#if CAN_LIST_USE_RTOS
+    volatile uint32_t ext_change; /*!< Times the Ext ID index moved.  */
+    ring_fifo_t *rx_ring[2];      /*!< FIFO0 and FIFO1 frames.        */
+#endif                            /* CAN_LIST_USE_RTOS */
 } can_table_t;
 
 /* The CAN instance, each CAN has an independent table. */
 can_table_t *can_table[CAN_LIST_MAX_CAN_NUMBER];
 
+#if (CAN_LIST_NODE_POOL_SIZE > 255)
+#error "CAN_LIST_NODE_POOL_SIZE must fit in the uint8_t Std ID index! "
+#endif /* (CAN_LIST_NODE_POOL_SIZE > 255) */
+
+/* Nodes of all CANs. Freed nodes are linked by `next`. */
+static can_node_t can_list_node_pool[CAN_LIST_NODE_POOL_SIZE];
+static can_node_t *can_list_free_nodes;
+static uint32_t can_list_pool_used;
+
+/* Nodes deleted while a dispatch may still walk them, linked by `next`,
+   back to the pool when the dispatch finishes. */
+static can_node_t *can_list_retired_nodes;
+/* Dispatches in progress, and the number of dispatches finished. */
+static volatile uint32_t can_list_dispatching;
+static volatile uint32_t can_list_dispatch_count;
+
+/**
+ * @brief Lock the dispatch index against the receive path.
+ */
+static inline void can_list_lock(void) {
+#if CAN_LIST_USE_RTOS
+    taskENTER_CRITICAL();
+#else  /* CAN_LIST_USE_RTOS */
+    __disable_irq();
+#endif /* CAN_LIST_USE_RTOS */
+}
+
+/**
+ * @brief Unlock the dispatch index.
+ */
+static inline void can_list_unlock(void) {
+#if CAN_LIST_USE_RTOS
+    taskEXIT_CRITICAL();
+#else  /* CAN_LIST_USE_RTOS */
+    __enable_irq();
+#endif /* CAN_LIST_USE_RTOS */
+}
+
+/**
+ * @brief Take a node from the pool.
+ *
+ * @return The node, `NULL` if the pool is used up.
+ */
+static can_node_t *can_list_alloc_node(void) {
+    can_node_t *node = NULL;
+
+    can_list_lock();
+    if (can_list_free_nodes != NULL) {
+        node = can_list_free_nodes;
+        can_list_free_nodes = node->next;
+    } else if (can_list_pool_used < CAN_LIST_NODE_POOL_SIZE) {
+        node = &can_list_node_pool[can_list_pool_used++];
+    }
+    can_list_unlock();
+
+    return node;
+}
+
+/**
+ * @brief Give a node back to the pool.
+ *
+ * @param node The node, already out of the table and index.
+ * @note A dispatch in progress may have read the node from the index before
+ *       it was removed, and still walks its `sibling`. Keep the node until
+ *       the dispatch finishes so that it is not reused meanwhile.
+ */
+static void can_list_free_node(can_node_t *node) {
+    can_list_lock();
+    if (can_list_dispatching != 0) {
+        node->next = can_list_retired_nodes;
+        can_list_retired_nodes = node;
+    } else {
+        node->next = can_list_free_nodes;
+        can_list_free_nodes = node;
+    }
+    can_list_unlock();
+}
+
+/**
+ * @brief Mark the start of a dispatch, nodes deleted from now on are kept
+ *        until `can_list_dispatch_end`.
+ */
+static void can_list_dispatch_begin(void) {
+    can_list_lock();
+    ++can_list_dispatching;
+    can_list_unlock();
+}
+
+/**
+ * @brief Mark the end of a dispatch, give the kept nodes back to the pool
+ *        once no dispatch is in progress.
+ */
+static void can_list_dispatch_end(void) {
+    can_list_lock();
+    if (--can_list_dispatching == 0) {
+        while (can_list_retired_nodes != NULL) {
+            can_node_t *node = can_list_retired_nodes;
+            can_list_retired_nodes = node->next;
+            node->next = can_list_free_nodes;
+            can_list_free_nodes = node;
+        }
+    }
+    ++can_list_dispatch_count;
+    can_list_unlock();
+}
+
+/**
+ * @brief Wait for the dispatch in progress to finish after deleting nodes,
+ *        so that the caller can free the node data on return.
+ *
+ * @note Without RTOS the dispatch runs in the CAN interrupt, it has already
+ *       finished when the deleting code runs again. The CAN list task does
+ *       not wait for itself, deleting from a callback is fine.
+ */
+static void can_list_wait_dispatch(void) {
+#if CAN_LIST_USE_RTOS
+    uint32_t count = can_list_dispatch_count;
+
+    if ((xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) ||
+        (xTaskGetCurrentTaskHandle() == can_list_task_handle)) {
+        return;
+    }
+
+    while ((can_list_dispatching != 0) && (count == can_list_dispatch_count)) {
+        vTaskDelay(1);
+    }
+#endif /* CAN_LIST_USE_RTOS */
+}
+
+/**
+ * @brief Get the Std ID index entry of a node.
+ *
+ * @param node The node, can be `NULL`.
+ * @return Pool position plus 1, 0 for `NULL`.
+ */
+static inline uint8_t can_list_node_to_index(const can_node_t *node) {
+    return (node == NULL) ? 0U : (uint8_t)(node - can_list_node_pool + 1);
+}
+
+/**
+ * @brief Get the node of a Std ID index entry.
+ *
+ * @param index Pool position plus 1, 0 for none.
+ * @return The node, `NULL` for none.
+ */
+static inline can_node_t *can_list_index_to_node(uint8_t index) {
+    return (index == 0U) ? NULL : &can_list_node_pool[index - 1U];
+}
+
+/**
+ * @}
+ */
+
+/*****************************************************************************
+ * @defgroup Hardware filter of bxCAN.
+ * @{
+ */
+
+#if (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN)
+
+/**
+ * @brief Filter bank values, the same as `CAN_FilterTypeDef`.
+ */
+typedef struct {
+    uint16_t id_high;   /*!< `FilterIdHigh`.      */
+    uint16_t id_low;    /*!< `FilterIdLow`.       */
+    uint16_t mask_high; /*!< `FilterMaskIdHigh`.  */
+    uint16_t mask_low;  /*!< `FilterMaskIdLow`.   */
+    uint8_t mode;       /*!< `FilterMode`.        */
+    uint8_t scale;      /*!< `FilterScale`.       */
+} can_filter_bank_t;
+
+/**
+ * @brief Filters collected from the nodes of a CAN, at most enough to fill
+ *        all banks of a CAN in each kind.
+ */
+static struct {
+    uint16_t std_exact[CAN_FILTER_BANK_NUMBER * 4]; /*!< 4 in a bank. */
+    uint16_t std_mask[CAN_FILTER_BANK_NUMBER * 2];  /*!< 2 in a bank. */
+    uint32_t ext_exact[CAN_FILTER_BANK_NUMBER * 2]; /*!< 2 in a bank. */
+    uint32_t ext_mask[CAN_FILTER_BANK_NUMBER];      /*!< 1 in a bank. */
+
+    uint16_t std_mask_id[CAN_FILTER_BANK_NUMBER * 2];
+    uint32_t ext_mask_id[CAN_FILTER_BANK_NUMBER];
+
+    uint32_t std_exact_num;
+    uint32_t std_mask_num;
+    uint32_t ext_exact_num;
+    uint32_t ext_mask_num;
+
+    can_filter_bank_t bank[CAN_FILTER_BANK_NUMBER];
+} can_filter;
+
+/**
+ * @brief Get the filter banks of a CAN.
+ *
+ * @param can_select Specific which CAN.
+ * @param[out] first The first bank.
+ * @return The number of banks.
+ */
+static uint32_t can_list_filter_range(can_selected_t can_select,
+                                      uint32_t *first) {
+    *first = 0;
+
+#if defined(CAN2)
+    if (can_select == can1_selected) {
+        return CAN_SLAVE_START_FILTER_BANK;
+    }
+
+    if (can_select == can2_selected) {
+        *first = CAN_SLAVE_START_FILTER_BANK;
+        return CAN_FILTER_BANK_NUMBER - CAN_SLAVE_START_FILTER_BANK;
+    }
+#endif /* defined(CAN2) */
+
+    /* CAN1 of single CAN chips and CAN3 have 14 dedicated banks. */
+    return 14;
+}
+
+/**
+ * @brief Get the RX FIFOs of a CAN which have interrupt enabled.
+ *
+ * @param can_select Specific which CAN.
+ * @return Bit 0 for FIFO0, bit 1 for FIFO1.
+ */
+static uint32_t can_list_filter_fifo(can_selected_t can_select) {
+    switch (can_select) {
+#if CAN1_ENABLE
+        case can1_selected: {
+            return (CAN1_RX0_IT_ENABLE ? 1U : 0U) |
+                   (CAN1_RX1_IT_ENABLE ? 2U : 0U);
+        }
+#endif /* CAN1_ENABLE */
+
+#if CAN2_ENABLE
+        case can2_selected: {
+            return (CAN2_RX0_IT_ENABLE ? 1U : 0U) |
+                   (CAN2_RX1_IT_ENABLE ? 2U : 0U);
+        }
+#endif /* CAN2_ENABLE */
+
+#if CAN3_ENABLE
+        case can3_selected: {
+            return (CAN3_RX0_IT_ENABLE ? 1U : 0U) |
+                   (CAN3_RX1_IT_ENABLE ? 2U : 0U);
+        }
+#endif /* CAN3_ENABLE */
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Sort values and the values bound to them, from small to large.
+ *
+ * @param key The values to sort by.
+ * @param key_size Size of a value, 2 or 4.
+ * @param other The values bound to `key`, can be `NULL`.
+ * @param num The number of values.
+ */
+static void can_list_filter_sort(void *key, uint32_t key_size, void *other,
+                                 uint32_t num) {
+    for (uint32_t i = 1; i < num; ++i) {
+        for (uint32_t j = i; j > 0; --j) {
+            uint32_t a, b;
+
+            if (key_size == 2) {
+                a = ((uint16_t *)key)[j - 1];
+                b = ((uint16_t *)key)[j];
+            } else {
+                a = ((uint32_t *)key)[j - 1];
+                b = ((uint32_t *)key)[j];
+            }
+
+            if (a <= b) {
+                break;
+            }
+
+            if (key_size == 2) {
+                ((uint16_t *)key)[j - 1] = (uint16_t)b;
+                ((uint16_t *)key)[j] = (uint16_t)a;
+                if (other != NULL) {
+                    uint16_t t = ((uint16_t *)other)[j - 1];
+                    ((uint16_t *)other)[j - 1] = ((uint16_t *)other)[j];
+                    ((uint16_t *)other)[j] = t;
+                }
+            } else {
+                ((uint32_t *)key)[j - 1] = b;
+                ((uint32_t *)key)[j] = a;
+                if (other != NULL) {
+                    uint32_t t = ((uint32_t *)other)[j - 1];
+                    ((uint32_t *)other)[j - 1] = ((uint32_t *)other)[j];
+                    ((uint32_t *)other)[j] = t;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Collect the filters of all nodes of a CAN.
+ *
+ * @param can The CAN table.
+ * @param bank_num The number of banks of this CAN.
+ * @return Collect status:
+ * @retval - 0: Success.
+ * @retval - 1: Too many nodes for the banks.
+ */
+static uint8_t can_list_filter_collect(const can_table_t *can,
+                                       uint32_t bank_num) {
+    const hash_table_t *table;
+
+    can_filter.std_exact_num = 0;
+    can_filter.std_mask_num = 0;
+    can_filter.ext_exact_num = 0;
+    can_filter.ext_mask_num = 0;
+
+    /* Std ID in 16 bits filter: STDID[10:0], RTR, IDE, EXTID[17:15]. */
+    table = &can->id_table[STD_ID_TABLE];
+    for (uint32_t i = 0; i < table->len; ++i) {
+        for (can_node_t *node = table->table[i]; node != NULL;
+             node = node->next) {
+            if ((node->id_mask & 0x7FFU) == 0x7FFU) {
+                if (can_filter.std_exact_num >= bank_num * 4) {
+                    return 1;
+                }
+                can_filter.std_exact[can_filter.std_exact_num++] =
+                    (uint16_t)((node->id & 0x7FFU) << 5);
+            } else {
+                if (can_filter.std_mask_num >= bank_num * 2) {
+                    return 1;
+                }
+                /* IDE must be 0. */
+                can_filter.std_mask_id[can_filter.std_mask_num] =
+                    (uint16_t)((node->id & 0x7FFU) << 5);
+                can_filter.std_mask[can_filter.std_mask_num++] =
+                    (uint16_t)(((node->id_mask & 0x7FFU) << 5) | 0x08U);
+            }
+        }
+    }
+
+    /* Ext ID in 32 bits filter: EXTID[28:0], IDE, RTR, 0. */
+    table = &can->id_table[EXT_ID_TABLE];
+    for (uint32_t i = 0; i < table->len; ++i) {
+        for (can_node_t *node = table->table[i]; node != NULL;
+             node = node->next) {
+            if ((node->id_mask & EXT_ID_MASK) == EXT_ID_MASK) {
+                if (can_filter.ext_exact_num >= bank_num * 2) {
+                    return 1;
+                }
+                can_filter.ext_exact[can_filter.ext_exact_num++] =
+                    ((node->id & EXT_ID_MASK) << 3) | CAN_ID_EXT;
+            } else {
+                if (can_filter.ext_mask_num >= bank_num) {
+                    return 1;
+                }
+                /* IDE must be 1. */
+                can_filter.ext_mask_id[can_filter.ext_mask_num] =
+                    ((node->id & EXT_ID_MASK) << 3) | CAN_ID_EXT;
+                can_filter.ext_mask[can_filter.ext_mask_num++] =
+                    ((node->id_mask & EXT_ID_MASK) << 3) | CAN_ID_EXT;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Pack the collected filters into banks, lower IDs first.
+ *
+ * @param bank_num The number of banks of this CAN.
+ * @return The number of banks used, `bank_num + 1` if not enough.
+ */
+static uint32_t can_list_filter_pack(uint32_t bank_num) {
+    uint32_t used = 0;
+    uint32_t n;
+    can_filter_bank_t *bank;
+
+    can_list_filter_sort(can_filter.std_exact, 2, NULL,
+                         can_filter.std_exact_num);
+    can_list_filter_sort(can_filter.std_mask_id, 2, can_filter.std_mask,
+                         can_filter.std_mask_num);
+    can_list_filter_sort(can_filter.ext_exact, 4, NULL,
+                         can_filter.ext_exact_num);
+    can_list_filter_sort(can_filter.ext_mask_id, 4, can_filter.ext_mask,
+                         can_filter.ext_mask_num);
+
+    if ((can_filter.std_exact_num + 3) / 4 + (can_filter.std_mask_num + 1) / 2 +
+            (can_filter.ext_exact_num + 1) / 2 + can_filter.ext_mask_num >
+        bank_num) {
+        return bank_num + 1;
+    }
+
+    /* The empty slots of the last bank repeat the last filter. */
+    for (uint32_t i = 0; i < can_filter.std_exact_num; i += 4) {
+        const uint16_t *id = &can_filter.std_exact[i];
+        n = can_filter.std_exact_num - i;
+        bank = &can_filter.bank[used++];
+        bank->mode = CAN_FILTERMODE_IDLIST;
+        bank->scale = CAN_FILTERSCALE_16BIT;
+        bank->id_low = id[0];
+        bank->mask_low = id[(n > 1) ? 1 : n - 1];
+        bank->id_high = id[(n > 2) ? 2 : n - 1];
+        bank->mask_high = id[(n > 3) ? 3 : n - 1];
+    }
+
+    for (uint32_t i = 0; i < can_filter.std_mask_num; i += 2) {
+        n = (can_filter.std_mask_num - i > 1) ? i + 1 : i;
+        bank = &can_filter.bank[used++];
+        bank->mode = CAN_FILTERMODE_IDMASK;
+        bank->scale = CAN_FILTERSCALE_16BIT;
+        bank->id_low = can_filter.std_mask_id[i];
+        bank->mask_low = can_filter.std_mask[i];
+        bank->id_high = can_filter.std_mask_id[n];
+        bank->mask_high = can_filter.std_mask[n];
+    }
+
+    for (uint32_t i = 0; i < can_filter.ext_exact_num; i += 2) {
+        n = (can_filter.ext_exact_num - i > 1) ? i + 1 : i;
+        bank = &can_filter.bank[used++];
+        bank->mode = CAN_FILTERMODE_IDLIST;
+        bank->scale = CAN_FILTERSCALE_32BIT;
+        bank->id_high = (uint16_t)(can_filter.ext_exact[i] >> 16);
+        bank->id_low = (uint16_t)can_filter.ext_exact[i];
+        bank->mask_high = (uint16_t)(can_filter.ext_exact[n] >> 16);
+        bank->mask_low = (uint16_t)can_filter.ext_exact[n];
+    }
+
+    for (uint32_t i = 0; i < can_filter.ext_mask_num; ++i) {
+        bank = &can_filter.bank[used++];
+        bank->mode = CAN_FILTERMODE_IDMASK;
+        bank->scale = CAN_FILTERSCALE_32BIT;
+        bank->id_high = (uint16_t)(can_filter.ext_mask_id[i] >> 16);
+        bank->id_low = (uint16_t)can_filter.ext_mask_id[i];
+        bank->mask_high = (uint16_t)(can_filter.ext_mask[i] >> 16);
+        bank->mask_low = (uint16_t)can_filter.ext_mask[i];
+    }
+
+    return used;
+}
+
+/**
+ * @brief Program the filter banks of a CAN from its nodes, so only the
+ *        frames of the nodes reach the CPU.
+ *
+ * @param can_select Specific which CAN.
+ * @return Operational status:
+ * @retval - 0: Success.
+ * @retval - 1: This CAN does not exists.
+ * @retval - 2: The specific CAN table is not created.
+ * @retval - 3: This CAN is not initialized or filter config failed.
+ * @retval - 4: Too many nodes for the banks, all frames are accepted.
+ * @note Called after adding or deleting a node. Call it after `canx_init`
+ *       if nodes are added before the CAN is initialized, `canx_init`
+ *       configures a filter which accepts all frames.
+ */
+uint8_t can_list_update_filter(can_selected_t can_select) {
+    uint32_t first, bank_num, used, fifo, fifo0_num;
+    uint8_t res = 0;
+    CAN_FilterTypeDef filter = {0};
+
+    if (can_select >= CAN_LIST_MAX_CAN_NUMBER) {
+        return 1;
+    }
+
+    if (can_table[can_select] == NULL) {
+        return 2;
+    }
+
+    CAN_HandleTypeDef *hcan = can_get_handle(can_select);
+    if ((hcan == NULL) || (HAL_CAN_GetState(hcan) == HAL_CAN_STATE_RESET)) {
+        return 3;
+    }
+
+    bank_num = can_list_filter_range(can_select, &first);
+
+    used = bank_num + 1;
+    if (can_list_filter_collect(can_table[can_select], bank_num) == 0) {
+        used = can_list_filter_pack(bank_num);
+    }
+
+    if (used > bank_num) {
+        /* One bank accepts all, filter in software. */
+        can_filter.bank[0].mode = CAN_FILTERMODE_IDMASK;
+        can_filter.bank[0].scale = CAN_FILTERSCALE_32BIT;
+        can_filter.bank[0].id_high = 0;
+        can_filter.bank[0].id_low = 0;
+        can_filter.bank[0].mask_high = 0;
+        can_filter.bank[0].mask_low = 0;
+        used = 1;
+        res = 4;
+    }
+
+    /* Lower IDs in FIFO0, the rest in FIFO1, only the FIFOs with interrupt
+     * enabled are used. */
+    fifo = can_list_filter_fifo(can_select);
+    if (fifo == 3U) {
+        fifo0_num = (used + 1) / 2;
+    } else if (fifo == 2U) {
+        fifo0_num = 0;
+    } else {
+        fifo0_num = used;
+    }
+
+    filter.SlaveStartFilterBank = CAN_SLAVE_START_FILTER_BANK;
+    for (uint32_t i = 0; i < bank_num; ++i) {
+        filter.FilterBank = first + i;
+
+        if (i < used) {
+            filter.FilterMode = can_filter.bank[i].mode;
+            filter.FilterScale = can_filter.bank[i].scale;
+            filter.FilterIdHigh = can_filter.bank[i].id_high;
+            filter.FilterIdLow = can_filter.bank[i].id_low;
+            filter.FilterMaskIdHigh = can_filter.bank[i].mask_high;
+            filter.FilterMaskIdLow = can_filter.bank[i].mask_low;
+            filter.FilterFIFOAssignment =
+                (i < fifo0_num) ? CAN_FILTER_FIFO0 : CAN_FILTER_FIFO1;
+            filter.FilterActivation = CAN_FILTER_ENABLE;
+        } else {
+            filter.FilterActivation = CAN_FILTER_DISABLE;
+        }
+
+        if (HAL_CAN_ConfigFilter(hcan, &filter) != HAL_OK) {
+            return 3;
+        }
+    }
+
+    return res;
+}
+
+#endif /* (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN) */
+
 /**
  * @}
  */
@@ -99,6 +681,338 @@ static can_node_t *can_list_find_node_by_id(const hash_table_t *table,
     return node;
 }
 
+/**
+ * @brief Find the node of a received Std ID in the other Std nodes.
+ *
+ * @param table Std ID hash table.
+ * @param id The received id.
+ * @param except The node to skip, it is being deleted.
+ * @return The first node matched, `NULL` if none.
+ */
+static can_node_t *can_list_match_std_node(const hash_table_t *table,
+                                           uint32_t id,
+                                           const can_node_t *except) {
+    for (uint32_t i = 0; i < table->len; ++i) {
+        for (can_node_t *node = table->table[i]; node != NULL;
+             node = node->next) {
+            if ((node != except) && (node->id == (id & node->id_mask))) {
+                return node;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Whether two nodes of different IDs match a common received ID.
+ *
+ * @param a One node.
+ * @param b The other node.
+ * @return Overlap or not.
+ */
+static inline bool can_list_node_overlap(const can_node_t *a,
+                                         const can_node_t *b) {
+    uint32_t mask = a->id_mask & b->id_mask;
+
+    return (a->id & mask) == (b->id & mask);
+}
+
+/**
+ * @brief Mark the IDs of a table whose masks overlap another ID. The index
+ *        only holds one of them for a received ID, the receive path looks
+ *        for the others when the indexed one is marked.
+ *
+ * @param table Std or Ext ID table.
+ */
+static void can_list_update_overlap(hash_table_t *table) {
+    can_node_t *node, *other;
+    uint32_t i, j;
+
+    for (i = 0; i < table->len; ++i) {
+        for (node = table->table[i]; node != NULL; node = node->next) {
+            node->overlap = false;
+        }
+    }
+
+    for (i = 0; i < table->len; ++i) {
+        for (node = table->table[i]; node != NULL; node = node->next) {
+            /* Only compare with the nodes after it. */
+            j = i;
+            other = node->next;
+            for (;;) {
+                for (; other != NULL; other = other->next) {
+                    if (can_list_node_overlap(node, other)) {
+                        node->overlap = true;
+                        other->overlap = true;
+                    }
+                }
+
+                if (++j >= table->len) {
+                    break;
+                }
+                other = table->table[j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Add a Std node to the dispatch index. IDs already owned by other
+ *        nodes are not changed.
+ *
+ * @param can Specific which CAN table.
+ * @param node The node added.
+ */
+static void can_list_std_index_add(can_table_t *can, can_node_t *node) {
+    uint8_t index = can_list_node_to_index(node);
+
+    for (uint32_t id = 0; id < STD_ID_NUMBER; ++id) {
+        if ((can->std_index[id] == 0U) && (node->id == (id & node->id_mask))) {
+            can->std_index[id] = index;
+        }
+    }
+}
+
+/**
+ * @brief Remove a Std node from the dispatch index, its IDs go to the other
+ *        nodes which match them.
+ *
+ * @param can Specific which CAN table.
+ * @param node The node to be removed.
+ */
+static void can_list_std_index_remove(can_table_t *can, can_node_t *node) {
+    uint8_t index = can_list_node_to_index(node);
+
+    for (uint32_t id = 0; id < STD_ID_NUMBER; ++id) {
+        if (can->std_index[id] == index) {
+            can->std_index[id] = can_list_node_to_index(can_list_match_std_node(
+                &can->id_table[STD_ID_TABLE], id, node));
+        }
+    }
+}
+
+/**
+ * @brief Hash the exact IDs of the Ext ID index again.
+ *
+ * @param can Specific which CAN table.
+ */
+static void can_list_ext_hash_build(can_table_t *can) {
+    memset(can->ext_hash, 0, sizeof(can->ext_hash));
+
+    for (uint32_t pos = 0; pos < can->ext_exact; ++pos) {
+        uint32_t slot = EXT_HASH(can->ext_id[pos]);
+
+        while (can->ext_hash[slot] != 0) {
+            slot = (slot + 1) & (EXT_HASH_LEN - 1);
+        }
+        can->ext_hash[slot] = (uint8_t)(pos + 1);
+    }
+}
+
+/**
+ * @brief Add an Ext node to the dispatch index.
+ *
+ * @param can Specific which CAN table.
+ * @param node The node added.
+ * @return Operational status:
+ * @retval - 0: Success.
+ * @retval - 1: The index is full.
+ */
+static uint8_t can_list_ext_index_add(can_table_t *can, can_node_t *node) {
+    uint32_t pos;
+
+    if (can->ext_count >= CAN_LIST_EXT_INDEX_LEN) {
+        return 1;
+    }
+
+    can_list_lock();
+    if ((node->id_mask & EXT_ID_MASK) == EXT_ID_MASK) {
+        /* Exact ID, at the end of the front part. */
+        pos = can->ext_exact;
+        ++can->ext_exact;
+    } else {
+        pos = can->ext_count;
+    }
+
+    for (uint32_t i = can->ext_count; i > pos; --i) {
+        can->ext_index[i] = can->ext_index[i - 1];
+        can->ext_id[i] = can->ext_id[i - 1];
+    }
+    can->ext_index[pos] = node;
+    can->ext_id[pos] = node->id;
+    ++can->ext_count;
+    can_list_ext_hash_build(can);
+#if CAN_LIST_USE_RTOS
+    ++can->ext_change;
+#endif /* CAN_LIST_USE_RTOS */
+    can_list_unlock();
+
+    return 0;
+}
+
+/**
+ * @brief Remove an Ext node from the dispatch index.
+ *
+ * @param can Specific which CAN table.
+ * @param node The node to be removed.
+ */
+static void can_list_ext_index_remove(can_table_t *can, can_node_t *node) {
+    can_list_lock();
+    for (uint32_t pos = 0; pos < can->ext_count; ++pos) {
+        if (can->ext_index[pos] != node) {
+            continue;
+        }
+
+        if (pos < can->ext_exact) {
+            --can->ext_exact;
+        }
+        --can->ext_count;
+        for (uint32_t i = pos; i < can->ext_count; ++i) {
+            can->ext_index[i] = can->ext_index[i + 1];
+            can->ext_id[i] = can->ext_id[i + 1];
+        }
+        can_list_ext_hash_build(can);
+#if CAN_LIST_USE_RTOS
+        ++can->ext_change;
+#endif /* CAN_LIST_USE_RTOS */
+        break;
+    }
+    can_list_unlock();
+}
+
+/**
+ * @brief Find the node of a received Ext ID in the dispatch index.
+ *
+ * @param can Specific which CAN table.
+ * @param id The received id.
+ * @return The node matched, `NULL` if none.
+ */
+static can_node_t *can_list_ext_index_find(const can_table_t *can,
+                                           uint32_t id) {
+    /* At most half of the slots are used, most IDs are found at the first
+       probe and an empty slot ends a miss. */
+    for (uint32_t slot = EXT_HASH(id); can->ext_hash[slot] != 0;
+         slot = (slot + 1) & (EXT_HASH_LEN - 1)) {
+        uint32_t pos = can->ext_hash[slot] - 1U;
+
+        if (can->ext_id[pos] == id) {
+            return can->ext_index[pos];
+        }
+    }
+
+    for (uint32_t i = can->ext_exact; i < can->ext_count; ++i) {
+        if (can->ext_id[i] == (id & can->ext_index[i]->id_mask)) {
+            return can->ext_index[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Let another node of the same ID take the place of a node in the
+ *        dispatch index.
+ *
+ * @param can Specific which CAN table.
+ * @param table_type `STD_ID_TABLE` or `EXT_ID_TABLE`.
+ * @param old_node The node to be replaced.
+ * @param new_node The node takes its place.
+ */
+static void can_list_index_replace(can_table_t *can, uint32_t table_type,
+                                   const can_node_t *old_node,
+                                   can_node_t *new_node) {
+    if (table_type == STD_ID_TABLE) {
+        uint8_t old_index = can_list_node_to_index(old_node);
+        uint8_t new_index = can_list_node_to_index(new_node);
+
+        for (uint32_t id = 0; id < STD_ID_NUMBER; ++id) {
+            if (can->std_index[id] == old_index) {
+                can->std_index[id] = new_index;
+            }
+        }
+        return;
+    }
+
+    can_list_lock();
+    for (uint32_t pos = 0; pos < can->ext_count; ++pos) {
+        if (can->ext_index[pos] == old_node) {
+            can->ext_index[pos] = new_node;
+            break;
+        }
+    }
+    can_list_unlock();
+}
+
+/**
+ * @brief Remove a node from the table and index, then free it.
+ *
+ * @param can Specific which CAN table.
+ * @param table_type `STD_ID_TABLE` or `EXT_ID_TABLE`.
+ * @param node The node to be removed.
+ * @return The ID has no node left or not.
+ */
+static bool can_list_remove_node(can_table_t *can, uint32_t table_type,
+                                 can_node_t *node) {
+    hash_table_t *table = &can->id_table[table_type];
+    can_node_t **link = &table->table[node->id % table->len];
+    bool id_removed = false;
+
+    while ((*link)->id != node->id) {
+        link = &(*link)->next;
+    }
+
+    if (*link != node) {
+        /* Not the first node of this ID, only in the sibling list. */
+        can_node_t *previous_node = *link;
+
+        while (previous_node->sibling != node) {
+            previous_node = previous_node->sibling;
+        }
+        previous_node->sibling = node->sibling;
+    } else if (node->sibling != NULL) {
+        /* The next node of this ID takes its place. */
+        node->sibling->next = node->next;
+        node->sibling->overlap = node->overlap;
+        *link = node->sibling;
+        can_list_index_replace(can, table_type, node, node->sibling);
+    } else {
+        /* Out of the hash table first, the IDs will not go back to it. */
+        *link = node->next;
+        if (table_type == STD_ID_TABLE) {
+            can_list_std_index_remove(can, node);
+        } else {
+            can_list_ext_index_remove(can, node);
+        }
+        can_list_update_overlap(table);
+        id_removed = true;
+    }
+
+    can_list_free_node(node);
+
+    return id_removed;
+}
+
+/**
+ * @brief Free a CAN table and everything in it.
+ *
+ * @param can The CAN table, members not allocated must be `NULL`.
+ */
+static void can_list_free_table(can_table_t *can) {
+#if CAN_LIST_USE_RTOS
+    for (uint32_t i = 0; i < 2; ++i) {
+        if (can->rx_ring[i] != NULL) {
+            ring_fifo_destroy(can->rx_ring[i]);
+        }
+    }
+#endif /* CAN_LIST_USE_RTOS */
+
+    CAN_LIST_FREE(can->std_index);
+    CAN_LIST_FREE(can->id_table[EXT_ID_TABLE].table);
+    CAN_LIST_FREE(can->id_table[STD_ID_TABLE].table);
+    CAN_LIST_FREE(can);
+}
+
 /**
  * @brief Create a CAN table to receive and process the CAN message.
  *
@@ -121,40 +1035,53 @@ uint8_t can_list_add_can(can_selected_t can_select, uint32_t std_len,
         return 2;
     }
 
-    can_table[can_select] = (can_table_t *)CAN_LIST_MALLOC(sizeof(can_table_t));
-    if (can_table[can_select] == NULL) {
+    can_table_t *can = (can_table_t *)CAN_LIST_CALLOC(1, sizeof(can_table_t));
+    if (can == NULL) {
         return 3;
     }
 
-    can_table[can_select]->id_table[STD_ID_TABLE].table =
+    can->id_table[STD_ID_TABLE].table =
         (can_node_t **)CAN_LIST_CALLOC(std_len, sizeof(can_node_t *));
-    if (can_table[can_select]->id_table[STD_ID_TABLE].table == NULL) {
-        CAN_LIST_FREE(can_table[can_select]);
-        can_table[can_select] = NULL;
-        return 3;
-    }
-    can_table[can_select]->id_table[STD_ID_TABLE].len = std_len;
-
-    can_table[can_select]->id_table[EXT_ID_TABLE].table =
+    can->id_table[STD_ID_TABLE].len = std_len;
+    can->id_table[EXT_ID_TABLE].table =
         (can_node_t **)CAN_LIST_CALLOC(ext_len, sizeof(can_node_t *));
-    if (can_table[can_select]->id_table[EXT_ID_TABLE].table == NULL) {
-        CAN_LIST_FREE(can_table[can_select]->id_table[STD_ID_TABLE].table);
-        CAN_LIST_FREE(can_table[can_select]);
-        can_table[can_select] = NULL;
+    can->id_table[EXT_ID_TABLE].len = ext_len;
+    can->std_index = (uint8_t *)CAN_LIST_CALLOC(STD_ID_NUMBER, sizeof(uint8_t));
+
+    if ((can->id_table[STD_ID_TABLE].table == NULL) ||
+        (can->id_table[EXT_ID_TABLE].table == NULL) ||
+        (can->std_index == NULL)) {
+        can_list_free_table(can);
         return 3;
     }
-    can_table[can_select]->id_table[EXT_ID_TABLE].len = ext_len;
 
 #if CAN_LIST_USE_RTOS
-    if (can_list_queue_handle == NULL) {
-        can_list_queue_handle =
-            xQueueCreate(CAN_LIST_QUEUE_LENGTH, sizeof(queue_msg_t));
+    /* Each frame takes a 4 bytes length header in the ring. */
+    for (uint32_t i = 0; i < 2; ++i) {
+        can->rx_ring[i] = ring_fifo_init(
+            NULL, CAN_LIST_RX_RING_LEN * (sizeof(can_frame_t) + 4),
+            RF_TYPE_FRAME);
+        if (can->rx_ring[i] == NULL) {
+            can_list_free_table(can);
+            return 3;
+        }
+    }
+
+    if (can_list_task_handle == NULL) {
+#if CAN_LIST_ENABLE_STATISTICS
+        /* Enable the DWT cycle counter for latency measurement. */
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif /* CAN_LIST_ENABLE_STATISTICS */
+
         xTaskCreate(can_list_polling_task, CAN_LIST_TASK_NAME,
                     CAN_LSIT_TASK_STK_SIZE, NULL, CAN_LIST_TASK_PRIORITY,
                     &can_list_task_handle);
     }
 #endif /* CAN_LIST_USE_RTOS */
 
+    can_table[can_select] = can;
+
     return 0;
 }
 
@@ -171,9 +1098,16 @@ uint8_t can_list_add_can(can_selected_t can_select, uint32_t std_len,
  * @retval - 0: Success.
  * @retval - 1: This CAN does not exists.
  * @retval - 2: The specific CAN table is not created.
- * @retval - 3: Parameter invaild.
- * @retval - 4: This ID already exists in the table.
- * @retval - 5: Memroy allocated failed.
+ * @retval - 3: Parameter invaild, or the mask is different from the other
+ *              nodes of this ID.
+ * @retval - 4: The same data and callback already exists on this ID.
+ * @retval - 5: The node pool is used up, or the Ext ID index is full.
+ * @note Several nodes can be added on one ID, all of their callbacks are
+ *       called in order of adding. If the masks of different IDs match a
+ *       common received ID, the callbacks of all of them are called. The ID
+ *       found by the index goes first, the others follow in the order of the
+ *       ID table buckets, not in order of adding. Such IDs are found by a
+ *       scan of the ID table, slower than the index.
  */
 uint8_t can_list_add_new_node(can_selected_t can_select, void *node_data,
                               uint32_t id, uint32_t id_mask, uint32_t id_type,
@@ -200,12 +1134,27 @@ uint8_t can_list_add_new_node(can_selected_t can_select, void *node_data,
 
     /* Specific hash table to insert. */
     hash_table_t *table = &can_table[can_select]->id_table[id_type];
+    can_node_t *last_node = can_list_find_node_by_id(table, id);
 
-    if (can_list_find_node_by_id(table, id) != NULL) {
-        return 4;
+    if (last_node != NULL) {
+        if (last_node->id_mask != id_mask) {
+            return 3;
+        }
+
+        for (;;) {
+            if ((last_node->can_data == node_data) &&
+                (last_node->callback == callback)) {
+                return 4;
+            }
+
+            if (last_node->sibling == NULL) {
+                break;
+            }
+            last_node = last_node->sibling;
+        }
     }
 
-    can_node_t *new_node = (can_node_t *)CAN_LIST_MALLOC(sizeof(can_node_t));
+    can_node_t *new_node = can_list_alloc_node();
     if (new_node == NULL) {
         return 5;
     }
@@ -214,31 +1163,115 @@ uint8_t can_list_add_new_node(can_selected_t can_select, void *node_data,
     new_node->id = id;
     new_node->id_mask = id_mask;
     new_node->callback = callback;
+    new_node->next = NULL;
+    new_node->sibling = NULL;
+    new_node->overlap = false;
+
+    if (last_node != NULL) {
+        /* The ID is already indexed, the receive path sees the new node
+         * after this. */
+        last_node->sibling = new_node;
+        return 0;
+    }
+
+    if (id_type == STD_ID_TABLE) {
+        can_list_std_index_add(can_table[can_select], new_node);
+    } else if (can_list_ext_index_add(can_table[can_select], new_node) != 0) {
+        can_list_free_node(new_node);
+        return 5;
+    }
+
+    /* Calculate the table index to insert. */
+    can_node_t **table_head = &(table->table[id % table->len]);
+
+    new_node->next = *table_head;
+    *table_head = new_node;
+    can_list_update_overlap(table);
+
+#if (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN)
+    can_list_update_filter(can_select);
+#endif /* (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN) */
+
+    return 0;
+}
+
+/**
+ * @brief Delete all nodes of an ID.
+ *
+ * @param can_select Specific which can to operate.
+ * @param id_type Specific which id table to operate.
+ * @param id Specific which nodes will be deleted.
+ * @return Operational status:
+ * @retval - 0: Success.
+ * @retval - 1: This CAN does not exists.
+ * @retval - 2: The specific CAN table is not created.
+ * @retval - 3: Parameter invaild.
+ * @retval - 4: Node does not exists.
+ * @note With RTOS, returns after the dispatch in progress has finished, the
+ *       node data can be freed then. Do not call in a critical section.
+ */
+uint8_t can_list_del_node_by_id(can_selected_t can_select, uint32_t id_type,
+                                uint32_t id) {
+    if (can_select >= CAN_LIST_MAX_CAN_NUMBER) {
+        return 1;
+    }
+
+    if (can_table[can_select] == NULL) {
+        return 2;
+    }
+
+    if (id_type == CAN_ID_STD) {
+        id_type = STD_ID_TABLE;
+    } else if (id_type == CAN_ID_EXT) {
+        id_type = EXT_ID_TABLE;
+    } else {
+        return 3;
+    }
+
+    can_node_t *node =
+        can_list_find_node_by_id(&can_table[can_select]->id_table[id_type], id);
+
+    if (node == NULL) {
+        /* The node does not exist */
+        return 4;
+    }
 
-    /* Calculate the table index to insert. */
-    can_node_t **table_head = &(table->table[id % table->len]);
+    /* The siblings first, the index is updated only once. */
+    while (node->sibling != NULL) {
+        can_list_remove_node(can_table[can_select], id_type, node->sibling);
+    }
+    can_list_remove_node(can_table[can_select], id_type, node);
+    can_list_wait_dispatch();
 
-    new_node->next = *table_head;
-    *table_head = new_node;
+#if (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN)
+    can_list_update_filter(can_select);
+#endif /* (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN) */
 
     return 0;
 }
 
 /**
- * @brief Delete node by data pointer.
+ * @brief Delete the nodes of an ID by data pointer, the other nodes of this
+ *        ID are kept.
  *
  * @param can_select Specific which can to operate.
  * @param id_type Specific which id table to operate.
- * @param id Specific which node will be deleted.
+ * @param id Specific which ID the nodes are on.
+ * @param node_data The data pointer of the nodes to be deleted.
  * @return Operational status:
  * @retval - 0: Success.
  * @retval - 1: This CAN does not exists.
  * @retval - 2: The specific CAN table is not created.
  * @retval - 3: Parameter invaild.
  * @retval - 4: Node does not exists.
+ * @note With RTOS, returns after the dispatch in progress has finished, the
+ *       node data can be freed then. Do not call in a critical section.
  */
-uint8_t can_list_del_node_by_id(can_selected_t can_select, uint32_t id_type,
-                                uint32_t id) {
+uint8_t can_list_del_node_by_data(can_selected_t can_select, uint32_t id_type,
+                                  uint32_t id, const void *node_data) {
+    bool id_removed = false;
+    bool found = false;
+
     if (can_select >= CAN_LIST_MAX_CAN_NUMBER) {
         return 1;
     }
@@ -255,39 +1288,43 @@ uint8_t can_list_del_node_by_id(can_selected_t can_select, uint32_t id_type,
         return 3;
     }
 
-    hash_table_t *table = &can_table[can_select]->id_table[id_type];
-    can_node_t **list_head = &table->table[id % table->len];
+    can_node_t *node =
+        can_list_find_node_by_id(&can_table[can_select]->id_table[id_type], id);
 
-    can_node_t *current_node = *list_head;
-    can_node_t *previous_node = *list_head;
+    while (node != NULL) {
+        can_node_t *next_node = node->sibling;
 
-    while ((current_node != NULL) && (current_node->id != id)) {
-        previous_node = current_node;
-        current_node = current_node->next;
+        if (node->can_data == node_data) {
+            id_removed =
+                can_list_remove_node(can_table[can_select], id_type, node);
+            found = true;
+        }
+        node = next_node;
     }
 
-    if (current_node == NULL) {
-        /* The node does not exist */
+    if (!found) {
         return 4;
     }
 
-    if (previous_node == current_node) {
-        *list_head = previous_node->next;
-    }
-
-    previous_node->next = current_node->next;
+    can_list_wait_dispatch();
 
-    CAN_LIST_FREE(current_node);
+#if (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN)
+    if (id_removed) {
+        can_list_update_filter(can_select);
+    }
+#else  /* (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN) */
+    UNUSED(id_removed);
+#endif /* (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN) */
 
     return 0;
 }
 
 /**
- * @brief Delete node by data pointer.
+ * @brief Change the callback of the first node added on an ID.
  *
  * @param can_select Specific which can to operate.
  * @param id_type Specific which id table to operate.
- * @param id Specific which node will be deleted.
+ * @param id Specific which node will be changed.
  * @param new_callback New callback of this node to set.
  * @return Operational status:
  * @retval - 0: Success.
@@ -336,306 +1373,423 @@ uint8_t can_list_change_callback(can_selected_t can_select, uint32_t id_type,
  * @{
  */
 
-#if CAN_LIST_USE_RTOS
+#if CAN_LIST_USE_FDCAN
 
 /**
- * @brief CAN list polling task.
+ * @brief Get the CAN list index of the FDCAN.
  *
- * @param args Start arguments.
+ * @param hcan The handle of FDCAN.
+ * @return The index, `CAN_LIST_MAX_CAN_NUMBER` if unknown.
  */
-void can_list_polling_task(void *args) {
-    UNUSED(args);
-#if CAN_LIST_USE_FDCAN
-    /* The rx header read from the CAN. */
-    static FDCAN_RxHeaderTypeDef rx_header;
-    /* The rx data read from the CAN. */
-    static uint8_t rx_data[64];
-#else  /* CAN_LIST_USE_FDCAN */
-    /* The rx header read from the CAN. */
-    static CAN_RxHeaderTypeDef rx_header;
-    /* The rx data read from the CAN. */
-    static uint8_t rx_data[8];
-#endif /* CAN_LIST_USE_FDCAN */
-
-    /* The rx header to callback function. */
-    static can_rx_header_t call_rx_header;
-
-    uint32_t id = 0x00;
-    hash_table_t *table = NULL;
-    can_node_t *node = NULL;
-
-    can_selected_t can_received;
-
-    queue_msg_t recv_msg;
-
-    while (1) {
-        xQueueReceive(can_list_queue_handle, &recv_msg, portMAX_DELAY);
-
-#if CAN_LIST_USE_FDCAN
-
-        switch ((uintptr_t)(recv_msg.hcan->Instance)) {
+static uint8_t can_list_get_index(FDCAN_HandleTypeDef *hcan) {
+    switch ((uintptr_t)(hcan->Instance)) {
 #if FDCAN1_ENABLE
-            case FDCAN1_BASE: {
-                can_received = can1_selected;
-            } break;
+        case FDCAN1_BASE: {
+            return can1_selected;
+        }
 #endif /* FDCAN1_ENABLE */
 
 #if FDCAN2_ENABLE
-            case FDCAN2_BASE: {
-                can_received = can2_selected;
-            } break;
+        case FDCAN2_BASE: {
+            return can2_selected;
+        }
 #endif /* FDCAN2_ENABLE */
 
 #if FDCAN3_ENABLE
-            case FDCAN3_BASE: {
-                can_received = can3_selected;
-            } break;
-#endif /* FDCAN3_ENABLE */
-
-            default:
-                continue;
+        case FDCAN3_BASE: {
+            return can3_selected;
         }
+#endif /* FDCAN3_ENABLE */
 
-        if (HAL_FDCAN_GetRxMessage(recv_msg.hcan, recv_msg.rx_fifo, &rx_header,
-                                   rx_data) != HAL_OK) {
-            continue;
-        }
+        default:
+            return CAN_LIST_MAX_CAN_NUMBER;
+    }
+}
 
-        if (rx_header.IdType == FDCAN_STANDARD_ID) {
-            table = &can_table[can_received]->id_table[STD_ID_TABLE];
-        } else {
-            table = &can_table[can_received]->id_table[EXT_ID_TABLE];
-        }
-        id = rx_header.Identifier;
+/**
+ * @brief Read a frame from the FDCAN RX FIFO.
+ *
+ * @param hcan The handle of FDCAN.
+ * @param rx_fifo Specific which FIFO will read.
+ * @param[out] frame The frame read.
+ * @return Read status:
+ * @retval - 0: Success.
+ * @retval - 1: FIFO is empty or read failed.
+ */
+static uint8_t can_list_read_frame(FDCAN_HandleTypeDef *hcan, uint32_t rx_fifo,
+                                   can_frame_t *frame) {
+    FDCAN_RxHeaderTypeDef rx_header;
 
-        node = table->table[id % table->len];
+    if (HAL_FDCAN_GetRxFifoFillLevel(hcan, rx_fifo) == 0) {
+        return 1;
+    }
 
-        while ((node != NULL) && (node->id) != (id & node->id_mask)) {
-            node = node->next;
-        }
+    if (HAL_FDCAN_GetRxMessage(hcan, rx_fifo, &rx_header, frame->data) !=
+        HAL_OK) {
+        return 1;
+    }
 
-        if (node == NULL || node->callback == NULL) {
-            continue;
-        }
+    frame->header.id = rx_header.Identifier;
+    frame->header.id_type = rx_header.IdType;
+    frame->header.frame_type = rx_header.RxFrameType;
+    frame->header.data_length = rx_header.DataLength;
 
-        call_rx_header.id_type = rx_header.IdType;
-        call_rx_header.frame_type = rx_header.RxFrameType;
-        call_rx_header.data_length = rx_header.DataLength;
+    return 0;
+}
 
 #else /* CAN_LIST_USE_FDCAN */
-        switch ((uintptr_t)(recv_msg.hcan->Instance)) {
+
+/**
+ * @brief Get the CAN list index of the CAN.
+ *
+ * @param hcan The handle of CAN.
+ * @return The index, `CAN_LIST_MAX_CAN_NUMBER` if unknown.
+ */
+static uint8_t can_list_get_index(CAN_HandleTypeDef *hcan) {
+    switch ((uintptr_t)(hcan->Instance)) {
 #if CAN1_ENABLE
-            case CAN1_BASE: {
-                can_received = can1_selected;
-            } break;
+        case CAN1_BASE: {
+            return can1_selected;
+        }
 #endif /* CAN1_ENABLE */
 
 #if CAN2_ENABLE
-            case CAN2_BASE: {
-                can_received = can2_selected;
-            } break;
+        case CAN2_BASE: {
+            return can2_selected;
+        }
 #endif /* CAN2_ENABLE */
 
 #if CAN3_ENABLE
-            case CAN3_BASE: {
-                can_received = can3_selected;
-            } break;
+        case CAN3_BASE: {
+            return can3_selected;
+        }
 #endif /* CAN3_ENABLE */
 
-            default:
-                continue;
-        }
+        default:
+            return CAN_LIST_MAX_CAN_NUMBER;
+    }
+}
 
-        if (HAL_CAN_GetRxMessage(recv_msg.hcan, recv_msg.rx_fifo, &rx_header,
-                                 rx_data) != HAL_OK) {
-            continue;
-        }
+/**
+ * @brief Read a frame from the CAN RX FIFO.
+ *
+ * @param hcan The handle of CAN.
+ * @param rx_fifo Specific which FIFO will read.
+ * @param[out] frame The frame read.
+ * @return Read status:
+ * @retval - 0: Success.
+ * @retval - 1: FIFO is empty or read failed.
+ */
+static uint8_t can_list_read_frame(CAN_HandleTypeDef *hcan, uint32_t rx_fifo,
+                                   can_frame_t *frame) {
+    CAN_RxHeaderTypeDef rx_header;
 
-        /* Enable the notification. */
-        if (recv_msg.rx_fifo == CAN_RX_FIFO0) {
-            HAL_CAN_ActivateNotification(recv_msg.hcan,
-                                         CAN_IT_RX_FIFO0_MSG_PENDING);
-        } else {
-            HAL_CAN_ActivateNotification(recv_msg.hcan,
-                                         CAN_IT_RX_FIFO1_MSG_PENDING);
-        }
+    if (HAL_CAN_GetRxFifoFillLevel(hcan, rx_fifo) == 0) {
+        return 1;
+    }
 
-        if (rx_header.IDE == CAN_ID_STD) {
-            table = &can_table[can_received]->id_table[STD_ID_TABLE];
-            id = rx_header.StdId;
-        } else {
-            table = &can_table[can_received]->id_table[EXT_ID_TABLE];
-            id = rx_header.ExtId;
-        }
+    if (HAL_CAN_GetRxMessage(hcan, rx_fifo, &rx_header, frame->data) !=
+        HAL_OK) {
+        return 1;
+    }
+
+    frame->header.id =
+        (rx_header.IDE == CAN_ID_STD) ? rx_header.StdId : rx_header.ExtId;
+    frame->header.id_type = rx_header.IDE;
+    frame->header.frame_type = rx_header.RTR;
+    frame->header.data_length = (uint8_t)rx_header.DLC;
+
+    return 0;
+}
 
-        node = table->table[id % table->len];
+#endif /* CAN_LIST_USE_FDCAN */
 
-        while ((node != NULL) && (node->id) != (id & node->id_mask)) {
-            node = node->next;
+/**
+ * @brief Call the callbacks of a node and the other nodes of its ID.
+ *
+ * @param node The first node of the ID.
+ * @param frame The frame received.
+ */
+static void can_list_call_node(can_node_t *node, can_frame_t *frame) {
+    for (; node != NULL; node = node->sibling) {
+        if (node->callback != NULL) {
+            node->callback(node->can_data, &frame->header, frame->data);
         }
+    }
+}
 
-        if (node == NULL || node->callback == NULL) {
-            continue;
+/**
+ * @brief Call the other IDs whose masks also match the received ID.
+ *
+ * @param table The ID table of the frame.
+ * @param first The node already called from the dispatch index.
+ * @param frame The frame received.
+ */
+static void can_list_dispatch_overlap(const hash_table_t *table,
+                                      const can_node_t *first,
+                                      can_frame_t *frame) {
+    can_node_t *match[CAN_LIST_NODE_POOL_SIZE];
+    uint32_t match_num = 0;
+    uint32_t id = frame->header.id;
+
+    /* Collect them first, the callbacks are called without the lock. */
+#if CAN_LIST_USE_RTOS
+    can_list_lock();
+#endif /* CAN_LIST_USE_RTOS */
+    for (uint32_t i = 0; i < table->len; ++i) {
+        for (can_node_t *node = table->table[i]; node != NULL;
+             node = node->next) {
+            if ((node != first) && node->overlap &&
+                (node->id == (id & node->id_mask))) {
+                match[match_num++] = node;
+            }
         }
+    }
+#if CAN_LIST_USE_RTOS
+    can_list_unlock();
+#endif /* CAN_LIST_USE_RTOS */
+
+    for (uint32_t i = 0; i < match_num; ++i) {
+        can_list_call_node(match[i], frame);
+    }
+}
 
-        call_rx_header.id_type = rx_header.IDE;
-        call_rx_header.frame_type = rx_header.RTR;
-        call_rx_header.data_length = rx_header.DLC;
+/**
+ * @brief Find the nodes of the frame and call their callbacks.
+ *
+ * @param can_index Specific which CAN received the frame.
+ * @param frame The frame received.
+ */
+static void can_list_dispatch(uint8_t can_index, can_frame_t *frame) {
+    can_node_t *node;
+    uint32_t id = frame->header.id;
+    uint32_t table_type;
 
+#if CAN_LIST_USE_FDCAN
+    if (frame->header.id_type == FDCAN_STANDARD_ID) {
+#else  /* CAN_LIST_USE_FDCAN */
+    if (frame->header.id_type == CAN_ID_STD) {
 #endif /* CAN_LIST_USE_FDCAN */
+        table_type = STD_ID_TABLE;
+        node = can_list_index_to_node(
+            can_table[can_index]->std_index[id & (STD_ID_NUMBER - 1)]);
+    } else {
+        table_type = EXT_ID_TABLE;
+#if CAN_LIST_USE_RTOS
+        /* The index may be moved by a task adding or deleting nodes, it does
+           so in a critical section and counts it. Search again if the index
+           moved during the search, no lock in the receive path. */
+        uint32_t change;
+
+        do {
+            change = can_table[can_index]->ext_change;
+            __COMPILER_BARRIER();
+            node = can_list_ext_index_find(can_table[can_index], id);
+            __COMPILER_BARRIER();
+        } while (change != can_table[can_index]->ext_change);
+#else  /* CAN_LIST_USE_RTOS */
+        node = can_list_ext_index_find(can_table[can_index], id);
+#endif /* CAN_LIST_USE_RTOS */
+    }
+
+    if (node == NULL) {
+        return;
+    }
 
-        call_rx_header.id = id;
+    can_list_call_node(node, frame);
 
-        node->callback(node->can_data, &call_rx_header, rx_data);
+    if (node->overlap) {
+        can_list_dispatch_overlap(&can_table[can_index]->id_table[table_type],
+                                  node, frame);
     }
 }
 
-#else /* CAN_LIST_USE_RTOS */
+#if CAN_LIST_USE_RTOS
 
 #if CAN_LIST_USE_FDCAN
-
 /**
- * @brief Process the can message and call the function by FDCAN ID.
+ * @brief Drain the FDCAN RX FIFO into the ring, wake the task once.
  *
  * @param hcan The handle of FDCAN.
  * @param rx_fifo Specific which FIFO will read.
  */
-static void can_message_process(FDCAN_HandleTypeDef *hcan, uint32_t rx_fifo) {
-
-#else /* CAN_LIST_USE_FDCAN */
-
+static void can_message_receive(FDCAN_HandleTypeDef *hcan, uint32_t rx_fifo) {
+#else  /* CAN_LIST_USE_FDCAN */
 /**
- * @brief Process the can message and call the function by CAN ID.
+ * @brief Drain the CAN RX FIFO into the ring, wake the task once.
  *
  * @param hcan The handle of CAN.
  * @param rx_fifo Specific which FIFO will read.
  */
-static void can_message_process(CAN_HandleTypeDef *hcan, uint32_t rx_fifo) {
-
+static void can_message_receive(CAN_HandleTypeDef *hcan, uint32_t rx_fifo) {
 #endif /* CAN_LIST_USE_FDCAN */
-
-    uint8_t can_received = CAN_LIST_MAX_CAN_NUMBER;
-
+    can_frame_t frame;
+    ring_fifo_t *ring = NULL;
+    uint32_t count = 0;
+    BaseType_t task_woken = pdFALSE;
+
+    uint8_t can_index = can_list_get_index(hcan);
+    if ((can_index < CAN_LIST_MAX_CAN_NUMBER) &&
+        (can_table[can_index] != NULL)) {
+        /* FIFO0 and FIFO1 have their own ring, each ring has one writer. */
 #if CAN_LIST_USE_FDCAN
-
-    switch ((uintptr_t)(hcan->Instance)) {
-#if FDCAN1_ENABLE
-        case FDCAN1_BASE: {
-            can_received = can1_selected;
-        } break;
-#endif /* FDCAN1_ENABLE */
-
-#if FDCAN2_ENABLE
-        case FDCAN2_BASE: {
-            can_received = can2_selected;
-        } break;
-#endif /* FDCAN2_ENABLE */
-
-#if FDCAN3_ENABLE
-        case FDCAN3_BASE: {
-            can_received = can3_selected;
-        } break;
-#endif /* FDCAN3_ENABLE */
-
-        default:
-            return;
+        ring = can_table[can_index]->rx_ring[rx_fifo == FDCAN_RX_FIFO0 ? 0 : 1];
+#else  /* CAN_LIST_USE_FDCAN */
+        ring = can_table[can_index]->rx_ring[rx_fifo == CAN_RX_FIFO0 ? 0 : 1];
+#endif /* CAN_LIST_USE_FDCAN */
     }
 
-#else /* CAN_LIST_USE_FDCAN */
-
-    /* Specific which CAN had received message. */
-    switch ((uintptr_t)(hcan->Instance)) {
-#if CAN1_ENABLE
-        case CAN1_BASE: {
-            can_received = can1_selected;
-        } break;
-#endif /* CAN1_ENABLE */
+    /* Always empty the hardware FIFO, otherwise the interrupt keeps
+     * pending. */
+    while (can_list_read_frame(hcan, rx_fifo, &frame) == 0) {
+        if (ring == NULL) {
+            continue;
+        }
 
-#if CAN2_ENABLE
-        case CAN2_BASE: {
-            can_received = can2_selected;
-        } break;
-#endif /* CAN2_ENABLE */
+#if CAN_LIST_ENABLE_STATISTICS
+        frame.timestamp = DWT->CYCCNT;
+#endif /* CAN_LIST_ENABLE_STATISTICS */
 
-#if CAN3_ENABLE
-        case CAN3_BASE: {
-            can_received = can3_selected;
-        } break;
-#endif /* CAN3_ENABLE */
+        if (ring_fifo_write(ring, &frame, sizeof(frame)) == 0) {
+#if CAN_LIST_ENABLE_STATISTICS
+            ++can_list_stat[can_index].rx_drop;
+#endif /* CAN_LIST_ENABLE_STATISTICS */
+            continue;
+        }
 
-        default:
-            return;
+        ++count;
     }
 
-#endif /* CAN_LIST_USE_FDCAN */
+    if ((count != 0) && (can_list_task_handle != NULL)) {
+        vTaskNotifyGiveFromISR(can_list_task_handle, &task_woken);
+        portYIELD_FROM_ISR(task_woken);
+    }
+}
 
-    /* The rx header to callback function. */
-    static can_rx_header_t call_rx_header;
+#if CAN_LIST_ENABLE_STATISTICS
 
-    /* Specific hash table will search. */
-    uint32_t id;
-    hash_table_t *table;
+/**
+ * @brief Update frame rate of every CAN once a second.
+ */
+static void can_list_stat_rate(void) {
+    static uint32_t last_tick;
+    static uint32_t last_count[CAN_LIST_MAX_CAN_NUMBER];
 
-#if CAN_LIST_USE_FDCAN
-    /* The rx header read from the CAN. */
-    static FDCAN_RxHeaderTypeDef rx_header;
-    /* The rx data read from the CAN. */
-    static uint8_t rx_data[64];
-    if (HAL_FDCAN_GetRxMessage(hcan, rx_fifo, &rx_header, rx_data) != HAL_OK) {
+    if (HAL_GetTick() - last_tick < 1000) {
         return;
     }
+    last_tick = HAL_GetTick();
 
-    if (rx_header.IdType == FDCAN_STANDARD_ID) {
-        table = &can_table[can_received]->id_table[STD_ID_TABLE];
-
-    } else {
-        table = &can_table[can_received]->id_table[EXT_ID_TABLE];
-    }
-    id = rx_header.Identifier;
-#else  /* CAN_LIST_USE_FDCAN */
-    /* The rx header read from the CAN. */
-    static CAN_RxHeaderTypeDef rx_header;
-    /* The rx data read from the CAN. */
-    static uint8_t rx_data[8];
-    if (HAL_CAN_GetRxMessage(hcan, rx_fifo, &rx_header, rx_data) != HAL_OK) {
-        return;
+    for (uint32_t i = 0; i < CAN_LIST_MAX_CAN_NUMBER; ++i) {
+        can_list_stat[i].rx_rate = can_list_stat[i].rx_count - last_count[i];
+        last_count[i] = can_list_stat[i].rx_count;
     }
+}
 
-    if (rx_header.IDE == CAN_ID_STD) {
-        table = &can_table[can_received]->id_table[STD_ID_TABLE];
-        id = rx_header.StdId;
-    } else {
-        table = &can_table[can_received]->id_table[EXT_ID_TABLE];
-        id = rx_header.ExtId;
-    }
-#endif /* CAN_LIST_USE_FDCAN */
+#endif /* CAN_LIST_ENABLE_STATISTICS */
 
-    can_node_t *node = table->table[id % table->len];
+/**
+ * @brief CAN list polling task.
+ *
+ * @param args Start arguments.
+ */
+void can_list_polling_task(void *args) {
+    UNUSED(args);
 
-    while ((node != NULL) && (node->id) != (id & node->id_mask)) {
-        node = node->next;
-    }
+    /* The frame read from the ring. */
+    static can_frame_t frame;
+#if CAN_LIST_ENABLE_STATISTICS
+    uint32_t burst;
+    uint32_t cycle_per_us;
+#endif /* CAN_LIST_ENABLE_STATISTICS */
 
-    if (node == NULL || node->callback == NULL) {
-        return;
+    while (1) {
+#if CAN_LIST_ENABLE_STATISTICS
+        /* Wake up at least once a second to update the frame rate. */
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        cycle_per_us = SystemCoreClock / 1000000U;
+#else  /* CAN_LIST_ENABLE_STATISTICS */
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#endif /* CAN_LIST_ENABLE_STATISTICS */
+
+        for (uint8_t i = 0; i < CAN_LIST_MAX_CAN_NUMBER; ++i) {
+            if (can_table[i] == NULL) {
+                continue;
+            }
+
+#if CAN_LIST_ENABLE_STATISTICS
+            burst = 0;
+#endif /* CAN_LIST_ENABLE_STATISTICS */
+
+            can_list_dispatch_begin();
+            for (uint32_t j = 0; j < 2; ++j) {
+                while (ring_fifo_read(can_table[i]->rx_ring[j], &frame,
+                                      sizeof(frame)) != 0) {
+#if CAN_LIST_ENABLE_STATISTICS
+                    ++burst;
+                    ++can_list_stat[i].rx_count;
+                    can_list_stat[i].latency =
+                        (DWT->CYCCNT - frame.timestamp) / cycle_per_us;
+                    if (can_list_stat[i].latency >
+                        can_list_stat[i].max_latency) {
+                        can_list_stat[i].max_latency =
+                            can_list_stat[i].latency;
+                    }
+#endif /* CAN_LIST_ENABLE_STATISTICS */
+
+                    can_list_dispatch(i, &frame);
+                }
+            }
+            can_list_dispatch_end();
+
+#if CAN_LIST_ENABLE_STATISTICS
+            if (burst > can_list_stat[i].max_burst) {
+                can_list_stat[i].max_burst = burst;
+            }
+#endif /* CAN_LIST_ENABLE_STATISTICS */
+        }
+
+#if CAN_LIST_ENABLE_STATISTICS
+        can_list_stat_rate();
+#endif /* CAN_LIST_ENABLE_STATISTICS */
     }
+}
 
-    call_rx_header.id = id;
+#else /* CAN_LIST_USE_RTOS */
 
 #if CAN_LIST_USE_FDCAN
-    call_rx_header.id_type = rx_header.IdType;
-    call_rx_header.frame_type = rx_header.RxFrameType;
-    call_rx_header.data_length = rx_header.DataLength;
+/**
+ * @brief Drain the FDCAN RX FIFO and call the function by FDCAN ID.
+ *
+ * @param hcan The handle of FDCAN.
+ * @param rx_fifo Specific which FIFO will read.
+ */
+static void can_message_receive(FDCAN_HandleTypeDef *hcan, uint32_t rx_fifo) {
 #else  /* CAN_LIST_USE_FDCAN */
-    call_rx_header.id_type = rx_header.IDE;
-    call_rx_header.frame_type = rx_header.RTR;
-    call_rx_header.data_length = rx_header.DLC;
+/**
+ * @brief Drain the CAN RX FIFO and call the function by CAN ID.
+ *
+ * @param hcan The handle of CAN.
+ * @param rx_fifo Specific which FIFO will read.
+ */
+static void can_message_receive(CAN_HandleTypeDef *hcan, uint32_t rx_fifo) {
 #endif /* CAN_LIST_USE_FDCAN */
+    /* The frame read from the CAN. */
+    static can_frame_t frame;
 
-    node->callback(node->can_data, &call_rx_header, rx_data);
+    uint8_t can_index = can_list_get_index(hcan);
+
+    can_list_dispatch_begin();
+    while (can_list_read_frame(hcan, rx_fifo, &frame) == 0) {
+        if ((can_index < CAN_LIST_MAX_CAN_NUMBER) &&
+            (can_table[can_index] != NULL)) {
+            can_list_dispatch(can_index, &frame);
+        }
+    }
+    can_list_dispatch_end();
 }
 
-#endif /* CAN_LIST_USE_RTOS */
+#endif /* CAN_LIST_USE_FDCAN */
 
 /**
  * @}
@@ -650,7 +1804,7 @@ static void can_message_process(CAN_HandleTypeDef *hcan, uint32_t rx_fifo) {
 
 /**
  * @brief Rx FIFO 0 callback.
- * 
+ *
  * @param hfdcan pointer to an FDCAN_HandleTypeDef structure that contains
  *        the configuration information for the specified FDCAN.
  * @param RxFifo0ITs indicates which Rx FIFO 0 interrupts are signaled.
@@ -662,17 +1816,7 @@ void HAL_FDCAN_RxFifo0Callback(FDCAN_HandleTypeDef *hfdcan,
         return;
     }
 
-#if CAN_LIST_USE_RTOS
-    if (can_list_queue_handle == NULL) {
-        return;
-    }
-
-    send_msg_from_isr.hcan = hfdcan;
-    send_msg_from_isr.rx_fifo = FDCAN_RX_FIFO0;
-    xQueueSendFromISR(can_list_queue_handle, &send_msg_from_isr, NULL);
-#else  /* CAN_LIST_USE_RTOS */
-    can_message_process(hfdcan, FDCAN_RX_FIFO0);
-#endif /* CAN_LIST_USE_RTOS */
+    can_message_receive(hfdcan, FDCAN_RX_FIFO0);
 }
 /**
  * @brief Rx FIFO 1 callback.
@@ -688,17 +1832,7 @@ void HAL_FDCAN_RxFifo1Callback(FDCAN_HandleTypeDef *hfdcan,
         return;
     }
 
-#if CAN_LIST_USE_RTOS
-    if (can_list_queue_handle == NULL) {
-        return;
-    }
-
-    send_msg_from_isr.hcan = hfdcan;
-    send_msg_from_isr.rx_fifo = FDCAN_RX_FIFO1;
-    xQueueSendFromISR(can_list_queue_handle, &send_msg_from_isr, NULL);
-#else  /* CAN_LIST_USE_RTOS */
-    can_message_process(hfdcan, FDCAN_RX_FIFO1);
-#endif /* CAN_LIST_USE_RTOS */
+    can_message_receive(hfdcan, FDCAN_RX_FIFO1);
 }
 
 #else /* CAN_LIST_USE_FDCAN */
@@ -708,18 +1842,7 @@ void HAL_FDCAN_RxFifo1Callback(FDCAN_HandleTypeDef *hfdcan,
  * @param hcan The handle of CAN.
  */
 void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan) {
-#if CAN_LIST_USE_RTOS
-    if (can_list_queue_handle == NULL) {
-        return;
-    }
-
-    send_msg_from_isr.hcan = hcan;
-    send_msg_from_isr.rx_fifo = CAN_RX_FIFO0;
-    xQueueSendFromISR(can_list_queue_handle, &send_msg_from_isr, NULL);
-    HAL_CAN_DeactivateNotification(hcan, CAN_IT_RX_FIFO0_MSG_PENDING);
-#else  /* CAN_LIST_USE_RTOS */
-    can_message_process(hcan, CAN_RX_FIFO0);
-#endif /* CAN_LIST_USE_RTOS */
+    can_message_receive(hcan, CAN_RX_FIFO0);
 }
 
 /**
@@ -728,21 +1851,10 @@ void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan) {
  * @param hcan The handle of CAN.
  */
 void HAL_CAN_RxFifo1MsgPendingCallback(CAN_HandleTypeDef *hcan) {
-#if CAN_LIST_USE_RTOS
-    if (can_list_queue_handle == NULL) {
-        return;
-    }
-
-    send_msg_from_isr.hcan = hcan;
-    send_msg_from_isr.rx_fifo = CAN_RX_FIFO1;
-    xQueueSendFromISR(can_list_queue_handle, &send_msg_from_isr, NULL);
-    HAL_CAN_DeactivateNotification(hcan, CAN_IT_RX_FIFO1_MSG_PENDING);
-#else  /* CAN_LIST_USE_RTOS */
-    can_message_process(hcan, CAN_RX_FIFO1);
-#endif /* CAN_LIST_USE_RTOS */
+    can_message_receive(hcan, CAN_RX_FIFO1);
 }
 
-#endif /* CAN_LIST_USE_RTOS */
+#endif /* CAN_LIST_USE_FDCAN */
 
 /**
  * @}
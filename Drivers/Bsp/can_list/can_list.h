@@ -2,8 +2,8 @@
  * @file    can_list.c
  * @author  Deadline039
  * @brief   CAN Receive list.
- * @version 1.0
- * @date    2024-11-24
+ * @version 1.1
+ * @date    2026-10-17
  * @note    We will overload the CAN interrupt callback functions, include CAN
  *          RX0 and RX1 FIFO pending callbacck.
  */
@@ -22,7 +22,31 @@ extern "C" {
 
 #define CAN_LIST_MAX_CAN_NUMBER 3
 
-#define CAN_LIST_MALLOC(p)      malloc(p)
+/**
+ * Frames are dispatched through an index built when nodes are added or
+ * deleted. Standard IDs use a 2048 entries table (2 KB for each CAN), mask
+ * ranges are expanded into it. Exact extended IDs are hashed into a table of
+ * 2 ~ 4 slots per index entry (1 byte each), masked extended IDs are searched
+ * one by one after it. No more than 128.
+ */
+#ifndef CAN_LIST_EXT_INDEX_LEN
+#define CAN_LIST_EXT_INDEX_LEN 16
+#endif /* CAN_LIST_EXT_INDEX_LEN */
+
+/**
+ * Program the bxCAN filter banks from the registered nodes, so the frames of
+ * other IDs are dropped by hardware. Exact IDs use list mode, masked IDs use
+ * mask mode, lower IDs go to FIFO0 when both FIFOs are enabled. Falls back to
+ * accept all frames if the nodes need more banks than the CAN has.
+ */
+#define CAN_LIST_HW_FILTER      1
+
+/* Nodes of all CANs, no more than 255. A node takes 24 bytes. */
+#ifndef CAN_LIST_NODE_POOL_SIZE
+#define CAN_LIST_NODE_POOL_SIZE 32
+#endif /* CAN_LIST_NODE_POOL_SIZE */
+
+/* Hash tables and Std ID index, allocated once by `can_list_add_can`. */
 #define CAN_LIST_CALLOC(x, p)   calloc(x, p)
 #define CAN_LIST_FREE(p)        free(p)
 
@@ -39,10 +63,16 @@ extern "C" {
 #define CAN_LIST_USE_RTOS       1
 
 #if CAN_LIST_USE_RTOS
-#define CAN_LIST_TASK_NAME     "Can list"
-#define CAN_LIST_TASK_PRIORITY 2
-#define CAN_LSIT_TASK_STK_SIZE 256
-#define CAN_LIST_QUEUE_LENGTH  5
+#define CAN_LIST_TASK_NAME         "Can list"
+#define CAN_LIST_TASK_PRIORITY     2
+#define CAN_LSIT_TASK_STK_SIZE     256
+/* Frames buffered between the ISR and the task, for each RX FIFO. */
+#define CAN_LIST_RX_RING_LEN       16
+/* Count frame rate, drops and ISR to callback latency of each CAN. The task
+   then wakes every second and the ISR reads DWT, keep it off unless tuning. */
+#ifndef CAN_LIST_ENABLE_STATISTICS
+#define CAN_LIST_ENABLE_STATISTICS 0
+#endif /* CAN_LIST_ENABLE_STATISTICS */
 #endif /* CAN_LIST_USE_RTOS */
 
 /**
@@ -66,6 +96,22 @@ typedef void (*can_callback_t)(void * /* node_obj */,
                                can_rx_header_t * /* can_rx_header */,
                                uint8_t * /* can_msg */);
 
+#if (CAN_LIST_USE_RTOS && CAN_LIST_ENABLE_STATISTICS)
+/**
+ * @brief Receive statistics of a CAN.
+ */
+typedef struct {
+    uint32_t rx_count;    /*!< Frames dispatched by the task.              */
+    uint32_t rx_drop;     /*!< Frames dropped in ISR, the ring was full.   */
+    uint32_t rx_rate;     /*!< Frames per second, updated every second.    */
+    uint32_t max_burst;   /*!< Most frames handled in one task wake-up.    */
+    uint32_t latency;     /*!< Last ISR to callback latency. Unit: us.     */
+    uint32_t max_latency; /*!< Max ISR to callback latency. Unit: us.      */
+} can_list_stat_t;
+
+extern can_list_stat_t can_list_stat[CAN_LIST_MAX_CAN_NUMBER];
+#endif /* (CAN_LIST_USE_RTOS && CAN_LIST_ENABLE_STATISTICS) */
+
 uint8_t can_list_add_can(can_selected_t can_select, uint32_t std_len,
                          uint32_t ext_len);
 
@@ -74,6 +120,11 @@ uint8_t can_list_add_new_node(can_selected_t can_select, void *node_data,
                               can_callback_t callback);
 uint8_t can_list_del_node_by_id(can_selected_t can_select, uint32_t id_type,
                                 uint32_t id);
+uint8_t can_list_del_node_by_data(can_selected_t can_select, uint32_t id_type,
+                                  uint32_t id, const void *node_data);
+#if (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN)
+uint8_t can_list_update_filter(can_selected_t can_select);
+#endif /* (CAN_LIST_HW_FILTER && !CAN_LIST_USE_FDCAN) */
 uint8_t can_list_change_callback(can_selected_t can_select, uint32_t id_type,
                                  uint32_t id, can_callback_t new_callback);
 
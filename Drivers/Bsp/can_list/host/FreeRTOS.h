@@ -0,0 +1,61 @@
+/**
+ * @file    FreeRTOS.h
+ * @brief   FreeRTOS stand-in of the CAN list host tests, only the parts used
+ *          by `can_list.c`.
+ */
+
+#ifndef __HOST_FREERTOS_H
+#define __HOST_FREERTOS_H
+
+#include <stdint.h>
+
+typedef void *TaskHandle_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdFALSE                       0
+#define pdTRUE                        1
+#define pdPASS                        1
+#define portMAX_DELAY                 0xFFFFFFFFU
+#define pdMS_TO_TICKS(x)              (x)
+#define portYIELD_FROM_ISR(x)         ((void)(x))
+
+#define taskSCHEDULER_SUSPENDED       0
+#define taskSCHEDULER_NOT_STARTED     1
+#define taskSCHEDULER_RUNNING         2
+
+/* Critical sections nest like the Cortex-M port, PRIMASK is restored by the
+ * outermost exit. */
+#define taskENTER_CRITICAL()          vPortEnterCritical()
+#define taskEXIT_CRITICAL()           vPortExitCritical()
+
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name,
+                       uint16_t stack_depth, void *params,
+                       UBaseType_t priority, TaskHandle_t *handle);
+BaseType_t xTaskGetSchedulerState(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+void vTaskDelay(TickType_t ticks);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+
+/*****************************************************************************
+ * Control of the tests.
+ */
+
+/* Notifications given to the task and not taken yet. */
+extern uint32_t host_task_notify;
+/* Number of vTaskNotifyGiveFromISR calls. */
+extern uint32_t host_task_gives;
+/* Number of passes of the task loop. */
+extern uint32_t host_task_runs;
+/* Timeout of the last ulTaskNotifyTake. */
+extern TickType_t host_task_wait;
+
+uint32_t host_task_run(void);
+
+#endif /* __HOST_FREERTOS_H */
@@ -0,0 +1,359 @@
+/**
+ * @file    can_list_test.c
+ * @brief   Add, delete and dispatch of the CAN list on the host.
+ *
+ * @note Frames go the firmware path: the bxCAN model of the CSP stubs
+ *       filters them into the RX FIFOs, the CSP vectors drain them into the
+ *       rings and `host_task_run` runs one pass of the CAN list task.
+ *       Covers the error codes, several callbacks on one ID in order of
+ *       adding, mask ranges overlapping exact IDs, Ext IDs, the node pool
+ *       running out and being reused, and deleting nodes from a callback
+ *       while the dispatch still walks them.
+ */
+
+#include "can_list/can_list.h"
+#include "hal_stubs.h"
+#include "FreeRTOS.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Vectors of the CANs, defined by the CSP. */
+void CAN1_RX0_IRQHandler(void);
+void CAN1_RX1_IRQHandler(void);
+void CAN2_RX0_IRQHandler(void);
+
+#define TEST_CALL_LEN 64U
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief A callback call.
+ */
+typedef struct {
+    char callback;    /*!< 'a', 'b' or 'd'. */
+    void *node;       /*!< Node data.       */
+    uint32_t id;      /*!< Frame ID.        */
+    uint32_t id_type; /*!< Frame ID type.   */
+    uint8_t len;      /*!< Frame length.    */
+    uint8_t first;    /*!< First data byte. */
+} test_call_t;
+
+static test_call_t test_calls[TEST_CALL_LEN];
+static uint32_t test_call_num;
+
+/* Nodes, only their addresses are used. */
+static int motor, logger, monitor, range, ext_dev;
+static int spare[CAN_LIST_NODE_POOL_SIZE];
+
+static void test_record(char callback, void *node, can_rx_header_t *header,
+                        uint8_t *msg) {
+    if (test_call_num < TEST_CALL_LEN) {
+        test_calls[test_call_num] = (test_call_t){
+            callback, node, header->id, header->id_type, header->data_length,
+            msg[0]};
+    }
+    ++test_call_num;
+}
+
+static void test_cb_a(void *node, can_rx_header_t *header, uint8_t *msg) {
+    test_record('a', node, header, msg);
+}
+
+static void test_cb_b(void *node, can_rx_header_t *header, uint8_t *msg) {
+    test_record('b', node, header, msg);
+}
+
+/**
+ * @brief Deletes its own node, then adds a node on another ID.
+ */
+static void test_cb_delete(void *node, can_rx_header_t *header, uint8_t *msg) {
+    test_record('d', node, header, msg);
+    CHECK(can_list_del_node_by_data(can1_selected, CAN_ID_STD, header->id,
+                                    node) == 0);
+    CHECK(can_list_add_new_node(can1_selected, &spare[0], 0x300, 0x7FF,
+                                CAN_ID_STD, test_cb_b) == 0);
+}
+
+/**
+ * @brief Frames arrive on the bus, the RX interrupts run after each one.
+ *
+ * @param can_select CAN1 or CAN2.
+ * @param ide `CAN_ID_STD` or `CAN_ID_EXT`.
+ * @param id Frame IDs.
+ * @param num Number of frames.
+ */
+static void test_bus_rx(can_selected_t can_select, uint32_t ide,
+                        const uint32_t *id, uint32_t num) {
+    CAN_HandleTypeDef *hcan = can_get_handle(can_select);
+
+    for (uint32_t i = 0; i < num; ++i) {
+        uint8_t data[8] = {(uint8_t)i, 1, 2, 3, 4, 5, 6, 7};
+
+        host_can_rx(hcan, ide, id[i], 8, data);
+        if (can_select == can1_selected) {
+            CAN1_RX0_IRQHandler();
+            CAN1_RX1_IRQHandler();
+        } else {
+            CAN2_RX0_IRQHandler();
+        }
+    }
+}
+
+/**
+ * @brief Frames arrive, then the task runs once.
+ */
+static void test_dispatch(can_selected_t can_select, uint32_t ide,
+                          const uint32_t *id, uint32_t num) {
+    test_call_num = 0;
+    test_bus_rx(can_select, ide, id, num);
+    host_task_run();
+}
+
+static bool test_call(uint32_t n, char callback, void *node, uint32_t id) {
+    return (test_calls[n].callback == callback) &&
+           (test_calls[n].node == node) && (test_calls[n].id == id);
+}
+
+/**
+ * @brief Error codes of adding and deleting.
+ */
+static void test_errors(void) {
+    CHECK(can_list_add_new_node(can2_selected, &motor, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 2);
+    CHECK(can_list_add_new_node(CAN_LIST_MAX_CAN_NUMBER, &motor, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 1);
+
+    CHECK(can_list_add_can(can1_selected, 4, 4) == 0);
+    CHECK(can_list_add_can(can1_selected, 4, 4) == 2);
+    CHECK(can_list_add_can(can2_selected, 1, 1) == 0);
+
+    CHECK(can_list_add_new_node(can1_selected, &motor, 0x201, 0x7FF, 3,
+                                test_cb_a) == 3);
+    CHECK(can_list_add_new_node(can1_selected, &motor, 0x201, 0x7FF,
+                                CAN_ID_STD, NULL) == 3);
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x201) == 4);
+    CHECK(can_list_del_node_by_data(can1_selected, CAN_ID_STD, 0x201,
+                                    &motor) == 4);
+    CHECK(can_list_change_callback(can1_selected, CAN_ID_STD, 0x201,
+                                   test_cb_b) == 4);
+}
+
+/**
+ * @brief Several callbacks on one ID, deleting them one by one.
+ */
+static void test_fan_out(void) {
+    const uint32_t id[] = {0x201, 0x202};
+
+    CHECK(can_list_add_new_node(can1_selected, &motor, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 0);
+    CHECK(can_list_add_new_node(can1_selected, &logger, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_b) == 0);
+    CHECK(can_list_add_new_node(can1_selected, &monitor, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 0);
+    /* Same data and callback again, a different mask on the same ID. */
+    CHECK(can_list_add_new_node(can1_selected, &logger, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_b) == 4);
+    CHECK(can_list_add_new_node(can1_selected, &spare[0], 0x201, 0x7F0,
+                                CAN_ID_STD, test_cb_b) == 3);
+    /* Same data with another callback is another node. */
+    CHECK(can_list_add_new_node(can1_selected, &logger, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 0);
+
+    /* 0x202 is dropped by the filters, nothing is called. */
+    test_dispatch(can1_selected, CAN_ID_STD, id, 2);
+    CHECK(test_call_num == 4);
+    CHECK(test_call(0, 'a', &motor, 0x201));
+    CHECK(test_call(1, 'b', &logger, 0x201));
+    CHECK(test_call(2, 'a', &monitor, 0x201));
+    CHECK(test_call(3, 'a', &logger, 0x201));
+    CHECK((test_calls[0].id_type == CAN_ID_STD) && (test_calls[0].len == 8) &&
+          (test_calls[0].first == 0));
+    CHECK(host_can(&can1_handle)->rejected == 1);
+
+    /* Both nodes of the logger go, the others keep their order. */
+    CHECK(can_list_del_node_by_data(can1_selected, CAN_ID_STD, 0x201,
+                                    &logger) == 0);
+    test_dispatch(can1_selected, CAN_ID_STD, id, 1);
+    CHECK(test_call_num == 2);
+    CHECK(test_call(0, 'a', &motor, 0x201));
+    CHECK(test_call(1, 'a', &monitor, 0x201));
+
+    /* The first node of the ID goes, the next one takes its place. */
+    CHECK(can_list_change_callback(can1_selected, CAN_ID_STD, 0x201,
+                                   test_cb_b) == 0);
+    CHECK(can_list_del_node_by_data(can1_selected, CAN_ID_STD, 0x201,
+                                    &motor) == 0);
+    test_dispatch(can1_selected, CAN_ID_STD, id, 1);
+    CHECK(test_call_num == 1);
+    CHECK(test_call(0, 'a', &monitor, 0x201));
+
+    /* The last node goes with the ID. */
+    CHECK(can_list_del_node_by_data(can1_selected, CAN_ID_STD, 0x201,
+                                    &monitor) == 0);
+    CHECK(can_list_del_node_by_data(can1_selected, CAN_ID_STD, 0x201,
+                                    &monitor) == 4);
+    test_dispatch(can1_selected, CAN_ID_STD, id, 1);
+    CHECK(test_call_num == 0);
+}
+
+/**
+ * @brief A mask range overlapping exact IDs, on CAN1 only.
+ */
+static void test_mask(void) {
+    const uint32_t id[] = {0x201, 0x20A, 0x211, 0x205};
+
+    CHECK(can_list_add_new_node(can1_selected, &motor, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 0);
+    CHECK(can_list_add_new_node(can1_selected, &range, 0x200, 0x7F0,
+                                CAN_ID_STD, test_cb_b) == 0);
+    CHECK(can_list_add_new_node(can2_selected, &monitor, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 0);
+
+    /* The indexed ID first, then the range. */
+    test_dispatch(can1_selected, CAN_ID_STD, id, 4);
+    CHECK(test_call_num == 4);
+    CHECK(test_call(0, 'a', &motor, 0x201));
+    CHECK(test_call(1, 'b', &range, 0x201));
+    CHECK(test_call(2, 'b', &range, 0x20A));
+    CHECK(test_call(3, 'b', &range, 0x205));
+
+    /* Deleting the exact ID gives its ID back to the range. */
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x201) == 0);
+    test_dispatch(can1_selected, CAN_ID_STD, id, 1);
+    CHECK(test_call_num == 1);
+    CHECK(test_call(0, 'b', &range, 0x201));
+
+    /* CAN2 has its own table. */
+    test_dispatch(can2_selected, CAN_ID_STD, id, 2);
+    CHECK(test_call_num == 1);
+    CHECK(test_call(0, 'a', &monitor, 0x201));
+
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x200) == 0);
+    CHECK(can_list_del_node_by_id(can2_selected, CAN_ID_STD, 0x201) == 0);
+    test_dispatch(can1_selected, CAN_ID_STD, id, 4);
+    CHECK(test_call_num == 0);
+}
+
+/**
+ * @brief Exact and masked Ext IDs, the ID format of the README example.
+ */
+static void test_ext(void) {
+    const uint32_t id[] = {0x1234567, 0x3A5B01, 0x1234568, 0x0BCD02};
+
+    CHECK(can_list_add_new_node(can1_selected, &ext_dev, 0x1234567,
+                                0x1FFFFFFF, CAN_ID_EXT, test_cb_a) == 0);
+    CHECK(can_list_add_new_node(can1_selected, &range, 0x01, 0xFF, CAN_ID_EXT,
+                                test_cb_b) == 0);
+
+    test_dispatch(can1_selected, CAN_ID_EXT, id, 4);
+    CHECK(test_call_num == 2);
+    CHECK(test_call(0, 'a', &ext_dev, 0x1234567));
+    CHECK(test_call(1, 'b', &range, 0x3A5B01));
+    CHECK(test_calls[1].id_type == CAN_ID_EXT);
+
+    /* A Std frame of the same value is another ID. */
+    test_dispatch(can1_selected, CAN_ID_STD, &id[3], 1);
+    CHECK(test_call_num == 0);
+
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_EXT, 0x1234567) == 0);
+    CHECK(can_list_del_node_by_data(can1_selected, CAN_ID_EXT, 0x01,
+                                    &range) == 0);
+    test_dispatch(can1_selected, CAN_ID_EXT, id, 4);
+    CHECK(test_call_num == 0);
+}
+
+/**
+ * @brief The node pool runs out, deleted nodes are reused.
+ */
+static void test_pool(void) {
+    const uint32_t id = 0x400 + CAN_LIST_NODE_POOL_SIZE - 1;
+
+    for (uint32_t i = 0; i < CAN_LIST_NODE_POOL_SIZE; ++i) {
+        CHECK(can_list_add_new_node(can1_selected, &spare[i], 0x400 + i,
+                                    0x7FF, CAN_ID_STD, test_cb_a) == 0);
+    }
+    CHECK(can_list_add_new_node(can1_selected, &motor, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 5);
+    CHECK(can_list_add_new_node(can1_selected, &spare[0], 0x400, 0x7FF,
+                                CAN_ID_STD, test_cb_b) == 5);
+
+    /* The last node added is still reached. */
+    test_dispatch(can1_selected, CAN_ID_STD, &id, 1);
+    CHECK(test_call_num == 1);
+    CHECK(test_call(0, 'a', &spare[CAN_LIST_NODE_POOL_SIZE - 1], id));
+
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x405) == 0);
+    CHECK(can_list_add_new_node(can1_selected, &motor, 0x201, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 0);
+    CHECK(can_list_add_new_node(can1_selected, &logger, 0x202, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 5);
+
+    for (uint32_t i = 0; i < CAN_LIST_NODE_POOL_SIZE; ++i) {
+        can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x400 + i);
+    }
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x201) == 0);
+    CHECK(can_list_update_filter(can1_selected) == 0);
+}
+
+/**
+ * @brief A callback deletes its node while the dispatch walks it.
+ */
+static void test_delete_in_callback(void) {
+    const uint32_t id[] = {0x205, 0x205, 0x300};
+
+    CHECK(can_list_add_new_node(can1_selected, &motor, 0x205, 0x7FF,
+                                CAN_ID_STD, test_cb_delete) == 0);
+    CHECK(can_list_add_new_node(can1_selected, &logger, 0x205, 0x7FF,
+                                CAN_ID_STD, test_cb_a) == 0);
+
+    /* The first frame calls both, the node added by the callback does not
+     * take the place of the deleted one while the sibling walk goes on. */
+    test_dispatch(can1_selected, CAN_ID_STD, id, 2);
+    CHECK(test_call_num == 3);
+    CHECK(test_call(0, 'd', &motor, 0x205));
+    CHECK(test_call(1, 'a', &logger, 0x205));
+    CHECK(test_call(2, 'a', &logger, 0x205));
+
+    test_dispatch(can1_selected, CAN_ID_STD, id, 3);
+    CHECK(test_call_num == 3);
+    CHECK(test_call(2, 'b', &spare[0], 0x300));
+
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x205) == 0);
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x300) == 0);
+}
+
+int main(void) {
+    host_periph_map();
+
+    CHECK(can1_init(1000, 0) == CAN_INIT_OK);
+    CHECK(can2_init(1000, 0) == CAN_INIT_OK);
+
+    test_errors();
+    test_fan_out();
+    test_mask();
+    test_ext();
+    test_pool();
+    test_delete_in_callback();
+
+    /* Every frame was taken from the FIFOs, the critical sections are
+     * balanced. */
+    CHECK(host_can(&can1_handle)->overrun[0] == 0);
+    CHECK(host_can(&can1_handle)->overrun[1] == 0);
+    CHECK(host_primask == 0);
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
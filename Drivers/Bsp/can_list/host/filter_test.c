@@ -0,0 +1,340 @@
+/**
+ * @file    filter_test.c
+ * @brief   bxCAN filter banks programmed by the CAN list, on the host.
+ *
+ * @note The banks written by `can_list_update_filter` are matched by the
+ *       bxCAN model of the CSP stubs. For each set of nodes every Std ID and
+ *       a sample of Ext IDs are checked: a frame reaches a FIFO if and only
+ *       if a node matches it. Typical DJI motor ID sets are checked for the
+ *       banks used and the FIFO split, then random sets for the math.
+ */
+
+#include "can_list/can_list.h"
+#include "hal_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_NODE_LEN 32U
+#define TEST_EXT_ID   0x1FFFFFFFU
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief A node added by the test.
+ */
+typedef struct {
+    uint32_t id;
+    uint32_t mask;
+    uint32_t ide;
+} test_node_t;
+
+static test_node_t test_nodes[CAN_LIST_MAX_CAN_NUMBER][TEST_NODE_LEN];
+static uint32_t test_node_num[CAN_LIST_MAX_CAN_NUMBER];
+static uint32_t test_seed = 1;
+
+static void test_callback(void *node, can_rx_header_t *header, uint8_t *msg) {
+    UNUSED(node);
+    UNUSED(header);
+    UNUSED(msg);
+}
+
+static uint32_t test_rand(void) {
+    test_seed = test_seed * 1103515245U + 12345U;
+    return test_seed >> 1;
+}
+
+/**
+ * @brief Add a node, remember it for the expected result.
+ *
+ * @return Return value of `can_list_add_new_node`.
+ */
+static uint8_t test_add(can_selected_t can, uint32_t ide, uint32_t id,
+                        uint32_t mask) {
+    uint8_t res = can_list_add_new_node(can, NULL, id, mask, ide,
+                                        test_callback);
+
+    if (res == 0) {
+        test_nodes[can][test_node_num[can]++] = (test_node_t){id, mask, ide};
+    }
+    return res;
+}
+
+/**
+ * @brief Add the DJI motor IDs `first ~ last`, exact IDs.
+ */
+static void test_add_range(can_selected_t can, uint32_t first, uint32_t last) {
+    for (uint32_t id = first; id <= last; ++id) {
+        CHECK(test_add(can, CAN_ID_STD, id, 0x7FF) == 0);
+    }
+}
+
+/**
+ * @brief Delete all nodes of a CAN.
+ */
+static void test_clear(can_selected_t can) {
+    for (uint32_t i = 0; i < test_node_num[can]; ++i) {
+        can_list_del_node_by_id(can, test_nodes[can][i].ide,
+                                test_nodes[can][i].id);
+    }
+    test_node_num[can] = 0;
+}
+
+/**
+ * @brief Whether a node of the CAN matches the frame.
+ */
+static bool test_expect(can_selected_t can, uint32_t ide, uint32_t id) {
+    for (uint32_t i = 0; i < test_node_num[can]; ++i) {
+        const test_node_t *node = &test_nodes[can][i];
+
+        if ((node->ide == ide) && (node->id == (id & node->mask))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Banks enabled for a CAN.
+ */
+static uint32_t test_banks(can_selected_t can) {
+    uint32_t first = (can == can1_selected) ? 0 : CAN_SLAVE_START_FILTER_BANK;
+    uint32_t last = (can == can1_selected) ? CAN_SLAVE_START_FILTER_BANK
+                                           : HOST_CAN_FILTER_NUM;
+    uint32_t num = 0;
+
+    for (uint32_t bank = first; bank < last; ++bank) {
+        num += (host_can_filter[bank].FilterActivation == CAN_FILTER_ENABLE);
+    }
+    return num;
+}
+
+/**
+ * @brief Check one frame against the nodes.
+ *
+ * @return The FIFO it goes to, -1: rejected.
+ */
+static int32_t test_frame(can_selected_t can, uint32_t ide, uint32_t id) {
+    int32_t fifo = host_can_filter_match(can_get_handle(can), ide,
+                                         CAN_RTR_DATA, id, NULL);
+
+    if ((fifo >= 0) != test_expect(can, ide, id)) {
+        printf("%s %s 0x%X: filter %s, nodes %s\n",
+               (can == can1_selected) ? "CAN1" : "CAN2",
+               (ide == CAN_ID_STD) ? "Std" : "Ext", id,
+               (fifo >= 0) ? "accepts" : "rejects",
+               test_expect(can, ide, id) ? "match" : "do not match");
+        ++test_fail;
+    }
+    return fifo;
+}
+
+/**
+ * @brief Every Std ID, and Ext IDs around the nodes and at random.
+ *
+ * @return Number of Std IDs accepted.
+ */
+static uint32_t test_all_frames(can_selected_t can) {
+    uint32_t accepted = 0;
+
+    for (uint32_t id = 0; id < 0x800; ++id) {
+        accepted += (test_frame(can, CAN_ID_STD, id) >= 0);
+        /* Same base ID as an Ext frame, told apart by IDE. */
+        test_frame(can, CAN_ID_EXT, id << 18);
+        test_frame(can, CAN_ID_EXT, id);
+    }
+
+    for (uint32_t i = 0; i < test_node_num[can]; ++i) {
+        const test_node_t *node = &test_nodes[can][i];
+
+        if (node->ide != CAN_ID_EXT) {
+            continue;
+        }
+        for (uint32_t j = 0; j < 256; ++j) {
+            /* Any value in the bits out of the mask, then single bit
+             * errors in the bits of the mask. */
+            test_frame(can, CAN_ID_EXT,
+                       node->id | (test_rand() & ~node->mask & TEST_EXT_ID));
+            test_frame(can, CAN_ID_EXT, node->id ^ (1U << (j % 29)));
+        }
+    }
+
+    for (uint32_t i = 0; i < 4096; ++i) {
+        test_frame(can, CAN_ID_EXT, test_rand() & TEST_EXT_ID);
+    }
+
+    return accepted;
+}
+
+/**
+ * @brief Four M3508 on CAN1: one bank of 4 Std IDs in list mode.
+ */
+static void test_dji_3508(void) {
+    test_add_range(can1_selected, 0x201, 0x204);
+
+    CHECK(can_list_update_filter(can1_selected) == 0);
+    CHECK(test_banks(can1_selected) == 1);
+    CHECK(host_can_filter[0].FilterMode == CAN_FILTERMODE_IDLIST);
+    CHECK(host_can_filter[0].FilterScale == CAN_FILTERSCALE_16BIT);
+    CHECK(test_all_frames(can1_selected) == 4);
+
+    test_clear(can1_selected);
+}
+
+/**
+ * @brief Eight motors on CAN1: two banks, 0x201 ~ 0x204 in FIFO0 and
+ *        0x205 ~ 0x208 in FIFO1.
+ */
+static void test_dji_8(void) {
+    test_add_range(can1_selected, 0x201, 0x208);
+
+    CHECK(test_banks(can1_selected) == 2);
+    CHECK(test_all_frames(can1_selected) == 8);
+    for (uint32_t id = 0x201; id <= 0x208; ++id) {
+        CHECK(host_can_filter_match(&can1_handle, CAN_ID_STD, CAN_RTR_DATA,
+                                    id, NULL) == ((id < 0x205) ? 0 : 1));
+    }
+
+    test_clear(can1_selected);
+}
+
+/**
+ * @brief Seven GM6020 on CAN2: banks after `CAN_SLAVE_START_FILTER_BANK`,
+ *        FIFO0 only, the CAN1 banks are not changed.
+ */
+static void test_dji_6020(void) {
+    CAN_FilterTypeDef can1_bank[CAN_SLAVE_START_FILTER_BANK];
+
+    test_add_range(can1_selected, 0x201, 0x204);
+    memcpy(can1_bank, host_can_filter, sizeof(can1_bank));
+
+    test_add_range(can2_selected, 0x205, 0x20B);
+
+    CHECK(test_banks(can2_selected) == 2);
+    CHECK(host_can_filter[CAN_SLAVE_START_FILTER_BANK].FilterActivation ==
+          CAN_FILTER_ENABLE);
+    CHECK(memcmp(can1_bank, host_can_filter, sizeof(can1_bank)) == 0);
+    CHECK(test_all_frames(can2_selected) == 7);
+    CHECK(test_all_frames(can1_selected) == 4);
+    for (uint32_t id = 0x205; id <= 0x20B; ++id) {
+        CHECK(host_can_filter_match(&can2_handle, CAN_ID_STD, CAN_RTR_DATA,
+                                    id, NULL) == 0);
+    }
+
+    test_clear(can2_selected);
+    CHECK(test_banks(can2_selected) == 0);
+    CHECK(test_all_frames(can2_selected) == 0);
+    test_clear(can1_selected);
+}
+
+/**
+ * @brief Motors with a logger range and an Ext device on CAN1: list and
+ *        mask banks of both scales.
+ */
+static void test_dji_mixed(void) {
+    test_add_range(can1_selected, 0x201, 0x204);
+    test_add_range(can1_selected, 0x205, 0x20B);
+    CHECK(test_add(can1_selected, CAN_ID_STD, 0x200, 0x7F0) == 0);
+    CHECK(test_add(can1_selected, CAN_ID_STD, 0x300, 0x700) == 0);
+    CHECK(test_add(can1_selected, CAN_ID_EXT, 0x1234567, TEST_EXT_ID) == 0);
+    CHECK(test_add(can1_selected, CAN_ID_EXT, 0x01, 0xFF) == 0);
+
+    /* 11 exact Std in 3 banks, 2 Std masks in 1, 1 exact Ext in 1, 1 Ext
+     * mask in 1. */
+    CHECK(can_list_update_filter(can1_selected) == 0);
+    CHECK(test_banks(can1_selected) == 6);
+    CHECK(test_all_frames(can1_selected) == 0x100 + 16);
+
+    test_clear(can1_selected);
+}
+
+/**
+ * @brief More nodes than the banks hold: one bank accepts all frames.
+ */
+static void test_fallback(void) {
+    for (uint32_t i = 0; i < 15; ++i) {
+        CHECK(test_add(can1_selected, CAN_ID_EXT, i << 8, 0xFF00) == 0);
+    }
+
+    CHECK(can_list_update_filter(can1_selected) == 4);
+    CHECK(test_banks(can1_selected) == 1);
+    CHECK(host_can_filter_match(&can1_handle, CAN_ID_STD, CAN_RTR_DATA, 0x123,
+                                NULL) == 0);
+    CHECK(host_can_filter_match(&can1_handle, CAN_ID_EXT, CAN_RTR_DATA,
+                                0x1ABCDEF, NULL) == 0);
+
+    /* Back to the exact filters once they fit again. */
+    CHECK(can_list_del_node_by_id(can1_selected, CAN_ID_EXT, 14U << 8) == 0);
+    --test_node_num[can1_selected];
+    CHECK(test_banks(can1_selected) == 14);
+    test_all_frames(can1_selected);
+
+    test_clear(can1_selected);
+}
+
+/**
+ * @brief Random sets of exact and masked IDs which fit in the banks.
+ */
+static void test_random(void) {
+    for (uint32_t round = 0; round < 200; ++round) {
+        uint32_t std_exact = test_rand() % 21;
+        uint32_t std_mask = test_rand() % 5;
+        uint32_t ext_exact = test_rand() % 6;
+        uint32_t ext_mask = test_rand() % 3;
+
+        for (uint32_t i = 0; i < std_exact; ++i) {
+            test_add(can1_selected, CAN_ID_STD, test_rand() & 0x7FF, 0x7FF);
+        }
+        for (uint32_t i = 0; i < std_mask; ++i) {
+            uint32_t mask = (0x7FFU << (test_rand() % 8)) & 0x7FF;
+            test_add(can1_selected, CAN_ID_STD, test_rand() & mask, mask);
+        }
+        for (uint32_t i = 0; i < ext_exact; ++i) {
+            test_add(can1_selected, CAN_ID_EXT, test_rand() & TEST_EXT_ID,
+                     TEST_EXT_ID);
+        }
+        for (uint32_t i = 0; i < ext_mask; ++i) {
+            uint32_t mask = test_rand() & TEST_EXT_ID;
+            test_add(can1_selected, CAN_ID_EXT, test_rand() & mask, mask);
+        }
+
+        CHECK(can_list_update_filter(can1_selected) == 0);
+        test_all_frames(can1_selected);
+        test_clear(can1_selected);
+    }
+}
+
+int main(void) {
+    host_periph_map();
+
+    CHECK(can1_init(1000, 0) == CAN_INIT_OK);
+    CHECK(can2_init(1000, 0) == CAN_INIT_OK);
+    CHECK(can_list_add_can(can1_selected, 4, 4) == 0);
+    CHECK(can_list_add_can(can2_selected, 4, 4) == 0);
+
+    /* `canx_init` accepts all frames until nodes are added. */
+    CHECK(can_list_update_filter(can1_selected) == 0);
+    CHECK(test_banks(can1_selected) == 0);
+
+    test_dji_3508();
+    test_dji_8();
+    test_dji_6020();
+    test_dji_mixed();
+    test_fallback();
+    test_random();
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
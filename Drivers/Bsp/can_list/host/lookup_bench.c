@@ -0,0 +1,270 @@
+/**
+ * @file    lookup_bench.c
+ * @brief   Receive lookup time of the dispatch index against the chained
+ *          hash used before, on the host.
+ *
+ * @note `can_list.c` is included so its static `can_list_dispatch` can be
+ *       timed directly. The chained hash is the code it replaced: nodes
+ *       pushed to the head of `table[id % len]`, found by walking `next`.
+ *       Both are called through a pointer for every frame of the same random
+ *       sequence of registered IDs, with 4, 16 and 64 nodes of Std and Ext
+ *       IDs. The hash is timed with 4 buckets (`rtos_tasks.c` creates the
+ *       tables so) and with one bucket per node.
+ *
+ *       Host times only compare the two, the Cortex-M4 has no cache and a
+ *       divide of 2 ~ 12 cycles, but walking the chain grows the same way.
+ */
+
+#include "../can_list.c"
+
+#include "hal_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES 4096U
+#define BENCH_ROUNDS 200U
+#define BENCH_TRIALS 10U
+
+/**
+ * @brief Node of the chained hash, as it was.
+ */
+typedef struct old_node {
+    void *can_data;
+    uint32_t id;
+    uint32_t id_mask;
+    can_callback_t callback;
+    struct old_node *next;
+} old_node_t;
+
+/**
+ * @brief The chained hash table, as it was.
+ */
+typedef struct {
+    old_node_t **table;
+    uint32_t len;
+} old_table_t;
+
+static old_node_t bench_old_nodes[64];
+static old_node_t *bench_old_buckets[64];
+static old_table_t bench_old_table = {bench_old_buckets, 4};
+
+static can_frame_t bench_frames[BENCH_FRAMES];
+static uint32_t bench_ids[64];
+static uint32_t bench_calls;
+static uint32_t bench_seed = 1;
+
+static void bench_callback(void *node, can_rx_header_t *header, uint8_t *msg) {
+    UNUSED(node);
+    UNUSED(header);
+    UNUSED(msg);
+    ++bench_calls;
+}
+
+static uint32_t bench_rand(void) {
+    bench_seed = bench_seed * 1103515245U + 12345U;
+    return bench_seed >> 1;
+}
+
+/**
+ * @brief Monotonic clock, unit: ns.
+ */
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Add a node to the chained hash, as it was.
+ */
+static void old_add(old_table_t *table, old_node_t *node, uint32_t id,
+                    uint32_t id_mask) {
+    old_node_t **table_head = &(table->table[id % table->len]);
+
+    node->can_data = NULL;
+    node->id = id;
+    node->id_mask = id_mask;
+    node->callback = bench_callback;
+    node->next = *table_head;
+    *table_head = node;
+}
+
+/**
+ * @brief The receive lookup of the chained hash, as it was.
+ */
+static void old_dispatch(uint8_t can_index, can_frame_t *frame) {
+    old_table_t *table = &bench_old_table;
+    uint32_t id = frame->header.id;
+
+    UNUSED(can_index);
+
+    old_node_t *node = table->table[id % table->len];
+
+    while ((node != NULL) && (node->id) != (id & node->id_mask)) {
+        node = node->next;
+    }
+
+    if (node == NULL || node->callback == NULL) {
+        return;
+    }
+
+    node->callback(node->can_data, &frame->header, frame->data);
+}
+
+/**
+ * @brief Build the chained hash of the registered IDs.
+ *
+ * @param len Number of buckets.
+ * @param num Number of IDs.
+ * @param mask Mask of the IDs.
+ */
+static void bench_old_build(uint32_t len, uint32_t num, uint32_t mask) {
+    memset(bench_old_buckets, 0, sizeof(bench_old_buckets));
+    bench_old_table.len = len;
+    for (uint32_t i = 0; i < num; ++i) {
+        old_add(&bench_old_table, &bench_old_nodes[i], bench_ids[i], mask);
+    }
+}
+
+typedef void (*bench_dispatch_t)(uint8_t, can_frame_t *);
+
+/**
+ * @brief Dispatch every frame `BENCH_ROUNDS` times, in `BENCH_TRIALS` runs.
+ *
+ * @return Time of a frame in the fastest run, unit: ns.
+ */
+static double bench_run(bench_dispatch_t dispatch) {
+    volatile bench_dispatch_t call = dispatch;
+    uint64_t best = UINT64_MAX;
+
+    bench_calls = 0;
+    for (uint32_t trial = 0; trial < BENCH_TRIALS; ++trial) {
+        uint64_t start = bench_now_ns();
+
+        for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+            /* The next frame depends on the callback of the last one, so
+               the lookups do not overlap, as on the in-order Cortex-M4. */
+            for (uint32_t i = 0; i < BENCH_FRAMES; ++i) {
+                call(0, &bench_frames[(i + bench_calls) % BENCH_FRAMES]);
+            }
+        }
+
+        start = bench_now_ns() - start;
+        best = (start < best) ? start : best;
+    }
+
+    return (double)best / (BENCH_FRAMES * BENCH_ROUNDS);
+}
+
+/**
+ * @brief Register `num` IDs in both, time them.
+ *
+ * @return 0: every frame found its node; 1: not.
+ */
+static int bench_case(uint32_t id_type, uint32_t num) {
+    const uint32_t mask = (id_type == CAN_ID_STD) ? 0x7FFU : EXT_ID_MASK;
+    double index_ns, hash4_ns, hashn_ns;
+    int res = 0;
+
+    /* Motor like IDs, then spread over the ID range. */
+    for (uint32_t i = 0; i < num; ++i) {
+        bench_ids[i] = (id_type == CAN_ID_STD) ? (0x201U + i * 0x1DU) & mask
+                                               : (0x10000U + i * 0x4F1BU);
+        can_list_add_new_node(can1_selected, NULL, bench_ids[i], mask,
+                              id_type, bench_callback);
+    }
+
+    for (uint32_t i = 0; i < BENCH_FRAMES; ++i) {
+        bench_frames[i].header.id = bench_ids[bench_rand() % num];
+        bench_frames[i].header.id_type = id_type;
+        bench_frames[i].header.frame_type = CAN_RTR_DATA;
+        bench_frames[i].header.data_length = 8;
+    }
+
+    index_ns = bench_run(can_list_dispatch);
+    res |= (bench_calls != BENCH_FRAMES * BENCH_ROUNDS * BENCH_TRIALS);
+
+    bench_old_build(4, num, mask);
+    hash4_ns = bench_run(old_dispatch);
+    res |= (bench_calls != BENCH_FRAMES * BENCH_ROUNDS * BENCH_TRIALS);
+
+    bench_old_build(num, num, mask);
+    hashn_ns = bench_run(old_dispatch);
+    res |= (bench_calls != BENCH_FRAMES * BENCH_ROUNDS * BENCH_TRIALS);
+
+    printf("%-4s %5u %12.2f %12.2f %12.2f\n",
+           (id_type == CAN_ID_STD) ? "Std" : "Ext", (unsigned)num, index_ns,
+           hash4_ns, hashn_ns);
+
+    for (uint32_t i = 0; i < num; ++i) {
+        can_list_del_node_by_id(can1_selected, id_type, bench_ids[i]);
+    }
+
+    return res;
+}
+
+/**
+ * @brief A `0x200`/`0x7F0` range node: the chained hash puts it in the
+ *        bucket of `0x200`, frames of the other IDs of the range look in
+ *        their own buckets and miss it.
+ *
+ * @return 0: the index finds all 16 IDs; 1: not.
+ */
+static int bench_mask(void) {
+    uint32_t index_found, hash_found;
+    can_frame_t frame = {{0, CAN_ID_STD, CAN_RTR_DATA, 8}};
+
+    can_list_add_new_node(can1_selected, NULL, 0x200, 0x7F0, CAN_ID_STD,
+                          bench_callback);
+    bench_ids[0] = 0x200;
+    bench_old_build(4, 1, 0x7F0);
+
+    bench_calls = 0;
+    for (frame.header.id = 0x200; frame.header.id < 0x210; ++frame.header.id) {
+        can_list_dispatch(0, &frame);
+    }
+    index_found = bench_calls;
+
+    bench_calls = 0;
+    for (frame.header.id = 0x200; frame.header.id < 0x210; ++frame.header.id) {
+        old_dispatch(0, &frame);
+    }
+    hash_found = bench_calls;
+
+    printf("\n0x200/0x7F0, frames 0x200 ~ 0x20F: index calls %u, hash calls "
+           "%u\n",
+           (unsigned)index_found, (unsigned)hash_found);
+
+    can_list_del_node_by_id(can1_selected, CAN_ID_STD, 0x200);
+    return (index_found != 16);
+}
+
+int main(void) {
+    static const uint32_t node_num[] = {4, 16, 64};
+    int res = 0;
+
+    host_periph_map();
+    if ((can1_init(1000, 0) != CAN_INIT_OK) ||
+        (can_list_add_can(can1_selected, 4, 4) != 0)) {
+        printf("init failed\n");
+        return 1;
+    }
+
+    printf("ns per frame\n");
+    printf("%-4s %5s %12s %12s %12s\n", "ID", "nodes", "index", "hash 4",
+           "hash n");
+    for (uint32_t type = 0; type < 2; ++type) {
+        for (uint32_t i = 0; i < sizeof(node_num) / sizeof(node_num[0]);
+             ++i) {
+            res |= bench_case((type == 0) ? CAN_ID_STD : CAN_ID_EXT,
+                              node_num[i]);
+        }
+    }
+
+    res |= bench_mask();
+
+    return res;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file    rtos_stubs.c
+ * @brief   FreeRTOS stand-in of the CAN list host tests.
+ *
+ * @note There is no scheduler. `xTaskCreate` records the CAN list task and
+ *       `host_task_run` runs one pass of its loop: the pass returns from
+ *       `ulTaskNotifyTake`, the next call jumps back to the test.
+ */
+
+#include <CSP_Config.h>
+
+#include "FreeRTOS.h"
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+uint32_t host_task_notify;
+uint32_t host_task_gives;
+uint32_t host_task_runs;
+TickType_t host_task_wait;
+
+static TaskFunction_t host_task_code;
+static void *host_task_params;
+static uint32_t host_task_handle;
+static uint32_t host_critical_nesting;
+static bool host_task_in_pass;
+static jmp_buf host_task_exit;
+
+void vPortEnterCritical(void) {
+    __disable_irq();
+    ++host_critical_nesting;
+}
+
+void vPortExitCritical(void) {
+    if (--host_critical_nesting == 0) {
+        __enable_irq();
+    }
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name,
+                       uint16_t stack_depth, void *params,
+                       UBaseType_t priority, TaskHandle_t *handle) {
+    UNUSED(name);
+    UNUSED(stack_depth);
+    UNUSED(priority);
+
+    host_task_code = code;
+    host_task_params = params;
+    if (handle != NULL) {
+        *handle = &host_task_handle;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskGetSchedulerState(void) {
+    return taskSCHEDULER_NOT_STARTED;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return host_task_in_pass ? &host_task_handle : NULL;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    UNUSED(ticks);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken) {
+    UNUSED(task);
+    ++host_task_notify;
+    ++host_task_gives;
+    *woken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait) {
+    uint32_t notify = host_task_notify;
+
+    /* The pass is done, the task would block here. */
+    if (host_task_in_pass) {
+        longjmp(host_task_exit, 1);
+    }
+
+    host_task_in_pass = true;
+    host_task_wait = wait;
+    if (clear) {
+        host_task_notify = 0;
+    } else if (notify != 0) {
+        --host_task_notify;
+    }
+    ++host_task_runs;
+    return notify;
+}
+
+/**
+ * @brief Run one pass of the task loop, as if it was woken now.
+ *
+ * @return Notifications taken by the pass.
+ */
+uint32_t host_task_run(void) {
+    uint32_t notify = host_task_notify;
+
+    if (host_task_code == NULL) {
+        return 0;
+    }
+
+    host_task_in_pass = false;
+    if (setjmp(host_task_exit) == 0) {
+        host_task_code(host_task_params);
+    }
+    host_task_in_pass = false;
+
+    return notify;
+}
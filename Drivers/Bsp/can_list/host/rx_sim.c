@@ -0,0 +1,293 @@
+/**
+ * @file    rx_sim.c
+ * @brief   Receive path of the CAN list against a simulated bxCAN FIFO, on
+ *          the host.
+ *
+ * @note DJI motors on CAN1 answer every 1 ms control frame with a burst of
+ *       feedback frames, 130 us apart at 1 Mbps. The bxCAN model puts them
+ *       in the 3 deep FIFO0, the CSP vector drains it into the ring when the
+ *       ISR runs, and the task runs once after the burst. The DWT cycle
+ *       counter and `HAL_GetTick` follow the simulated time, so the
+ *       statistics of the CAN list are checked as well. Cases:
+ *
+ *       - the ISR runs at once: every frame arrives in order, one task
+ *         pass per burst;
+ *       - the ISR is held off past the burst: 3 frames are drained in one
+ *         ISR, the 4th frame overruns the hardware FIFO;
+ *       - the task is starved: the ring keeps 16 frames, the rest are
+ *         dropped in the ISR and counted.
+ */
+
+#include "can_list/can_list.h"
+#include "hal_stubs.h"
+#include "FreeRTOS.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if !CAN_LIST_ENABLE_STATISTICS
+#error "Build with -DCAN_LIST_ENABLE_STATISTICS=1 "
+#endif /* !CAN_LIST_ENABLE_STATISTICS */
+
+/* Vector of CAN1 FIFO0, defined by the CSP. */
+void CAN1_RX0_IRQHandler(void);
+
+#define SIM_MOTOR_NUM   4U
+#define SIM_FRAME_US    130U
+#define SIM_TASK_US     50U
+#define SIM_CYCLE_PER_US (168000000U / 1000000U)
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief A motor, what it sent and what the callback got.
+ */
+typedef struct {
+    uint16_t sent;      /*!< Sequence number of the next frame.       */
+    uint16_t next;      /*!< Sequence number expected by the callback. */
+    uint32_t received;  /*!< Frames the callback got.                  */
+    uint32_t out_order; /*!< Frames not in the sequence expected.      */
+} sim_motor_t;
+
+static sim_motor_t sim_motors[SIM_MOTOR_NUM];
+static uint32_t sim_isr_count;
+
+/**
+ * @brief Set the simulated time: DWT cycle counter and SysTick.
+ *
+ * @param us Time, unit: us.
+ */
+static void sim_at(uint64_t us) {
+    host_dwt.CYCCNT = (uint32_t)(us * SIM_CYCLE_PER_US);
+    host_tick = (uint32_t)(us / 1000U);
+}
+
+static void sim_callback(void *node, can_rx_header_t *header, uint8_t *msg) {
+    sim_motor_t *motor = (sim_motor_t *)node;
+    uint16_t seq = (uint16_t)(msg[0] | (msg[1] << 8));
+
+    UNUSED(header);
+
+    motor->out_order += (seq != motor->next);
+    motor->next = (uint16_t)(seq + 1U);
+    ++motor->received;
+}
+
+/**
+ * @brief A feedback frame of a motor arrives at CAN1.
+ *
+ * @return Return value of `host_can_rx`.
+ */
+static int32_t sim_frame(uint32_t motor) {
+    uint8_t data[8] = {0};
+
+    data[0] = (uint8_t)sim_motors[motor].sent;
+    data[1] = (uint8_t)(sim_motors[motor].sent >> 8);
+    ++sim_motors[motor].sent;
+
+    return host_can_rx(&can1_handle, CAN_ID_STD, 0x201U + motor, 8, data);
+}
+
+static void sim_isr(void) {
+    ++sim_isr_count;
+    CAN1_RX0_IRQHandler();
+}
+
+/**
+ * @brief Simulate some 1 ms control cycles.
+ *
+ * @param first First cycle, the time starts at `first` ms.
+ * @param num Number of cycles.
+ * @param motors Number of motors answering.
+ * @param isr_delay 0: the ISR runs at each frame, others: it runs once,
+ *        `isr_delay` us after the cycle starts.
+ * @param task_runs Whether the task runs after the burst.
+ */
+static void sim_cycles(uint32_t first, uint32_t num, uint32_t motors,
+                       uint32_t isr_delay, bool task_runs) {
+    for (uint32_t cycle = first; cycle < first + num; ++cycle) {
+        uint64_t start = (uint64_t)cycle * 1000U;
+        uint64_t end = start + (motors - 1U) * SIM_FRAME_US;
+
+        for (uint32_t i = 0; i < motors; ++i) {
+            sim_at(start + i * SIM_FRAME_US);
+            sim_frame(i);
+            if (isr_delay == 0) {
+                sim_isr();
+            }
+        }
+
+        if (isr_delay != 0) {
+            sim_at(start + isr_delay);
+            sim_isr();
+            end = start + isr_delay;
+        }
+
+        if (task_runs) {
+            sim_at(end + SIM_TASK_US);
+            host_task_run();
+        }
+    }
+}
+
+/**
+ * @brief Clear the counters of the last case.
+ */
+static void sim_reset(void) {
+    host_can_t *can = host_can(&can1_handle);
+
+    for (uint32_t i = 0; i < SIM_MOTOR_NUM; ++i) {
+        sim_motors[i].received = 0;
+        sim_motors[i].out_order = 0;
+        sim_motors[i].next = sim_motors[i].sent;
+    }
+    memset(can->overrun, 0, sizeof(can->overrun));
+    memset(can->max_level, 0, sizeof(can->max_level));
+    memset(&can_list_stat[can1_selected], 0, sizeof(can_list_stat_t));
+    sim_isr_count = 0;
+    host_task_gives = 0;
+    host_task_runs = 0;
+}
+
+static void sim_print(const char *name) {
+    const can_list_stat_t *stat = &can_list_stat[can1_selected];
+
+    printf("%-10s %6u %6u %6u %6u %8u %6u %6u %10u\n", name,
+           (unsigned)sim_isr_count, (unsigned)host_task_gives,
+           (unsigned)host_task_runs, (unsigned)stat->rx_count,
+           (unsigned)host_can(&can1_handle)->overrun[0],
+           (unsigned)stat->rx_drop, (unsigned)stat->max_burst,
+           (unsigned)stat->max_latency);
+}
+
+/**
+ * @brief One second of four motors, the ISR runs at each frame.
+ */
+static void sim_prompt(void) {
+    const can_list_stat_t *stat = &can_list_stat[can1_selected];
+
+    sim_reset();
+    sim_cycles(1, 1000, SIM_MOTOR_NUM, 0, true);
+    sim_print("prompt");
+
+    for (uint32_t i = 0; i < SIM_MOTOR_NUM; ++i) {
+        CHECK(sim_motors[i].received == 1000);
+        CHECK(sim_motors[i].out_order == 0);
+    }
+    CHECK(host_can(&can1_handle)->overrun[0] == 0);
+    CHECK(host_can(&can1_handle)->max_level[0] == 1);
+    CHECK(sim_isr_count == 4000);
+    CHECK(host_task_gives == 4000);
+    CHECK(host_task_runs == 1000);
+
+    CHECK(stat->rx_count == 4000);
+    CHECK(stat->rx_drop == 0);
+    CHECK(stat->rx_rate == 4000);
+    CHECK(stat->max_burst == 4);
+    /* The last frame of a burst waits for the task, the first waits for the
+       whole burst. */
+    CHECK(stat->latency == SIM_TASK_US);
+    CHECK(stat->max_latency == 3 * SIM_FRAME_US + SIM_TASK_US);
+}
+
+/**
+ * @brief The ISR is held off past the burst: 3 frames fit in the FIFO and
+ *        are drained by one ISR, a 4th frame overruns it.
+ */
+static void sim_held_off(void) {
+    sim_reset();
+    sim_cycles(1001, 100, 3, 3 * SIM_FRAME_US, true);
+    sim_print("held off 3");
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        CHECK(sim_motors[i].received == 100);
+        CHECK(sim_motors[i].out_order == 0);
+    }
+    CHECK(host_can(&can1_handle)->overrun[0] == 0);
+    CHECK(host_can(&can1_handle)->max_level[0] == 3);
+    CHECK(sim_isr_count == 100);
+    CHECK(host_task_gives == 100);
+    CHECK(can_list_stat[can1_selected].max_burst == 3);
+
+    /* The FIFO is not locked, the 4th frame overwrites the 3rd. */
+    sim_reset();
+    sim_cycles(1101, 100, SIM_MOTOR_NUM, 4 * SIM_FRAME_US, true);
+    sim_print("held off 4");
+
+    CHECK(host_can(&can1_handle)->overrun[0] == 100);
+    CHECK(sim_motors[0].received == 100);
+    CHECK(sim_motors[1].received == 100);
+    CHECK(sim_motors[2].received == 0);
+    CHECK(sim_motors[3].received == 100);
+    CHECK(can_list_stat[can1_selected].rx_drop == 0);
+}
+
+/**
+ * @brief The task does not run for 10 cycles: the ring keeps the first 16
+ *        frames, the ISR drops the others. Then the task catches up.
+ */
+static void sim_starved(void) {
+    const can_list_stat_t *stat = &can_list_stat[can1_selected];
+
+    sim_reset();
+    sim_cycles(1201, 10, SIM_MOTOR_NUM, 0, false);
+    sim_at(1211U * 1000U);
+    host_task_run();
+    sim_print("starved");
+
+    CHECK(host_can(&can1_handle)->overrun[0] == 0);
+    CHECK(stat->rx_count == CAN_LIST_RX_RING_LEN);
+    CHECK(stat->rx_drop == 10 * SIM_MOTOR_NUM - CAN_LIST_RX_RING_LEN);
+    CHECK(stat->max_burst == CAN_LIST_RX_RING_LEN);
+    /* The ISR only wakes the task when it wrote a frame into the ring. */
+    CHECK(host_task_gives == CAN_LIST_RX_RING_LEN);
+    CHECK(host_task_runs == 1);
+    CHECK(stat->max_latency == 10 * 1000);
+    for (uint32_t i = 0; i < SIM_MOTOR_NUM; ++i) {
+        CHECK(sim_motors[i].received == CAN_LIST_RX_RING_LEN / SIM_MOTOR_NUM);
+    }
+
+    /* Back to normal, nothing left over. */
+    sim_reset();
+    sim_cycles(1211, 10, SIM_MOTOR_NUM, 0, true);
+    CHECK(stat->rx_count == 10 * SIM_MOTOR_NUM);
+    CHECK(stat->rx_drop == 0);
+}
+
+int main(void) {
+    host_periph_map();
+    sim_at(0);
+
+    CHECK(can1_init(1000, 0) == CAN_INIT_OK);
+    CHECK(can_list_add_can(can1_selected, 4, 4) == 0);
+    CHECK((host_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0);
+    for (uint32_t i = 0; i < SIM_MOTOR_NUM; ++i) {
+        CHECK(can_list_add_new_node(can1_selected, &sim_motors[i],
+                                    0x201U + i, 0x7FF, CAN_ID_STD,
+                                    sim_callback) == 0);
+    }
+
+    printf("%-10s %6s %6s %6s %6s %8s %6s %6s %10s\n", "case", "ISR",
+           "gives", "passes", "frames", "overrun", "drop", "burst",
+           "max lat us");
+    sim_prompt();
+    sim_held_off();
+    sim_starved();
+
+    CHECK(host_primask == 0);
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
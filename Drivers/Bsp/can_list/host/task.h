@@ -0,0 +1 @@
+/* Host test stand-in, everything is in FreeRTOS.h. */
@@ -11,6 +11,10 @@
 #include "CAN_STM32F4xx.h"
 
 #include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+static void can_tx_queue_clear(CAN_HandleTypeDef *hcan);
 
 
 /*****************************************************************************
@@ -75,7 +79,7 @@ uint8_t can1_init(uint32_t baud_rate, uint32_t prop_delay) {
     can_filter_config.FilterMaskIdHigh = 0x0000;
     can_filter_config.FilterMaskIdLow = 0x0000;
     can_filter_config.FilterActivation = CAN_FILTER_ENABLE;
-    can_filter_config.SlaveStartFilterBank = 0;
+    can_filter_config.SlaveStartFilterBank = CAN_SLAVE_START_FILTER_BANK;
 
 #if CAN1_RX0_IT_ENABLE
     can_filter_config.FilterFIFOAssignment = CAN_FILTER_FIFO0;
@@ -99,6 +103,18 @@ uint8_t can1_init(uint32_t baud_rate, uint32_t prop_delay) {
     }
 #endif /* CAN1_RX1_IT_ENABLE */
 
+#if CAN1_TX_IT_ENABLE
+    /* Refill the tx mailboxes from the tx queue. */
+    if (HAL_CAN_ActivateNotification(&can1_handle,
+                                     CAN_IT_TX_MAILBOX_EMPTY) != HAL_OK) {
+        return CAN_INIT_NOTIFY_FAIL;
+    }
+#endif /* CAN1_TX_IT_ENABLE */
+
+    /* The DWT cycle counter time stamps the tx queue for its statistics. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     if (HAL_CAN_Start(&can1_handle) != HAL_OK) {
         return CAN_INIT_START_FAIL;
     }
@@ -240,7 +256,7 @@ uint8_t can2_init(uint32_t baud_rate, uint32_t prop_delay) {
 
     CAN_FilterTypeDef can_filter_config;
 
-    can_filter_config.FilterBank = 0;
+    can_filter_config.FilterBank = CAN_SLAVE_START_FILTER_BANK;
     can_filter_config.FilterMode = CAN_FILTERMODE_IDMASK;
     can_filter_config.FilterScale = CAN_FILTERSCALE_32BIT;
     can_filter_config.FilterIdHigh = 0x0000;
@@ -248,7 +264,7 @@ uint8_t can2_init(uint32_t baud_rate, uint32_t prop_delay) {
     can_filter_config.FilterMaskIdHigh = 0x0000;
     can_filter_config.FilterMaskIdLow = 0x0000;
     can_filter_config.FilterActivation = CAN_FILTER_ENABLE;
-    can_filter_config.SlaveStartFilterBank = 0;
+    can_filter_config.SlaveStartFilterBank = CAN_SLAVE_START_FILTER_BANK;
 
 #if CAN2_RX0_IT_ENABLE
     can_filter_config.FilterFIFOAssignment = CAN_FILTER_FIFO0;
@@ -272,6 +288,18 @@ uint8_t can2_init(uint32_t baud_rate, uint32_t prop_delay) {
     }
 #endif /* CAN2_RX1_IT_ENABLE */
 
+#if CAN2_TX_IT_ENABLE
+    /* Refill the tx mailboxes from the tx queue. */
+    if (HAL_CAN_ActivateNotification(&can2_handle,
+                                     CAN_IT_TX_MAILBOX_EMPTY) != HAL_OK) {
+        return CAN_INIT_NOTIFY_FAIL;
+    }
+#endif /* CAN2_TX_IT_ENABLE */
+
+    /* The DWT cycle counter time stamps the tx queue for its statistics. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     if (HAL_CAN_Start(&can2_handle) != HAL_OK) {
         return CAN_INIT_START_FAIL;
     }
@@ -445,6 +473,18 @@ uint8_t can3_init(uint32_t baud_rate, uint32_t prop_delay) {
     }
 #endif /* CAN3_RX1_IT_ENABLE */
 
+#if CAN3_TX_IT_ENABLE
+    /* Refill the tx mailboxes from the tx queue. */
+    if (HAL_CAN_ActivateNotification(&can3_handle,
+                                     CAN_IT_TX_MAILBOX_EMPTY) != HAL_OK) {
+        return CAN_INIT_NOTIFY_FAIL;
+    }
+#endif /* CAN3_TX_IT_ENABLE */
+
+    /* The DWT cycle counter time stamps the tx queue for its statistics. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     if (HAL_CAN_Start(&can3_handle) != HAL_OK) {
         return CAN_INIT_START_FAIL;
     }
@@ -668,6 +708,8 @@ void HAL_CAN_MspInit(CAN_HandleTypeDef *hcan) {
  * @param hcan The handle of CAN
  */
 void HAL_CAN_MspDeInit(CAN_HandleTypeDef *hcan) {
+    /* Not sent after the next init, the data would be stale. */
+    can_tx_queue_clear(hcan);
 
 #if CAN1_ENABLE
     if (hcan->Instance == CAN1) {
@@ -874,28 +916,140 @@ CAN_HandleTypeDef *can_get_handle(can_selected_t can_selected) {
 }
 
 /**
- * @brief CAN send message.
+ * @brief Message waiting in the tx queue.
+ */
+typedef struct {
+    CAN_TxHeaderTypeDef header; /*!< Tx header.                      */
+    uint32_t priority;          /*!< Lower value is sent first.      */
+    uint32_t timestamp;         /*!< DWT cycle count when queued.    */
+    uint8_t data[8];            /*!< Message data.                   */
+} can_tx_msg_t;
+
+/**
+ * @brief Tx queue, sorted by priority, the next message is at the end.
+ */
+typedef struct {
+    can_tx_msg_t msg[CAN_TX_QUEUE_LEN]; /*!< Messages.               */
+    uint32_t count;                     /*!< Messages in the queue.  */
+    can_tx_stat_t stat;                 /*!< Statistics.             */
+} can_tx_queue_t;
+
+#if CAN1_ENABLE
+static can_tx_queue_t can1_tx_queue;
+#endif /* CAN1_ENABLE */
+
+#if CAN2_ENABLE
+static can_tx_queue_t can2_tx_queue;
+#endif /* CAN2_ENABLE */
+
+#if CAN3_ENABLE
+static can_tx_queue_t can3_tx_queue;
+#endif /* CAN3_ENABLE */
+
+/**
+ * @brief Get the tx queue of the CAN handle.
+ *
+ * @param hcan The handle of CAN.
+ * @return The tx queue. return NULL which the CAN doesn't exist.
+ */
+static can_tx_queue_t *can_get_tx_queue(CAN_HandleTypeDef *hcan) {
+#if CAN1_ENABLE
+    if (hcan == &can1_handle) {
+        return &can1_tx_queue;
+    }
+#endif /* CAN1_ENABLE */
+
+#if CAN2_ENABLE
+    if (hcan == &can2_handle) {
+        return &can2_tx_queue;
+    }
+#endif /* CAN2_ENABLE */
+
+#if CAN3_ENABLE
+    if (hcan == &can3_handle) {
+        return &can3_tx_queue;
+    }
+#endif /* CAN3_ENABLE */
+
+    return NULL;
+}
+
+/**
+ * @brief Drop the queued messages of a CAN, counted as dropped.
+ *
+ * @param hcan The handle of CAN.
+ */
+static void can_tx_queue_clear(CAN_HandleTypeDef *hcan) {
+    can_tx_queue_t *queue = can_get_tx_queue(hcan);
+    if (queue == NULL) {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    queue->stat.drop += queue->count;
+    queue->count = 0;
+    queue->stat.depth = 0;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Move queued messages into the free tx mailboxes, the highest
+ *        priority first. Call with interrupts disabled.
+ *
+ * @param hcan The handle of CAN.
+ * @param queue The tx queue of this CAN.
+ */
+static void can_tx_queue_flush(CAN_HandleTypeDef *hcan,
+                               can_tx_queue_t *queue) {
+    uint32_t tx_mail_box;
+    can_tx_msg_t *msg;
+
+    while ((queue->count != 0) &&
+           (HAL_CAN_GetTxMailboxesFreeLevel(hcan) != 0)) {
+        msg = &queue->msg[queue->count - 1];
+        if (HAL_CAN_AddTxMessage(hcan, &msg->header, msg->data,
+                                 &tx_mail_box) != HAL_OK) {
+            break;
+        }
+
+        --queue->count;
+        queue->stat.depth = queue->count;
+        queue->stat.latency =
+            (DWT->CYCCNT - msg->timestamp) / (SystemCoreClock / 1000000U);
+        if (queue->stat.latency > queue->stat.max_latency) {
+            queue->stat.max_latency = queue->stat.latency;
+        }
+    }
+}
+
+/**
+ * @brief Put a message into the tx queue and send as much as possible.
  *
  * @param can_selected Specific which CAN to send message.
  * @param can_ide Specific standard ID or Extend ID.
+ * @param rtr Specific data or remote frame.
  * @param id Specific message id.
  * @param len Specific message length.
  * @param msg Specific message content.
+ * @param latest Replace the data of a queued data frame of the same ID
+ *               instead of queueing another one.
  * @return Send status.
- *  @retval - 0: Success.
- *  @retval - 1: Send error.
- *  @retval - 2: Timeout.
+ *  @retval - 0: Success, sent, queued or replaced the queued one.
+ *  @retval - 2: Tx queue is full.
  *  @retval - 3: Parameter invalid.
  *  @retval - 4: This CAN is not initialized.
  */
-uint8_t can_send_message(can_selected_t can_selected, uint32_t can_ide,
-                         uint32_t id, uint8_t len, const uint8_t *msg) {
+static uint8_t can_send(can_selected_t can_selected, uint32_t can_ide,
+                        uint32_t rtr, uint32_t id, uint8_t len,
+                        const uint8_t *msg, bool latest) {
     CAN_HandleTypeDef *can_handle = can_get_handle(can_selected);
     if (can_handle == NULL) {
         return 3;
     }
 
-    if (len > 8) {
+    /* A remote frame has a length but no data. */
+    if ((len > 8) || ((msg == NULL) && (len != 0) && (rtr == CAN_RTR_DATA))) {
         return 3;
     }
 
@@ -903,32 +1057,119 @@ uint8_t can_send_message(can_selected_t can_selected, uint32_t can_ide,
         return 4;
     }
 
-    uint16_t wait_time = 0;
-    uint32_t tx_mail_box = CAN_TX_MAILBOX0;
+    can_tx_queue_t *queue = can_get_tx_queue(can_handle);
+    can_tx_msg_t new_msg = {0};
+    uint32_t pos;
+    uint8_t res = 0;
 
-    CAN_TxHeaderTypeDef tx_header = {0};
-    tx_header.IDE = can_ide;
-    tx_header.RTR = CAN_RTR_DATA;
-    tx_header.DLC = len;
+    new_msg.header.IDE = can_ide;
+    new_msg.header.RTR = rtr;
+    new_msg.header.DLC = len;
+    /* Same order as the bus arbitration, base ID first, then Std before
+     * Ext. */
     if (can_ide == CAN_ID_STD) {
-        tx_header.StdId = id;
+        new_msg.header.StdId = id;
+        new_msg.priority = id << 19;
     } else {
-        tx_header.ExtId = id;
+        new_msg.header.ExtId = id;
+        new_msg.priority = (id << 1) | 1U;
     }
+    if ((msg != NULL) && (rtr == CAN_RTR_DATA)) {
+        memcpy(new_msg.data, msg, len);
+    }
+
+    new_msg.timestamp = DWT->CYCCNT;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
 
-    while (HAL_CAN_GetTxMailboxesFreeLevel(can_handle) == 0) {
-        /* Wait to all mailbox is empty. */
-        ++wait_time;
-        if (wait_time > CAN_SEND_TIMEOUT) {
-            return 2;
+    /* Messages of the same ID are sent in order, unless the caller asks for
+     * the latest one only, e.g. a motor setpoint. */
+    pos = queue->count;
+    if (latest && (rtr == CAN_RTR_DATA)) {
+        for (pos = 0; pos < queue->count; ++pos) {
+            if ((queue->msg[pos].priority == new_msg.priority) &&
+                (queue->msg[pos].header.RTR == CAN_RTR_DATA)) {
+                break;
+            }
         }
     }
 
-    if (HAL_CAN_AddTxMessage(can_handle, &tx_header, msg, &tx_mail_box) !=
-        HAL_OK) {
-        return 1;
+    if (pos < queue->count) {
+        queue->msg[pos].header.DLC = new_msg.header.DLC;
+        memcpy(queue->msg[pos].data, new_msg.data, sizeof(new_msg.data));
+        ++queue->stat.replace;
+    } else if (queue->count >= CAN_TX_QUEUE_LEN) {
+        ++queue->stat.drop;
+        res = 2;
+    } else {
+        /* Insert before the messages of lower priority. */
+        pos = queue->count;
+        while ((pos > 0) &&
+               (queue->msg[pos - 1].priority <= new_msg.priority)) {
+            queue->msg[pos] = queue->msg[pos - 1];
+            --pos;
+        }
+        queue->msg[pos] = new_msg;
+        ++queue->count;
+
+        queue->stat.depth = queue->count;
+        if (queue->count > queue->stat.max_depth) {
+            queue->stat.max_depth = queue->count;
+        }
     }
-    return 0;
+
+    can_tx_queue_flush(can_handle, queue);
+
+    __set_PRIMASK(primask);
+
+    return res;
+}
+
+/**
+ * @brief CAN send message.
+ *
+ * @param can_selected Specific which CAN to send message.
+ * @param can_ide Specific standard ID or Extend ID.
+ * @param id Specific message id.
+ * @param len Specific message length.
+ * @param msg Specific message content.
+ * @return Send status.
+ *  @retval - 0: Success, sent, queued or replaced the queued one.
+ *  @retval - 2: Tx queue is full.
+ *  @retval - 3: Parameter invalid.
+ *  @retval - 4: This CAN is not initialized.
+ * @note Return immediately, the message is sent from the tx mailbox empty
+ *       interrupt if all mailboxes are busy. Enable the TX interrupt of this
+ *       CAN, otherwise queued messages are only sent on the next call.
+ *       Messages of the same ID are sent in the order of calling.
+ */
+uint8_t can_send_message(can_selected_t can_selected, uint32_t can_ide,
+                         uint32_t id, uint8_t len, const uint8_t *msg) {
+    return can_send(can_selected, can_ide, CAN_RTR_DATA, id, len, msg, false);
+}
+
+/**
+ * @brief CAN send message, only the latest data of this ID is sent.
+ *
+ * @param can_selected Specific which CAN to send message.
+ * @param can_ide Specific standard ID or Extend ID.
+ * @param id Specific message id.
+ * @param len Specific message length.
+ * @param msg Specific message content.
+ * @return Send status.
+ *  @retval - 0: Success, sent, queued or replaced the queued one.
+ *  @retval - 2: Tx queue is full.
+ *  @retval - 3: Parameter invalid.
+ *  @retval - 4: This CAN is not initialized.
+ * @note For setpoints sent periodically, e.g. the DJI motor group frames. If
+ *       a data frame of the same ID is still queued, its data is replaced
+ *       and the older data is never sent. Same as `can_send_message`
+ *       otherwise.
+ */
+uint8_t can_send_message_latest(can_selected_t can_selected, uint32_t can_ide,
+                                uint32_t id, uint8_t len, const uint8_t *msg) {
+    return can_send(can_selected, can_ide, CAN_RTR_DATA, id, len, msg, true);
 }
 
 /**
@@ -940,57 +1181,76 @@ uint8_t can_send_message(can_selected_t can_selected, uint32_t can_ide,
  * @param len Specific message length.
  * @param msg Specific message content.
  * @return Send status.
- *  @retval - 0: Success.
- *  @retval - 1: Send error.
- *  @retval - 2: Timeout.
+ *  @retval - 0: Success, sent or queued.
+ *  @retval - 2: Tx queue is full.
  *  @retval - 3: Parameter invalid.
  *  @retval - 4: This CAN is not initialized.
  */
 uint8_t can_send_remote(can_selected_t can_selected, uint32_t can_ide,
                         uint32_t id, uint8_t len, const uint8_t *msg) {
-    CAN_HandleTypeDef *can_handle = can_get_handle(can_selected);
-    if (can_handle == NULL) {
-        return 3;
-    }
+    return can_send(can_selected, can_ide, CAN_RTR_REMOTE, id, len, msg,
+                    false);
+}
 
-    if (len > 8) {
-        return 3;
+/**
+ * @brief Get the tx queue statistics.
+ *
+ * @param can_selected Specific which CAN.
+ * @param[out] stat The statistics.
+ * @return Operational status.
+ *  @retval - 0: Success.
+ *  @retval - 1: Parameter invalid.
+ */
+uint8_t can_get_tx_stat(can_selected_t can_selected, can_tx_stat_t *stat) {
+    CAN_HandleTypeDef *can_handle = can_get_handle(can_selected);
+    if ((can_handle == NULL) || (stat == NULL)) {
+        return 1;
     }
 
-    if (HAL_CAN_GetState(can_handle) == HAL_CAN_STATE_RESET) {
-        return 4;
-    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stat = can_get_tx_queue(can_handle)->stat;
+    __set_PRIMASK(primask);
 
-    uint16_t wait_time = 0;
-    uint32_t tx_mail_box = CAN_TX_MAILBOX0;
+    return 0;
+}
 
-    CAN_TxHeaderTypeDef tx_header = {0};
-    tx_header.IDE = can_ide;
-    tx_header.RTR = CAN_RTR_REMOTE;
-    tx_header.DLC = len;
-    if (can_ide == CAN_ID_STD) {
-        tx_header.StdId = id;
-    } else {
-        tx_header.ExtId = id;
+/**
+ * @brief Tx mailbox 0 complete callback, send the next queued message.
+ *
+ * @param hcan The handle of CAN.
+ */
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan) {
+    can_tx_queue_t *queue = can_get_tx_queue(hcan);
+    if (queue == NULL) {
+        return;
     }
 
-    while (HAL_CAN_GetTxMailboxesFreeLevel(can_handle) == 0) {
-        /* Wait to all mailbox is empty. */
-        ++wait_time;
-        if (wait_time > CAN_SEND_TIMEOUT) {
-            return 2;
-        }
-    }
+    /* A higher priority interrupt may call `can_send` on the same CAN. */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    can_tx_queue_flush(hcan, queue);
+    __set_PRIMASK(primask);
+}
 
-    if (HAL_CAN_AddTxMessage(can_handle, &tx_header, msg, &tx_mail_box) !=
-        HAL_OK) {
-        return 1;
-    }
+/**
+ * @brief Tx mailbox 1 complete callback, send the next queued message.
+ *
+ * @param hcan The handle of CAN.
+ */
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan) {
+    HAL_CAN_TxMailbox0CompleteCallback(hcan);
+}
 
-    return 0;
+/**
+ * @brief Tx mailbox 2 complete callback, send the next queued message.
+ *
+ * @param hcan The handle of CAN.
+ */
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan) {
+    HAL_CAN_TxMailbox0CompleteCallback(hcan);
 }
 
 /**
  * @}
  */
-
@@ -35,8 +35,13 @@ extern "C" {
 #define CAN_DEINIT_FAIL         1
 #define CAN_NO_INIT             2
 
-/* Wait for can tx mailbox empty times. */
-#define CAN_SEND_TIMEOUT        100
+/* Messages waiting for a free tx mailbox, for each CAN. Messages of the
+ * same ID are sent in order, `can_send_message_latest` replaces the data of
+ * a queued one instead. */
+#define CAN_TX_QUEUE_LEN        16
+
+/* First filter bank of CAN2, CAN1 uses the banks before it. */
+#define CAN_SLAVE_START_FILTER_BANK 14
 
 /**
  * @}
@@ -57,6 +62,18 @@ typedef enum {
     can3_selected       /*!< Select CAN3 */
 } can_selected_t;
 
+/**
+ * @brief TX queue statistics.
+ */
+typedef struct {
+    uint32_t depth;       /*!< Messages in the queue now.                */
+    uint32_t max_depth;   /*!< Most messages in the queue.               */
+    uint32_t drop;        /*!< Messages dropped, the queue was full.     */
+    uint32_t replace;     /*!< Queued data replaced by the latest one.   */
+    uint32_t latency;     /*!< Last send to mailbox latency. Unit: us.   */
+    uint32_t max_latency; /*!< Max send to mailbox latency. Unit: us.    */
+} can_tx_stat_t;
+
 /**
  * @}
  */
@@ -198,8 +215,12 @@ uint8_t can_rate_calc(uint32_t baud_rate, uint32_t prop_delay,
                       uint32_t base_freq, uint32_t *prescale, uint32_t *tsjw,
                       uint32_t *tseg1, uint32_t *tseg2);
 
+CAN_HandleTypeDef *can_get_handle(can_selected_t can_selected);
 uint8_t can_send_message(can_selected_t can_selected, uint32_t can_ide,
                          uint32_t id, uint8_t len, const uint8_t *msg);
+uint8_t can_send_message_latest(can_selected_t can_selected, uint32_t can_ide,
+                                uint32_t id, uint8_t len, const uint8_t *msg);
+uint8_t can_get_tx_stat(can_selected_t can_selected, can_tx_stat_t *stat);
 
 /**
  * @}
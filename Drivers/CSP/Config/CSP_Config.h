@@ -685,7 +685,7 @@
 
 //   <o> UART4 Interrupt Priority <0-15>
 //   <i> The Interrupt Priority of UART4
-#define UART4_IT_PRIORITY        2
+#define UART4_IT_PRIORITY        5
 //   <o> UART4 Interrupt SubPriority <0-15>
 //   <i> The Interrupt SubPriority of UART4
 #define UART4_IT_SUB             3
@@ -723,7 +723,7 @@
 
 //     <o> DMA RX Interrupt Priority <0-15>
 //     <i>  The Interrupt Priority of DMA Rx
-#define UART4_RX_DMA_IT_PRIORITY 2
+#define UART4_RX_DMA_IT_PRIORITY 5
 
 //     <o> DMA RX Interrupt SubPriority <0-15>
 //     <i>  The Interrupt SubPriority of DMA Rx
@@ -889,7 +889,7 @@
 
 //   <o> UART5 Interrupt Priority <0-15>
 //   <i> The Interrupt Priority of UART5
-#define UART5_IT_PRIORITY        2
+#define UART5_IT_PRIORITY        5
 //   <o> UART5 Interrupt SubPriority <0-15>
 //   <i> The Interrupt SubPriority of UART5
 #define UART5_IT_SUB             3
@@ -927,7 +927,7 @@
 
 //     <o> DMA RX Interrupt Priority <0-15>
 //     <i>  The Interrupt Priority of DMA Rx
-#define UART5_RX_DMA_IT_PRIORITY 2
+#define UART5_RX_DMA_IT_PRIORITY 5
 
 //     <o> DMA RX Interrupt SubPriority <0-15>
 //     <i>  The Interrupt SubPriority of DMA Rx
@@ -4041,7 +4041,7 @@
 #endif  /* CAN1_TX_ID */
 
 //   <e> Enable CAN1 TX Interrupt
-#define CAN1_TX_IT_ENABLE 0
+#define CAN1_TX_IT_ENABLE 1
 
 #if CAN1_TX_IT_ENABLE
 
@@ -24,13 +24,19 @@
 static char uart_buffer[256];
 
 /**
- * @brief Send buf of UART.
+ * @brief Send buf of UART, two halves used as ping-pong buffers. One half is
+ *        written while the other one is on the wire.
  */
 typedef struct {
-    uint8_t *send_buf; /*!< Send data buf.                                  */
-    uint32_t head_ptr; /*!< Pointer of send buf to control the length of DMA
-                            transfer.                                       */
-    size_t buf_size;   /*!< The size of buffer. Prevent overflow.           */
+    uint8_t *send_buf;        /*!< Send data buf, two halves of `buf_size`. */
+    uint32_t head_ptr;        /*!< Pointer of the filling half to control
+                                   the length of DMA transfer.              */
+    size_t buf_size;          /*!< The size of each half. Prevent overflow. */
+    uint8_t fill_idx;         /*!< Index of the half being written.         */
+    volatile uint8_t busy;    /*!< The other half is on the wire.           */
+    volatile uint8_t pending; /*!< The filling half is waiting to be sent.  */
+    uart_tx_event_callback_t cplt_callback; /*!< Called when DMA transfer
+                                                 is complete.       */
 } uart_tx_buf_t;
 
 /**
@@ -44,8 +50,69 @@ typedef struct {
                                control the DMA receive.      */
     uint32_t buf_size;    /*!< Size of `recv_buf`.           */
     uint32_t fifo_size;   /*!< Size of `rx_fifo_buf`.        */
+    uint32_t read_ptr;    /*!< Pointer of receive buf that
+                               read in place by peek.        */
+    uint32_t overrun;     /*!< Count of in place overruns.   */
+    uint8_t zero_copy;    /*!< Read in place, bypass fifo.   */
+    uart_rx_event_callback_t event_callback; /*!< Called after new data
+                                                  is put into fifo.  */
 } uart_rx_fifo_t;
 
+/**
+ * @brief Index of UART in the registry, O(1) lookup from the handle in ISR.
+ *        Bits [14:10] of the base address are unique for all UART instances
+ *        on STM32F4xx: APB1 0x4000_4400 ~ 0x4000_7C00 and APB2
+ *        0x4001_1000 ~ 0x4001_1C00.
+ */
+#define UART_REG_INDEX(base) ((((uintptr_t)(base)) >> 10) & 0x1FU)
+#define UART_REG_SIZE        32U
+
+/**
+ * @brief Pins of UART, the index of `uart_desc_t::pin`.
+ */
+typedef enum {
+    UART_PIN_TX,
+    UART_PIN_RX,
+    UART_PIN_CTS,
+    UART_PIN_RTS,
+    UART_PIN_NUM
+} uart_pin_id_t;
+
+/**
+ * @brief Pin of UART, `port` is `NULL` if the pin is not used.
+ */
+typedef struct {
+    GPIO_TypeDef *port; /*!< GPIO port.           */
+    uint16_t pin;       /*!< GPIO pin.            */
+    uint8_t alternate;  /*!< Alternate function.  */
+} uart_pin_t;
+
+/**
+ * @brief Interrupt of UART or its DMA stream.
+ */
+typedef struct {
+    uint8_t enable;    /*!< The interrupt is used. */
+    IRQn_Type irqn;    /*!< IRQ number.            */
+    uint8_t priority;  /*!< Preempt priority.      */
+    uint8_t sub;       /*!< Sub priority.          */
+} uart_irq_t;
+
+/**
+ * @brief Everything that differs between the UART instances in init and
+ *        deinit. The buffers are found in `uart_rx_reg` and `uart_tx_reg`.
+ */
+typedef struct {
+    UART_HandleTypeDef *huart;        /*!< Handle of UART.                  */
+    volatile uint32_t *clk_reg;       /*!< RCC enable register of UART.     */
+    uint32_t clk_bit;                 /*!< Clock enable bit in `clk_reg`.   */
+    uart_pin_t pin[UART_PIN_NUM];     /*!< Pins, TX, RX, CTS and RTS.       */
+    uart_irq_t irq;                   /*!< Interrupt of UART.               */
+    DMA_HandleTypeDef *dmarx;         /*!< Rx DMA, `NULL` if not used.      */
+    uart_irq_t dmarx_irq;             /*!< Interrupt of Rx DMA stream.      */
+    DMA_HandleTypeDef *dmatx;         /*!< Tx DMA, `NULL` if not used.      */
+    uart_irq_t dmatx_irq;             /*!< Interrupt of Tx DMA stream.      */
+} uart_desc_t;
+
 /**
  * @}
  */
@@ -58,6 +125,86 @@ typedef struct {
 static void uart_dmarx_halfdone_callback(UART_HandleTypeDef *huart);
 static void uart_dmarx_done_callback(UART_HandleTypeDef *huart);
 void uart_dmarx_idle_callback(UART_HandleTypeDef *huart);
+static void uart_dmatx_done_callback(UART_HandleTypeDef *huart);
+static void uart_init_unwind(UART_HandleTypeDef *huart);
+static uint8_t uart_init(const uart_desc_t *desc, uint32_t baud_rate);
+static uint8_t uart_deinit(const uart_desc_t *desc);
+
+/**
+ * @brief Allocate the receive buf and fifo, reset the pointers.
+ *
+ * @param uart_rx_fifo The receive fifo of UART.
+ * @return 0: Success; 1: No free memory, nothing is allocated.
+ */
+static inline uint8_t uart_dmarx_buf_init(uart_rx_fifo_t *uart_rx_fifo) {
+    uart_rx_fifo->head_ptr = 0;
+    uart_rx_fifo->read_ptr = 0;
+    uart_rx_fifo->zero_copy = 0;
+
+    uart_rx_fifo->recv_buf = CSP_MALLOC(uart_rx_fifo->buf_size);
+    uart_rx_fifo->rx_fifo_buf = CSP_MALLOC(uart_rx_fifo->fifo_size);
+    uart_rx_fifo->rx_fifo = NULL;
+    if ((uart_rx_fifo->recv_buf != NULL) &&
+        (uart_rx_fifo->rx_fifo_buf != NULL)) {
+        uart_rx_fifo->rx_fifo =
+            ring_fifo_init(uart_rx_fifo->rx_fifo_buf, uart_rx_fifo->fifo_size,
+                           RF_TYPE_STREAM);
+    }
+
+    if (uart_rx_fifo->rx_fifo == NULL) {
+        CSP_FREE(uart_rx_fifo->recv_buf);
+        CSP_FREE(uart_rx_fifo->rx_fifo_buf);
+        uart_rx_fifo->recv_buf = NULL;
+        uart_rx_fifo->rx_fifo_buf = NULL;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Free the receive buf and fifo.
+ *
+ * @param uart_rx_fifo The receive fifo of UART.
+ */
+static inline void uart_dmarx_buf_deinit(uart_rx_fifo_t *uart_rx_fifo) {
+    CSP_FREE(uart_rx_fifo->recv_buf);
+    CSP_FREE(uart_rx_fifo->rx_fifo_buf);
+    ring_fifo_destroy(uart_rx_fifo->rx_fifo);
+    uart_rx_fifo->recv_buf = NULL;
+    uart_rx_fifo->rx_fifo_buf = NULL;
+    uart_rx_fifo->rx_fifo = NULL;
+}
+
+/**
+ * @brief Allocate the two halves of send buf, reset the pointers.
+ *
+ * @param send_tx_buf The send buf of UART.
+ * @return 0: Success; 1: No free memory.
+ */
+static inline uint8_t uart_dmatx_buf_init(uart_tx_buf_t *send_tx_buf) {
+    send_tx_buf->head_ptr = 0;
+    send_tx_buf->fill_idx = 0;
+    send_tx_buf->busy = 0;
+    send_tx_buf->pending = 0;
+
+    send_tx_buf->send_buf = CSP_MALLOC(send_tx_buf->buf_size * 2);
+    if (send_tx_buf->send_buf == NULL) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Free the send buf.
+ *
+ * @param send_tx_buf The send buf of UART.
+ */
+static inline void uart_dmatx_buf_deinit(uart_tx_buf_t *send_tx_buf) {
+    CSP_FREE(send_tx_buf->send_buf);
+    send_tx_buf->send_buf = NULL;
+}
 
 /**
  * @}
@@ -110,137 +257,58 @@ static uart_tx_buf_t usart1_tx_buf = {.buf_size = USART1_TX_DMA_BUF_SIZE};
 
 #endif /* USART1_TX_DMA */
 
-/**
- * @brief USART1 initialization
- *
- * @param baud_rate Baud rate.
- * @return USART1 init status.
- *  @retval - 0: `UART_INIT_OK`:       Success.
- *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
- *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
- *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
- *                                    dynamic allocate memory when using DMA).
- *  @retval - 4: `UART_INITED`:        This uart is inited.
- */
-uint8_t usart1_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&usart1_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    usart1_handle.Init.BaudRate = baud_rate;
+/* Pins, clock and interrupts of USART1. */
+static const uart_desc_t usart1_desc = {
+    .huart = &usart1_handle,
+    .clk_reg = &RCC->APB2ENR,
+    .clk_bit = RCC_APB2ENR_USART1EN,
+    .pin = {
 #if USART1_TX
-    usart1_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(USART1_TX_PORT);
-    gpio_init_struct.Pin = USART1_TX_PIN;
-    gpio_init_struct.Alternate = USART1_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART1_TX_PORT), &gpio_init_struct);
+        [UART_PIN_TX] = {CSP_GPIO_PORT(USART1_TX_PORT), USART1_TX_PIN,
+                         USART1_TX_GPIO_AF},
 #endif /* USART1_TX */
-
 #if USART1_RX
-    usart1_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(USART1_RX_PORT);
-    gpio_init_struct.Pin = USART1_RX_PIN;
-    gpio_init_struct.Alternate = USART1_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART1_RX_PORT), &gpio_init_struct);
+        [UART_PIN_RX] = {CSP_GPIO_PORT(USART1_RX_PORT), USART1_RX_PIN,
+                         USART1_RX_GPIO_AF},
 #endif /* USART1_RX */
-
 #if USART1_CTS
-    usart1_handle.Init.HwFlowCtl |= UART_HWCONTROL_CTS;
-
-    CSP_GPIO_CLK_ENABLE(USART1_CTS_PORT);
-    gpio_init_struct.Pin = USART1_CTS_PIN;
-    gpio_init_struct.Alternate = USART1_CTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART1_CTS_PORT), &gpio_init_struct);
-#endif /* USART1_USART1_CTS */
-
+        [UART_PIN_CTS] = {CSP_GPIO_PORT(USART1_CTS_PORT), USART1_CTS_PIN,
+                          USART1_CTS_GPIO_AF},
+#endif /* USART1_CTS */
 #if USART1_RTS
-    usart1_handle.Init.HwFlowCtl |= UART_HWCONTROL_RTS;
-
-    CSP_GPIO_CLK_ENABLE(USART1_RTS_PORT);
-    gpio_init_struct.Pin = USART1_RTS_PIN;
-    gpio_init_struct.Alternate = USART1_RTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART1_RTS_PORT), &gpio_init_struct);
+        [UART_PIN_RTS] = {CSP_GPIO_PORT(USART1_RTS_PORT), USART1_RTS_PIN,
+                          USART1_RTS_GPIO_AF},
 #endif /* USART1_RTS */
-
-    __HAL_RCC_USART1_CLK_ENABLE();
+    },
 #if USART1_IT_ENABLE
-    HAL_NVIC_EnableIRQ(USART1_IRQn);
-    HAL_NVIC_SetPriority(USART1_IRQn, USART1_IT_PRIORITY, USART1_IT_SUB);
+    .irq = {1, USART1_IRQn, USART1_IT_PRIORITY, USART1_IT_SUB},
 #endif /* USART1_IT_ENABLE */
-
 #if USART1_RX_DMA
-    usart1_rx_fifo.head_ptr = 0;
-
-    usart1_rx_fifo.recv_buf = CSP_MALLOC(usart1_rx_fifo.buf_size);
-    if (usart1_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    usart1_rx_fifo.rx_fifo_buf = CSP_MALLOC(usart1_rx_fifo.fifo_size);
-    if (usart1_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    usart1_rx_fifo.rx_fifo = ring_fifo_init(
-        usart1_rx_fifo.rx_fifo_buf, usart1_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (usart1_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(USART1_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&usart1_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&usart1_handle, hdmarx, usart1_dmarx_handle);
-
-    HAL_NVIC_SetPriority(USART1_RX_DMA_IRQn, USART1_RX_DMA_IT_PRIORITY, USART1_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(USART1_RX_DMA_IRQn);
-
+    .dmarx = &usart1_dmarx_handle,
+    .dmarx_irq = {1, USART1_RX_DMA_IRQn, USART1_RX_DMA_IT_PRIORITY,
+                  USART1_RX_DMA_IT_SUB},
 #endif /* USART1_RX_DMA */
-
 #if USART1_TX_DMA
-    usart1_tx_buf.send_buf = CSP_MALLOC(usart1_tx_buf.buf_size);
-    if (usart1_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(USART1_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&usart1_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&usart1_handle, hdmatx, usart1_dmatx_handle);
-
-    HAL_NVIC_SetPriority(USART1_TX_DMA_IRQn, USART1_TX_DMA_IT_PRIORITY, USART1_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(USART1_TX_DMA_IRQn);
-
+    .dmatx = &usart1_dmatx_handle,
+    .dmatx_irq = {1, USART1_TX_DMA_IRQn, USART1_TX_DMA_IT_PRIORITY,
+                  USART1_TX_DMA_IT_SUB},
 #endif /* USART1_TX_DMA */
+};
 
-    if (HAL_UART_Init(&usart1_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if USART1_RX_DMA
-    __HAL_UART_ENABLE_IT(&usart1_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&usart1_handle);
-
-    HAL_UART_Receive_DMA(&usart1_handle, usart1_rx_fifo.recv_buf,
-                         usart1_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&usart1_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&usart1_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* USART1_RX_DMA */
-    return UART_INIT_OK;
+/**
+ * @brief USART1 initialization
+ *
+ * @param baud_rate Baud rate.
+ * @return USART1 init status.
+ *  @retval - 0: `UART_INIT_OK`:       Success.
+ *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
+ *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
+ *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
+ *                                    dynamic allocate memory when using DMA).
+ *  @retval - 4: `UART_INITED`:        This uart is inited.
+ */
+uint8_t usart1_init(uint32_t baud_rate) {
+    return uart_init(&usart1_desc, baud_rate);
 }
 
 #if USART1_IT_ENABLE
@@ -294,71 +362,7 @@ void USART1_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t usart1_deinit(void) {
-    if (HAL_UART_GetState(&usart1_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_USART1_CLK_DISABLE();
-
-#if USART1_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART1_TX_PORT), USART1_TX_PIN);
-#endif /* USART1_TX */
-
-#if USART1_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART1_RX_PORT), USART1_RX_PIN);
-#endif /* USART1_RX */
-
-#if USART1_CTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART1_CTS_PORT), USART1_CTS_PIN);
-#endif /* USART1_USART1_CTS */
-
-#if USART1_RTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART1_RTS_PORT), USART1_RTS_PIN);
-#endif /* USART1_RTS */
-
-#if USART1_IT_ENABLE
-    HAL_NVIC_DisableIRQ(USART1_IRQn);
-#endif /* USART1_IT_ENABLE */
-
-#if USART1_RX_DMA
-
-    HAL_DMA_Abort(&usart1_dmarx_handle);
-    CSP_FREE(usart1_rx_fifo.recv_buf);
-    CSP_FREE(usart1_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(usart1_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&usart1_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(USART1_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&usart1_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&usart1_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    usart1_handle.hdmarx = NULL;
-
-#endif /* USART1_RX_DMA */
-
-#if USART1_TX_DMA
-    HAL_DMA_Abort(&usart1_dmatx_handle);
-    CSP_FREE(usart1_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&usart1_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(USART1_TX_DMA_IRQn);
-
-    usart1_handle.hdmatx = NULL;
-#endif /* USART1_TX_DMA */
-
-    if (HAL_UART_DeInit(&usart1_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+    return uart_deinit(&usart1_desc);
 }
 
 #endif /* USART1_ENABLE */
@@ -415,137 +419,58 @@ static uart_tx_buf_t usart2_tx_buf = {.buf_size = USART2_TX_DMA_BUF_SIZE};
 
 #endif /* USART2_TX_DMA */
 
-/**
- * @brief USART2 initialization
- *
- * @param baud_rate Baud rate.
- * @return USART2 init status.
- *  @retval - 0: `UART_INIT_OK`:       Success.
- *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
- *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
- *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
- *                                    dynamic allocate memory when using DMA).
- *  @retval - 4: `UART_INITED`:        This uart is inited.
- */
-uint8_t usart2_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&usart2_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    usart2_handle.Init.BaudRate = baud_rate;
+/* Pins, clock and interrupts of USART2. */
+static const uart_desc_t usart2_desc = {
+    .huart = &usart2_handle,
+    .clk_reg = &RCC->APB1ENR,
+    .clk_bit = RCC_APB1ENR_USART2EN,
+    .pin = {
 #if USART2_TX
-    usart2_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(USART2_TX_PORT);
-    gpio_init_struct.Pin = USART2_TX_PIN;
-    gpio_init_struct.Alternate = USART2_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART2_TX_PORT), &gpio_init_struct);
+        [UART_PIN_TX] = {CSP_GPIO_PORT(USART2_TX_PORT), USART2_TX_PIN,
+                         USART2_TX_GPIO_AF},
 #endif /* USART2_TX */
-
 #if USART2_RX
-    usart2_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(USART2_RX_PORT);
-    gpio_init_struct.Pin = USART2_RX_PIN;
-    gpio_init_struct.Alternate = USART2_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART2_RX_PORT), &gpio_init_struct);
+        [UART_PIN_RX] = {CSP_GPIO_PORT(USART2_RX_PORT), USART2_RX_PIN,
+                         USART2_RX_GPIO_AF},
 #endif /* USART2_RX */
-
 #if USART2_CTS
-    usart2_handle.Init.HwFlowCtl |= UART_HWCONTROL_CTS;
-
-    CSP_GPIO_CLK_ENABLE(USART2_CTS_PORT);
-    gpio_init_struct.Pin = USART2_CTS_PIN;
-    gpio_init_struct.Alternate = USART2_CTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART2_CTS_PORT), &gpio_init_struct);
-#endif /* USART2_USART2_CTS */
-
+        [UART_PIN_CTS] = {CSP_GPIO_PORT(USART2_CTS_PORT), USART2_CTS_PIN,
+                          USART2_CTS_GPIO_AF},
+#endif /* USART2_CTS */
 #if USART2_RTS
-    usart2_handle.Init.HwFlowCtl |= UART_HWCONTROL_RTS;
-
-    CSP_GPIO_CLK_ENABLE(USART2_RTS_PORT);
-    gpio_init_struct.Pin = USART2_RTS_PIN;
-    gpio_init_struct.Alternate = USART2_RTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART2_RTS_PORT), &gpio_init_struct);
+        [UART_PIN_RTS] = {CSP_GPIO_PORT(USART2_RTS_PORT), USART2_RTS_PIN,
+                          USART2_RTS_GPIO_AF},
 #endif /* USART2_RTS */
-
-    __HAL_RCC_USART2_CLK_ENABLE();
+    },
 #if USART2_IT_ENABLE
-    HAL_NVIC_EnableIRQ(USART2_IRQn);
-    HAL_NVIC_SetPriority(USART2_IRQn, USART2_IT_PRIORITY, USART2_IT_SUB);
+    .irq = {1, USART2_IRQn, USART2_IT_PRIORITY, USART2_IT_SUB},
 #endif /* USART2_IT_ENABLE */
-
 #if USART2_RX_DMA
-    usart2_rx_fifo.head_ptr = 0;
-
-    usart2_rx_fifo.recv_buf = CSP_MALLOC(usart2_rx_fifo.buf_size);
-    if (usart2_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    usart2_rx_fifo.rx_fifo_buf = CSP_MALLOC(usart2_rx_fifo.fifo_size);
-    if (usart2_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    usart2_rx_fifo.rx_fifo = ring_fifo_init(
-        usart2_rx_fifo.rx_fifo_buf, usart2_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (usart2_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(USART2_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&usart2_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&usart2_handle, hdmarx, usart2_dmarx_handle);
-
-    HAL_NVIC_SetPriority(USART2_RX_DMA_IRQn, USART2_RX_DMA_IT_PRIORITY, USART2_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(USART2_RX_DMA_IRQn);
-
+    .dmarx = &usart2_dmarx_handle,
+    .dmarx_irq = {1, USART2_RX_DMA_IRQn, USART2_RX_DMA_IT_PRIORITY,
+                  USART2_RX_DMA_IT_SUB},
 #endif /* USART2_RX_DMA */
-
 #if USART2_TX_DMA
-    usart2_tx_buf.send_buf = CSP_MALLOC(usart2_tx_buf.buf_size);
-    if (usart2_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(USART2_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&usart2_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&usart2_handle, hdmatx, usart2_dmatx_handle);
-
-    HAL_NVIC_SetPriority(USART2_TX_DMA_IRQn, USART2_TX_DMA_IT_PRIORITY, USART2_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(USART2_TX_DMA_IRQn);
-
+    .dmatx = &usart2_dmatx_handle,
+    .dmatx_irq = {1, USART2_TX_DMA_IRQn, USART2_TX_DMA_IT_PRIORITY,
+                  USART2_TX_DMA_IT_SUB},
 #endif /* USART2_TX_DMA */
+};
 
-    if (HAL_UART_Init(&usart2_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if USART2_RX_DMA
-    __HAL_UART_ENABLE_IT(&usart2_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&usart2_handle);
-
-    HAL_UART_Receive_DMA(&usart2_handle, usart2_rx_fifo.recv_buf,
-                         usart2_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&usart2_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&usart2_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* USART2_RX_DMA */
-    return UART_INIT_OK;
+/**
+ * @brief USART2 initialization
+ *
+ * @param baud_rate Baud rate.
+ * @return USART2 init status.
+ *  @retval - 0: `UART_INIT_OK`:       Success.
+ *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
+ *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
+ *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
+ *                                    dynamic allocate memory when using DMA).
+ *  @retval - 4: `UART_INITED`:        This uart is inited.
+ */
+uint8_t usart2_init(uint32_t baud_rate) {
+    return uart_init(&usart2_desc, baud_rate);
 }
 
 #if USART2_IT_ENABLE
@@ -599,93 +524,29 @@ void USART2_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t usart2_deinit(void) {
-    if (HAL_UART_GetState(&usart2_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_USART2_CLK_DISABLE();
+    return uart_deinit(&usart2_desc);
+}
 
-#if USART2_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART2_TX_PORT), USART2_TX_PIN);
-#endif /* USART2_TX */
+#endif /* USART2_ENABLE */
 
-#if USART2_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART2_RX_PORT), USART2_RX_PIN);
-#endif /* USART2_RX */
+/**
+ * @}
+ */ 
 
-#if USART2_CTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART2_CTS_PORT), USART2_CTS_PIN);
-#endif /* USART2_USART2_CTS */
 
-#if USART2_RTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART2_RTS_PORT), USART2_RTS_PIN);
-#endif /* USART2_RTS */
+/*****************************************************************************
+ * @defgroup USART3 Functions
+ * @{
+ */
 
-#if USART2_IT_ENABLE
-    HAL_NVIC_DisableIRQ(USART2_IRQn);
-#endif /* USART2_IT_ENABLE */
+#if USART3_ENABLE
 
-#if USART2_RX_DMA
+UART_HandleTypeDef usart3_handle = {.Instance = USART3,
+                                    .Init = {.WordLength = UART_WORDLENGTH_8B,
+                                             .StopBits = UART_STOPBITS_1,
+                                             .Parity = UART_PARITY_NONE}};
 
-    HAL_DMA_Abort(&usart2_dmarx_handle);
-    CSP_FREE(usart2_rx_fifo.recv_buf);
-    CSP_FREE(usart2_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(usart2_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&usart2_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(USART2_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&usart2_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&usart2_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    usart2_handle.hdmarx = NULL;
-
-#endif /* USART2_RX_DMA */
-
-#if USART2_TX_DMA
-    HAL_DMA_Abort(&usart2_dmatx_handle);
-    CSP_FREE(usart2_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&usart2_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(USART2_TX_DMA_IRQn);
-
-    usart2_handle.hdmatx = NULL;
-#endif /* USART2_TX_DMA */
-
-    if (HAL_UART_DeInit(&usart2_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
-}
-
-#endif /* USART2_ENABLE */
-
-/**
- * @}
- */ 
-
-
-/*****************************************************************************
- * @defgroup USART3 Functions
- * @{
- */
-
-#if USART3_ENABLE
-
-UART_HandleTypeDef usart3_handle = {.Instance = USART3,
-                                    .Init = {.WordLength = UART_WORDLENGTH_8B,
-                                             .StopBits = UART_STOPBITS_1,
-                                             .Parity = UART_PARITY_NONE}};
-
-#if USART3_RX_DMA
+#if USART3_RX_DMA
 
 static DMA_HandleTypeDef usart3_dmarx_handle = {
     .Instance = CSP_DMA_STREAM(USART3_RX_DMA_NUMBER, USART3_RX_DMA_STREAM),
@@ -720,137 +581,58 @@ static uart_tx_buf_t usart3_tx_buf = {.buf_size = USART3_TX_DMA_BUF_SIZE};
 
 #endif /* USART3_TX_DMA */
 
-/**
- * @brief USART3 initialization
- *
- * @param baud_rate Baud rate.
- * @return USART3 init status.
- *  @retval - 0: `UART_INIT_OK`:       Success.
- *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
- *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
- *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
- *                                    dynamic allocate memory when using DMA).
- *  @retval - 4: `UART_INITED`:        This uart is inited.
- */
-uint8_t usart3_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&usart3_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    usart3_handle.Init.BaudRate = baud_rate;
+/* Pins, clock and interrupts of USART3. */
+static const uart_desc_t usart3_desc = {
+    .huart = &usart3_handle,
+    .clk_reg = &RCC->APB1ENR,
+    .clk_bit = RCC_APB1ENR_USART3EN,
+    .pin = {
 #if USART3_TX
-    usart3_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(USART3_TX_PORT);
-    gpio_init_struct.Pin = USART3_TX_PIN;
-    gpio_init_struct.Alternate = USART3_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART3_TX_PORT), &gpio_init_struct);
+        [UART_PIN_TX] = {CSP_GPIO_PORT(USART3_TX_PORT), USART3_TX_PIN,
+                         USART3_TX_GPIO_AF},
 #endif /* USART3_TX */
-
 #if USART3_RX
-    usart3_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(USART3_RX_PORT);
-    gpio_init_struct.Pin = USART3_RX_PIN;
-    gpio_init_struct.Alternate = USART3_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART3_RX_PORT), &gpio_init_struct);
+        [UART_PIN_RX] = {CSP_GPIO_PORT(USART3_RX_PORT), USART3_RX_PIN,
+                         USART3_RX_GPIO_AF},
 #endif /* USART3_RX */
-
 #if USART3_CTS
-    usart3_handle.Init.HwFlowCtl |= UART_HWCONTROL_CTS;
-
-    CSP_GPIO_CLK_ENABLE(USART3_CTS_PORT);
-    gpio_init_struct.Pin = USART3_CTS_PIN;
-    gpio_init_struct.Alternate = USART3_CTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART3_CTS_PORT), &gpio_init_struct);
-#endif /* USART3_USART3_CTS */
-
+        [UART_PIN_CTS] = {CSP_GPIO_PORT(USART3_CTS_PORT), USART3_CTS_PIN,
+                          USART3_CTS_GPIO_AF},
+#endif /* USART3_CTS */
 #if USART3_RTS
-    usart3_handle.Init.HwFlowCtl |= UART_HWCONTROL_RTS;
-
-    CSP_GPIO_CLK_ENABLE(USART3_RTS_PORT);
-    gpio_init_struct.Pin = USART3_RTS_PIN;
-    gpio_init_struct.Alternate = USART3_RTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART3_RTS_PORT), &gpio_init_struct);
+        [UART_PIN_RTS] = {CSP_GPIO_PORT(USART3_RTS_PORT), USART3_RTS_PIN,
+                          USART3_RTS_GPIO_AF},
 #endif /* USART3_RTS */
-
-    __HAL_RCC_USART3_CLK_ENABLE();
+    },
 #if USART3_IT_ENABLE
-    HAL_NVIC_EnableIRQ(USART3_IRQn);
-    HAL_NVIC_SetPriority(USART3_IRQn, USART3_IT_PRIORITY, USART3_IT_SUB);
+    .irq = {1, USART3_IRQn, USART3_IT_PRIORITY, USART3_IT_SUB},
 #endif /* USART3_IT_ENABLE */
-
 #if USART3_RX_DMA
-    usart3_rx_fifo.head_ptr = 0;
-
-    usart3_rx_fifo.recv_buf = CSP_MALLOC(usart3_rx_fifo.buf_size);
-    if (usart3_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    usart3_rx_fifo.rx_fifo_buf = CSP_MALLOC(usart3_rx_fifo.fifo_size);
-    if (usart3_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    usart3_rx_fifo.rx_fifo = ring_fifo_init(
-        usart3_rx_fifo.rx_fifo_buf, usart3_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (usart3_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(USART3_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&usart3_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&usart3_handle, hdmarx, usart3_dmarx_handle);
-
-    HAL_NVIC_SetPriority(USART3_RX_DMA_IRQn, USART3_RX_DMA_IT_PRIORITY, USART3_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(USART3_RX_DMA_IRQn);
-
+    .dmarx = &usart3_dmarx_handle,
+    .dmarx_irq = {1, USART3_RX_DMA_IRQn, USART3_RX_DMA_IT_PRIORITY,
+                  USART3_RX_DMA_IT_SUB},
 #endif /* USART3_RX_DMA */
-
 #if USART3_TX_DMA
-    usart3_tx_buf.send_buf = CSP_MALLOC(usart3_tx_buf.buf_size);
-    if (usart3_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(USART3_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&usart3_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&usart3_handle, hdmatx, usart3_dmatx_handle);
-
-    HAL_NVIC_SetPriority(USART3_TX_DMA_IRQn, USART3_TX_DMA_IT_PRIORITY, USART3_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(USART3_TX_DMA_IRQn);
-
+    .dmatx = &usart3_dmatx_handle,
+    .dmatx_irq = {1, USART3_TX_DMA_IRQn, USART3_TX_DMA_IT_PRIORITY,
+                  USART3_TX_DMA_IT_SUB},
 #endif /* USART3_TX_DMA */
+};
 
-    if (HAL_UART_Init(&usart3_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if USART3_RX_DMA
-    __HAL_UART_ENABLE_IT(&usart3_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&usart3_handle);
-
-    HAL_UART_Receive_DMA(&usart3_handle, usart3_rx_fifo.recv_buf,
-                         usart3_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&usart3_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&usart3_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* USART3_RX_DMA */
-    return UART_INIT_OK;
+/**
+ * @brief USART3 initialization
+ *
+ * @param baud_rate Baud rate.
+ * @return USART3 init status.
+ *  @retval - 0: `UART_INIT_OK`:       Success.
+ *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
+ *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
+ *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
+ *                                    dynamic allocate memory when using DMA).
+ *  @retval - 4: `UART_INITED`:        This uart is inited.
+ */
+uint8_t usart3_init(uint32_t baud_rate) {
+    return uart_init(&usart3_desc, baud_rate);
 }
 
 #if USART3_IT_ENABLE
@@ -904,71 +686,7 @@ void USART3_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t usart3_deinit(void) {
-    if (HAL_UART_GetState(&usart3_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_USART3_CLK_DISABLE();
-
-#if USART3_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART3_TX_PORT), USART3_TX_PIN);
-#endif /* USART3_TX */
-
-#if USART3_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART3_RX_PORT), USART3_RX_PIN);
-#endif /* USART3_RX */
-
-#if USART3_CTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART3_CTS_PORT), USART3_CTS_PIN);
-#endif /* USART3_USART3_CTS */
-
-#if USART3_RTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART3_RTS_PORT), USART3_RTS_PIN);
-#endif /* USART3_RTS */
-
-#if USART3_IT_ENABLE
-    HAL_NVIC_DisableIRQ(USART3_IRQn);
-#endif /* USART3_IT_ENABLE */
-
-#if USART3_RX_DMA
-
-    HAL_DMA_Abort(&usart3_dmarx_handle);
-    CSP_FREE(usart3_rx_fifo.recv_buf);
-    CSP_FREE(usart3_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(usart3_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&usart3_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(USART3_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&usart3_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&usart3_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    usart3_handle.hdmarx = NULL;
-
-#endif /* USART3_RX_DMA */
-
-#if USART3_TX_DMA
-    HAL_DMA_Abort(&usart3_dmatx_handle);
-    CSP_FREE(usart3_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&usart3_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(USART3_TX_DMA_IRQn);
-
-    usart3_handle.hdmatx = NULL;
-#endif /* USART3_TX_DMA */
-
-    if (HAL_UART_DeInit(&usart3_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+    return uart_deinit(&usart3_desc);
 }
 
 #endif /* USART3_ENABLE */
@@ -1025,137 +743,58 @@ static uart_tx_buf_t uart4_tx_buf = {.buf_size = UART4_TX_DMA_BUF_SIZE};
 
 #endif /* UART4_TX_DMA */
 
-/**
- * @brief UART4 initialization
- *
- * @param baud_rate Baud rate.
- * @return UART4 init status.
- *  @retval - 0: `UART_INIT_OK`:       Success.
- *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
- *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
- *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
- *                                    dynamic allocate memory when using DMA).
- *  @retval - 4: `UART_INITED`:        This uart is inited.
- */
-uint8_t uart4_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&uart4_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    uart4_handle.Init.BaudRate = baud_rate;
+/* Pins, clock and interrupts of UART4. */
+static const uart_desc_t uart4_desc = {
+    .huart = &uart4_handle,
+    .clk_reg = &RCC->APB1ENR,
+    .clk_bit = RCC_APB1ENR_UART4EN,
+    .pin = {
 #if UART4_TX
-    uart4_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(UART4_TX_PORT);
-    gpio_init_struct.Pin = UART4_TX_PIN;
-    gpio_init_struct.Alternate = UART4_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART4_TX_PORT), &gpio_init_struct);
+        [UART_PIN_TX] = {CSP_GPIO_PORT(UART4_TX_PORT), UART4_TX_PIN,
+                         UART4_TX_GPIO_AF},
 #endif /* UART4_TX */
-
 #if UART4_RX
-    uart4_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(UART4_RX_PORT);
-    gpio_init_struct.Pin = UART4_RX_PIN;
-    gpio_init_struct.Alternate = UART4_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART4_RX_PORT), &gpio_init_struct);
+        [UART_PIN_RX] = {CSP_GPIO_PORT(UART4_RX_PORT), UART4_RX_PIN,
+                         UART4_RX_GPIO_AF},
 #endif /* UART4_RX */
-
 #if UART4_CTS
-    uart4_handle.Init.HwFlowCtl |= UART_HWCONTROL_CTS;
-
-    CSP_GPIO_CLK_ENABLE(UART4_CTS_PORT);
-    gpio_init_struct.Pin = UART4_CTS_PIN;
-    gpio_init_struct.Alternate = UART4_CTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART4_CTS_PORT), &gpio_init_struct);
-#endif /* UART4_UART4_CTS */
-
+        [UART_PIN_CTS] = {CSP_GPIO_PORT(UART4_CTS_PORT), UART4_CTS_PIN,
+                          UART4_CTS_GPIO_AF},
+#endif /* UART4_CTS */
 #if UART4_RTS
-    uart4_handle.Init.HwFlowCtl |= UART_HWCONTROL_RTS;
-
-    CSP_GPIO_CLK_ENABLE(UART4_RTS_PORT);
-    gpio_init_struct.Pin = UART4_RTS_PIN;
-    gpio_init_struct.Alternate = UART4_RTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART4_RTS_PORT), &gpio_init_struct);
+        [UART_PIN_RTS] = {CSP_GPIO_PORT(UART4_RTS_PORT), UART4_RTS_PIN,
+                          UART4_RTS_GPIO_AF},
 #endif /* UART4_RTS */
-
-    __HAL_RCC_UART4_CLK_ENABLE();
+    },
 #if UART4_IT_ENABLE
-    HAL_NVIC_EnableIRQ(UART4_IRQn);
-    HAL_NVIC_SetPriority(UART4_IRQn, UART4_IT_PRIORITY, UART4_IT_SUB);
+    .irq = {1, UART4_IRQn, UART4_IT_PRIORITY, UART4_IT_SUB},
 #endif /* UART4_IT_ENABLE */
-
 #if UART4_RX_DMA
-    uart4_rx_fifo.head_ptr = 0;
-
-    uart4_rx_fifo.recv_buf = CSP_MALLOC(uart4_rx_fifo.buf_size);
-    if (uart4_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart4_rx_fifo.rx_fifo_buf = CSP_MALLOC(uart4_rx_fifo.fifo_size);
-    if (uart4_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart4_rx_fifo.rx_fifo = ring_fifo_init(
-        uart4_rx_fifo.rx_fifo_buf, uart4_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (uart4_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART4_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart4_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart4_handle, hdmarx, uart4_dmarx_handle);
-
-    HAL_NVIC_SetPriority(UART4_RX_DMA_IRQn, UART4_RX_DMA_IT_PRIORITY, UART4_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART4_RX_DMA_IRQn);
-
+    .dmarx = &uart4_dmarx_handle,
+    .dmarx_irq = {1, UART4_RX_DMA_IRQn, UART4_RX_DMA_IT_PRIORITY,
+                  UART4_RX_DMA_IT_SUB},
 #endif /* UART4_RX_DMA */
-
 #if UART4_TX_DMA
-    uart4_tx_buf.send_buf = CSP_MALLOC(uart4_tx_buf.buf_size);
-    if (uart4_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART4_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart4_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart4_handle, hdmatx, uart4_dmatx_handle);
-
-    HAL_NVIC_SetPriority(UART4_TX_DMA_IRQn, UART4_TX_DMA_IT_PRIORITY, UART4_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART4_TX_DMA_IRQn);
-
+    .dmatx = &uart4_dmatx_handle,
+    .dmatx_irq = {1, UART4_TX_DMA_IRQn, UART4_TX_DMA_IT_PRIORITY,
+                  UART4_TX_DMA_IT_SUB},
 #endif /* UART4_TX_DMA */
+};
 
-    if (HAL_UART_Init(&uart4_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if UART4_RX_DMA
-    __HAL_UART_ENABLE_IT(&uart4_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&uart4_handle);
-
-    HAL_UART_Receive_DMA(&uart4_handle, uart4_rx_fifo.recv_buf,
-                         uart4_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&uart4_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&uart4_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* UART4_RX_DMA */
-    return UART_INIT_OK;
+/**
+ * @brief UART4 initialization
+ *
+ * @param baud_rate Baud rate.
+ * @return UART4 init status.
+ *  @retval - 0: `UART_INIT_OK`:       Success.
+ *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
+ *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
+ *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
+ *                                    dynamic allocate memory when using DMA).
+ *  @retval - 4: `UART_INITED`:        This uart is inited.
+ */
+uint8_t uart4_init(uint32_t baud_rate) {
+    return uart_init(&uart4_desc, baud_rate);
 }
 
 #if UART4_IT_ENABLE
@@ -1209,71 +848,7 @@ void UART4_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t uart4_deinit(void) {
-    if (HAL_UART_GetState(&uart4_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_UART4_CLK_DISABLE();
-
-#if UART4_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART4_TX_PORT), UART4_TX_PIN);
-#endif /* UART4_TX */
-
-#if UART4_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART4_RX_PORT), UART4_RX_PIN);
-#endif /* UART4_RX */
-
-#if UART4_CTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART4_CTS_PORT), UART4_CTS_PIN);
-#endif /* UART4_UART4_CTS */
-
-#if UART4_RTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART4_RTS_PORT), UART4_RTS_PIN);
-#endif /* UART4_RTS */
-
-#if UART4_IT_ENABLE
-    HAL_NVIC_DisableIRQ(UART4_IRQn);
-#endif /* UART4_IT_ENABLE */
-
-#if UART4_RX_DMA
-
-    HAL_DMA_Abort(&uart4_dmarx_handle);
-    CSP_FREE(uart4_rx_fifo.recv_buf);
-    CSP_FREE(uart4_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(uart4_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&uart4_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART4_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&uart4_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&uart4_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    uart4_handle.hdmarx = NULL;
-
-#endif /* UART4_RX_DMA */
-
-#if UART4_TX_DMA
-    HAL_DMA_Abort(&uart4_dmatx_handle);
-    CSP_FREE(uart4_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&uart4_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART4_TX_DMA_IRQn);
-
-    uart4_handle.hdmatx = NULL;
-#endif /* UART4_TX_DMA */
-
-    if (HAL_UART_DeInit(&uart4_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+    return uart_deinit(&uart4_desc);
 }
 
 #endif /* UART4_ENABLE */
@@ -1330,137 +905,58 @@ static uart_tx_buf_t uart5_tx_buf = {.buf_size = UART5_TX_DMA_BUF_SIZE};
 
 #endif /* UART5_TX_DMA */
 
-/**
- * @brief UART5 initialization
- *
- * @param baud_rate Baud rate.
- * @return UART5 init status.
- *  @retval - 0: `UART_INIT_OK`:       Success.
- *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
- *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
- *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
- *                                    dynamic allocate memory when using DMA).
- *  @retval - 4: `UART_INITED`:        This uart is inited.
- */
-uint8_t uart5_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&uart5_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    uart5_handle.Init.BaudRate = baud_rate;
+/* Pins, clock and interrupts of UART5. */
+static const uart_desc_t uart5_desc = {
+    .huart = &uart5_handle,
+    .clk_reg = &RCC->APB1ENR,
+    .clk_bit = RCC_APB1ENR_UART5EN,
+    .pin = {
 #if UART5_TX
-    uart5_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(UART5_TX_PORT);
-    gpio_init_struct.Pin = UART5_TX_PIN;
-    gpio_init_struct.Alternate = UART5_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART5_TX_PORT), &gpio_init_struct);
+        [UART_PIN_TX] = {CSP_GPIO_PORT(UART5_TX_PORT), UART5_TX_PIN,
+                         UART5_TX_GPIO_AF},
 #endif /* UART5_TX */
-
 #if UART5_RX
-    uart5_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(UART5_RX_PORT);
-    gpio_init_struct.Pin = UART5_RX_PIN;
-    gpio_init_struct.Alternate = UART5_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART5_RX_PORT), &gpio_init_struct);
+        [UART_PIN_RX] = {CSP_GPIO_PORT(UART5_RX_PORT), UART5_RX_PIN,
+                         UART5_RX_GPIO_AF},
 #endif /* UART5_RX */
-
 #if UART5_CTS
-    uart5_handle.Init.HwFlowCtl |= UART_HWCONTROL_CTS;
-
-    CSP_GPIO_CLK_ENABLE(UART5_CTS_PORT);
-    gpio_init_struct.Pin = UART5_CTS_PIN;
-    gpio_init_struct.Alternate = UART5_CTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART5_CTS_PORT), &gpio_init_struct);
-#endif /* UART5_UART5_CTS */
-
+        [UART_PIN_CTS] = {CSP_GPIO_PORT(UART5_CTS_PORT), UART5_CTS_PIN,
+                          UART5_CTS_GPIO_AF},
+#endif /* UART5_CTS */
 #if UART5_RTS
-    uart5_handle.Init.HwFlowCtl |= UART_HWCONTROL_RTS;
-
-    CSP_GPIO_CLK_ENABLE(UART5_RTS_PORT);
-    gpio_init_struct.Pin = UART5_RTS_PIN;
-    gpio_init_struct.Alternate = UART5_RTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART5_RTS_PORT), &gpio_init_struct);
+        [UART_PIN_RTS] = {CSP_GPIO_PORT(UART5_RTS_PORT), UART5_RTS_PIN,
+                          UART5_RTS_GPIO_AF},
 #endif /* UART5_RTS */
-
-    __HAL_RCC_UART5_CLK_ENABLE();
+    },
 #if UART5_IT_ENABLE
-    HAL_NVIC_EnableIRQ(UART5_IRQn);
-    HAL_NVIC_SetPriority(UART5_IRQn, UART5_IT_PRIORITY, UART5_IT_SUB);
+    .irq = {1, UART5_IRQn, UART5_IT_PRIORITY, UART5_IT_SUB},
 #endif /* UART5_IT_ENABLE */
-
 #if UART5_RX_DMA
-    uart5_rx_fifo.head_ptr = 0;
-
-    uart5_rx_fifo.recv_buf = CSP_MALLOC(uart5_rx_fifo.buf_size);
-    if (uart5_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart5_rx_fifo.rx_fifo_buf = CSP_MALLOC(uart5_rx_fifo.fifo_size);
-    if (uart5_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart5_rx_fifo.rx_fifo = ring_fifo_init(
-        uart5_rx_fifo.rx_fifo_buf, uart5_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (uart5_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART5_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart5_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart5_handle, hdmarx, uart5_dmarx_handle);
-
-    HAL_NVIC_SetPriority(UART5_RX_DMA_IRQn, UART5_RX_DMA_IT_PRIORITY, UART5_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART5_RX_DMA_IRQn);
-
+    .dmarx = &uart5_dmarx_handle,
+    .dmarx_irq = {1, UART5_RX_DMA_IRQn, UART5_RX_DMA_IT_PRIORITY,
+                  UART5_RX_DMA_IT_SUB},
 #endif /* UART5_RX_DMA */
-
 #if UART5_TX_DMA
-    uart5_tx_buf.send_buf = CSP_MALLOC(uart5_tx_buf.buf_size);
-    if (uart5_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART5_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart5_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart5_handle, hdmatx, uart5_dmatx_handle);
-
-    HAL_NVIC_SetPriority(UART5_TX_DMA_IRQn, UART5_TX_DMA_IT_PRIORITY, UART5_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART5_TX_DMA_IRQn);
-
+    .dmatx = &uart5_dmatx_handle,
+    .dmatx_irq = {1, UART5_TX_DMA_IRQn, UART5_TX_DMA_IT_PRIORITY,
+                  UART5_TX_DMA_IT_SUB},
 #endif /* UART5_TX_DMA */
+};
 
-    if (HAL_UART_Init(&uart5_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if UART5_RX_DMA
-    __HAL_UART_ENABLE_IT(&uart5_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&uart5_handle);
-
-    HAL_UART_Receive_DMA(&uart5_handle, uart5_rx_fifo.recv_buf,
-                         uart5_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&uart5_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&uart5_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* UART5_RX_DMA */
-    return UART_INIT_OK;
+/**
+ * @brief UART5 initialization
+ *
+ * @param baud_rate Baud rate.
+ * @return UART5 init status.
+ *  @retval - 0: `UART_INIT_OK`:       Success.
+ *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
+ *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
+ *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
+ *                                    dynamic allocate memory when using DMA).
+ *  @retval - 4: `UART_INITED`:        This uart is inited.
+ */
+uint8_t uart5_init(uint32_t baud_rate) {
+    return uart_init(&uart5_desc, baud_rate);
 }
 
 #if UART5_IT_ENABLE
@@ -1514,71 +1010,7 @@ void UART5_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t uart5_deinit(void) {
-    if (HAL_UART_GetState(&uart5_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_UART5_CLK_DISABLE();
-
-#if UART5_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART5_TX_PORT), UART5_TX_PIN);
-#endif /* UART5_TX */
-
-#if UART5_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART5_RX_PORT), UART5_RX_PIN);
-#endif /* UART5_RX */
-
-#if UART5_CTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART5_CTS_PORT), UART5_CTS_PIN);
-#endif /* UART5_UART5_CTS */
-
-#if UART5_RTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART5_RTS_PORT), UART5_RTS_PIN);
-#endif /* UART5_RTS */
-
-#if UART5_IT_ENABLE
-    HAL_NVIC_DisableIRQ(UART5_IRQn);
-#endif /* UART5_IT_ENABLE */
-
-#if UART5_RX_DMA
-
-    HAL_DMA_Abort(&uart5_dmarx_handle);
-    CSP_FREE(uart5_rx_fifo.recv_buf);
-    CSP_FREE(uart5_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(uart5_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&uart5_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART5_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&uart5_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&uart5_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    uart5_handle.hdmarx = NULL;
-
-#endif /* UART5_RX_DMA */
-
-#if UART5_TX_DMA
-    HAL_DMA_Abort(&uart5_dmatx_handle);
-    CSP_FREE(uart5_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&uart5_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART5_TX_DMA_IRQn);
-
-    uart5_handle.hdmatx = NULL;
-#endif /* UART5_TX_DMA */
-
-    if (HAL_UART_DeInit(&uart5_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+    return uart_deinit(&uart5_desc);
 }
 
 #endif /* UART5_ENABLE */
@@ -1635,137 +1067,58 @@ static uart_tx_buf_t usart6_tx_buf = {.buf_size = USART6_TX_DMA_BUF_SIZE};
 
 #endif /* USART6_TX_DMA */
 
-/**
- * @brief USART6 initialization
- *
- * @param baud_rate Baud rate.
- * @return USART6 init status.
- *  @retval - 0: `UART_INIT_OK`:       Success.
- *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
- *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
- *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
- *                                    dynamic allocate memory when using DMA).
- *  @retval - 4: `UART_INITED`:        This uart is inited.
- */
-uint8_t usart6_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&usart6_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    usart6_handle.Init.BaudRate = baud_rate;
+/* Pins, clock and interrupts of USART6. */
+static const uart_desc_t usart6_desc = {
+    .huart = &usart6_handle,
+    .clk_reg = &RCC->APB2ENR,
+    .clk_bit = RCC_APB2ENR_USART6EN,
+    .pin = {
 #if USART6_TX
-    usart6_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(USART6_TX_PORT);
-    gpio_init_struct.Pin = USART6_TX_PIN;
-    gpio_init_struct.Alternate = USART6_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART6_TX_PORT), &gpio_init_struct);
+        [UART_PIN_TX] = {CSP_GPIO_PORT(USART6_TX_PORT), USART6_TX_PIN,
+                         USART6_TX_GPIO_AF},
 #endif /* USART6_TX */
-
 #if USART6_RX
-    usart6_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(USART6_RX_PORT);
-    gpio_init_struct.Pin = USART6_RX_PIN;
-    gpio_init_struct.Alternate = USART6_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART6_RX_PORT), &gpio_init_struct);
+        [UART_PIN_RX] = {CSP_GPIO_PORT(USART6_RX_PORT), USART6_RX_PIN,
+                         USART6_RX_GPIO_AF},
 #endif /* USART6_RX */
-
 #if USART6_CTS
-    usart6_handle.Init.HwFlowCtl |= UART_HWCONTROL_CTS;
-
-    CSP_GPIO_CLK_ENABLE(USART6_CTS_PORT);
-    gpio_init_struct.Pin = USART6_CTS_PIN;
-    gpio_init_struct.Alternate = USART6_CTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART6_CTS_PORT), &gpio_init_struct);
-#endif /* USART6_USART6_CTS */
-
+        [UART_PIN_CTS] = {CSP_GPIO_PORT(USART6_CTS_PORT), USART6_CTS_PIN,
+                          USART6_CTS_GPIO_AF},
+#endif /* USART6_CTS */
 #if USART6_RTS
-    usart6_handle.Init.HwFlowCtl |= UART_HWCONTROL_RTS;
-
-    CSP_GPIO_CLK_ENABLE(USART6_RTS_PORT);
-    gpio_init_struct.Pin = USART6_RTS_PIN;
-    gpio_init_struct.Alternate = USART6_RTS_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(USART6_RTS_PORT), &gpio_init_struct);
+        [UART_PIN_RTS] = {CSP_GPIO_PORT(USART6_RTS_PORT), USART6_RTS_PIN,
+                          USART6_RTS_GPIO_AF},
 #endif /* USART6_RTS */
-
-    __HAL_RCC_USART6_CLK_ENABLE();
+    },
 #if USART6_IT_ENABLE
-    HAL_NVIC_EnableIRQ(USART6_IRQn);
-    HAL_NVIC_SetPriority(USART6_IRQn, USART6_IT_PRIORITY, USART6_IT_SUB);
+    .irq = {1, USART6_IRQn, USART6_IT_PRIORITY, USART6_IT_SUB},
 #endif /* USART6_IT_ENABLE */
-
 #if USART6_RX_DMA
-    usart6_rx_fifo.head_ptr = 0;
-
-    usart6_rx_fifo.recv_buf = CSP_MALLOC(usart6_rx_fifo.buf_size);
-    if (usart6_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    usart6_rx_fifo.rx_fifo_buf = CSP_MALLOC(usart6_rx_fifo.fifo_size);
-    if (usart6_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    usart6_rx_fifo.rx_fifo = ring_fifo_init(
-        usart6_rx_fifo.rx_fifo_buf, usart6_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (usart6_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(USART6_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&usart6_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&usart6_handle, hdmarx, usart6_dmarx_handle);
-
-    HAL_NVIC_SetPriority(USART6_RX_DMA_IRQn, USART6_RX_DMA_IT_PRIORITY, USART6_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(USART6_RX_DMA_IRQn);
-
+    .dmarx = &usart6_dmarx_handle,
+    .dmarx_irq = {1, USART6_RX_DMA_IRQn, USART6_RX_DMA_IT_PRIORITY,
+                  USART6_RX_DMA_IT_SUB},
 #endif /* USART6_RX_DMA */
-
 #if USART6_TX_DMA
-    usart6_tx_buf.send_buf = CSP_MALLOC(usart6_tx_buf.buf_size);
-    if (usart6_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(USART6_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&usart6_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&usart6_handle, hdmatx, usart6_dmatx_handle);
-
-    HAL_NVIC_SetPriority(USART6_TX_DMA_IRQn, USART6_TX_DMA_IT_PRIORITY, USART6_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(USART6_TX_DMA_IRQn);
-
+    .dmatx = &usart6_dmatx_handle,
+    .dmatx_irq = {1, USART6_TX_DMA_IRQn, USART6_TX_DMA_IT_PRIORITY,
+                  USART6_TX_DMA_IT_SUB},
 #endif /* USART6_TX_DMA */
+};
 
-    if (HAL_UART_Init(&usart6_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if USART6_RX_DMA
-    __HAL_UART_ENABLE_IT(&usart6_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&usart6_handle);
-
-    HAL_UART_Receive_DMA(&usart6_handle, usart6_rx_fifo.recv_buf,
-                         usart6_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&usart6_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&usart6_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* USART6_RX_DMA */
-    return UART_INIT_OK;
+/**
+ * @brief USART6 initialization
+ *
+ * @param baud_rate Baud rate.
+ * @return USART6 init status.
+ *  @retval - 0: `UART_INIT_OK`:       Success.
+ *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
+ *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
+ *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
+ *                                    dynamic allocate memory when using DMA).
+ *  @retval - 4: `UART_INITED`:        This uart is inited.
+ */
+uint8_t usart6_init(uint32_t baud_rate) {
+    return uart_init(&usart6_desc, baud_rate);
 }
 
 #if USART6_IT_ENABLE
@@ -1805,85 +1158,21 @@ void USART6_RX_DMA_IRQHandler(void) {
  */
 void USART6_TX_DMA_IRQHandler(void) {
     HAL_DMA_IRQHandler(&usart6_dmatx_handle);
-}
-
-#endif /* USART6_TX_DMA */
-
-/**
- * @brief USART6 deinitialization.
- *
- * @return UART deinit status.
- *  @retval - 0: `UART_DEINIT_OK`:       Success.
- *  @retval - 1: `UART_DEINIT_FAIL`:     UART deinit failed.
- *  @retval - 2: `UART_DEINIT_DMA_FAIL`: UART DMA deinit failed.
- *  @retval - 3: `UART_NO_INIT`:         UART is not init.
- */
-uint8_t usart6_deinit(void) {
-    if (HAL_UART_GetState(&usart6_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_USART6_CLK_DISABLE();
-
-#if USART6_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART6_TX_PORT), USART6_TX_PIN);
-#endif /* USART6_TX */
-
-#if USART6_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART6_RX_PORT), USART6_RX_PIN);
-#endif /* USART6_RX */
-
-#if USART6_CTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART6_CTS_PORT), USART6_CTS_PIN);
-#endif /* USART6_USART6_CTS */
-
-#if USART6_RTS
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(USART6_RTS_PORT), USART6_RTS_PIN);
-#endif /* USART6_RTS */
-
-#if USART6_IT_ENABLE
-    HAL_NVIC_DisableIRQ(USART6_IRQn);
-#endif /* USART6_IT_ENABLE */
-
-#if USART6_RX_DMA
-
-    HAL_DMA_Abort(&usart6_dmarx_handle);
-    CSP_FREE(usart6_rx_fifo.recv_buf);
-    CSP_FREE(usart6_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(usart6_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&usart6_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(USART6_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&usart6_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&usart6_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    usart6_handle.hdmarx = NULL;
-
-#endif /* USART6_RX_DMA */
-
-#if USART6_TX_DMA
-    HAL_DMA_Abort(&usart6_dmatx_handle);
-    CSP_FREE(usart6_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&usart6_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(USART6_TX_DMA_IRQn);
+}
 
-    usart6_handle.hdmatx = NULL;
 #endif /* USART6_TX_DMA */
 
-    if (HAL_UART_DeInit(&usart6_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+/**
+ * @brief USART6 deinitialization.
+ *
+ * @return UART deinit status.
+ *  @retval - 0: `UART_DEINIT_OK`:       Success.
+ *  @retval - 1: `UART_DEINIT_FAIL`:     UART deinit failed.
+ *  @retval - 2: `UART_DEINIT_DMA_FAIL`: UART DMA deinit failed.
+ *  @retval - 3: `UART_NO_INIT`:         UART is not init.
+ */
+uint8_t usart6_deinit(void) {
+    return uart_deinit(&usart6_desc);
 }
 
 #endif /* USART6_ENABLE */
@@ -1940,6 +1229,36 @@ static uart_tx_buf_t uart7_tx_buf = {.buf_size = UART7_TX_DMA_BUF_SIZE};
 
 #endif /* UART7_TX_DMA */
 
+/* Pins, clock and interrupts of UART7. */
+static const uart_desc_t uart7_desc = {
+    .huart = &uart7_handle,
+    .clk_reg = &RCC->APB1ENR,
+    .clk_bit = RCC_APB1ENR_UART7EN,
+    .pin = {
+#if UART7_TX
+        [UART_PIN_TX] = {CSP_GPIO_PORT(UART7_TX_PORT), UART7_TX_PIN,
+                         UART7_TX_GPIO_AF},
+#endif /* UART7_TX */
+#if UART7_RX
+        [UART_PIN_RX] = {CSP_GPIO_PORT(UART7_RX_PORT), UART7_RX_PIN,
+                         UART7_RX_GPIO_AF},
+#endif /* UART7_RX */
+    },
+#if UART7_IT_ENABLE
+    .irq = {1, UART7_IRQn, UART7_IT_PRIORITY, UART7_IT_SUB},
+#endif /* UART7_IT_ENABLE */
+#if UART7_RX_DMA
+    .dmarx = &uart7_dmarx_handle,
+    .dmarx_irq = {1, UART7_RX_DMA_IRQn, UART7_RX_DMA_IT_PRIORITY,
+                  UART7_RX_DMA_IT_SUB},
+#endif /* UART7_RX_DMA */
+#if UART7_TX_DMA
+    .dmatx = &uart7_dmatx_handle,
+    .dmatx_irq = {1, UART7_TX_DMA_IRQn, UART7_TX_DMA_IT_PRIORITY,
+                  UART7_TX_DMA_IT_SUB},
+#endif /* UART7_TX_DMA */
+};
+
 /**
  * @brief UART7 initialization
  *
@@ -1953,106 +1272,7 @@ static uart_tx_buf_t uart7_tx_buf = {.buf_size = UART7_TX_DMA_BUF_SIZE};
  *  @retval - 4: `UART_INITED`:        This uart is inited.
  */
 uint8_t uart7_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&uart7_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    uart7_handle.Init.BaudRate = baud_rate;
-#if UART7_TX
-    uart7_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(UART7_TX_PORT);
-    gpio_init_struct.Pin = UART7_TX_PIN;
-    gpio_init_struct.Alternate = UART7_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART7_TX_PORT), &gpio_init_struct);
-#endif /* UART7_TX */
-
-#if UART7_RX
-    uart7_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(UART7_RX_PORT);
-    gpio_init_struct.Pin = UART7_RX_PIN;
-    gpio_init_struct.Alternate = UART7_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART7_RX_PORT), &gpio_init_struct);
-#endif /* UART7_RX */
-
-    __HAL_RCC_UART7_CLK_ENABLE();
-#if UART7_IT_ENABLE
-    HAL_NVIC_EnableIRQ(UART7_IRQn);
-    HAL_NVIC_SetPriority(UART7_IRQn, UART7_IT_PRIORITY, UART7_IT_SUB);
-#endif /* UART7_IT_ENABLE */
-
-#if UART7_RX_DMA
-    uart7_rx_fifo.head_ptr = 0;
-
-    uart7_rx_fifo.recv_buf = CSP_MALLOC(uart7_rx_fifo.buf_size);
-    if (uart7_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart7_rx_fifo.rx_fifo_buf = CSP_MALLOC(uart7_rx_fifo.fifo_size);
-    if (uart7_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart7_rx_fifo.rx_fifo = ring_fifo_init(
-        uart7_rx_fifo.rx_fifo_buf, uart7_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (uart7_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART7_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart7_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart7_handle, hdmarx, uart7_dmarx_handle);
-
-    HAL_NVIC_SetPriority(UART7_RX_DMA_IRQn, UART7_RX_DMA_IT_PRIORITY, UART7_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART7_RX_DMA_IRQn);
-
-#endif /* UART7_RX_DMA */
-
-#if UART7_TX_DMA
-    uart7_tx_buf.send_buf = CSP_MALLOC(uart7_tx_buf.buf_size);
-    if (uart7_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART7_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart7_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart7_handle, hdmatx, uart7_dmatx_handle);
-
-    HAL_NVIC_SetPriority(UART7_TX_DMA_IRQn, UART7_TX_DMA_IT_PRIORITY, UART7_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART7_TX_DMA_IRQn);
-
-#endif /* UART7_TX_DMA */
-
-    if (HAL_UART_Init(&uart7_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if UART7_RX_DMA
-    __HAL_UART_ENABLE_IT(&uart7_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&uart7_handle);
-
-    HAL_UART_Receive_DMA(&uart7_handle, uart7_rx_fifo.recv_buf,
-                         uart7_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&uart7_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&uart7_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* UART7_RX_DMA */
-    return UART_INIT_OK;
+    return uart_init(&uart7_desc, baud_rate);
 }
 
 #if UART7_IT_ENABLE
@@ -2106,63 +1326,7 @@ void UART7_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t uart7_deinit(void) {
-    if (HAL_UART_GetState(&uart7_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_UART7_CLK_DISABLE();
-
-#if UART7_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART7_TX_PORT), UART7_TX_PIN);
-#endif /* UART7_TX */
-
-#if UART7_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART7_RX_PORT), UART7_RX_PIN);
-#endif /* UART7_RX */
-
-#if UART7_IT_ENABLE
-    HAL_NVIC_DisableIRQ(UART7_IRQn);
-#endif /* UART7_IT_ENABLE */
-
-#if UART7_RX_DMA
-
-    HAL_DMA_Abort(&uart7_dmarx_handle);
-    CSP_FREE(uart7_rx_fifo.recv_buf);
-    CSP_FREE(uart7_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(uart7_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&uart7_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART7_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&uart7_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&uart7_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    uart7_handle.hdmarx = NULL;
-
-#endif /* UART7_RX_DMA */
-
-#if UART7_TX_DMA
-    HAL_DMA_Abort(&uart7_dmatx_handle);
-    CSP_FREE(uart7_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&uart7_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART7_TX_DMA_IRQn);
-
-    uart7_handle.hdmatx = NULL;
-#endif /* UART7_TX_DMA */
-
-    if (HAL_UART_DeInit(&uart7_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+    return uart_deinit(&uart7_desc);
 }
 
 #endif /* UART7_ENABLE */
@@ -2219,6 +1383,36 @@ static uart_tx_buf_t uart8_tx_buf = {.buf_size = UART8_TX_DMA_BUF_SIZE};
 
 #endif /* UART8_TX_DMA */
 
+/* Pins, clock and interrupts of UART8. */
+static const uart_desc_t uart8_desc = {
+    .huart = &uart8_handle,
+    .clk_reg = &RCC->APB1ENR,
+    .clk_bit = RCC_APB1ENR_UART8EN,
+    .pin = {
+#if UART8_TX
+        [UART_PIN_TX] = {CSP_GPIO_PORT(UART8_TX_PORT), UART8_TX_PIN,
+                         UART8_TX_GPIO_AF},
+#endif /* UART8_TX */
+#if UART8_RX
+        [UART_PIN_RX] = {CSP_GPIO_PORT(UART8_RX_PORT), UART8_RX_PIN,
+                         UART8_RX_GPIO_AF},
+#endif /* UART8_RX */
+    },
+#if UART8_IT_ENABLE
+    .irq = {1, UART8_IRQn, UART8_IT_PRIORITY, UART8_IT_SUB},
+#endif /* UART8_IT_ENABLE */
+#if UART8_RX_DMA
+    .dmarx = &uart8_dmarx_handle,
+    .dmarx_irq = {1, UART8_RX_DMA_IRQn, UART8_RX_DMA_IT_PRIORITY,
+                  UART8_RX_DMA_IT_SUB},
+#endif /* UART8_RX_DMA */
+#if UART8_TX_DMA
+    .dmatx = &uart8_dmatx_handle,
+    .dmatx_irq = {1, UART8_TX_DMA_IRQn, UART8_TX_DMA_IT_PRIORITY,
+                  UART8_TX_DMA_IT_SUB},
+#endif /* UART8_TX_DMA */
+};
+
 /**
  * @brief UART8 initialization
  *
@@ -2232,106 +1426,7 @@ static uart_tx_buf_t uart8_tx_buf = {.buf_size = UART8_TX_DMA_BUF_SIZE};
  *  @retval - 4: `UART_INITED`:        This uart is inited.
  */
 uint8_t uart8_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&uart8_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    uart8_handle.Init.BaudRate = baud_rate;
-#if UART8_TX
-    uart8_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(UART8_TX_PORT);
-    gpio_init_struct.Pin = UART8_TX_PIN;
-    gpio_init_struct.Alternate = UART8_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART8_TX_PORT), &gpio_init_struct);
-#endif /* UART8_TX */
-
-#if UART8_RX
-    uart8_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(UART8_RX_PORT);
-    gpio_init_struct.Pin = UART8_RX_PIN;
-    gpio_init_struct.Alternate = UART8_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART8_RX_PORT), &gpio_init_struct);
-#endif /* UART8_RX */
-
-    __HAL_RCC_UART8_CLK_ENABLE();
-#if UART8_IT_ENABLE
-    HAL_NVIC_EnableIRQ(UART8_IRQn);
-    HAL_NVIC_SetPriority(UART8_IRQn, UART8_IT_PRIORITY, UART8_IT_SUB);
-#endif /* UART8_IT_ENABLE */
-
-#if UART8_RX_DMA
-    uart8_rx_fifo.head_ptr = 0;
-
-    uart8_rx_fifo.recv_buf = CSP_MALLOC(uart8_rx_fifo.buf_size);
-    if (uart8_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart8_rx_fifo.rx_fifo_buf = CSP_MALLOC(uart8_rx_fifo.fifo_size);
-    if (uart8_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart8_rx_fifo.rx_fifo = ring_fifo_init(
-        uart8_rx_fifo.rx_fifo_buf, uart8_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (uart8_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART8_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart8_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart8_handle, hdmarx, uart8_dmarx_handle);
-
-    HAL_NVIC_SetPriority(UART8_RX_DMA_IRQn, UART8_RX_DMA_IT_PRIORITY, UART8_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART8_RX_DMA_IRQn);
-
-#endif /* UART8_RX_DMA */
-
-#if UART8_TX_DMA
-    uart8_tx_buf.send_buf = CSP_MALLOC(uart8_tx_buf.buf_size);
-    if (uart8_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART8_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart8_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart8_handle, hdmatx, uart8_dmatx_handle);
-
-    HAL_NVIC_SetPriority(UART8_TX_DMA_IRQn, UART8_TX_DMA_IT_PRIORITY, UART8_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART8_TX_DMA_IRQn);
-
-#endif /* UART8_TX_DMA */
-
-    if (HAL_UART_Init(&uart8_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if UART8_RX_DMA
-    __HAL_UART_ENABLE_IT(&uart8_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&uart8_handle);
-
-    HAL_UART_Receive_DMA(&uart8_handle, uart8_rx_fifo.recv_buf,
-                         uart8_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&uart8_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&uart8_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* UART8_RX_DMA */
-    return UART_INIT_OK;
+    return uart_init(&uart8_desc, baud_rate);
 }
 
 #if UART8_IT_ENABLE
@@ -2385,63 +1480,7 @@ void UART8_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t uart8_deinit(void) {
-    if (HAL_UART_GetState(&uart8_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_UART8_CLK_DISABLE();
-
-#if UART8_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART8_TX_PORT), UART8_TX_PIN);
-#endif /* UART8_TX */
-
-#if UART8_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART8_RX_PORT), UART8_RX_PIN);
-#endif /* UART8_RX */
-
-#if UART8_IT_ENABLE
-    HAL_NVIC_DisableIRQ(UART8_IRQn);
-#endif /* UART8_IT_ENABLE */
-
-#if UART8_RX_DMA
-
-    HAL_DMA_Abort(&uart8_dmarx_handle);
-    CSP_FREE(uart8_rx_fifo.recv_buf);
-    CSP_FREE(uart8_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(uart8_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&uart8_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART8_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&uart8_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&uart8_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    uart8_handle.hdmarx = NULL;
-
-#endif /* UART8_RX_DMA */
-
-#if UART8_TX_DMA
-    HAL_DMA_Abort(&uart8_dmatx_handle);
-    CSP_FREE(uart8_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&uart8_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART8_TX_DMA_IRQn);
-
-    uart8_handle.hdmatx = NULL;
-#endif /* UART8_TX_DMA */
-
-    if (HAL_UART_DeInit(&uart8_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+    return uart_deinit(&uart8_desc);
 }
 
 #endif /* UART8_ENABLE */
@@ -2498,119 +1537,50 @@ static uart_tx_buf_t uart9_tx_buf = {.buf_size = UART9_TX_DMA_BUF_SIZE};
 
 #endif /* UART9_TX_DMA */
 
-/**
- * @brief UART9 initialization
- *
- * @param baud_rate Baud rate.
- * @return UART9 init status.
- *  @retval - 0: `UART_INIT_OK`:       Success.
- *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
- *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
- *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
- *                                    dynamic allocate memory when using DMA).
- *  @retval - 4: `UART_INITED`:        This uart is inited.
- */
-uint8_t uart9_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&uart9_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    uart9_handle.Init.BaudRate = baud_rate;
+/* Pins, clock and interrupts of UART9. */
+static const uart_desc_t uart9_desc = {
+    .huart = &uart9_handle,
+    .clk_reg = &RCC->APB2ENR,
+    .clk_bit = RCC_APB2ENR_UART9EN,
+    .pin = {
 #if UART9_TX
-    uart9_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(UART9_TX_PORT);
-    gpio_init_struct.Pin = UART9_TX_PIN;
-    gpio_init_struct.Alternate = UART9_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART9_TX_PORT), &gpio_init_struct);
+        [UART_PIN_TX] = {CSP_GPIO_PORT(UART9_TX_PORT), UART9_TX_PIN,
+                         UART9_TX_GPIO_AF},
 #endif /* UART9_TX */
-
 #if UART9_RX
-    uart9_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(UART9_RX_PORT);
-    gpio_init_struct.Pin = UART9_RX_PIN;
-    gpio_init_struct.Alternate = UART9_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART9_RX_PORT), &gpio_init_struct);
+        [UART_PIN_RX] = {CSP_GPIO_PORT(UART9_RX_PORT), UART9_RX_PIN,
+                         UART9_RX_GPIO_AF},
 #endif /* UART9_RX */
-
-    __HAL_RCC_UART9_CLK_ENABLE();
+    },
 #if UART9_IT_ENABLE
-    HAL_NVIC_EnableIRQ(UART9_IRQn);
-    HAL_NVIC_SetPriority(UART9_IRQn, UART9_IT_PRIORITY, UART9_IT_SUB);
+    .irq = {1, UART9_IRQn, UART9_IT_PRIORITY, UART9_IT_SUB},
 #endif /* UART9_IT_ENABLE */
-
 #if UART9_RX_DMA
-    uart9_rx_fifo.head_ptr = 0;
-
-    uart9_rx_fifo.recv_buf = CSP_MALLOC(uart9_rx_fifo.buf_size);
-    if (uart9_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart9_rx_fifo.rx_fifo_buf = CSP_MALLOC(uart9_rx_fifo.fifo_size);
-    if (uart9_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart9_rx_fifo.rx_fifo = ring_fifo_init(
-        uart9_rx_fifo.rx_fifo_buf, uart9_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (uart9_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART9_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart9_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart9_handle, hdmarx, uart9_dmarx_handle);
-
-    HAL_NVIC_SetPriority(UART9_RX_DMA_IRQn, UART9_RX_DMA_IT_PRIORITY, UART9_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART9_RX_DMA_IRQn);
-
+    .dmarx = &uart9_dmarx_handle,
+    .dmarx_irq = {1, UART9_RX_DMA_IRQn, UART9_RX_DMA_IT_PRIORITY,
+                  UART9_RX_DMA_IT_SUB},
 #endif /* UART9_RX_DMA */
-
 #if UART9_TX_DMA
-    uart9_tx_buf.send_buf = CSP_MALLOC(uart9_tx_buf.buf_size);
-    if (uart9_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART9_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart9_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart9_handle, hdmatx, uart9_dmatx_handle);
-
-    HAL_NVIC_SetPriority(UART9_TX_DMA_IRQn, UART9_TX_DMA_IT_PRIORITY, UART9_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART9_TX_DMA_IRQn);
-
+    .dmatx = &uart9_dmatx_handle,
+    .dmatx_irq = {1, UART9_TX_DMA_IRQn, UART9_TX_DMA_IT_PRIORITY,
+                  UART9_TX_DMA_IT_SUB},
 #endif /* UART9_TX_DMA */
+};
 
-    if (HAL_UART_Init(&uart9_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if UART9_RX_DMA
-    __HAL_UART_ENABLE_IT(&uart9_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&uart9_handle);
-
-    HAL_UART_Receive_DMA(&uart9_handle, uart9_rx_fifo.recv_buf,
-                         uart9_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&uart9_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&uart9_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* UART9_RX_DMA */
-    return UART_INIT_OK;
+/**
+ * @brief UART9 initialization
+ *
+ * @param baud_rate Baud rate.
+ * @return UART9 init status.
+ *  @retval - 0: `UART_INIT_OK`:       Success.
+ *  @retval - 1: `UART_INIT_FAIL`:     UART init failed.
+ *  @retval - 2: `UART_INIT_DMA_FAIL`: UART DMA init failed.
+ *  @retval - 3: `UART_INIT_MEM_FAIL`: UART buffer memory init failed (It will
+ *                                    dynamic allocate memory when using DMA).
+ *  @retval - 4: `UART_INITED`:        This uart is inited.
+ */
+uint8_t uart9_init(uint32_t baud_rate) {
+    return uart_init(&uart9_desc, baud_rate);
 }
 
 #if UART9_IT_ENABLE
@@ -2664,63 +1634,7 @@ void UART9_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t uart9_deinit(void) {
-    if (HAL_UART_GetState(&uart9_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_UART9_CLK_DISABLE();
-
-#if UART9_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART9_TX_PORT), UART9_TX_PIN);
-#endif /* UART9_TX */
-
-#if UART9_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART9_RX_PORT), UART9_RX_PIN);
-#endif /* UART9_RX */
-
-#if UART9_IT_ENABLE
-    HAL_NVIC_DisableIRQ(UART9_IRQn);
-#endif /* UART9_IT_ENABLE */
-
-#if UART9_RX_DMA
-
-    HAL_DMA_Abort(&uart9_dmarx_handle);
-    CSP_FREE(uart9_rx_fifo.recv_buf);
-    CSP_FREE(uart9_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(uart9_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&uart9_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART9_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&uart9_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&uart9_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    uart9_handle.hdmarx = NULL;
-
-#endif /* UART9_RX_DMA */
-
-#if UART9_TX_DMA
-    HAL_DMA_Abort(&uart9_dmatx_handle);
-    CSP_FREE(uart9_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&uart9_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART9_TX_DMA_IRQn);
-
-    uart9_handle.hdmatx = NULL;
-#endif /* UART9_TX_DMA */
-
-    if (HAL_UART_DeInit(&uart9_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+    return uart_deinit(&uart9_desc);
 }
 
 #endif /* UART9_ENABLE */
@@ -2777,6 +1691,36 @@ static uart_tx_buf_t uart10_tx_buf = {.buf_size = UART10_TX_DMA_BUF_SIZE};
 
 #endif /* UART10_TX_DMA */
 
+/* Pins, clock and interrupts of UART10. */
+static const uart_desc_t uart10_desc = {
+    .huart = &uart10_handle,
+    .clk_reg = &RCC->APB2ENR,
+    .clk_bit = RCC_APB2ENR_UART10EN,
+    .pin = {
+#if UART10_TX
+        [UART_PIN_TX] = {CSP_GPIO_PORT(UART10_TX_PORT), UART10_TX_PIN,
+                         UART10_TX_GPIO_AF},
+#endif /* UART10_TX */
+#if UART10_RX
+        [UART_PIN_RX] = {CSP_GPIO_PORT(UART10_RX_PORT), UART10_RX_PIN,
+                         UART10_RX_GPIO_AF},
+#endif /* UART10_RX */
+    },
+#if UART10_IT_ENABLE
+    .irq = {1, UART10_IRQn, UART10_IT_PRIORITY, UART10_IT_SUB},
+#endif /* UART10_IT_ENABLE */
+#if UART10_RX_DMA
+    .dmarx = &uart10_dmarx_handle,
+    .dmarx_irq = {1, UART10_RX_DMA_IRQn, UART10_RX_DMA_IT_PRIORITY,
+                  UART10_RX_DMA_IT_SUB},
+#endif /* UART10_RX_DMA */
+#if UART10_TX_DMA
+    .dmatx = &uart10_dmatx_handle,
+    .dmatx_irq = {1, UART10_TX_DMA_IRQn, UART10_TX_DMA_IT_PRIORITY,
+                  UART10_TX_DMA_IT_SUB},
+#endif /* UART10_TX_DMA */
+};
+
 /**
  * @brief UART10 initialization
  *
@@ -2790,106 +1734,7 @@ static uart_tx_buf_t uart10_tx_buf = {.buf_size = UART10_TX_DMA_BUF_SIZE};
  *  @retval - 4: `UART_INITED`:        This uart is inited.
  */
 uint8_t uart10_init(uint32_t baud_rate) {
-    if (HAL_UART_GetState(&uart10_handle) != HAL_UART_STATE_RESET) {
-        return UART_INITED;
-    }
-
-    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
-                                         .Speed = GPIO_SPEED_FREQ_HIGH,
-                                         .Mode = GPIO_MODE_AF_PP};
-    uart10_handle.Init.BaudRate = baud_rate;
-#if UART10_TX
-    uart10_handle.Init.Mode |= UART_MODE_TX;
-
-    CSP_GPIO_CLK_ENABLE(UART10_TX_PORT);
-    gpio_init_struct.Pin = UART10_TX_PIN;
-    gpio_init_struct.Alternate = UART10_TX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART10_TX_PORT), &gpio_init_struct);
-#endif /* UART10_TX */
-
-#if UART10_RX
-    uart10_handle.Init.Mode |= UART_MODE_RX;
-
-    CSP_GPIO_CLK_ENABLE(UART10_RX_PORT);
-    gpio_init_struct.Pin = UART10_RX_PIN;
-    gpio_init_struct.Alternate = UART10_RX_GPIO_AF;
-    HAL_GPIO_Init(CSP_GPIO_PORT(UART10_RX_PORT), &gpio_init_struct);
-#endif /* UART10_RX */
-
-    __HAL_RCC_UART10_CLK_ENABLE();
-#if UART10_IT_ENABLE
-    HAL_NVIC_EnableIRQ(UART10_IRQn);
-    HAL_NVIC_SetPriority(UART10_IRQn, UART10_IT_PRIORITY, UART10_IT_SUB);
-#endif /* UART10_IT_ENABLE */
-
-#if UART10_RX_DMA
-    uart10_rx_fifo.head_ptr = 0;
-
-    uart10_rx_fifo.recv_buf = CSP_MALLOC(uart10_rx_fifo.buf_size);
-    if (uart10_rx_fifo.recv_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart10_rx_fifo.rx_fifo_buf = CSP_MALLOC(uart10_rx_fifo.fifo_size);
-    if (uart10_rx_fifo.rx_fifo_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    uart10_rx_fifo.rx_fifo = ring_fifo_init(
-        uart10_rx_fifo.rx_fifo_buf, uart10_rx_fifo.fifo_size, RF_TYPE_STREAM);
-    if (uart10_rx_fifo.rx_fifo == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART10_RX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart10_dmarx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart10_handle, hdmarx, uart10_dmarx_handle);
-
-    HAL_NVIC_SetPriority(UART10_RX_DMA_IRQn, UART10_RX_DMA_IT_PRIORITY, UART10_RX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART10_RX_DMA_IRQn);
-
-#endif /* UART10_RX_DMA */
-
-#if UART10_TX_DMA
-    uart10_tx_buf.send_buf = CSP_MALLOC(uart10_tx_buf.buf_size);
-    if (uart10_tx_buf.send_buf == NULL) {
-        return UART_INIT_MEM_FAIL;
-    }
-
-    CSP_DMA_CLK_ENABLE(UART10_TX_DMA_NUMBER);
-    if (HAL_DMA_Init(&uart10_dmatx_handle) != HAL_OK) {
-        return UART_INIT_DMA_FAIL;
-    }
-
-    __HAL_LINKDMA(&uart10_handle, hdmatx, uart10_dmatx_handle);
-
-    HAL_NVIC_SetPriority(UART10_TX_DMA_IRQn, UART10_TX_DMA_IT_PRIORITY, UART10_TX_DMA_IT_SUB);
-    HAL_NVIC_EnableIRQ(UART10_TX_DMA_IRQn);
-
-#endif /* UART10_TX_DMA */
-
-    if (HAL_UART_Init(&uart10_handle) != HAL_OK) {
-        return UART_INIT_FAIL;
-    }
-    
-#if UART10_RX_DMA
-    __HAL_UART_ENABLE_IT(&uart10_handle, UART_IT_IDLE);
-    __HAL_UART_CLEAR_IDLEFLAG(&uart10_handle);
-
-    HAL_UART_Receive_DMA(&uart10_handle, uart10_rx_fifo.recv_buf,
-                         uart10_rx_fifo.buf_size);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_RegisterCallback(&uart10_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID,
-                              uart_dmarx_halfdone_callback);
-    HAL_UART_RegisterCallback(&uart10_handle, HAL_UART_RX_COMPLETE_CB_ID,
-                              uart_dmarx_done_callback);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-#endif /* UART10_RX_DMA */
-    return UART_INIT_OK;
+    return uart_init(&uart10_desc, baud_rate);
 }
 
 #if UART10_IT_ENABLE
@@ -2943,63 +1788,7 @@ void UART10_TX_DMA_IRQHandler(void) {
  *  @retval - 3: `UART_NO_INIT`:         UART is not init.
  */
 uint8_t uart10_deinit(void) {
-    if (HAL_UART_GetState(&uart10_handle) == HAL_UART_STATE_RESET) {
-        return UART_NO_INIT;
-    }
-
-    __HAL_RCC_UART10_CLK_DISABLE();
-
-#if UART10_TX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART10_TX_PORT), UART10_TX_PIN);
-#endif /* UART10_TX */
-
-#if UART10_RX
-    HAL_GPIO_DeInit(CSP_GPIO_PORT(UART10_RX_PORT), UART10_RX_PIN);
-#endif /* UART10_RX */
-
-#if UART10_IT_ENABLE
-    HAL_NVIC_DisableIRQ(UART10_IRQn);
-#endif /* UART10_IT_ENABLE */
-
-#if UART10_RX_DMA
-
-    HAL_DMA_Abort(&uart10_dmarx_handle);
-    CSP_FREE(uart10_rx_fifo.recv_buf);
-    CSP_FREE(uart10_rx_fifo.rx_fifo_buf);
-    ring_fifo_destroy(uart10_rx_fifo.rx_fifo);
-
-    if (HAL_DMA_DeInit(&uart10_dmarx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART10_RX_DMA_IRQn);
-
-#if USE_HAL_UART_REGISTER_CALLBACKS
-    HAL_UART_UnRegisterCallback(&uart10_handle, HAL_UART_RX_HALFCOMPLETE_CB_ID);
-    HAL_UART_UnRegisterCallback(&uart10_handle, HAL_UART_RX_COMPLETE_CB_ID);
-#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
-    uart10_handle.hdmarx = NULL;
-
-#endif /* UART10_RX_DMA */
-
-#if UART10_TX_DMA
-    HAL_DMA_Abort(&uart10_dmatx_handle);
-    CSP_FREE(uart10_tx_buf.send_buf);
-
-    if (HAL_DMA_DeInit(&uart10_dmatx_handle) != HAL_OK) {
-        return UART_DEINIT_DMA_FAIL;
-    }
-
-    HAL_NVIC_DisableIRQ(UART10_TX_DMA_IRQn);
-
-    uart10_handle.hdmatx = NULL;
-#endif /* UART10_TX_DMA */
-
-    if (HAL_UART_DeInit(&uart10_handle) != HAL_OK) {
-        return UART_DEINIT_FAIL;
-    }
-
-    return UART_DEINIT_OK;
+    return uart_deinit(&uart10_desc);
 }
 
 #endif /* UART10_ENABLE */
@@ -3018,8 +1807,9 @@ uint8_t uart10_deinit(void) {
  *
  * @param huart The handle of UART.
  * @param __format The string with format.
- * @return The number of characters that would have been written in the
- *         array, not counting the terminating null character.
+ * @return The number of characters written, not counting the terminating
+ *         null character. 0 if the DMA Tx buf is full.
+ * @note It does not wait for the last transfer when using DMA Tx.
  */
 int uart_printf(UART_HandleTypeDef *huart, const char *__format, ...) {
     int len;
@@ -3030,16 +1820,23 @@ int uart_printf(UART_HandleTypeDef *huart, const char *__format, ...) {
         return 0;
     }
 
-    /* Wait for last transfer end. */
-    while (__HAL_UART_GET_FLAG(huart, UART_FLAG_TC) == RESET)
-        ;
-
     va_start(ap, __format);
     len = vsnprintf(uart_buffer, sizeof(uart_buffer), __format, ap);
     va_end(ap);
 
+    if (len < 0) {
+        return 0;
+    }
+
+    if (len >= (int)sizeof(uart_buffer)) {
+        /* Truncated by `vsnprintf`. */
+        len = sizeof(uart_buffer) - 1;
+    }
+
     if (huart->hdmatx != NULL) {
-        HAL_UART_Transmit_DMA(huart, (uint8_t *)uart_buffer, len);
+        /* Copied into the DMA Tx buf, return 0 if it is full. */
+        len = (int)uart_dmatx_write(huart, uart_buffer, len);
+        uart_dmatx_send(huart);
     } else {
         HAL_UART_Transmit(huart, (uint8_t *)uart_buffer, len, 1000);
     }
@@ -3092,79 +1889,52 @@ int uart_scanf(UART_HandleTypeDef *huart, const char *__format, ...) {
  * @{
  */
 
-/**
- * @brief Identify the UART receive fifo by handle.
- *
- * @param huart The handle of UART
- * @return The point of UART rx fifo.
- */
-static inline uart_rx_fifo_t *uart_rx_identify(UART_HandleTypeDef *huart) {
-    switch ((uintptr_t)huart->Instance) {
+/* clang-format off */
 
+/* Receive fifo of each UART, indexed by `UART_REG_INDEX`. */
+static uart_rx_fifo_t *const uart_rx_reg[UART_REG_SIZE] = {
 #if USART1_RX_DMA
-        case USART1_BASE: {
-            return &usart1_rx_fifo;
-        }
+    [UART_REG_INDEX(USART1_BASE)] = &usart1_rx_fifo,
 #endif /* USART1_RX_DMA */
-
 #if USART2_RX_DMA
-        case USART2_BASE: {
-            return &usart2_rx_fifo;
-        }
+    [UART_REG_INDEX(USART2_BASE)] = &usart2_rx_fifo,
 #endif /* USART2_RX_DMA */
 #if USART3_RX_DMA
-        case USART3_BASE: {
-            return &usart3_rx_fifo;
-        }
+    [UART_REG_INDEX(USART3_BASE)] = &usart3_rx_fifo,
 #endif /* USART3_RX_DMA */
-
 #if UART4_RX_DMA
-        case UART4_BASE: {
-            return &uart4_rx_fifo;
-        }
+    [UART_REG_INDEX(UART4_BASE)] = &uart4_rx_fifo,
 #endif /* UART4_RX_DMA */
-
 #if UART5_RX_DMA
-        case UART5_BASE: {
-            return &uart5_rx_fifo;
-        }
+    [UART_REG_INDEX(UART5_BASE)] = &uart5_rx_fifo,
 #endif /* UART5_RX_DMA */
-
 #if USART6_RX_DMA
-        case USART6_BASE: {
-            return &usart6_rx_fifo;
-        }
+    [UART_REG_INDEX(USART6_BASE)] = &usart6_rx_fifo,
 #endif /* USART6_RX_DMA */
-
 #if UART7_RX_DMA
-        case UART7_BASE: {
-            return &uart7_rx_fifo;
-        }
+    [UART_REG_INDEX(UART7_BASE)] = &uart7_rx_fifo,
 #endif /* UART7_RX_DMA */
-
 #if UART8_RX_DMA
-        case UART8_BASE: {
-            return &uart8_rx_fifo;
-        }
+    [UART_REG_INDEX(UART8_BASE)] = &uart8_rx_fifo,
 #endif /* UART8_RX_DMA */
-
 #if UART9_RX_DMA
-        case UART9_BASE: {
-            return &uart9_rx_fifo;
-        }
+    [UART_REG_INDEX(UART9_BASE)] = &uart9_rx_fifo,
 #endif /* UART9_RX_DMA */
-
 #if UART10_RX_DMA
-        case UART10_BASE: {
-            return &uart10_rx_fifo;
-        }
+    [UART_REG_INDEX(UART10_BASE)] = &uart10_rx_fifo,
 #endif /* UART10_RX_DMA */
+};
 
-        default: {
-        } break;
-    }
+/* clang-format on */
 
-    return NULL;
+/**
+ * @brief Identify the UART receive fifo by handle.
+ *
+ * @param huart The handle of UART
+ * @return The point of UART rx fifo.
+ */
+static inline uart_rx_fifo_t *uart_rx_identify(UART_HandleTypeDef *huart) {
+    return uart_rx_reg[UART_REG_INDEX(huart->Instance)];
 }
 
 /**
@@ -3197,7 +1967,14 @@ void uart_dmarx_idle_callback(UART_HandleTypeDef *huart) {
     copy = tail_ptr - offset;
     uart_rx_fifo->head_ptr += copy;
 
-    ring_fifo_write(uart_rx_fifo->rx_fifo, huart->pRxBuffPtr + offset, copy);
+    if (!uart_rx_fifo->zero_copy) {
+        ring_fifo_write(uart_rx_fifo->rx_fifo, huart->pRxBuffPtr + offset,
+                        copy);
+    }
+
+    if ((copy != 0) && (uart_rx_fifo->event_callback != NULL)) {
+        uart_rx_fifo->event_callback(huart);
+    }
 }
 
 /**
@@ -3230,7 +2007,14 @@ void uart_dmarx_halfdone_callback(UART_HandleTypeDef *huart) {
     copy = tail_ptr - offset;
     uart_rx_fifo->head_ptr += copy;
 
-    ring_fifo_write(uart_rx_fifo->rx_fifo, huart->pRxBuffPtr + offset, copy);
+    if (!uart_rx_fifo->zero_copy) {
+        ring_fifo_write(uart_rx_fifo->rx_fifo, huart->pRxBuffPtr + offset,
+                        copy);
+    }
+
+    if ((copy != 0) && (uart_rx_fifo->event_callback != NULL)) {
+        uart_rx_fifo->event_callback(huart);
+    }
 }
 
 /**
@@ -3263,7 +2047,14 @@ void uart_dmarx_done_callback(UART_HandleTypeDef *huart) {
     copy = tail_ptr - offset;
     uart_rx_fifo->head_ptr += copy;
 
-    ring_fifo_write(uart_rx_fifo->rx_fifo, huart->pRxBuffPtr + offset, copy);
+    if (!uart_rx_fifo->zero_copy) {
+        ring_fifo_write(uart_rx_fifo->rx_fifo, huart->pRxBuffPtr + offset,
+                        copy);
+    }
+
+    if ((copy != 0) && (uart_rx_fifo->event_callback != NULL)) {
+        uart_rx_fifo->event_callback(huart);
+    }
 
     if (huart->hdmarx->Init.Mode != DMA_CIRCULAR) {
         /* Reopen the DMA receive. */
@@ -3275,25 +2066,142 @@ void uart_dmarx_done_callback(UART_HandleTypeDef *huart) {
 }
 
 /**
- * @brief Read from UART Receive fifo.
+ * @brief Read from UART Receive fifo.
+ *
+ * @param huart The handle of UART
+ * @param[out] buf The data buf which receive the data from the fifo.
+ * @param buf_size The size of buf.
+ * @return The length that be received.
+ */
+uint32_t uart_dmarx_read(UART_HandleTypeDef *huart, void *buf,
+                         size_t buf_size) {
+    if ((buf == NULL) || (buf_size == 0)) {
+        return 0;
+    }
+    uart_rx_fifo_t *uart_rx_fifo = uart_rx_identify(huart);
+
+    if (uart_rx_fifo == NULL) {
+        return 0;
+    }
+
+    return ring_fifo_read(uart_rx_fifo->rx_fifo, buf, buf_size);
+}
+
+/**
+ * @brief Get the count of bytes written by DMA since initialization.
+ *
+ * @param huart The handle of UART
+ * @param uart_rx_fifo The receive fifo of UART.
+ * @return The DMA write pointer, same unit as `head_ptr`.
+ * @note `head_ptr` is updated at least every half buffer, the DMA can not be
+ *       a whole buffer ahead of it, so NDTR is enough to locate the DMA.
+ */
+static inline uint32_t uart_dmarx_dma_ptr(UART_HandleTypeDef *huart,
+                                          uart_rx_fifo_t *uart_rx_fifo) {
+    uint32_t size = huart->RxXferSize;
+    uint32_t head_ptr = uart_rx_fifo->head_ptr;
+    uint32_t tail_ptr = size - __HAL_DMA_GET_COUNTER(huart->hdmarx);
+
+    return head_ptr + (tail_ptr + size - head_ptr % size) % size;
+}
+
+/**
+ * @brief Get the received data in the DMA buffer without copy.
+ *
+ * @param huart The handle of UART
+ * @param[out] span Up to two spans of received data in the DMA buffer, the
+ *                  second one is used when the data wraps around. Unused
+ *                  spans are set to length 0.
+ * @return The total length of the spans.
+ * @note After the first call, the received data no longer goes into the
+ *       receive fifo, `uart_dmarx_read` only returns the data received
+ *       before. Call `uart_dmarx_consume` after the data is processed.
+ *       If the DMA laps the unread data, it is dropped and counted as
+ *       overrun.
+ */
+uint32_t uart_dmarx_peek(UART_HandleTypeDef *huart, uart_rx_span_t span[2]) {
+    span[0].len = 0;
+    span[1].len = 0;
+
+    uart_rx_fifo_t *uart_rx_fifo = uart_rx_identify(huart);
+    if ((uart_rx_fifo == NULL) || (huart->hdmarx == NULL)) {
+        return 0;
+    }
+
+    if (!uart_rx_fifo->zero_copy) {
+        /* Data before `head_ptr` is in the fifo already. */
+        uart_rx_fifo->read_ptr = uart_rx_fifo->head_ptr;
+        uart_rx_fifo->zero_copy = 1;
+    }
+
+    uint32_t size = huart->RxXferSize;
+    uint32_t dma_ptr = uart_dmarx_dma_ptr(huart, uart_rx_fifo);
+    uint32_t len = dma_ptr - uart_rx_fifo->read_ptr;
+
+    if (len > size) {
+        /* The DMA has overwritten the unread data, skip to the newest. */
+        ++uart_rx_fifo->overrun;
+        uart_rx_fifo->read_ptr = dma_ptr;
+        return 0;
+    }
+
+    uint32_t offset = uart_rx_fifo->read_ptr % size;
+
+    span[0].data = huart->pRxBuffPtr + offset;
+    span[0].len = (offset + len > size) ? (size - offset) : len;
+    span[1].data = huart->pRxBuffPtr;
+    span[1].len = len - span[0].len;
+
+    return len;
+}
+
+/**
+ * @brief Release the data got by `uart_dmarx_peek`.
+ *
+ * @param huart The handle of UART
+ * @param len The length to release, from the start of the first span.
+ * @return Consume message:
+ *  @retval - 0: Success.
+ *  @retval - 1: This uart not enable DMA Rx.
+ *  @retval - 2: Overrun, the DMA overwrote the data before it is released,
+ *               the data read in place may be broken.
+ *  @retval - 3: Parameter error, `len` is longer than the received data.
+ */
+uint8_t uart_dmarx_consume(UART_HandleTypeDef *huart, uint32_t len) {
+    uart_rx_fifo_t *uart_rx_fifo = uart_rx_identify(huart);
+    if ((uart_rx_fifo == NULL) || (huart->hdmarx == NULL)) {
+        return 1;
+    }
+
+    uint32_t dma_ptr = uart_dmarx_dma_ptr(huart, uart_rx_fifo);
+    if (len > dma_ptr - uart_rx_fifo->read_ptr) {
+        return 3;
+    }
+
+    uart_rx_fifo->read_ptr += len;
+
+    if (dma_ptr - uart_rx_fifo->read_ptr + len > huart->RxXferSize) {
+        /* The DMA has reached the released data while it was read. */
+        ++uart_rx_fifo->overrun;
+        return 2;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the count of overruns when read in place.
  *
  * @param huart The handle of UART
- * @param[out] buf The data buf which receive the data from the fifo.
- * @param buf_size The size of buf.
- * @return The length that be received.
+ * @return The count of overruns.
  */
-uint32_t uart_dmarx_read(UART_HandleTypeDef *huart, void *buf,
-                         size_t buf_size) {
-    if ((buf == NULL) || (buf_size == 0)) {
-        return 0;
-    }
+uint32_t uart_dmarx_get_overrun(UART_HandleTypeDef *huart) {
     uart_rx_fifo_t *uart_rx_fifo = uart_rx_identify(huart);
-
     if (uart_rx_fifo == NULL) {
         return 0;
     }
 
-    return ring_fifo_read(uart_rx_fifo->rx_fifo, buf, buf_size);
+    return uart_rx_fifo->overrun;
 }
 
 /**
@@ -3323,7 +2231,7 @@ uint8_t uart_dmarx_resize_fifo(UART_HandleTypeDef *huart, uint32_t buf_size,
         return 1;
     }
 
-    if (huart->hdmatx != NULL) {
+    if (huart->hdmarx != NULL) {
         return 2;
     }
 
@@ -3361,6 +2269,30 @@ uint32_t uart_dmarx_get_fifo_size(UART_HandleTypeDef *huart) {
 
     return uart_rx_fifo->fifo_size;
 }
+
+/**
+ * @brief Register the callback which is called when new data is put into
+ *        the receive fifo.
+ *
+ * @param huart The handle of UART.
+ * @param callback The callback, `NULL` to unregister.
+ * @return Register message:
+ *  @retval - 0: Success
+ *  @retval - 1: This uart not enable DMA Rx.
+ * @note The callback is called in interrupt context (UART IDLE or DMA half/
+ *       full transfer), keep it short. It is kept after deinitialization.
+ */
+uint8_t uart_dmarx_register_event_callback(UART_HandleTypeDef *huart,
+                                           uart_rx_event_callback_t callback) {
+    uart_rx_fifo_t *uart_rx_fifo = uart_rx_identify(huart);
+    if (uart_rx_fifo == NULL) {
+        return 1;
+    }
+
+    uart_rx_fifo->event_callback = callback;
+    return 0;
+}
+
 /**
  * @}
  */
@@ -3370,6 +2302,44 @@ uint32_t uart_dmarx_get_fifo_size(UART_HandleTypeDef *huart) {
  * @{
  */
 
+/* clang-format off */
+
+/* Send buf of each UART, indexed by `UART_REG_INDEX`. */
+static uart_tx_buf_t *const uart_tx_reg[UART_REG_SIZE] = {
+#if USART1_TX_DMA
+    [UART_REG_INDEX(USART1_BASE)] = &usart1_tx_buf,
+#endif /* USART1_TX_DMA */
+#if USART2_TX_DMA
+    [UART_REG_INDEX(USART2_BASE)] = &usart2_tx_buf,
+#endif /* USART2_TX_DMA */
+#if USART3_TX_DMA
+    [UART_REG_INDEX(USART3_BASE)] = &usart3_tx_buf,
+#endif /* USART3_TX_DMA */
+#if UART4_TX_DMA
+    [UART_REG_INDEX(UART4_BASE)] = &uart4_tx_buf,
+#endif /* UART4_TX_DMA */
+#if UART5_TX_DMA
+    [UART_REG_INDEX(UART5_BASE)] = &uart5_tx_buf,
+#endif /* UART5_TX_DMA */
+#if USART6_TX_DMA
+    [UART_REG_INDEX(USART6_BASE)] = &usart6_tx_buf,
+#endif /* USART6_TX_DMA */
+#if UART7_TX_DMA
+    [UART_REG_INDEX(UART7_BASE)] = &uart7_tx_buf,
+#endif /* UART7_TX_DMA */
+#if UART8_TX_DMA
+    [UART_REG_INDEX(UART8_BASE)] = &uart8_tx_buf,
+#endif /* UART8_TX_DMA */
+#if UART9_TX_DMA
+    [UART_REG_INDEX(UART9_BASE)] = &uart9_tx_buf,
+#endif /* UART9_TX_DMA */
+#if UART10_TX_DMA
+    [UART_REG_INDEX(UART10_BASE)] = &uart10_tx_buf,
+#endif /* UART10_TX_DMA */
+};
+
+/* clang-format on */
+
 /**
  * @brief Identify the UART transmit buffer by handle.
  *
@@ -3377,73 +2347,283 @@ uint32_t uart_dmarx_get_fifo_size(UART_HandleTypeDef *huart) {
  * @return The point of UART tx buffer.
  */
 static inline uart_tx_buf_t *uart_tx_identify(UART_HandleTypeDef *huart) {
-    switch ((uintptr_t)(huart->Instance)) {
+    return uart_tx_reg[UART_REG_INDEX(huart->Instance)];
+}
 
-#if USART1_TX_DMA
-        case USART1_BASE: {
-            return &usart1_tx_buf;
-        }
-#endif /* USART1_TX_DMA */
+/**
+ * @brief Release what a failed UART init has set up, the next init starts
+ *        from scratch without leaking the buffers.
+ *
+ * @param huart The handle of UART.
+ */
+static void uart_init_unwind(UART_HandleTypeDef *huart) {
+    uart_rx_fifo_t *uart_rx_fifo = uart_rx_identify(huart);
+    uart_tx_buf_t *send_tx_buf = uart_tx_identify(huart);
 
-#if USART2_TX_DMA
-        case USART2_BASE: {
-            return &usart2_tx_buf;
-        }
-#endif /* USART2_TX_DMA */
+    if (huart->hdmarx != NULL) {
+        HAL_DMA_DeInit(huart->hdmarx);
+        huart->hdmarx = NULL;
+    }
 
-#if USART3_TX_DMA
-        case USART3_BASE: {
-            return &usart3_tx_buf;
+    if (huart->hdmatx != NULL) {
+        HAL_DMA_DeInit(huart->hdmatx);
+        huart->hdmatx = NULL;
+    }
+
+    if ((uart_rx_fifo != NULL) && (uart_rx_fifo->rx_fifo != NULL)) {
+        uart_dmarx_buf_deinit(uart_rx_fifo);
+    }
+
+    if (send_tx_buf != NULL) {
+        uart_dmatx_buf_deinit(send_tx_buf);
+    }
+}
+
+/**
+ * @brief Enable a peripheral clock in RCC, same as `__HAL_RCC_xxx_CLK_ENABLE`.
+ *
+ * @param reg The RCC enable register.
+ * @param bit The enable bit.
+ */
+static inline void uart_clk_enable(volatile uint32_t *reg, uint32_t bit) {
+    __IO uint32_t tmpreg;
+
+    SET_BIT(*reg, bit);
+    /* Delay after an RCC peripheral clock enabling. */
+    tmpreg = READ_BIT(*reg, bit);
+    UNUSED(tmpreg);
+}
+
+/**
+ * @brief Enable the clock of the GPIO port, GPIOA ~ GPIOK are 0x400 apart and
+ *        their enable bits are bit 0 ~ 10 of AHB1ENR.
+ *
+ * @param port The GPIO port.
+ */
+static inline void uart_gpio_clk_enable(GPIO_TypeDef *port) {
+    uart_clk_enable(&RCC->AHB1ENR,
+                    1UL << (((uintptr_t)port - GPIOA_BASE) >> 10));
+}
+
+/**
+ * @brief Enable the clock of the DMA controller that owns the stream.
+ *
+ * @param hdma The handle of DMA.
+ */
+static inline void uart_dma_clk_enable(DMA_HandleTypeDef *hdma) {
+    uart_clk_enable(&RCC->AHB1ENR, ((uintptr_t)hdma->Instance >= DMA2_BASE)
+                                       ? RCC_AHB1ENR_DMA2EN
+                                       : RCC_AHB1ENR_DMA1EN);
+}
+
+/**
+ * @brief UART initialization, shared by all instances.
+ *
+ * @param desc The pins, clock and interrupts of UART.
+ * @param baud_rate Baud rate.
+ * @return UART init status, see `usart1_init`.
+ */
+static uint8_t uart_init(const uart_desc_t *desc, uint32_t baud_rate) {
+    /* Mode and flow control bits each pin adds. */
+    static const uint32_t pin_mode[UART_PIN_NUM] = {UART_MODE_TX,
+                                                    UART_MODE_RX, 0, 0};
+    static const uint32_t pin_flow[UART_PIN_NUM] = {
+        0, 0, UART_HWCONTROL_CTS, UART_HWCONTROL_RTS};
+    UART_HandleTypeDef *huart = desc->huart;
+
+    if (HAL_UART_GetState(huart) != HAL_UART_STATE_RESET) {
+        return UART_INITED;
+    }
+
+    GPIO_InitTypeDef gpio_init_struct = {.Pull = GPIO_PULLUP,
+                                         .Speed = GPIO_SPEED_FREQ_HIGH,
+                                         .Mode = GPIO_MODE_AF_PP};
+    huart->Init.BaudRate = baud_rate;
+
+    for (uint32_t i = 0; i < UART_PIN_NUM; ++i) {
+        const uart_pin_t *pin = &desc->pin[i];
+        if (pin->port == NULL) {
+            continue;
         }
-#endif /* USART3_TX_DMA */
 
-#if UART4_TX_DMA
-        case UART4_BASE: {
-            return &uart4_tx_buf;
+        huart->Init.Mode |= pin_mode[i];
+        huart->Init.HwFlowCtl |= pin_flow[i];
+
+        uart_gpio_clk_enable(pin->port);
+        gpio_init_struct.Pin = pin->pin;
+        gpio_init_struct.Alternate = pin->alternate;
+        HAL_GPIO_Init(pin->port, &gpio_init_struct);
+    }
+
+    uart_clk_enable(desc->clk_reg, desc->clk_bit);
+    if (desc->irq.enable) {
+        HAL_NVIC_SetPriority(desc->irq.irqn, desc->irq.priority,
+                             desc->irq.sub);
+        HAL_NVIC_EnableIRQ(desc->irq.irqn);
+    }
+
+    if (desc->dmarx != NULL) {
+        if (uart_dmarx_buf_init(uart_rx_identify(huart)) != 0) {
+            return UART_INIT_MEM_FAIL;
         }
-#endif /* UART4_TX_DMA */
 
-#if UART5_TX_DMA
-        case UART5_BASE: {
-            return &uart5_tx_buf;
+        uart_dma_clk_enable(desc->dmarx);
+        if (HAL_DMA_Init(desc->dmarx) != HAL_OK) {
+            uart_init_unwind(huart);
+            return UART_INIT_DMA_FAIL;
         }
-#endif /* UART5_TX_DMA */
 
-#if USART6_TX_DMA
-        case USART6_BASE: {
-            return &usart6_tx_buf;
+        __HAL_LINKDMA(huart, hdmarx, *desc->dmarx);
+
+        HAL_NVIC_SetPriority(desc->dmarx_irq.irqn, desc->dmarx_irq.priority,
+                             desc->dmarx_irq.sub);
+        HAL_NVIC_EnableIRQ(desc->dmarx_irq.irqn);
+    }
+
+    if (desc->dmatx != NULL) {
+        if (uart_dmatx_buf_init(uart_tx_identify(huart)) != 0) {
+            uart_init_unwind(huart);
+            return UART_INIT_MEM_FAIL;
         }
-#endif /* USART6_TX_DMA */
 
-#if UART7_TX_DMA
-        case UART7_BASE: {
-            return &uart7_tx_buf;
+        uart_dma_clk_enable(desc->dmatx);
+        if (HAL_DMA_Init(desc->dmatx) != HAL_OK) {
+            uart_init_unwind(huart);
+            return UART_INIT_DMA_FAIL;
         }
-#endif /* UART7_TX_DMA */
 
-#if UART8_TX_DMA
-        case UART8_BASE: {
-            return &uart8_tx_buf;
+        __HAL_LINKDMA(huart, hdmatx, *desc->dmatx);
+
+        HAL_NVIC_SetPriority(desc->dmatx_irq.irqn, desc->dmatx_irq.priority,
+                             desc->dmatx_irq.sub);
+        HAL_NVIC_EnableIRQ(desc->dmatx_irq.irqn);
+    }
+
+    if (HAL_UART_Init(huart) != HAL_OK) {
+        uart_init_unwind(huart);
+        return UART_INIT_FAIL;
+    }
+
+    if (desc->dmarx != NULL) {
+        uart_rx_fifo_t *uart_rx_fifo = uart_rx_identify(huart);
+
+        __HAL_UART_ENABLE_IT(huart, UART_IT_IDLE);
+        __HAL_UART_CLEAR_IDLEFLAG(huart);
+
+        HAL_UART_Receive_DMA(huart, uart_rx_fifo->recv_buf,
+                             uart_rx_fifo->buf_size);
+
+#if USE_HAL_UART_REGISTER_CALLBACKS
+        HAL_UART_RegisterCallback(huart, HAL_UART_RX_HALFCOMPLETE_CB_ID,
+                                  uart_dmarx_halfdone_callback);
+        HAL_UART_RegisterCallback(huart, HAL_UART_RX_COMPLETE_CB_ID,
+                                  uart_dmarx_done_callback);
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+    }
+
+#if USE_HAL_UART_REGISTER_CALLBACKS
+    if (desc->dmatx != NULL) {
+        HAL_UART_RegisterCallback(huart, HAL_UART_TX_COMPLETE_CB_ID,
+                                  uart_dmatx_done_callback);
+    }
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
+    return UART_INIT_OK;
+}
+
+/**
+ * @brief UART deinitialization, shared by all instances.
+ *
+ * @param desc The pins, clock and interrupts of UART.
+ * @return UART deinit status, see `usart1_deinit`.
+ */
+static uint8_t uart_deinit(const uart_desc_t *desc) {
+    UART_HandleTypeDef *huart = desc->huart;
+
+    if (HAL_UART_GetState(huart) == HAL_UART_STATE_RESET) {
+        return UART_NO_INIT;
+    }
+
+    CLEAR_BIT(*desc->clk_reg, desc->clk_bit);
+
+    for (uint32_t i = 0; i < UART_PIN_NUM; ++i) {
+        if (desc->pin[i].port != NULL) {
+            HAL_GPIO_DeInit(desc->pin[i].port, desc->pin[i].pin);
         }
-#endif /* UART8_TX_DMA */
+    }
 
-#if UART9_TX_DMA
-        case UART9_BASE: {
-            return &uart9_tx_buf;
+    if (desc->irq.enable) {
+        HAL_NVIC_DisableIRQ(desc->irq.irqn);
+    }
+
+    if (desc->dmarx != NULL) {
+        HAL_DMA_Abort(desc->dmarx);
+        uart_dmarx_buf_deinit(uart_rx_identify(huart));
+
+        if (HAL_DMA_DeInit(desc->dmarx) != HAL_OK) {
+            return UART_DEINIT_DMA_FAIL;
         }
-#endif /* UART9_TX_DMA */
 
-#if UART10_TX_DMA
-        case UART10_BASE: {
-            return &uart10_tx_buf;
+        HAL_NVIC_DisableIRQ(desc->dmarx_irq.irqn);
+
+#if USE_HAL_UART_REGISTER_CALLBACKS
+        HAL_UART_UnRegisterCallback(huart, HAL_UART_RX_HALFCOMPLETE_CB_ID);
+        HAL_UART_UnRegisterCallback(huart, HAL_UART_RX_COMPLETE_CB_ID);
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+        huart->hdmarx = NULL;
+    }
+
+    if (desc->dmatx != NULL) {
+        HAL_DMA_Abort(desc->dmatx);
+        uart_dmatx_buf_deinit(uart_tx_identify(huart));
+
+        if (HAL_DMA_DeInit(desc->dmatx) != HAL_OK) {
+            return UART_DEINIT_DMA_FAIL;
         }
-#endif /* UART10_TX_DMA */
 
-        default: {
-        } break;
+        HAL_NVIC_DisableIRQ(desc->dmatx_irq.irqn);
+
+        huart->hdmatx = NULL;
+    }
+
+    if (HAL_UART_DeInit(huart) != HAL_OK) {
+        return UART_DEINIT_FAIL;
+    }
+
+    return UART_DEINIT_OK;
+}
+
+/**
+ * @brief Start the DMA transfer of the filling half and swap the halves.
+ *
+ * @param huart The handle of UART.
+ * @param send_tx_buf The send buf of UART.
+ * @return The length which is started, 0 if nothing to send or the UART is
+ *         busy.
+ * @note Must be called with interrupts disabled.
+ */
+static uint32_t uart_dmatx_start(UART_HandleTypeDef *huart,
+                                 uart_tx_buf_t *send_tx_buf) {
+    uint32_t len = send_tx_buf->head_ptr;
+    uint8_t *half =
+        send_tx_buf->send_buf + send_tx_buf->fill_idx * send_tx_buf->buf_size;
+
+    if ((send_tx_buf->busy) || (len == 0)) {
+        return 0;
+    }
+
+    if (HAL_UART_Transmit_DMA(huart, half, (uint16_t)len) != HAL_OK) {
+        /* Someone else is using the UART (e.g. `HAL_UART_Transmit_DMA`),
+         * retry in the complete callback of that transfer. */
+        return 0;
     }
 
-    return NULL;
+    send_tx_buf->busy = 1;
+    send_tx_buf->pending = 0;
+    send_tx_buf->fill_idx ^= 1;
+    send_tx_buf->head_ptr = 0;
+
+    return len;
 }
 
 /**
@@ -3452,11 +2632,47 @@ static inline uart_tx_buf_t *uart_tx_identify(UART_HandleTypeDef *huart) {
  * @param huart The handle of UART.
  * @param data The data will be write.
  * @param len The data length will be written.
- * @return The length that be written.
+ * @return The length that be written, 0 if the free space of buffer is not
+ *         enough. The data is written completely or not at all.
+ * @note The data goes into the half which is not on the wire, it never
+ *       waits for the transfer. When it returns 0, call `uart_dmatx_send`
+ *       and retry later.
  */
 uint32_t uart_dmatx_write(UART_HandleTypeDef *huart, const void *data,
                           size_t len) {
-    if ((data == NULL) || (len == 0)) {
+    uart_tx_iovec_t iov = {.data = data, .len = len};
+
+    return uart_dmatx_writev(huart, &iov, 1);
+}
+
+/**
+ * @brief Write several pieces of data to the buffer as one, such as header,
+ *        payload and trailer of a frame, without joining them first.
+ *
+ * @param huart The handle of UART.
+ * @param iov The pieces of data, `NULL` data is not allowed unless its length
+ *            is 0.
+ * @param iov_cnt The count of pieces.
+ * @return The total length that be written, 0 if the free space of buffer is
+ *         not enough. All the pieces are written or none of them.
+ * @note Each piece is copied once, into the half which is not on the wire.
+ */
+uint32_t uart_dmatx_writev(UART_HandleTypeDef *huart,
+                           const uart_tx_iovec_t *iov, uint32_t iov_cnt) {
+    uint32_t len = 0;
+
+    if (iov == NULL) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < iov_cnt; ++i) {
+        if ((iov[i].data == NULL) && (iov[i].len != 0)) {
+            return 0;
+        }
+        len += iov[i].len;
+    }
+
+    if (len == 0) {
         return 0;
     }
 
@@ -3465,27 +2681,39 @@ uint32_t uart_dmatx_write(UART_HandleTypeDef *huart, const void *data,
         return 0;
     }
 
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
     /* Get the remain length of buffer. */
     uint32_t buf_remain = send_tx_buf->buf_size - send_tx_buf->head_ptr;
 
-    /* Prevent overflow. */
     if (buf_remain < len) {
-        memcpy(send_tx_buf->send_buf + send_tx_buf->head_ptr, data, buf_remain);
-        send_tx_buf->head_ptr += buf_remain;
-        return buf_remain;
-    } else {
-        memcpy(send_tx_buf->send_buf + send_tx_buf->head_ptr, data, len);
-        send_tx_buf->head_ptr += len;
-        return len;
+        /* Back-pressure, do not truncate. */
+        __set_PRIMASK(primask);
+        return 0;
     }
+
+    uint8_t *dst = send_tx_buf->send_buf +
+                   send_tx_buf->fill_idx * send_tx_buf->buf_size +
+                   send_tx_buf->head_ptr;
+    for (uint32_t i = 0; i < iov_cnt; ++i) {
+        memcpy(dst, iov[i].data, iov[i].len);
+        dst += iov[i].len;
+    }
+    send_tx_buf->head_ptr += len;
+
+    __set_PRIMASK(primask);
+    return len;
 }
 
 /**
  * @brief Transmit the data in the buf.
  *
  * @param huart The handle of UART.
- * @return The length which is succeed transmitted.
+ * @return The length which is started or queued to transmit.
  * @note If you want transmit data, using `uart_dmatx_write` before.
+ *       It does not wait for the last transfer. If the UART is busy, the
+ *       data is sent automatically in the transmit complete interrupt.
  *       If you have huge continous data to transmit, we recommand use
  *       `HAL_UART_Transmit_DMA()`.
  */
@@ -3499,25 +2727,74 @@ uint32_t uart_dmatx_send(UART_HandleTypeDef *huart) {
         return 0;
     }
 
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
     uint32_t len = send_tx_buf->head_ptr;
-    if (len == 0) {
-        return 0;
+    if ((len != 0) && (uart_dmatx_start(huart, send_tx_buf) == 0)) {
+        /* The other half is on the wire, send in the complete callback. */
+        send_tx_buf->pending = 1;
     }
 
-    /* Wait for last transfer end. */
-    while (__HAL_UART_GET_FLAG(huart, UART_FLAG_TC) == RESET)
-        ;
-
-    HAL_UART_Transmit_DMA(huart, send_tx_buf->send_buf, (uint16_t)len);
-    send_tx_buf->head_ptr = 0;
+    __set_PRIMASK(primask);
     return len;
 }
 
+/**
+ * @brief UART DMA transmit complete callback.
+ *
+ * @param huart The handle of UART
+ */
+void uart_dmatx_done_callback(UART_HandleTypeDef *huart) {
+    uart_tx_buf_t *send_tx_buf = uart_tx_identify(huart);
+    if (send_tx_buf == NULL) {
+        return;
+    }
+
+    /* Only one transfer at a time, if ours is started, this is it. */
+    send_tx_buf->busy = 0;
+
+    if (send_tx_buf->cplt_callback != NULL) {
+        send_tx_buf->cplt_callback(huart);
+    }
+
+    if (send_tx_buf->pending) {
+        /* If the callback has started another transfer, it fails and
+         * retries in the next complete callback. */
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        uart_dmatx_start(huart, send_tx_buf);
+        __set_PRIMASK(primask);
+    }
+}
+
+/**
+ * @brief Register the callback which is called when DMA transmit complete.
+ *
+ * @param huart The handle of UART.
+ * @param callback The callback, `NULL` to unregister.
+ * @return Register message:
+ *  @retval - 0: Success
+ *  @retval - 1: This uart not enable DMA Tx.
+ * @note The callback is called in interrupt context, keep it short. The
+ *       UART is ready for the next transfer when it is called.
+ */
+uint8_t uart_dmatx_register_cplt_callback(UART_HandleTypeDef *huart,
+                                          uart_tx_event_callback_t callback) {
+    uart_tx_buf_t *send_tx_buf = uart_tx_identify(huart);
+    if (send_tx_buf == NULL) {
+        return 1;
+    }
+
+    send_tx_buf->cplt_callback = callback;
+    return 0;
+}
+
 /**
  * @brief Resize the send buf of UART.
  *
  * @param huart The handle of UART
- * @param size New size
+ * @param size New size of each half, twice of it is allocated
  * @return Resize message:
  *  @retval - 0: Success
  *  @retval - 1: This uart not enable DMA Tx.
@@ -3535,8 +2812,10 @@ uint8_t uart_dmatx_resize_buf(UART_HandleTypeDef *huart, uint32_t size) {
         return 1;
     }
 
-    if ((huart->gState) & (HAL_UART_STATE_BUSY_TX | HAL_UART_STATE_BUSY) &
-        ~HAL_UART_STATE_READY) {
+    if (((huart->gState) & (HAL_UART_STATE_BUSY_TX | HAL_UART_STATE_BUSY) &
+         ~HAL_UART_STATE_READY) ||
+        send_tx_buf->busy || send_tx_buf->pending ||
+        (send_tx_buf->head_ptr != 0)) {
         /* The UART is busy. */
         return 3;
     }
@@ -3547,7 +2826,7 @@ uint8_t uart_dmatx_resize_buf(UART_HandleTypeDef *huart, uint32_t size) {
         return 0;
     }
 
-    uint8_t *new_ptr = CSP_REALLOC(send_tx_buf->send_buf, size);
+    uint8_t *new_ptr = CSP_REALLOC(send_tx_buf->send_buf, size * 2);
 
     if (new_ptr == NULL) {
         return 2;
@@ -3563,7 +2842,7 @@ uint8_t uart_dmatx_resize_buf(UART_HandleTypeDef *huart, uint32_t size) {
  * @brief Get the buffer size of UART DMA Tx.
  *
  * @param huart The handle of UART.
- * @return The size of UART DMA Tx buf.
+ * @return The size of each half of UART DMA Tx buf.
  */
 uint32_t uart_damtx_get_buf_szie(UART_HandleTypeDef *huart) {
     uart_tx_buf_t *uart_tx_buf = uart_tx_identify(huart);
@@ -3622,6 +2901,20 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
     }
 
     if (NULL != huart->hdmarx) {
+        uart_rx_fifo_t *uart_rx_fifo = uart_rx_identify(huart);
+        if (uart_rx_fifo != NULL) {
+            /* DMA restarts from the beginning of the buffer, align the
+             * pointers to it. Unread data in place is dropped. */
+            uint32_t size = huart->RxXferSize;
+            uart_rx_fifo->head_ptr +=
+                (size - uart_rx_fifo->head_ptr % size) % size;
+            if (uart_rx_fifo->zero_copy &&
+                (uart_rx_fifo->read_ptr != uart_rx_fifo->head_ptr)) {
+                uart_rx_fifo->read_ptr = uart_rx_fifo->head_ptr;
+                ++uart_rx_fifo->overrun;
+            }
+        }
+
         while (
             HAL_UART_Receive_DMA(huart, huart->pRxBuffPtr, huart->RxXferSize)) {
             __HAL_UNLOCK(huart);
@@ -3662,6 +2955,17 @@ void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *huart) {
     }
 }
 
+/**
+ * @brief Tx Transfer completed callbacks.
+ *
+ * @param huart The handle of UART.
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart->hdmatx != NULL) {
+        uart_dmatx_done_callback(huart);
+    }
+}
+
 #endif /* USE_HAL_UART_REGISTER_CALLBACKS == 0 */
 
 /**
@@ -770,6 +770,32 @@ uint8_t uart10_deinit(void);
 
 /* clang-format on */
 
+/**
+ * @brief UART DMA Rx event callback, called in interrupt context.
+ */
+typedef void (*uart_rx_event_callback_t)(UART_HandleTypeDef * /* huart */);
+
+/**
+ * @brief UART DMA Tx event callback, called in interrupt context.
+ */
+typedef void (*uart_tx_event_callback_t)(UART_HandleTypeDef * /* huart */);
+
+/**
+ * @brief A piece of data to transmit.
+ */
+typedef struct {
+    const void *data; /*!< Start of the data. */
+    size_t len;       /*!< Length of the data. */
+} uart_tx_iovec_t;
+
+/**
+ * @brief A span of received data in the DMA buffer.
+ */
+typedef struct {
+    const uint8_t *data; /*!< Start of the data. */
+    uint32_t len;        /*!< Length of the data. */
+} uart_rx_span_t;
+
 /*****************************************************************************
  * @defgroup Public uart function.
  * @{
@@ -779,16 +805,25 @@ int uart_printf(UART_HandleTypeDef *huart, const char *__format, ...);
 int uart_scanf(UART_HandleTypeDef *huart, const char *__format, ...);
 
 uint32_t uart_dmarx_read(UART_HandleTypeDef *huart, void *buf, size_t len);
+uint32_t uart_dmarx_peek(UART_HandleTypeDef *huart, uart_rx_span_t span[2]);
+uint8_t uart_dmarx_consume(UART_HandleTypeDef *huart, uint32_t len);
+uint32_t uart_dmarx_get_overrun(UART_HandleTypeDef *huart);
 uint8_t uart_dmarx_resize_fifo(UART_HandleTypeDef *huart, uint32_t buf_size,
                                uint32_t fifo_size);
 uint32_t uart_dmarx_get_buf_size(UART_HandleTypeDef *huart);
 uint32_t uart_dmarx_get_fifo_size(UART_HandleTypeDef *huart);
+uint8_t uart_dmarx_register_event_callback(UART_HandleTypeDef *huart,
+                                           uart_rx_event_callback_t callback);
 
 uint32_t uart_dmatx_write(UART_HandleTypeDef *huart, const void *data,
                           size_t len);
+uint32_t uart_dmatx_writev(UART_HandleTypeDef *huart,
+                           const uart_tx_iovec_t *iov, uint32_t iov_cnt);
 uint32_t uart_dmatx_send(UART_HandleTypeDef *huart);
 uint8_t uart_dmatx_resize_buf(UART_HandleTypeDef *huart, uint32_t size);
 uint32_t uart_damtx_get_buf_szie(UART_HandleTypeDef *huart);
+uint8_t uart_dmatx_register_cplt_callback(UART_HandleTypeDef *huart,
+                                          uart_tx_event_callback_t callback);
 
 /**
  * @}
@@ -0,0 +1,182 @@
+/**
+ * @file    CSP_Config.h
+ * @brief   UART and CAN configuration of the host tests.
+ *
+ * @note Same settings and tail as `Config/CSP_Config.h`, limited to three
+ *       UARTs that cover the variants of the driver:
+ *       - USART1: APB2, TX/RX/CTS/RTS, interrupt, Rx DMA2 and Tx DMA2.
+ *       - UART5:  APB1, TX/RX, interrupt, Rx DMA1 only.
+ *       - UART7:  APB1, TX/RX, no interrupt, no DMA.
+ *
+ *       And two CANs sharing the filter banks:
+ *       - CAN1: PD0/PD1, TX, RX0 and RX1 interrupts.
+ *       - CAN2: PB12/PB13, TX and RX0 interrupts.
+ */
+
+#ifndef __CSP_CONFIG_H
+#define __CSP_CONFIG_H
+
+/* USART1 */
+#define USART1_ENABLE             1
+#define USART1_TX_ID              1
+#define USART1_TX                 1
+#define USART1_TX_PORT            A
+#define USART1_TX_PIN             GPIO_PIN_9
+#define USART1_RX_ID              2
+#define USART1_RX                 1
+#define USART1_RX_PORT            B
+#define USART1_RX_PIN             GPIO_PIN_7
+#define USART1_CTS_ID             1
+#define USART1_CTS                1
+#define USART1_CTS_PORT           A
+#define USART1_CTS_PIN            GPIO_PIN_11
+#define USART1_RTS_ID             1
+#define USART1_RTS                1
+#define USART1_RTS_PORT           A
+#define USART1_RTS_PIN            GPIO_PIN_12
+#define USART1_IT_ENABLE          1
+#define USART1_IT_PRIORITY        2
+#define USART1_IT_SUB             3
+#define USART1_RX_DMA             1
+#define USART1_RX_DMA_NUMBER      2
+#define USART1_RX_DMA_STREAM      2
+#define USART1_RX_DMA_CHANNEL     4
+#define USART1_RX_DMA_PRIORITY    DMA_PRIORITY_MEDIUM
+#define USART1_RX_DMA_IT_PRIORITY 2
+#define USART1_RX_DMA_IT_SUB      1
+#define USART1_RX_DMA_BUF_SIZE    256
+#define USART1_RX_DMA_FIFO_SIZE   512
+#define USART1_TX_DMA             1
+#define USART1_TX_DMA_NUMBER      2
+#define USART1_TX_DMA_STREAM      7
+#define USART1_TX_DMA_CHANNEL     4
+#define USART1_TX_DMA_PRIORITY    DMA_PRIORITY_MEDIUM
+#define USART1_TX_DMA_IT_PRIORITY 3
+#define USART1_TX_DMA_IT_SUB      0
+#define USART1_TX_DMA_BUF_SIZE    128
+
+/* UART5 */
+#define UART5_ENABLE              1
+#define UART5_TX_ID               4
+#define UART5_TX                  1
+#define UART5_TX_PORT             C
+#define UART5_TX_PIN              GPIO_PIN_12
+#define UART5_RX_ID               4
+#define UART5_RX                  1
+#define UART5_RX_PORT             D
+#define UART5_RX_PIN              GPIO_PIN_2
+#define UART5_CTS_ID              0
+#define UART5_CTS                 0
+#define UART5_RTS_ID              0
+#define UART5_RTS                 0
+#define UART5_IT_ENABLE           1
+#define UART5_IT_PRIORITY         5
+#define UART5_IT_SUB              3
+#define UART5_RX_DMA              1
+#define UART5_RX_DMA_NUMBER       1
+#define UART5_RX_DMA_STREAM       0
+#define UART5_RX_DMA_CHANNEL      4
+#define UART5_RX_DMA_PRIORITY     DMA_PRIORITY_HIGH
+#define UART5_RX_DMA_IT_PRIORITY  4
+#define UART5_RX_DMA_IT_SUB       2
+#define UART5_RX_DMA_BUF_SIZE     64
+#define UART5_RX_DMA_FIFO_SIZE    128
+#define UART5_TX_DMA              0
+
+/* UART7 */
+#define UART7_ENABLE              1
+#define UART7_TX_ID               4
+#define UART7_TX                  1
+#define UART7_TX_PORT             F
+#define UART7_TX_PIN              GPIO_PIN_7
+#define UART7_RX_ID               4
+#define UART7_RX                  1
+#define UART7_RX_PORT             F
+#define UART7_RX_PIN              GPIO_PIN_6
+#define UART7_IT_ENABLE           0
+#define UART7_RX_DMA              0
+#define UART7_TX_DMA              0
+
+/* CAN1 */
+#define CAN1_ENABLE               1
+#define CAN1_RX_ID                2
+#define CAN1_RX_PORT              D
+#define CAN1_RX_PIN               GPIO_PIN_0
+#define CAN1_TX_ID                2
+#define CAN1_TX_PORT              D
+#define CAN1_TX_PIN               GPIO_PIN_1
+#define CAN1_TX_IT_ENABLE         1
+#define CAN1_TX_IT_PRIORITY       6
+#define CAN1_TX_IT_SUB            0
+#define CAN1_SCE_IT_ENABLE        0
+#define CAN1_RX0_IT_ENABLE        1
+#define CAN1_RX0_IT_PRIORITY      5
+#define CAN1_RX0_IT_SUB           1
+#define CAN1_RX1_IT_ENABLE        1
+#define CAN1_RX1_IT_PRIORITY      5
+#define CAN1_RX1_IT_SUB           2
+
+/* CAN2 */
+#define CAN2_ENABLE               1
+#define CAN2_RX_ID                1
+#define CAN2_RX_PORT              B
+#define CAN2_RX_PIN               GPIO_PIN_12
+#define CAN2_TX_ID                1
+#define CAN2_TX_PORT              B
+#define CAN2_TX_PIN               GPIO_PIN_13
+#define CAN2_TX_IT_ENABLE         1
+#define CAN2_TX_IT_PRIORITY       7
+#define CAN2_TX_IT_SUB            0
+#define CAN2_SCE_IT_ENABLE        0
+#define CAN2_RX0_IT_ENABLE        1
+#define CAN2_RX0_IT_PRIORITY      6
+#define CAN2_RX0_IT_SUB           1
+#define CAN2_RX1_IT_ENABLE        0
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Enable the clock of GPIO. */
+#define _CSP_GPIO_PORT(x)          GPIO##x
+#define CSP_GPIO_PORT(x)           _CSP_GPIO_PORT(x)
+#define _CSP_GPIO_CLK_ENABLE(x)    __HAL_RCC_GPIO##x##_CLK_ENABLE()
+#define CSP_GPIO_CLK_ENABLE(x)     _CSP_GPIO_CLK_ENABLE(x)
+
+/* Pasting the DMA Stream. */
+#define _CSP_DMA_STREAM(x, y)      DMA##x##_Stream##y
+#define CSP_DMA_STREAM(x, y)       _CSP_DMA_STREAM(x, y)
+
+#define _CSP_DMA_STREAM_IRQn(x, y) DMA##x##_Stream##y##_IRQn
+#define CSP_DMA_STREAM_IRQn(x, y)  _CSP_DMA_STREAM_IRQn(x, y)
+
+#define _CSP_DMA_STREAM_IRQ(x, y)  DMA##x##_Stream##y##_IRQHandler
+#define CSP_DMA_STREAM_IRQ(x, y)   _CSP_DMA_STREAM_IRQ(x, y)
+
+/* Pasting the DMA Channel */
+#define _CSP_DMA_CHANNEL(x)        DMA_CHANNEL_##x
+#define CSP_DMA_CHANNEL(x)         _CSP_DMA_CHANNEL(x)
+
+/* Enable and disable the clock of DMA. */
+#define _CSP_DMA_CLK_ENABLE(x)     __HAL_RCC_DMA##x##_CLK_ENABLE()
+#define CSP_DMA_CLK_ENABLE(x)      _CSP_DMA_CLK_ENABLE(x)
+
+/* CSP memory management functions, counted by the tests. */
+#include <stdlib.h>
+void *host_malloc(size_t size);
+void host_free(void *ptr);
+#define CSP_MALLOC(x)              host_malloc(x)
+#define CSP_FREE(x)                host_free(x)
+#define CSP_REALLOC(p, x)          realloc(p, x)
+
+/* Devices Family header files.  */
+#include "stm32f4xx_hal.h"
+
+#include "../UART_STM32F4xx.h"
+#include "../CAN_STM32F4xx.h"
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __CSP_CONFIG_H */
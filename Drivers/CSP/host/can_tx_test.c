@@ -0,0 +1,334 @@
+/**
+ * @file    can_tx_test.c
+ * @brief   TX queue of the CAN CSP against the bxCAN mailbox model, on the
+ *          host.
+ *
+ * @note The test plays the bus: `host_can_bus_tx` sends the mailbox which
+ *       wins the arbitration, then the CSP TX vector refills the mailboxes
+ *       from the queue. Checks the order on the bus (ID priority, Std before
+ *       Ext of the same base ID, messages of one ID in order of sending),
+ *       the queue running full, `can_send_message_latest` replacing queued
+ *       data, the latency from the DWT cycle counter, PRIMASK being
+ *       restored, the error codes and the queue being dropped at deinit.
+ */
+
+#include "hal_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Vector of CAN1, defined by the CSP. */
+void CAN1_TX_IRQHandler(void);
+
+/* Not in the header, the CAN list does not send remote frames. */
+uint8_t can_send_remote(can_selected_t can_selected, uint32_t can_ide,
+                        uint32_t id, uint8_t len, const uint8_t *msg);
+
+#define TEST_CYCLE_PER_US (168000000U / 1000000U)
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief A frame expected on the bus.
+ */
+typedef struct {
+    uint32_t ide;
+    uint32_t rtr;
+    uint32_t id;
+    uint8_t data;
+} test_frame_t;
+
+/**
+ * @brief Send a data frame, the first byte tells the frames of one ID
+ *        apart.
+ */
+static uint8_t test_send(uint32_t ide, uint32_t id, uint8_t data) {
+    uint8_t msg[8] = {data};
+
+    return can_send_message(can1_selected, ide, id, 8, msg);
+}
+
+static uint8_t test_send_latest(uint32_t id, uint8_t data) {
+    uint8_t msg[8] = {data};
+
+    return can_send_message_latest(can1_selected, CAN_ID_STD, id, 8, msg);
+}
+
+/**
+ * @brief One frame goes on the bus, then the TX interrupt.
+ *
+ * @return The frame sent, `NULL`: nothing to send.
+ */
+static const host_can_frame_t *test_bus_step(void) {
+    const host_can_frame_t *frame = host_can_bus_tx(&can1_handle);
+
+    if (frame != NULL) {
+        CAN1_TX_IRQHandler();
+    }
+    return frame;
+}
+
+/**
+ * @brief Send everything, compare with the frames expected.
+ */
+static void test_bus_expect(const test_frame_t *expect, uint32_t num) {
+    const host_can_frame_t *frame;
+    uint32_t sent = 0;
+
+    while ((frame = test_bus_step()) != NULL) {
+        if (sent < num) {
+            const test_frame_t *e = &expect[sent];
+
+            if ((frame->ide != e->ide) || (frame->rtr != e->rtr) ||
+                (frame->id != e->id) ||
+                ((e->rtr == CAN_RTR_DATA) && (frame->data[0] != e->data))) {
+                printf("frame %u: 0x%X data %u, expect 0x%X data %u\n",
+                       (unsigned)sent, (unsigned)frame->id,
+                       (unsigned)frame->data[0], (unsigned)e->id,
+                       (unsigned)e->data);
+                ++test_fail;
+            }
+        }
+        ++sent;
+    }
+
+    CHECK(sent == num);
+    CHECK(HAL_CAN_GetTxMailboxesFreeLevel(&can1_handle) == 3);
+}
+
+/**
+ * @brief Fill the 3 mailboxes, so the next messages are queued.
+ */
+static void test_fill_mailboxes(uint32_t first_id) {
+    for (uint32_t i = 0; i < 3; ++i) {
+        CHECK(test_send(CAN_ID_STD, first_id + i * 0x10U, 0) == 0);
+    }
+    CHECK(HAL_CAN_GetTxMailboxesFreeLevel(&can1_handle) == 0);
+}
+
+static can_tx_stat_t test_stat(void) {
+    can_tx_stat_t stat;
+
+    CHECK(can_get_tx_stat(can1_selected, &stat) == 0);
+    return stat;
+}
+
+static void test_errors(void) {
+    uint8_t msg[8] = {0};
+    can_tx_stat_t stat;
+
+    CHECK(can_send_message(can1_selected, CAN_ID_STD, 0x200, 8, msg) == 4);
+    CHECK(can_send_message(can3_selected, CAN_ID_STD, 0x200, 8, msg) == 3);
+    CHECK(can_get_tx_stat(can1_selected, NULL) == 1);
+    CHECK(can_get_tx_stat(can3_selected, &stat) == 1);
+
+    CHECK(can1_init(1000, 0) == CAN_INIT_OK);
+    CHECK(can_send_message(can1_selected, CAN_ID_STD, 0x200, 9, msg) == 3);
+    CHECK(can_send_message(can1_selected, CAN_ID_STD, 0x200, 8, NULL) == 3);
+    CHECK(host_can(&can1_handle)->tx_count == 0);
+
+    /* No data, no buffer needed. */
+    CHECK(can_send_message(can1_selected, CAN_ID_STD, 0x200, 0, NULL) == 0);
+    CHECK(host_can_bus_tx(&can1_handle)->dlc == 0);
+    CAN1_TX_IRQHandler();
+}
+
+/**
+ * @brief The mailboxes are busy: queued frames go out by priority, Std
+ *        before Ext of the same base ID, one ID in order of sending.
+ */
+static void test_priority(void) {
+    static const test_frame_t expect[] = {
+        {CAN_ID_STD, CAN_RTR_DATA, 0x300, 0},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x002, 1},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x020, 2},
+        {CAN_ID_EXT, CAN_RTR_DATA, 0x020U << 18, 3},
+        {CAN_ID_EXT, CAN_RTR_DATA, (0x020U << 18) | 1U, 4},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x200, 5},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x200, 6},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x200, 7},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x310, 0},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x320, 0},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x400, 8},
+    };
+
+    test_fill_mailboxes(0x300);
+
+    CHECK(test_send(CAN_ID_STD, 0x400, 8) == 0);
+    CHECK(test_send(CAN_ID_STD, 0x200, 5) == 0);
+    CHECK(test_send(CAN_ID_EXT, (0x020U << 18) | 1U, 4) == 0);
+    CHECK(test_send(CAN_ID_STD, 0x200, 6) == 0);
+    CHECK(test_send(CAN_ID_EXT, 0x020U << 18, 3) == 0);
+    CHECK(test_send(CAN_ID_STD, 0x020, 2) == 0);
+    CHECK(test_send(CAN_ID_STD, 0x002, 1) == 0);
+    CHECK(test_send(CAN_ID_STD, 0x200, 7) == 0);
+    CHECK(test_stat().depth == 8);
+
+    test_bus_expect(expect, sizeof(expect) / sizeof(expect[0]));
+    CHECK(test_stat().depth == 0);
+    CHECK(test_stat().max_depth == 8);
+}
+
+/**
+ * @brief The latest data of a setpoint replaces the queued one, remote
+ *        frames are never replaced.
+ */
+static void test_latest(void) {
+    static const test_frame_t expect[] = {
+        {CAN_ID_STD, CAN_RTR_DATA, 0x300, 0},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x1FF, 3},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x200, 12},
+        {CAN_ID_STD, CAN_RTR_REMOTE, 0x205, 0},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x205, 21},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x310, 0},
+        {CAN_ID_STD, CAN_RTR_DATA, 0x320, 0},
+    };
+    uint32_t replace = test_stat().replace;
+
+    test_fill_mailboxes(0x300);
+
+    CHECK(test_send_latest(0x200, 10) == 0);
+    CHECK(test_send_latest(0x1FF, 1) == 0);
+    CHECK(test_send_latest(0x200, 11) == 0);
+    CHECK(test_send_latest(0x1FF, 2) == 0);
+    CHECK(test_send_latest(0x200, 12) == 0);
+    CHECK(test_send_latest(0x1FF, 3) == 0);
+    CHECK(can_send_remote(can1_selected, CAN_ID_STD, 0x205, 8, NULL) == 0);
+    CHECK(test_send_latest(0x205, 20) == 0);
+    CHECK(test_send_latest(0x205, 21) == 0);
+    CHECK(test_stat().depth == 4);
+    CHECK(test_stat().replace == replace + 5);
+
+    test_bus_expect(expect, sizeof(expect) / sizeof(expect[0]));
+}
+
+/**
+ * @brief The queue runs full: the caller gets 2 at once, the message is
+ *        counted as dropped, the queued ones are still sent.
+ */
+static void test_full(void) {
+    uint32_t drop = test_stat().drop;
+    uint32_t sent = host_can(&can1_handle)->tx_count;
+
+    test_fill_mailboxes(0x300);
+    for (uint32_t i = 0; i < CAN_TX_QUEUE_LEN; ++i) {
+        CHECK(test_send(CAN_ID_STD, 0x100 + i, (uint8_t)i) == 0);
+    }
+    CHECK(test_send(CAN_ID_STD, 0x001, 0) == 2);
+    CHECK(test_send_latest(0x001, 0) == 2);
+    /* Replacing needs no space. */
+    CHECK(test_send_latest(0x100, 100) == 0);
+
+    CHECK(test_stat().depth == CAN_TX_QUEUE_LEN);
+    CHECK(test_stat().max_depth == CAN_TX_QUEUE_LEN);
+    CHECK(test_stat().drop == drop + 2);
+
+    while (test_bus_step() != NULL) {
+    }
+    CHECK(host_can(&can1_handle)->tx_count == sent + 3 + CAN_TX_QUEUE_LEN);
+}
+
+/**
+ * @brief Latency from sending to the mailbox, by the DWT cycle counter.
+ */
+static void test_latency(void) {
+    host_dwt.CYCCNT = 1000;
+    test_fill_mailboxes(0x300);
+    CHECK(test_stat().latency == 0);
+
+    CHECK(test_send(CAN_ID_STD, 0x200, 0) == 0);
+    CHECK(test_send(CAN_ID_STD, 0x201, 0) == 0);
+
+    /* 0x200 waits 250 us for a mailbox, 0x201 500 us. */
+    host_dwt.CYCCNT += 250 * TEST_CYCLE_PER_US;
+    test_bus_step();
+    CHECK(test_stat().latency == 250);
+    host_dwt.CYCCNT += 250 * TEST_CYCLE_PER_US;
+    test_bus_step();
+    CHECK(test_stat().latency == 500);
+    CHECK(test_stat().max_latency == 500);
+
+    /* The counter wraps around. */
+    while (test_bus_step() != NULL) {
+    }
+    host_dwt.CYCCNT = 0xFFFFFFFFU - 100 * TEST_CYCLE_PER_US + 1;
+    test_fill_mailboxes(0x300);
+    CHECK(test_send(CAN_ID_STD, 0x200, 0) == 0);
+    host_dwt.CYCCNT += 200 * TEST_CYCLE_PER_US;
+    test_bus_step();
+    CHECK(test_stat().latency == 200);
+
+    while (test_bus_step() != NULL) {
+    }
+}
+
+/**
+ * @brief Sending with interrupts disabled keeps them disabled.
+ */
+static void test_primask(void) {
+    host_primask = 1;
+    CHECK(test_send(CAN_ID_STD, 0x200, 0) == 0);
+    CHECK(host_primask == 1);
+    host_primask = 0;
+
+    CHECK(test_send(CAN_ID_STD, 0x200, 0) == 0);
+    CHECK(host_primask == 0);
+
+    while (test_bus_step() != NULL) {
+    }
+}
+
+/**
+ * @brief Messages still queued at deinit are dropped, not sent with stale
+ *        data after the next init.
+ */
+static void test_deinit(void) {
+    uint32_t drop = test_stat().drop;
+
+    test_fill_mailboxes(0x300);
+    CHECK(test_send(CAN_ID_STD, 0x200, 0) == 0);
+    CHECK(test_send(CAN_ID_STD, 0x201, 0) == 0);
+
+    CHECK(can1_deinit() == CAN_DEINIT_OK);
+    CHECK(test_stat().depth == 0);
+    CHECK(test_stat().drop == drop + 2);
+    CHECK(test_send(CAN_ID_STD, 0x200, 0) == 4);
+
+    CHECK(can1_init(1000, 0) == CAN_INIT_OK);
+    CHECK(test_send(CAN_ID_STD, 0x123, 9) == 0);
+    {
+        static const test_frame_t expect[] = {
+            {CAN_ID_STD, CAN_RTR_DATA, 0x123, 9},
+        };
+        test_bus_expect(expect, 1);
+    }
+}
+
+int main(void) {
+    host_periph_map();
+
+    test_errors();
+    test_priority();
+    test_latest();
+    test_full();
+    test_latency();
+    test_primask();
+    test_deinit();
+
+    CHECK(host_primask == 0);
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file    core_cm4.h
+ * @brief   Host stand-in for the CMSIS Cortex-M4 core header.
+ *
+ * @note The device header `stm32f429xx.h` includes `core_cm4.h`. This one
+ *       comes first in the include path of the host tests and replaces the
+ *       intrinsics written in ARM assembly with plain C. PRIMASK is a
+ *       variable so the tests can check the critical sections.
+ */
+
+#ifndef __CORE_CM4_H_GENERIC
+#define __CORE_CM4_H_GENERIC
+#define __CORE_CM4_H_DEPENDANT
+
+#include <stdint.h>
+
+#define __I                   volatile const
+#define __O                   volatile
+#define __IO                  volatile
+#define __IM                  volatile const
+#define __OM                  volatile
+#define __IOM                 volatile
+
+#define __ASM                 __asm
+#define __INLINE              inline
+#define __STATIC_INLINE       static inline
+#define __STATIC_FORCEINLINE  static inline
+#define __NO_RETURN           __attribute__((__noreturn__))
+#define __USED                __attribute__((used))
+#define __WEAK                __attribute__((weak))
+#define __PACKED              __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT       struct __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)          __attribute__((aligned(x)))
+#define __RESTRICT            __restrict
+
+/* PRIMASK of the host, 1: interrupts disabled. */
+extern uint32_t host_primask;
+
+__STATIC_INLINE void __enable_irq(void) {
+    host_primask = 0U;
+}
+
+__STATIC_INLINE void __disable_irq(void) {
+    host_primask = 1U;
+}
+
+__STATIC_INLINE uint32_t __get_PRIMASK(void) {
+    return host_primask;
+}
+
+__STATIC_INLINE void __set_PRIMASK(uint32_t pri_mask) {
+    host_primask = pri_mask;
+}
+
+/**
+ * @brief The DWT registers used by the CSP, the cycle counter is advanced by
+ *        the tests.
+ */
+typedef struct {
+    __IOM uint32_t CTRL;
+    __IOM uint32_t CYCCNT;
+} DWT_Type;
+
+/**
+ * @brief The CoreDebug registers used by the CSP.
+ */
+typedef struct {
+    __IOM uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_core_debug;
+
+#define DWT                         (&host_dwt)
+#define CoreDebug                   (&host_core_debug)
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0U)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24U)
+
+#define __NOP() ((void)0)
+#define __DSB() __sync_synchronize()
+#define __DMB() __sync_synchronize()
+#define __ISB() __sync_synchronize()
+
+#define __COMPILER_BARRIER() __ASM volatile("" ::: "memory")
+
+#endif /* __CORE_CM4_H_GENERIC */
@@ -0,0 +1,716 @@
+/**
+ * @file    hal_stubs.c
+ * @brief   Recording HAL stubs for the CSP host tests.
+ */
+
+#include "hal_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* APB1, APB2 and AHB1 peripherals: 0x4000_0000 ~ 0x4002_FFFF. */
+#define HOST_PERIPH_SIZE 0x30000U
+/* GPIOA ~ GPIOK, 16 pins each. */
+#define HOST_GPIO_NUM    11U
+
+uint32_t host_primask;
+DWT_Type host_dwt;
+CoreDebug_Type host_core_debug;
+uint32_t SystemCoreClock = 168000000U;
+uint32_t host_tick;
+
+host_nvic_t host_nvic[HOST_IRQ_NUM];
+static host_pin_t host_pins[HOST_GPIO_NUM][16];
+
+int32_t host_alloc_count;
+uint32_t host_malloc_fail;
+uint32_t host_dma_init_fail;
+uint32_t host_uart_init_fail;
+
+uint8_t *host_rx_dma_buf;
+uint16_t host_rx_dma_size;
+
+const uint8_t *host_tx_dma_buf;
+uint16_t host_tx_dma_size;
+uint32_t host_tx_dma_count;
+
+/**
+ * @brief Map the peripheral window as zeroed memory at its real address.
+ */
+void host_periph_map(void) {
+    void *addr = mmap((void *)PERIPH_BASE, HOST_PERIPH_SIZE,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (addr != (void *)PERIPH_BASE) {
+        perror("mmap peripherals");
+        exit(2);
+    }
+}
+
+/**
+ * @brief State of the pin.
+ *
+ * @param port GPIO port.
+ * @param pin `GPIO_PIN_x`, only one pin.
+ * @return State of the pin.
+ */
+host_pin_t *host_pin(GPIO_TypeDef *port, uint32_t pin) {
+    uint32_t index = ((uintptr_t)port - GPIOA_BASE) >> 10;
+
+    return &host_pins[index][__builtin_ctz(pin)];
+}
+
+/**
+ * @brief Count down a failure trigger.
+ *
+ * @param trigger The trigger.
+ * @return true: This call fails.
+ */
+static bool host_fail(uint32_t *trigger) {
+    if (*trigger == 0U) {
+        return false;
+    }
+
+    return --*trigger == 0U;
+}
+
+void *host_malloc(size_t size) {
+    void *ptr;
+
+    if (host_fail(&host_malloc_fail)) {
+        return NULL;
+    }
+
+    ptr = malloc(size);
+    if (ptr != NULL) {
+        ++host_alloc_count;
+    }
+    return ptr;
+}
+
+void host_free(void *ptr) {
+    if (ptr != NULL) {
+        --host_alloc_count;
+    }
+    free(ptr);
+}
+
+/*****************************************************************************
+ * Cortex
+ */
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority,
+                          uint32_t SubPriority) {
+    host_nvic[IRQn].priority = PreemptPriority;
+    host_nvic[IRQn].sub = SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+    host_nvic[IRQn].enabled = true;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) {
+    host_nvic[IRQn].enabled = false;
+}
+
+uint32_t HAL_GetTick(void) {
+    return host_tick;
+}
+
+/*****************************************************************************
+ * RCC
+ */
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return SystemCoreClock / 4U;
+}
+
+/*****************************************************************************
+ * GPIO
+ */
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+    for (uint32_t pin = 0; pin < 16U; ++pin) {
+        if (GPIO_Init->Pin & (1U << pin)) {
+            host_pin_t *state = host_pin(GPIOx, 1U << pin);
+            state->inited = true;
+            state->mode = GPIO_Init->Mode;
+            state->pull = GPIO_Init->Pull;
+            state->alternate = GPIO_Init->Alternate;
+        }
+    }
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin) {
+    for (uint32_t pin = 0; pin < 16U; ++pin) {
+        if (GPIO_Pin & (1U << pin)) {
+            host_pin(GPIOx, 1U << pin)->inited = false;
+        }
+    }
+}
+
+/*****************************************************************************
+ * DMA
+ */
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) {
+    if (host_fail(&host_dma_init_fail)) {
+        return HAL_ERROR;
+    }
+
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma) {
+    hdma->State = HAL_DMA_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma) {
+    UNUSED(hdma);
+}
+
+/*****************************************************************************
+ * UART
+ */
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart) {
+    if (host_fail(&host_uart_init_fail)) {
+        return HAL_ERROR;
+    }
+
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart) {
+    huart->gState = HAL_UART_STATE_RESET;
+    huart->RxState = HAL_UART_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_UART_StateTypeDef HAL_UART_GetState(const UART_HandleTypeDef *huart) {
+    return (HAL_UART_StateTypeDef)(huart->gState | huart->RxState);
+}
+
+uint32_t HAL_UART_GetError(const UART_HandleTypeDef *huart) {
+    return huart->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart,
+                                       uint8_t *pData, uint16_t Size) {
+    host_rx_dma_buf = pData;
+    host_rx_dma_size = Size;
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    huart->hdmarx->Instance->NDTR = Size;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart,
+                                      uint8_t *pData, uint16_t Size) {
+    UNUSED(huart);
+    UNUSED(pData);
+    UNUSED(Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle(UART_HandleTypeDef *huart,
+                                           uint8_t *pData, uint16_t Size,
+                                           uint16_t *RxLen, uint32_t Timeout) {
+    UNUSED(huart);
+    UNUSED(pData);
+    UNUSED(Size);
+    UNUSED(Timeout);
+    *RxLen = 0;
+    return HAL_TIMEOUT;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart,
+                                    const uint8_t *pData, uint16_t Size,
+                                    uint32_t Timeout) {
+    UNUSED(huart);
+    UNUSED(Timeout);
+    fwrite(pData, 1, Size, stdout);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart,
+                                        const uint8_t *pData, uint16_t Size) {
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    host_tx_dma_buf = pData;
+    host_tx_dma_size = Size;
+    ++host_tx_dma_count;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    /* Same as the HAL, TC is cleared when the transfer starts. */
+    CLEAR_BIT(huart->Instance->SR, USART_SR_TC);
+    return HAL_OK;
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart) {
+    UNUSED(huart);
+}
+
+HAL_StatusTypeDef HAL_UART_RegisterCallback(UART_HandleTypeDef *huart,
+                                            HAL_UART_CallbackIDTypeDef CallbackID,
+                                            pUART_CallbackTypeDef pCallback) {
+    switch (CallbackID) {
+        case HAL_UART_TX_COMPLETE_CB_ID:
+            huart->TxCpltCallback = pCallback;
+            break;
+        case HAL_UART_RX_HALFCOMPLETE_CB_ID:
+            huart->RxHalfCpltCallback = pCallback;
+            break;
+        case HAL_UART_RX_COMPLETE_CB_ID:
+            huart->RxCpltCallback = pCallback;
+            break;
+        default:
+            return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_UnRegisterCallback(UART_HandleTypeDef *huart,
+                                              HAL_UART_CallbackIDTypeDef CallbackID) {
+    return HAL_UART_RegisterCallback(huart, CallbackID, NULL);
+}
+
+/*****************************************************************************
+ * CAN
+ */
+
+CAN_FilterTypeDef host_can_filter[HOST_CAN_FILTER_NUM];
+uint32_t host_can_filter_calls;
+static uint32_t host_can_slave_start = HOST_CAN_FILTER_NUM;
+static host_can_t host_cans[2];
+
+/**
+ * @brief State of a bxCAN.
+ *
+ * @param hcan The handle of CAN, CAN1 or CAN2.
+ * @return State of the CAN.
+ */
+host_can_t *host_can(const CAN_HandleTypeDef *hcan) {
+    return &host_cans[(hcan->Instance == CAN1) ? 0 : 1];
+}
+
+/**
+ * @brief Frame in the 32 bits filter layout: STDID[10:0], EXTID[17:0], IDE,
+ *        RTR, 0.
+ */
+static uint32_t host_can_id32(uint32_t ide, uint32_t rtr, uint32_t id) {
+    return ((ide == CAN_ID_STD) ? (id << 21) : (id << 3)) | ide | rtr;
+}
+
+/**
+ * @brief Frame in the 16 bits filter layout: STDID[10:0], RTR, IDE,
+ *        EXTID[17:15].
+ */
+static uint32_t host_can_id16(uint32_t ide, uint32_t rtr, uint32_t id) {
+    if (ide == CAN_ID_STD) {
+        return (id << 5) | (rtr << 3);
+    }
+
+    return ((id >> 18) << 5) | (rtr << 3) | 0x08U | ((id >> 15) & 0x07U);
+}
+
+/**
+ * @brief Filter the frame with the active banks of the CAN.
+ *
+ * @param hcan The handle of CAN.
+ * @param ide `CAN_ID_STD` or `CAN_ID_EXT`.
+ * @param rtr `CAN_RTR_DATA` or `CAN_RTR_REMOTE`.
+ * @param id Std or Ext ID.
+ * @param[out] filter Bank and slot matched, `bank * 4 + slot`, can be `NULL`.
+ * @return The FIFO the frame goes to, -1: rejected.
+ * @note Same priority as the hardware when several filters match: 32 bits
+ *       before 16 bits, then list mode before mask mode, then the lower
+ *       filter number.
+ */
+int32_t host_can_filter_match(CAN_HandleTypeDef *hcan, uint32_t ide,
+                              uint32_t rtr, uint32_t id, uint32_t *filter) {
+    uint32_t first = (hcan->Instance == CAN1) ? 0 : host_can_slave_start;
+    uint32_t last = (hcan->Instance == CAN1) ? host_can_slave_start
+                                             : HOST_CAN_FILTER_NUM;
+    uint32_t id32 = host_can_id32(ide, rtr, id);
+    uint32_t id16 = host_can_id16(ide, rtr, id);
+    int32_t best = -1;
+    uint32_t best_rank = 0;
+    uint32_t best_filter = 0;
+
+    for (uint32_t bank = first; bank < last; ++bank) {
+        const CAN_FilterTypeDef *f = &host_can_filter[bank];
+        uint32_t slot = 4;
+
+        if (f->FilterActivation != CAN_FILTER_ENABLE) {
+            continue;
+        }
+
+        if (f->FilterScale == CAN_FILTERSCALE_32BIT) {
+            uint32_t fr1 = (f->FilterIdHigh << 16) | f->FilterIdLow;
+            uint32_t fr2 = (f->FilterMaskIdHigh << 16) | f->FilterMaskIdLow;
+
+            if (f->FilterMode == CAN_FILTERMODE_IDMASK) {
+                slot = (((id32 ^ fr1) & fr2 & ~1U) == 0) ? 0 : 4;
+            } else if (id32 == (fr1 & ~1U)) {
+                slot = 0;
+            } else if (id32 == (fr2 & ~1U)) {
+                slot = 1;
+            }
+        } else if (f->FilterMode == CAN_FILTERMODE_IDMASK) {
+            if (((id16 ^ f->FilterIdLow) & f->FilterMaskIdLow) == 0) {
+                slot = 0;
+            } else if (((id16 ^ f->FilterIdHigh) & f->FilterMaskIdHigh) == 0) {
+                slot = 1;
+            }
+        } else {
+            const uint32_t list[4] = {f->FilterIdLow, f->FilterMaskIdLow,
+                                      f->FilterIdHigh, f->FilterMaskIdHigh};
+            for (uint32_t i = 0; i < 4; ++i) {
+                if (id16 == list[i]) {
+                    slot = i;
+                    break;
+                }
+            }
+        }
+
+        if (slot == 4) {
+            continue;
+        }
+
+        /* 32 bits list 4, 32 bits mask 3, 16 bits list 2, 16 bits mask 1,
+         * the first bank wins a tie. */
+        uint32_t rank = ((f->FilterScale == CAN_FILTERSCALE_32BIT) ? 3U : 1U) +
+                        ((f->FilterMode == CAN_FILTERMODE_IDLIST) ? 1U : 0U);
+        if (rank > best_rank) {
+            best_rank = rank;
+            best = (f->FilterFIFOAssignment == CAN_FILTER_FIFO0) ? 0 : 1;
+            best_filter = bank * 4 + slot;
+        }
+    }
+
+    if ((best >= 0) && (filter != NULL)) {
+        *filter = best_filter;
+    }
+
+    return best;
+}
+
+/**
+ * @brief A data frame arrives from the bus.
+ *
+ * @param hcan The handle of CAN.
+ * @param ide `CAN_ID_STD` or `CAN_ID_EXT`.
+ * @param id Std or Ext ID.
+ * @param dlc Data length.
+ * @param data Data.
+ * @return The FIFO it is stored in, -1: rejected by the filters, -2: lost,
+ *         the FIFO was full.
+ * @note The FIFO is not locked, same as `ReceiveFifoLocked = DISABLE`: the
+ *       last frame in a full FIFO is overwritten. The interrupt runs when
+ *       the test calls the IRQ handler.
+ */
+int32_t host_can_rx(CAN_HandleTypeDef *hcan, uint32_t ide, uint32_t id,
+                    uint32_t dlc, const uint8_t *data) {
+    host_can_t *can = host_can(hcan);
+    host_can_frame_t *frame;
+    uint32_t filter = 0;
+    int32_t fifo;
+    bool lost = false;
+
+    if (hcan->State != HAL_CAN_STATE_LISTENING) {
+        return -1;
+    }
+
+    fifo = host_can_filter_match(hcan, ide, CAN_RTR_DATA, id, &filter);
+    if (fifo < 0) {
+        ++can->rejected;
+        return -1;
+    }
+
+    if (can->fifo_level[fifo] == HOST_CAN_FIFO_DEPTH) {
+        ++can->overrun[fifo];
+        frame = &can->fifo[fifo][HOST_CAN_FIFO_DEPTH - 1];
+        lost = true;
+    } else {
+        frame = &can->fifo[fifo][can->fifo_level[fifo]++];
+    }
+
+    frame->ide = ide;
+    frame->rtr = CAN_RTR_DATA;
+    frame->id = id;
+    frame->dlc = dlc;
+    frame->filter = filter;
+    memcpy(frame->data, data, dlc);
+
+    if (can->fifo_level[fifo] > can->max_level[fifo]) {
+        can->max_level[fifo] = can->fifo_level[fifo];
+    }
+
+    return lost ? -2 : fifo;
+}
+
+/**
+ * @brief Arbitration field of a frame, lower wins: base ID, RTR or SRR, IDE,
+ *        extended ID, RTR.
+ */
+static uint32_t host_can_arbitration(const host_can_frame_t *frame) {
+    if (frame->ide == CAN_ID_STD) {
+        return (frame->id << 21) | ((frame->rtr == CAN_RTR_REMOTE) << 20);
+    }
+
+    return ((frame->id >> 18) << 21) | (1U << 20) | (1U << 19) |
+           ((frame->id & 0x3FFFFU) << 1) | (frame->rtr == CAN_RTR_REMOTE);
+}
+
+/**
+ * @brief The pending mailbox of the highest priority wins the bus and is
+ *        sent.
+ *
+ * @param hcan The handle of CAN.
+ * @return The frame sent, `NULL` if all mailboxes are empty.
+ * @note Same as `TransmitFifoPriority = DISABLE`: the lowest identifier
+ *       first, the lower mailbox on a tie. The mailbox complete interrupt
+ *       runs when the test calls the IRQ handler.
+ */
+const host_can_frame_t *host_can_bus_tx(CAN_HandleTypeDef *hcan) {
+    host_can_t *can = host_can(hcan);
+    host_can_frame_t *frame;
+    int32_t next = -1;
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        if (can->mailbox_busy[i] &&
+            ((next < 0) || (host_can_arbitration(&can->mailbox[i]) <
+                            host_can_arbitration(&can->mailbox[next])))) {
+            next = (int32_t)i;
+        }
+    }
+
+    if (next < 0) {
+        return NULL;
+    }
+
+    can->mailbox_busy[next] = false;
+    can->mailbox_done[next] = true;
+
+    frame = &can->tx_log[can->tx_count++ % HOST_CAN_TX_LOG_LEN];
+    *frame = can->mailbox[next];
+    return frame;
+}
+
+/* Weak callbacks, same as the HAL. */
+__weak void HAL_CAN_MspInit(CAN_HandleTypeDef *hcan) {
+    UNUSED(hcan);
+}
+
+__weak void HAL_CAN_MspDeInit(CAN_HandleTypeDef *hcan) {
+    UNUSED(hcan);
+}
+
+__weak void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan) {
+    UNUSED(hcan);
+}
+
+__weak void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan) {
+    UNUSED(hcan);
+}
+
+__weak void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan) {
+    UNUSED(hcan);
+}
+
+__weak void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan) {
+    UNUSED(hcan);
+}
+
+__weak void HAL_CAN_RxFifo1MsgPendingCallback(CAN_HandleTypeDef *hcan) {
+    UNUSED(hcan);
+}
+
+HAL_StatusTypeDef HAL_CAN_Init(CAN_HandleTypeDef *hcan) {
+    if (hcan->State == HAL_CAN_STATE_RESET) {
+        HAL_CAN_MspInit(hcan);
+    }
+
+    memset(host_can(hcan), 0, sizeof(host_can_t));
+    hcan->ErrorCode = HAL_CAN_ERROR_NONE;
+    hcan->State = HAL_CAN_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_DeInit(CAN_HandleTypeDef *hcan) {
+    HAL_CAN_Stop(hcan);
+    HAL_CAN_MspDeInit(hcan);
+
+    /* Software reset of the registers. */
+    hcan->Instance->IER = 0;
+    memset(host_can(hcan), 0, sizeof(host_can_t));
+    hcan->State = HAL_CAN_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef *hcan,
+                                       const CAN_FilterTypeDef *sFilterConfig) {
+    if ((hcan->State != HAL_CAN_STATE_READY) &&
+        (hcan->State != HAL_CAN_STATE_LISTENING)) {
+        return HAL_ERROR;
+    }
+
+    if (sFilterConfig->FilterBank >= HOST_CAN_FILTER_NUM) {
+        return HAL_ERROR;
+    }
+
+    /* Banks of both CANs are in CAN1. */
+    host_can_slave_start = sFilterConfig->SlaveStartFilterBank;
+    host_can_filter[sFilterConfig->FilterBank] = *sFilterConfig;
+    ++host_can_filter_calls;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef *hcan) {
+    if (hcan->State != HAL_CAN_STATE_READY) {
+        return HAL_ERROR;
+    }
+
+    hcan->State = HAL_CAN_STATE_LISTENING;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef *hcan) {
+    if (hcan->State != HAL_CAN_STATE_LISTENING) {
+        return HAL_ERROR;
+    }
+
+    hcan->State = HAL_CAN_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_CAN_StateTypeDef HAL_CAN_GetState(const CAN_HandleTypeDef *hcan) {
+    return hcan->State;
+}
+
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef *hcan,
+                                               uint32_t ActiveITs) {
+    hcan->Instance->IER |= ActiveITs;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef *hcan,
+                                       const CAN_TxHeaderTypeDef *pHeader,
+                                       const uint8_t aData[],
+                                       uint32_t *pTxMailbox) {
+    host_can_t *can = host_can(hcan);
+    host_can_frame_t *frame;
+
+    if ((hcan->State != HAL_CAN_STATE_READY) &&
+        (hcan->State != HAL_CAN_STATE_LISTENING)) {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        if (can->mailbox_busy[i]) {
+            continue;
+        }
+
+        frame = &can->mailbox[i];
+        frame->ide = pHeader->IDE;
+        frame->rtr = pHeader->RTR;
+        frame->id = (pHeader->IDE == CAN_ID_STD) ? pHeader->StdId
+                                                 : pHeader->ExtId;
+        frame->dlc = pHeader->DLC;
+        frame->filter = 0;
+        memcpy(frame->data, aData, sizeof(frame->data));
+
+        can->mailbox_busy[i] = true;
+        *pTxMailbox = CAN_TX_MAILBOX0 << i;
+        return HAL_OK;
+    }
+
+    hcan->ErrorCode |= HAL_CAN_ERROR_PARAM;
+    return HAL_ERROR;
+}
+
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(const CAN_HandleTypeDef *hcan) {
+    host_can_t *can = host_can(hcan);
+    uint32_t level = 0;
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        level += can->mailbox_busy[i] ? 0U : 1U;
+    }
+
+    return level;
+}
+
+uint32_t HAL_CAN_GetRxFifoFillLevel(const CAN_HandleTypeDef *hcan,
+                                    uint32_t RxFifo) {
+    return host_can(hcan)->fifo_level[RxFifo];
+}
+
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef *hcan,
+                                       uint32_t RxFifo,
+                                       CAN_RxHeaderTypeDef *pHeader,
+                                       uint8_t aData[]) {
+    host_can_t *can = host_can(hcan);
+    host_can_frame_t *frame = &can->fifo[RxFifo][0];
+
+    if (can->fifo_level[RxFifo] == 0) {
+        hcan->ErrorCode |= HAL_CAN_ERROR_PARAM;
+        return HAL_ERROR;
+    }
+
+    pHeader->IDE = frame->ide;
+    pHeader->RTR = frame->rtr;
+    pHeader->StdId = (frame->ide == CAN_ID_STD) ? frame->id : (frame->id >> 18);
+    pHeader->ExtId = (frame->ide == CAN_ID_STD) ? 0 : frame->id;
+    pHeader->DLC = frame->dlc;
+    pHeader->FilterMatchIndex = frame->filter;
+    pHeader->Timestamp = 0;
+    memcpy(aData, frame->data, frame->dlc);
+
+    /* Release the output mailbox. */
+    --can->fifo_level[RxFifo];
+    memmove(&can->fifo[RxFifo][0], &can->fifo[RxFifo][1],
+            can->fifo_level[RxFifo] * sizeof(host_can_frame_t));
+    return HAL_OK;
+}
+
+void HAL_CAN_IRQHandler(CAN_HandleTypeDef *hcan) {
+    host_can_t *can = host_can(hcan);
+    uint32_t ier = hcan->Instance->IER;
+
+    if (ier & CAN_IT_TX_MAILBOX_EMPTY) {
+        if (can->mailbox_done[0]) {
+            can->mailbox_done[0] = false;
+            HAL_CAN_TxMailbox0CompleteCallback(hcan);
+        }
+        if (can->mailbox_done[1]) {
+            can->mailbox_done[1] = false;
+            HAL_CAN_TxMailbox1CompleteCallback(hcan);
+        }
+        if (can->mailbox_done[2]) {
+            can->mailbox_done[2] = false;
+            HAL_CAN_TxMailbox2CompleteCallback(hcan);
+        }
+    }
+
+    if ((ier & CAN_IT_RX_FIFO0_MSG_PENDING) && (can->fifo_level[0] != 0)) {
+        HAL_CAN_RxFifo0MsgPendingCallback(hcan);
+    }
+
+    if ((ier & CAN_IT_RX_FIFO1_MSG_PENDING) && (can->fifo_level[1] != 0)) {
+        HAL_CAN_RxFifo1MsgPendingCallback(hcan);
+    }
+}
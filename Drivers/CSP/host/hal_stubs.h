@@ -0,0 +1,116 @@
+/**
+ * @file    hal_stubs.h
+ * @brief   Recording HAL stubs for the CSP host tests.
+ *
+ * @note The CSP is compiled with the real device and HAL headers. The
+ *       peripheral window is mapped as plain memory at its real address, so
+ *       the register macros (`RCC->APB2ENR`, `__HAL_UART_ENABLE_IT`,
+ *       `__HAL_DMA_GET_COUNTER` ...) and the registry index of the base
+ *       address work unchanged. HAL functions only record their arguments,
+ *       except CAN: the bxCAN model below has the RX FIFOs, TX mailboxes
+ *       and filter banks of the hardware, and the tests play the bus.
+ */
+
+#ifndef __HAL_STUBS_H
+#define __HAL_STUBS_H
+
+#include <CSP_Config.h>
+
+#include <stdbool.h>
+
+#define HOST_IRQ_NUM 128U
+
+/* bxCAN: frames in an RX FIFO, filter banks shared by CAN1 and CAN2, frames
+ * kept in the bus log. */
+#define HOST_CAN_FIFO_DEPTH  3U
+#define HOST_CAN_FILTER_NUM  28U
+#define HOST_CAN_TX_LOG_LEN  256U
+
+/**
+ * @brief State of an NVIC line.
+ */
+typedef struct {
+    bool enabled;
+    uint32_t priority;
+    uint32_t sub;
+} host_nvic_t;
+
+/**
+ * @brief State of a GPIO pin.
+ */
+typedef struct {
+    bool inited;
+    uint32_t mode;
+    uint32_t pull;
+    uint32_t alternate;
+} host_pin_t;
+
+/**
+ * @brief A CAN frame, received or sent on the bus.
+ */
+typedef struct {
+    uint32_t ide;    /*!< `CAN_ID_STD` or `CAN_ID_EXT`.         */
+    uint32_t rtr;    /*!< `CAN_RTR_DATA` or `CAN_RTR_REMOTE`.   */
+    uint32_t id;     /*!< Std or Ext ID.                        */
+    uint32_t dlc;    /*!< Data length.                          */
+    uint32_t filter; /*!< Filter match index, received only.    */
+    uint8_t data[8]; /*!< Data.                                 */
+} host_can_frame_t;
+
+/**
+ * @brief State of a bxCAN.
+ */
+typedef struct {
+    host_can_frame_t fifo[2][HOST_CAN_FIFO_DEPTH]; /*!< RX FIFO0 and FIFO1. */
+    uint32_t fifo_level[2];      /*!< Frames pending in each FIFO.          */
+    uint32_t overrun[2];         /*!< Frames lost, the FIFO was full.       */
+    uint32_t rejected;           /*!< Frames dropped by the filters.        */
+    uint32_t max_level[2];       /*!< Most frames pending in each FIFO.     */
+
+    bool mailbox_busy[3];        /*!< TX mailbox waits for the bus.         */
+    bool mailbox_done[3];        /*!< TX mailbox sent, interrupt pending.   */
+    host_can_frame_t mailbox[3]; /*!< TX mailboxes.                         */
+
+    host_can_frame_t tx_log[HOST_CAN_TX_LOG_LEN]; /*!< Frames sent.         */
+    uint32_t tx_count;           /*!< Frames sent, may exceed the log.      */
+} host_can_t;
+
+extern host_nvic_t host_nvic[HOST_IRQ_NUM];
+
+/* Number of CSP_MALLOC minus CSP_FREE. */
+extern int32_t host_alloc_count;
+/* The n-th CSP_MALLOC from now fails, 0: never fail. */
+extern uint32_t host_malloc_fail;
+/* The n-th HAL_DMA_Init from now fails, 0: never fail. */
+extern uint32_t host_dma_init_fail;
+/* The n-th HAL_UART_Init from now fails, 0: never fail. */
+extern uint32_t host_uart_init_fail;
+
+/* Buffer and size of the last HAL_UART_Receive_DMA. */
+extern uint8_t *host_rx_dma_buf;
+extern uint16_t host_rx_dma_size;
+/* Buffer and size of the last HAL_UART_Transmit_DMA, number of calls
+ * that started a transfer. It returns `HAL_BUSY` until the test sets
+ * `gState` back to ready. */
+extern const uint8_t *host_tx_dma_buf;
+extern uint16_t host_tx_dma_size;
+extern uint32_t host_tx_dma_count;
+
+/* Value of HAL_GetTick. */
+extern uint32_t host_tick;
+/* Filter banks programmed by HAL_CAN_ConfigFilter. */
+extern CAN_FilterTypeDef host_can_filter[HOST_CAN_FILTER_NUM];
+/* Number of HAL_CAN_ConfigFilter calls. */
+extern uint32_t host_can_filter_calls;
+
+void host_periph_map(void);
+host_pin_t *host_pin(GPIO_TypeDef *port, uint32_t pin);
+
+host_can_t *host_can(const CAN_HandleTypeDef *hcan);
+int32_t host_can_filter_match(CAN_HandleTypeDef *hcan, uint32_t ide,
+                              uint32_t rtr, uint32_t id, uint32_t *filter);
+int32_t host_can_rx(CAN_HandleTypeDef *hcan, uint32_t ide, uint32_t id,
+                    uint32_t dlc, const uint8_t *data);
+const host_can_frame_t *host_can_bus_tx(CAN_HandleTypeDef *hcan);
+
+#endif /* __HAL_STUBS_H */
@@ -0,0 +1,38 @@
+#!/bin/sh
+# Flash/RAM of UART_STM32F4xx.c before and after a change, on the host.
+#
+# Usage: host/size_report.sh [rev]   (run in Drivers/CSP, rev defaults to HEAD)
+#
+# Compiles the working tree file and the file at `rev` with gcc -Os against
+# the real device and HAL headers, once with the project configuration
+# (Config/CSP_Config.h) and once with the test configuration
+# (host/CSP_Config.h), and prints text/data/bss of both objects. -fno-pic
+# keeps the const descriptors in .rodata as in the firmware image. Host code
+# is not Cortex-M code, only the difference between the two is meaningful.
+
+set -e
+
+rev=${1:-HEAD}
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+# Only the host stand-ins, so that Config/CSP_Config.h is found first.
+mkdir "$tmp/inc"
+cp host/core_cm4.h host/stm32f4xx_hal_conf.h "$tmp/inc/"
+git show "$rev:Drivers/CSP/UART_STM32F4xx.c" > "$tmp/UART_STM32F4xx.c"
+
+CFLAGS="-std=gnu11 -Os -fno-pic -ffunction-sections -fdata-sections -DUSE_HAL_DRIVER -DSTM32F429xx"
+HAL="-I../CMSIS/Device/ST/STM32F4xx/Include -I../STM32_HAL_Driver/Inc -I../../User/Utils -I."
+
+report() {
+    name=$1
+    inc=$2
+    gcc $CFLAGS $inc $HAL -c "$tmp/UART_STM32F4xx.c" -o "$tmp/old.o"
+    gcc $CFLAGS $inc $HAL -c UART_STM32F4xx.c -o "$tmp/new.o"
+    echo "== $name"
+    size "$tmp/old.o" "$tmp/new.o" | sed -e "s|$tmp/old.o|$rev|" \
+                                        -e "s|$tmp/new.o|working tree|"
+}
+
+report "project config (Config/CSP_Config.h)" "-I$tmp/inc -IConfig"
+report "test config (host/CSP_Config.h)" "-Ihost"
@@ -0,0 +1,56 @@
+/**
+ * @file    stm32f4xx_hal_conf.h
+ * @brief   HAL configuration of the host tests.
+ *
+ * @note Only the modules used by the CSP under test, the other modules pull
+ *       in LL headers that assume 32-bit pointers. The values that matter
+ *       to the CSP are the same as `User/Application/Inc/stm32f4xx_hal_conf.h`.
+ */
+
+#ifndef __STM32F4xx_HAL_CONF_H
+#define __STM32F4xx_HAL_CONF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HAL_MODULE_ENABLED
+#define HAL_CORTEX_MODULE_ENABLED
+#define HAL_DMA_MODULE_ENABLED
+#define HAL_GPIO_MODULE_ENABLED
+#define HAL_RCC_MODULE_ENABLED
+#define HAL_UART_MODULE_ENABLED
+#define HAL_CAN_MODULE_ENABLED
+
+#define HSE_VALUE                       25000000UL
+#define HSE_STARTUP_TIMEOUT             100UL
+#define HSI_VALUE                       16000000UL
+#define LSE_VALUE                       32768UL
+#define LSE_STARTUP_TIMEOUT             5000UL
+#define LSI_VALUE                       32000UL
+#define EXTERNAL_CLOCK_VALUE            12288000UL
+
+#define VDD_VALUE                       3300UL
+#define TICK_INT_PRIORITY               15UL
+#define USE_RTOS                        0
+#define PREFETCH_ENABLE                 1
+#define INSTRUCTION_CACHE_ENABLE        1
+#define DATA_CACHE_ENABLE               1
+
+#define USE_HAL_CAN_REGISTER_CALLBACKS  0
+#define USE_HAL_UART_REGISTER_CALLBACKS 1
+
+#include "stm32f4xx_hal_rcc.h"
+#include "stm32f4xx_hal_gpio.h"
+#include "stm32f4xx_hal_dma.h"
+#include "stm32f4xx_hal_cortex.h"
+#include "stm32f4xx_hal_can.h"
+#include "stm32f4xx_hal_uart.h"
+
+#define assert_param(expr) ((void)0U)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F4xx_HAL_CONF_H */
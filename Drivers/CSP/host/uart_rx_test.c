@@ -0,0 +1,329 @@
+/**
+ * @file    uart_rx_test.c
+ * @brief   Read in place from the circular Rx DMA buffer of the UART CSP on
+ *          the host, with a model of the DMA at 921600 baud.
+ *
+ * @note The test plays the line and the DMA: bytes arrive at 92.16 bytes per
+ *       ms, each one is written at `RxXferSize - NDTR` and NDTR counts down
+ *       and reloads as in circular mode, the half and full transfer
+ *       callbacks run when NDTR crosses them, and the IDLE interrupt runs
+ *       at the end of each burst. The consumer peeks, checks every byte and
+ *       consumes what it got, the way a parser would. Checks:
+ *
+ *       - data received before the first peek is still in the fifo;
+ *       - bursts with idle gaps and a full line, consumer every 1 or 2 ms:
+ *         every byte arrives once, in order, and no overrun;
+ *       - consumer slower than the buffer: the loss is never silent, every
+ *         skip is counted by peek and the data after it is right;
+ *       - the DMA reaches the data while it is read: consume returns 2;
+ *       - consume longer than the data returns 3.
+ */
+
+#include "hal_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Vector of USART1, defined by the CSP. */
+void USART1_IRQHandler(void);
+
+/* 921600 baud, 10 bits per byte. */
+#define LINE_BYTES_PER_S 92160U
+#define LINE_STEP_US     100U
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+static UART_HandleTypeDef *const test_uart = &usart1_handle;
+static uint32_t test_seed = 1;
+
+/* Bytes written by the DMA, and the index of the next byte to read. */
+static uint64_t line_sent;
+static uint64_t rx_expect;
+/* Time of the line. */
+static uint64_t line_us;
+
+/**
+ * @brief Result of one run.
+ */
+static struct {
+    uint64_t recv;     /*!< Bytes read and right.                */
+    uint64_t bad;      /*!< Bytes read and wrong.                */
+    uint64_t skipped;  /*!< Bytes dropped by the overruns.       */
+    uint32_t overrun;  /*!< Overruns reported by peek.           */
+    uint32_t wrapped;  /*!< Peeks that returned two spans.       */
+    uint32_t max_len;  /*!< Most bytes returned by one peek.     */
+} run;
+
+static uint32_t test_rand(void) {
+    test_seed = test_seed * 1103515245U + 12345U;
+    return test_seed >> 8;
+}
+
+/**
+ * @brief Byte `i` on the line, does not repeat with the buffer size, so a
+ *        lapped buffer is seen.
+ */
+static uint8_t line_byte(uint64_t i) {
+    return (uint8_t)(((uint32_t)i * 2654435761U) >> 24);
+}
+
+/**
+ * @brief The DMA writes `len` bytes from the line.
+ */
+static void line_dma(uint32_t len) {
+    DMA_Stream_TypeDef *stream = test_uart->hdmarx->Instance;
+    uint32_t size = test_uart->RxXferSize;
+
+    for (uint32_t i = 0; i < len; ++i) {
+        test_uart->pRxBuffPtr[size - stream->NDTR] = line_byte(line_sent++);
+        --stream->NDTR;
+
+        if (stream->NDTR == size / 2U) {
+            test_uart->RxHalfCpltCallback(test_uart);
+        } else if (stream->NDTR == 0) {
+            /* Circular mode reloads NDTR. */
+            stream->NDTR = size;
+            test_uart->RxCpltCallback(test_uart);
+        }
+    }
+}
+
+/**
+ * @brief The line goes idle.
+ */
+static void line_idle(void) {
+    SET_BIT(USART1->SR, USART_SR_IDLE);
+    USART1_IRQHandler();
+    CLEAR_BIT(USART1->SR, USART_SR_IDLE);
+}
+
+/**
+ * @brief Peek, check the bytes and consume them.
+ */
+static void test_consume(void) {
+    uart_rx_span_t span[2];
+    uint32_t overrun = uart_dmarx_get_overrun(test_uart);
+    uint32_t len = uart_dmarx_peek(test_uart, span);
+
+    if (uart_dmarx_get_overrun(test_uart) != overrun) {
+        /* Skipped to the newest byte. */
+        ++run.overrun;
+        run.skipped += line_sent - rx_expect;
+        rx_expect = line_sent;
+        CHECK(len == 0);
+        return;
+    }
+
+    CHECK(span[0].len + span[1].len == len);
+    run.wrapped += (span[1].len != 0);
+    run.max_len = (len > run.max_len) ? len : run.max_len;
+
+    for (uint32_t s = 0; s < 2; ++s) {
+        for (uint32_t i = 0; i < span[s].len; ++i) {
+            if (span[s].data[i] == line_byte(rx_expect)) {
+                ++run.recv;
+            } else {
+                ++run.bad;
+            }
+            ++rx_expect;
+        }
+    }
+
+    CHECK(uart_dmarx_consume(test_uart, len) == 0);
+}
+
+/**
+ * @brief Run the line for `ms` and consume every `poll_us`.
+ *
+ * @param burst true: bursts of 1 ~ 200 bytes with 0 ~ 2 ms idle gaps,
+ *              false: the line is always busy.
+ * @param stall true: the consumer misses 4 ms every 100 ms.
+ */
+static void test_line(uint32_t ms, uint32_t poll_us, bool burst, bool stall) {
+    uint64_t end = line_us + ms * 1000ULL;
+    uint32_t burst_left = 0, gap_us = 0, send;
+
+    memset(&run, 0, sizeof(run));
+
+    while (line_us < end) {
+        /* Bytes the line can carry in this step. */
+        send = (uint32_t)((line_us + LINE_STEP_US) * LINE_BYTES_PER_S /
+                              1000000U -
+                          line_us * LINE_BYTES_PER_S / 1000000U);
+        line_us += LINE_STEP_US;
+
+        if (burst) {
+            if (burst_left == 0) {
+                if (gap_us > LINE_STEP_US) {
+                    gap_us -= LINE_STEP_US;
+                    send = 0;
+                } else {
+                    burst_left = 1U + test_rand() % 200U;
+                    gap_us = test_rand() % 2000U;
+                }
+            }
+            send = (send > burst_left) ? burst_left : send;
+            burst_left -= send;
+        }
+
+        line_dma(send);
+        if (burst && (send != 0) && (burst_left == 0)) {
+            line_idle();
+        }
+
+        if ((line_us % poll_us == 0) &&
+            !(stall && (line_us / 1000U % 100U < 4U))) {
+            test_consume();
+        }
+    }
+}
+
+/**
+ * @brief Data received before the first peek goes to the fifo, after it
+ *        the fifo is bypassed.
+ */
+static void test_switch(void) {
+    uint8_t buf[64];
+    uart_rx_span_t span[2];
+
+    line_dma(40);
+    line_idle();
+    CHECK(uart_dmarx_read(test_uart, buf, sizeof(buf)) == 40);
+    for (uint32_t i = 0; i < 40; ++i) {
+        CHECK(buf[i] == line_byte(line_sent - 40U + i));
+    }
+
+    line_dma(10);
+    line_idle();
+    CHECK(uart_dmarx_peek(test_uart, span) == 0);
+    /* Still in the fifo. */
+    CHECK(uart_dmarx_read(test_uart, buf, sizeof(buf)) == 10);
+
+    line_dma(20);
+    line_idle();
+    CHECK(uart_dmarx_peek(test_uart, span) == 20);
+    CHECK(span[0].data[0] == line_byte(line_sent - 20U));
+    CHECK(uart_dmarx_consume(test_uart, 20) == 0);
+    CHECK(uart_dmarx_read(test_uart, buf, sizeof(buf)) == 0);
+    CHECK(uart_dmarx_get_overrun(test_uart) == 0);
+    rx_expect = line_sent;
+}
+
+/**
+ * @brief Bursts and a full line, consumer fast enough: no byte lost.
+ */
+static void test_no_loss(void) {
+    static const struct {
+        uint32_t poll_us;
+        bool burst;
+    } cases[] = {{1000, true}, {2000, true}, {1000, false}, {2000, false}};
+
+    printf("%-6s %-5s %9s %9s %6s %8s %8s %8s\n", "poll", "line", "sent",
+           "recv", "bad", "overrun", "wrapped", "max");
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        uint64_t sent = line_sent;
+
+        test_line(10000, cases[i].poll_us, cases[i].burst, false);
+        /* Take the rest. */
+        line_idle();
+        test_consume();
+        sent = line_sent - sent;
+
+        printf("%4ums %-5s %9llu %9llu %6llu %8u %8u %8u\n",
+               (unsigned)(cases[i].poll_us / 1000U),
+               cases[i].burst ? "burst" : "full", (unsigned long long)sent,
+               (unsigned long long)run.recv, (unsigned long long)run.bad,
+               (unsigned)run.overrun, (unsigned)run.wrapped,
+               (unsigned)run.max_len);
+        CHECK(sent > 100000U);
+        CHECK(run.recv == sent);
+        CHECK(run.bad == 0);
+        CHECK(run.overrun == 0);
+        CHECK(run.wrapped != 0);
+        CHECK(run.max_len <= test_uart->RxXferSize);
+    }
+}
+
+/**
+ * @brief Consumer stalls longer than the buffer (256 bytes is 2.78 ms):
+ *        bytes are lost, but every loss is reported and what is read is
+ *        right.
+ */
+static void test_slow(void) {
+    uint64_t start = line_sent;
+    uint64_t expect = rx_expect;
+    uint32_t overrun = uart_dmarx_get_overrun(test_uart);
+
+    test_line(1000, 1000, false, true);
+
+    printf("%-6s %-5s %9llu %9llu %6llu %8u %8u %8u\n", "stall", "full",
+           (unsigned long long)(line_sent - start),
+           (unsigned long long)run.recv, (unsigned long long)run.bad,
+           (unsigned)run.overrun, (unsigned)run.wrapped,
+           (unsigned)run.max_len);
+    CHECK(run.overrun == 10);
+    CHECK(run.bad == 0);
+    /* Nothing lost without an overrun. */
+    CHECK(run.recv + run.skipped == rx_expect - expect);
+    CHECK(uart_dmarx_get_overrun(test_uart) == overrun + run.overrun);
+
+    /* Back to a consumer without stalls, no more overrun. */
+    test_line(1000, 1000, false, false);
+    CHECK(run.overrun == 0);
+    CHECK(run.bad == 0);
+}
+
+/**
+ * @brief The DMA reaches the data while it is read in place.
+ */
+static void test_consume_overrun(void) {
+    uart_rx_span_t span[2];
+    uint32_t overrun = uart_dmarx_get_overrun(test_uart);
+    uint32_t len;
+
+    line_dma(100);
+    len = uart_dmarx_peek(test_uart, span);
+    CHECK(len == 100);
+    CHECK(uart_dmarx_consume(test_uart, len + 1U) == 3);
+
+    /* Fine as long as the DMA has not come back to the first byte. */
+    line_dma(test_uart->RxXferSize - len);
+    CHECK(uart_dmarx_consume(test_uart, 50) == 0);
+
+    /* Now it has overwritten the rest of what was peeked. */
+    line_dma(60);
+    CHECK(uart_dmarx_consume(test_uart, 50) == 2);
+    CHECK(uart_dmarx_get_overrun(test_uart) == overrun + 1U);
+
+    /* What is left after the released data is still in the buffer. */
+    len = uart_dmarx_peek(test_uart, span);
+    CHECK(uart_dmarx_get_overrun(test_uart) == overrun + 1U);
+    CHECK(len == test_uart->RxXferSize + 60U - 100U);
+    CHECK(span[0].data[0] == line_byte(line_sent - len));
+    CHECK(uart_dmarx_consume(test_uart, len) == 0);
+}
+
+int main(void) {
+    host_periph_map();
+    CHECK(usart1_init(921600) == UART_INIT_OK);
+    CHECK(test_uart->hdmarx->Init.Mode == DMA_CIRCULAR);
+
+    test_switch();
+    test_no_loss();
+    test_slow();
+    test_consume_overrun();
+
+    CHECK(usart1_deinit() == UART_DEINIT_OK);
+    CHECK(host_alloc_count == 0);
+
+    printf("%s\n", (test_fail == 0) ? "ok" : "FAIL");
+    return (test_fail == 0) ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file    uart_test.c
+ * @brief   Init and deinit of the UART CSP on the host with stubbed HAL.
+ *
+ * @note Checks what `uart_init` and `uart_deinit` do from the per-instance
+ *       descriptors: pins and alternate functions, RCC enable bits, NVIC
+ *       priorities, DMA links and buffer sizes from the registry, the unwind
+ *       on every failure, and that nothing leaks after deinit.
+ */
+
+#include "hal_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Vector of UART5, defined by the CSP. */
+void UART5_IRQHandler(void);
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief Pin is inited as pull-up AF push-pull with the alternate function.
+ */
+static bool test_pin_af(GPIO_TypeDef *port, uint32_t pin, uint32_t af) {
+    host_pin_t *state = host_pin(port, pin);
+
+    return state->inited && (state->mode == GPIO_MODE_AF_PP) &&
+           (state->pull == GPIO_PULLUP) && (state->alternate == af);
+}
+
+static bool test_irq(IRQn_Type irqn, uint32_t priority, uint32_t sub) {
+    return host_nvic[irqn].enabled && (host_nvic[irqn].priority == priority) &&
+           (host_nvic[irqn].sub == sub);
+}
+
+/**
+ * @brief USART1: APB2, four pins, interrupt, Rx and Tx DMA on DMA2.
+ */
+static void test_usart1(void) {
+    CHECK(usart1_init(115200) == UART_INIT_OK);
+    CHECK(usart1_init(115200) == UART_INITED);
+
+    CHECK(READ_BIT(RCC->APB2ENR, RCC_APB2ENR_USART1EN));
+    CHECK(READ_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_GPIOBEN) ==
+          (RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_GPIOBEN));
+    CHECK(READ_BIT(RCC->AHB1ENR, RCC_AHB1ENR_DMA2EN));
+
+    CHECK(test_pin_af(GPIOA, GPIO_PIN_9, GPIO_AF7_USART1));
+    CHECK(test_pin_af(GPIOB, GPIO_PIN_7, GPIO_AF7_USART1));
+    CHECK(test_pin_af(GPIOA, GPIO_PIN_11, GPIO_AF7_USART1));
+    CHECK(test_pin_af(GPIOA, GPIO_PIN_12, GPIO_AF7_USART1));
+
+    CHECK(usart1_handle.Init.BaudRate == 115200);
+    CHECK(usart1_handle.Init.Mode == UART_MODE_TX_RX);
+    CHECK(usart1_handle.Init.HwFlowCtl == UART_HWCONTROL_RTS_CTS);
+
+    CHECK(test_irq(USART1_IRQn, 2, 3));
+    CHECK(test_irq(DMA2_Stream2_IRQn, 2, 1));
+    CHECK(test_irq(DMA2_Stream7_IRQn, 3, 0));
+
+    CHECK(usart1_handle.hdmarx->Instance == DMA2_Stream2);
+    CHECK(usart1_handle.hdmarx->Parent == &usart1_handle);
+    CHECK(usart1_handle.hdmatx->Instance == DMA2_Stream7);
+    CHECK(usart1_handle.hdmatx->Parent == &usart1_handle);
+
+    CHECK(uart_dmarx_get_buf_size(&usart1_handle) == 256);
+    CHECK(uart_dmarx_get_fifo_size(&usart1_handle) == 512);
+    CHECK(uart_damtx_get_buf_szie(&usart1_handle) == 128);
+    CHECK(host_rx_dma_size == 256);
+    CHECK(READ_BIT(USART1->CR1, USART_CR1_IDLEIE));
+
+    CHECK(usart1_handle.RxHalfCpltCallback != NULL);
+    CHECK(usart1_handle.RxCpltCallback != NULL);
+    CHECK(usart1_handle.TxCpltCallback != NULL);
+
+    CHECK(usart1_deinit() == UART_DEINIT_OK);
+    CHECK(usart1_deinit() == UART_NO_INIT);
+
+    CHECK(!READ_BIT(RCC->APB2ENR, RCC_APB2ENR_USART1EN));
+    CHECK(!host_pin(GPIOA, GPIO_PIN_9)->inited);
+    CHECK(!host_pin(GPIOB, GPIO_PIN_7)->inited);
+    CHECK(!host_pin(GPIOA, GPIO_PIN_11)->inited);
+    CHECK(!host_pin(GPIOA, GPIO_PIN_12)->inited);
+    CHECK(!host_nvic[USART1_IRQn].enabled);
+    CHECK(!host_nvic[DMA2_Stream2_IRQn].enabled);
+    CHECK(!host_nvic[DMA2_Stream7_IRQn].enabled);
+    CHECK(usart1_handle.hdmarx == NULL);
+    CHECK(usart1_handle.hdmatx == NULL);
+    CHECK(usart1_handle.RxCpltCallback == NULL);
+    CHECK(host_alloc_count == 0);
+}
+
+/**
+ * @brief UART5: APB1, two pins, interrupt, Rx DMA on DMA1 only. Data
+ *        written by the DMA goes through the registry to the fifo.
+ */
+static void test_uart5(void) {
+    static const char data[] = "uart5 rx";
+    char buf[sizeof(data)] = {0};
+
+    CHECK(uart5_init(921600) == UART_INIT_OK);
+
+    CHECK(READ_BIT(RCC->APB1ENR, RCC_APB1ENR_UART5EN));
+    CHECK(READ_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIOCEN | RCC_AHB1ENR_GPIODEN) ==
+          (RCC_AHB1ENR_GPIOCEN | RCC_AHB1ENR_GPIODEN));
+    CHECK(READ_BIT(RCC->AHB1ENR, RCC_AHB1ENR_DMA1EN));
+
+    CHECK(test_pin_af(GPIOC, GPIO_PIN_12, GPIO_AF8_UART5));
+    CHECK(test_pin_af(GPIOD, GPIO_PIN_2, GPIO_AF8_UART5));
+    CHECK(uart5_handle.Init.Mode == UART_MODE_TX_RX);
+    CHECK(uart5_handle.Init.HwFlowCtl == UART_HWCONTROL_NONE);
+
+    CHECK(test_irq(UART5_IRQn, 5, 3));
+    CHECK(test_irq(DMA1_Stream0_IRQn, 4, 2));
+    CHECK(uart5_handle.hdmarx->Instance == DMA1_Stream0);
+    CHECK(uart5_handle.hdmatx == NULL);
+    CHECK(uart_dmarx_get_buf_size(&uart5_handle) == 64);
+    CHECK(uart_damtx_get_buf_szie(&uart5_handle) == 0);
+
+    /* DMA writes the data and the line goes idle. */
+    memcpy(host_rx_dma_buf, data, sizeof(data));
+    DMA1_Stream0->NDTR = host_rx_dma_size - sizeof(data);
+    SET_BIT(UART5->SR, USART_SR_IDLE);
+    UART5_IRQHandler();
+    CHECK(uart_dmarx_read(&uart5_handle, buf, sizeof(buf)) == sizeof(data));
+    CHECK(memcmp(buf, data, sizeof(data)) == 0);
+
+    CHECK(uart5_deinit() == UART_DEINIT_OK);
+    CHECK(!READ_BIT(RCC->APB1ENR, RCC_APB1ENR_UART5EN));
+    CHECK(!host_nvic[DMA1_Stream0_IRQn].enabled);
+    CHECK(host_alloc_count == 0);
+}
+
+/**
+ * @brief UART7: APB1, two pins, no interrupt, no DMA.
+ */
+static void test_uart7(void) {
+    CHECK(uart7_init(9600) == UART_INIT_OK);
+
+    CHECK(READ_BIT(RCC->APB1ENR, RCC_APB1ENR_UART7EN));
+    CHECK(READ_BIT(RCC->AHB1ENR, RCC_AHB1ENR_GPIOFEN));
+    CHECK(test_pin_af(GPIOF, GPIO_PIN_7, GPIO_AF8_UART7));
+    CHECK(test_pin_af(GPIOF, GPIO_PIN_6, GPIO_AF8_UART7));
+    CHECK(!host_nvic[UART7_IRQn].enabled);
+    CHECK(uart7_handle.hdmarx == NULL);
+    CHECK(uart7_handle.hdmatx == NULL);
+    CHECK(uart_dmarx_get_buf_size(&uart7_handle) == 0);
+    CHECK(host_alloc_count == 0);
+
+    CHECK(uart7_deinit() == UART_DEINIT_OK);
+    CHECK(!READ_BIT(RCC->APB1ENR, RCC_APB1ENR_UART7EN));
+    CHECK(!host_pin(GPIOF, GPIO_PIN_7)->inited);
+}
+
+/**
+ * @brief Every failure of USART1 init leaves nothing allocated and the
+ *        handle not inited, the next init succeeds.
+ */
+static void test_unwind(void) {
+    static const struct {
+        uint32_t *trigger;
+        uint32_t nth;
+        uint8_t expect;
+    } cases[] = {
+        {&host_malloc_fail, 1, UART_INIT_MEM_FAIL},    /* Rx recv buf   */
+        {&host_malloc_fail, 2, UART_INIT_MEM_FAIL},    /* Rx fifo buf   */
+        {&host_malloc_fail, 3, UART_INIT_MEM_FAIL},    /* Tx send buf   */
+        {&host_dma_init_fail, 1, UART_INIT_DMA_FAIL},  /* Rx DMA        */
+        {&host_dma_init_fail, 2, UART_INIT_DMA_FAIL},  /* Tx DMA        */
+        {&host_uart_init_fail, 1, UART_INIT_FAIL},     /* HAL_UART_Init */
+    };
+
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        *cases[i].trigger = cases[i].nth;
+        CHECK(usart1_init(115200) == cases[i].expect);
+        *cases[i].trigger = 0;
+
+        CHECK(host_alloc_count == 0);
+        CHECK(usart1_handle.hdmarx == NULL);
+        CHECK(usart1_handle.hdmatx == NULL);
+        CHECK(HAL_UART_GetState(&usart1_handle) == HAL_UART_STATE_RESET);
+
+        CHECK(usart1_init(115200) == UART_INIT_OK);
+        CHECK(usart1_deinit() == UART_DEINIT_OK);
+        CHECK(host_alloc_count == 0);
+    }
+}
+
+int main(void) {
+    host_periph_map();
+
+    test_usart1();
+    test_uart5();
+    test_uart7();
+    test_unwind();
+
+    printf("%s\n", (test_fail == 0) ? "ok" : "FAIL");
+    return (test_fail == 0) ? 0 : 1;
+}
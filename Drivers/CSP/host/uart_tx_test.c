@@ -0,0 +1,270 @@
+/**
+ * @file    uart_tx_test.c
+ * @brief   Ping-pong DMA Tx of the UART CSP on the host, with a model of the
+ *          DMA and TC timing at 921600 baud.
+ *
+ * @note The test plays the line: a transfer started by
+ *       `HAL_UART_Transmit_DMA` takes 10 bits per byte, then TC is set, the
+ *       UART is ready again and the Tx complete callback runs, as the DMA
+ *       and UART interrupts do. The half on the wire is compared with the
+ *       copy taken when it started, so a write into it is seen. An alarm
+ *       ends the test if a call waits for TC. Checks:
+ *
+ *       - writes go into the other half while one is on the wire, the
+ *         complete callback starts the waiting half by itself;
+ *       - a write that does not fit returns 0 and writes nothing, it fits
+ *         again after the swap;
+ *       - producers below and above the line rate: every accepted frame is
+ *         on the wire whole and in order, rejected frames are not there at
+ *         all, the line never idles while data waits, and the half on the
+ *         wire is never written.
+ */
+
+#include "hal_stubs.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* 921600 baud, 10 bits per byte. */
+#define LINE_BYTES_PER_S 92160U
+#define LINE_STEP_US     10U
+#define FRAME_LEN        64U
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+static UART_HandleTypeDef *const test_uart = &usart1_handle;
+
+/* Bytes sent on the line. */
+static uint8_t wire[1U << 20];
+static uint32_t wire_len;
+
+/**
+ * @brief State of the line.
+ */
+static struct {
+    uint64_t us;             /*!< Time of the line.                        */
+    uint64_t credit;         /*!< Bytes the line could have carried.       */
+    uint32_t left;           /*!< Bytes of the transfer not sent yet.      */
+    uint8_t copy[256];       /*!< The half on the wire when it started.    */
+    uint32_t copy_len;       /*!< Length of the transfer.                  */
+    uint32_t overwritten;    /*!< Transfers changed while on the wire.     */
+    uint64_t busy_us;        /*!< Time with a transfer on the wire.        */
+    uint64_t stall_us;       /*!< Time idle while data waits in the driver. */
+} line;
+
+/**
+ * @brief Called instead of hanging when a call waits for TC.
+ */
+static void test_alarm(int sig) {
+    UNUSED(sig);
+    printf("busy-wait: a call did not return\n");
+    _exit(1);
+}
+
+/**
+ * @brief Take the transfer started since the last call.
+ */
+static void line_take(uint32_t *count) {
+    if (host_tx_dma_count == *count) {
+        return;
+    }
+
+    *count = host_tx_dma_count;
+    line.left = host_tx_dma_size;
+    line.copy_len = host_tx_dma_size;
+    memcpy(line.copy, host_tx_dma_buf, host_tx_dma_size);
+}
+
+/**
+ * @brief Run the line for one step, finish the transfer if it is done.
+ *
+ * @param pending Data waits in the driver.
+ */
+static void line_step(bool pending) {
+    static uint32_t count;
+    uint32_t send;
+
+    line_take(&count);
+    line.us += LINE_STEP_US;
+    send = (uint32_t)(line.us * LINE_BYTES_PER_S / 1000000U - line.credit);
+    line.credit += send;
+
+    if (line.left == 0) {
+        line.stall_us += pending ? LINE_STEP_US : 0;
+        return;
+    }
+
+    line.busy_us += LINE_STEP_US;
+    if (send < line.left) {
+        line.left -= send;
+        return;
+    }
+
+    /* Done: the DMA read the half, TC is set, the callback runs. */
+    line.left = 0;
+    line.overwritten +=
+        (memcmp(line.copy, host_tx_dma_buf, line.copy_len) != 0);
+    memcpy(&wire[wire_len], line.copy, line.copy_len);
+    wire_len += line.copy_len;
+
+    SET_BIT(USART1->SR, USART_SR_TC);
+    test_uart->gState = HAL_UART_STATE_READY;
+    test_uart->TxCpltCallback(test_uart);
+    line_take(&count);
+}
+
+/**
+ * @brief Run the line until nothing is left to send.
+ */
+static void line_flush(void) {
+    do {
+        line_step(false);
+    } while (line.left != 0);
+}
+
+/**
+ * @brief Frame `seq`: length, sequence, payload from the sequence.
+ */
+static void frame_fill(uint8_t *frame, uint32_t seq) {
+    frame[0] = FRAME_LEN;
+    memcpy(&frame[1], &seq, sizeof(seq));
+    for (uint32_t i = 5; i < FRAME_LEN; ++i) {
+        frame[i] = (uint8_t)(seq * 31U + i);
+    }
+}
+
+/**
+ * @brief One half on the wire, the other one filled and started by the
+ *        complete callback.
+ */
+static void test_ping_pong(void) {
+    uint32_t half = uart_damtx_get_buf_szie(test_uart);
+    uint8_t data[128];
+    uint32_t count = host_tx_dma_count;
+
+    for (uint32_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)i;
+    }
+
+    CHECK(half == sizeof(data));
+    CHECK(uart_dmatx_send(test_uart) == 0);
+    CHECK(uart_dmatx_write(test_uart, data, 40) == 40);
+    CHECK(uart_dmatx_send(test_uart) == 40);
+    CHECK(host_tx_dma_count == count + 1U);
+    CHECK(!READ_BIT(USART1->SR, USART_SR_TC));
+
+    /* On the wire: the other half takes a whole buffer, then refuses. */
+    CHECK(uart_dmatx_write(test_uart, data, half) == half);
+    CHECK(uart_dmatx_write(test_uart, data, 1) == 0);
+    CHECK(uart_dmatx_send(test_uart) == half);
+    CHECK(host_tx_dma_count == count + 1U);
+
+    /* The first transfer ends, the second one starts in the callback. */
+    line_step(true);
+    while (host_tx_dma_count == count + 1U) {
+        line_step(true);
+    }
+    CHECK(host_tx_dma_size == half);
+    CHECK(uart_dmatx_write(test_uart, data, 1) == 1);
+
+    line_flush();
+    CHECK(uart_dmatx_send(test_uart) == 1);
+    line_flush();
+
+    CHECK(wire_len == 40U + half + 1U);
+    CHECK(memcmp(wire, data, 40) == 0);
+    CHECK(memcmp(&wire[40], data, half) == 0);
+    CHECK(wire[40U + half] == 0);
+    CHECK(line.overwritten == 0);
+    wire_len = 0;
+}
+
+/**
+ * @brief A producer writes a frame and sends every `period_us` for 1 s.
+ */
+static void test_producer(uint32_t period_us) {
+    uint8_t frame[FRAME_LEN];
+    uint32_t seq = 0, accepted = 0, rejected = 0, pos = 0, last, got;
+    uint32_t whole = 0, broken = 0;
+    uint64_t end = line.us + 1000000U, start = line.us, busy = line.busy_us;
+    uint64_t stall = line.stall_us;
+    double busy_pct;
+
+    wire_len = 0;
+    while (line.us < end) {
+        if ((line.us - start) % period_us == 0) {
+            frame_fill(frame, seq);
+            if (uart_dmatx_write(test_uart, frame, FRAME_LEN) == FRAME_LEN) {
+                ++accepted;
+            } else {
+                ++rejected;
+            }
+            ++seq;
+            uart_dmatx_send(test_uart);
+        }
+        /* Data waits if the filling half has any. */
+        line_step(uart_dmatx_send(test_uart) != 0);
+    }
+    busy_pct = 100.0 * (double)(line.busy_us - busy) / (double)(end - start);
+    stall = line.stall_us - stall;
+    line_flush();
+    line_flush();
+
+    /* Each frame on the wire is whole and newer than the last one. */
+    last = UINT32_MAX;
+    while (pos + FRAME_LEN <= wire_len) {
+        memcpy(&got, &wire[pos + 1], sizeof(got));
+        frame_fill(frame, got);
+        if ((memcmp(&wire[pos], frame, FRAME_LEN) == 0) &&
+            ((last == UINT32_MAX) || (got > last))) {
+            ++whole;
+        } else {
+            ++broken;
+        }
+        last = got;
+        pos += FRAME_LEN;
+    }
+
+    printf("%6u %8u %8u %8u %6u %7.1f%% %8llu\n", (unsigned)period_us,
+           (unsigned)seq, (unsigned)accepted, (unsigned)rejected,
+           (unsigned)whole, busy_pct, (unsigned long long)stall);
+
+    CHECK(pos == wire_len);
+    CHECK(whole == accepted);
+    CHECK(broken == 0);
+    CHECK(stall == 0);
+    CHECK(line.overwritten == 0);
+}
+
+int main(void) {
+    signal(SIGALRM, test_alarm);
+    alarm(10);
+
+    host_periph_map();
+    CHECK(usart1_init(921600) == UART_INIT_OK);
+    SET_BIT(USART1->SR, USART_SR_TC);
+
+    test_ping_pong();
+
+    printf("%6s %8s %8s %8s %6s %8s %8s\n", "us", "frames", "accepted",
+           "rejected", "wire", "busy", "stall us");
+    /* 64 bytes per 1 ms is 69% of the line, per 500 us is 139%. */
+    test_producer(1000);
+    test_producer(500);
+
+    CHECK(usart1_deinit() == UART_DEINIT_OK);
+    CHECK(host_alloc_count == 0);
+
+    printf("%s\n", (test_fail == 0) ? "ok" : "FAIL");
+    return (test_fail == 0) ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file    uart_writev_bench.c
+ * @brief   Bytes copied per frame by `uart_dmatx_write` and
+ *          `uart_dmatx_writev` on the host.
+ *
+ * @note A frame is a 4 bytes header, the payload and a 3 bytes trailer
+ *       (CRC-16 and EOF). Before, the sender joins them in its own frame
+ *       buffer and `uart_dmatx_write` copies the frame again into the Tx
+ *       buffer. After, `uart_dmatx_writev` takes the three pieces and copies
+ *       each one once. `memcpy` is wrapped by the linker and counts every
+ *       byte copied by the test and the CSP, the CSP is built with
+ *       `-fno-builtin-memcpy` so no copy is inlined. The time also includes
+ *       starting and completing the DMA transfer of every frame.
+ */
+
+#include "hal_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES  1000000U
+#define BENCH_TRIALS  5U
+#define HEADER_LEN    4U
+#define TRAILER_LEN   3U
+
+void *__real_memcpy(void *dst, const void *src, size_t len);
+
+static UART_HandleTypeDef *const bench_uart = &usart1_handle;
+
+/* Bytes and calls of `memcpy`. */
+static uint64_t bench_copy_bytes;
+static uint64_t bench_copy_calls;
+
+/* Frame buffer of the sender, before. */
+static uint8_t bench_frame[128];
+
+void *__wrap_memcpy(void *dst, const void *src, size_t len) {
+    bench_copy_bytes += len;
+    ++bench_copy_calls;
+    return __real_memcpy(dst, src, len);
+}
+
+/**
+ * @brief Monotonic clock (ns).
+ */
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Send the frame and complete the transfer at once.
+ */
+static void bench_send(void) {
+    uart_dmatx_send(bench_uart);
+    bench_uart->gState = HAL_UART_STATE_READY;
+    bench_uart->TxCpltCallback(bench_uart);
+}
+
+/**
+ * @brief Send `BENCH_FRAMES` frames.
+ *
+ * @param payload_len Length of the payload.
+ * @param writev true: `uart_dmatx_writev`, false: join and
+ *               `uart_dmatx_write`.
+ * @return Time (ns).
+ */
+static uint64_t bench_run(uint32_t payload_len, bool writev) {
+    uint8_t header[HEADER_LEN] = {0xA5, 0x01, 0x00, 0x00};
+    uint8_t payload[128];
+    uint8_t trailer[TRAILER_LEN] = {0x12, 0x34, 0x7F};
+    uint32_t frame_len = HEADER_LEN + payload_len + TRAILER_LEN;
+    uint32_t failed = 0;
+    uint64_t t0;
+
+    for (uint32_t i = 0; i < payload_len; ++i) {
+        payload[i] = (uint8_t)i;
+    }
+    header[3] = (uint8_t)payload_len;
+    bench_copy_bytes = 0;
+    bench_copy_calls = 0;
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_FRAMES; ++i) {
+        header[2] = (uint8_t)i;
+        if (writev) {
+            const uart_tx_iovec_t iov[3] = {{header, HEADER_LEN},
+                                            {payload, payload_len},
+                                            {trailer, TRAILER_LEN}};
+            failed += (uart_dmatx_writev(bench_uart, iov, 3) != frame_len);
+        } else {
+            memcpy(bench_frame, header, HEADER_LEN);
+            memcpy(&bench_frame[HEADER_LEN], payload, payload_len);
+            memcpy(&bench_frame[HEADER_LEN + payload_len], trailer,
+                   TRAILER_LEN);
+            failed += (uart_dmatx_write(bench_uart, bench_frame, frame_len) !=
+                       frame_len);
+        }
+        bench_send();
+    }
+    t0 = bench_now_ns() - t0;
+
+    if (failed != 0) {
+        printf("%u frames not written\n", (unsigned)failed);
+    }
+
+    return t0;
+}
+
+int main(void) {
+    static const uint32_t lens[] = {12, 32, 100};
+    uint64_t ns, best_write, best_writev;
+    uint64_t write_bytes = 0, writev_bytes = 0;
+    uint64_t write_calls = 0, writev_calls = 0;
+
+    host_periph_map();
+    if (usart1_init(921600) != UART_INIT_OK) {
+        printf("init failed\n");
+        return 1;
+    }
+
+    printf("%8s %6s %12s %12s %12s %10s\n", "payload", "frame", "api",
+           "bytes/frame", "calls/frame", "ns/frame");
+    for (uint32_t i = 0; i < sizeof(lens) / sizeof(lens[0]); ++i) {
+        uint32_t frame_len = HEADER_LEN + lens[i] + TRAILER_LEN;
+
+        best_write = UINT64_MAX;
+        best_writev = UINT64_MAX;
+        for (uint32_t t = 0; t < BENCH_TRIALS; ++t) {
+            ns = bench_run(lens[i], false);
+            best_write = (ns < best_write) ? ns : best_write;
+            write_bytes = bench_copy_bytes;
+            write_calls = bench_copy_calls;
+
+            ns = bench_run(lens[i], true);
+            best_writev = (ns < best_writev) ? ns : best_writev;
+            writev_bytes = bench_copy_bytes;
+            writev_calls = bench_copy_calls;
+        }
+
+        printf("%8u %6u %12s %12.2f %12.2f %10.1f\n", (unsigned)lens[i],
+               (unsigned)frame_len, "write",
+               (double)write_bytes / BENCH_FRAMES,
+               (double)write_calls / BENCH_FRAMES,
+               (double)best_write / BENCH_FRAMES);
+        printf("%8s %6s %12s %12.2f %12.2f %10.1f\n", "", "", "writev",
+               (double)writev_bytes / BENCH_FRAMES,
+               (double)writev_calls / BENCH_FRAMES,
+               (double)best_writev / BENCH_FRAMES);
+
+        if ((write_bytes != 2ULL * frame_len * BENCH_FRAMES) ||
+            (writev_bytes != (uint64_t)frame_len * BENCH_FRAMES)) {
+            printf("unexpected copies\n");
+            return 1;
+        }
+    }
+
+    usart1_deinit();
+    return 0;
+}
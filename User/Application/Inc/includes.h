@@ -77,6 +77,7 @@ extern TaskHandle_t action_position_recv_task_handle;
 extern TaskHandle_t msg_polling_task_handle;
 void sub_pub_task(void *pvParameters);
 void msg_polling_task(void *pvParameters);
+void msg_polling_init(void);
 
 void sub_chassis_speed(float speedx, float speedy, float speedw);
 void sub_chassis_halt(bool halt);
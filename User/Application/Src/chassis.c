@@ -14,8 +14,10 @@
 #include "go_path/go_path.h"
 #include "action_position/action_position.h"
 #include "logger/logger.h"
+#include "message-protocol/msg_protocol.h"
 
 #define POS_NUM              5 /*!< 点位数量 */
+#define NUC_POS_TIMEOUT      100 /*!< 小电脑位姿超时时间 (ms) */
 
 /* 按键宏定义 */
 #define CHASSIS_AIMING_KEY   15  /*!< 底盘自瞄开启 */
@@ -472,6 +474,13 @@ void chassis_auto_ctrl_task(void *pvParameters) {
     /* 默认挂起自动任务 */
     vTaskSuspend(chassis_auto_ctrl_task_handle);
     while (1) {
+        if (message_get_latest_age(MSG_NUC) > NUC_POS_TIMEOUT) {
+            /* 位姿过时, 不能再按旧位姿跑点, 原地等待 */
+            chassis_wheel_ctrl(0.0f, 0.0f, 0.0f);
+            vTaskDelay(1);
+            continue;
+        }
+
         constant_orientation_resolve(BASKET_POINT_X, BASKET_POINT_Y);
         pos_array[POS_NUM + EX_NODE_TARGET_RADIUM].pos_yaw =
             RAD2DEG(orientation_aim_angle);
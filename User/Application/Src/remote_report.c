@@ -8,42 +8,22 @@
 
 #include "includes.h"
 #include "message-protocol/msg_protocol.h"
+#include "message-protocol/msg_schema.h"
 #include "action_position/action_position.h"
 #include "logger/logger.h"
 
 /**
- * @brief 位置信息上报
+ * @brief 位置信息上报, 字段定义见`MSG_SCHEMA_REPORT_CHASSIS`
  */
-static struct __packed {
-    remote_report_data_t type; /*!< 上报的数据类型: 位置 */
-    int16_t x;                 /*!< x 坐标 */
-    int16_t y;                 /*!< y 坐标 */
-    int16_t yaw;               /*!< yaw 坐标 */
-    uint8_t point_index;          /*!< 目标点序列号 */
-
-    /*!< 底盘状态 
-     * bit[7:3] 保留
-     * bit[2]   是否自锁
-     * bit[1]   是否在自瞄状态
-     * bit[0]   是否世界坐标系
-     */
-    uint8_t chassis_status;
-} report_chassis = {.type = REMOTE_REPORT_POSITION};
+static msg_report_chassis_t report_chassis = {.type = REMOTE_REPORT_POSITION};
 
 /**
- * @brief 发射信息上报
+ * @brief 发射信息上报, 字段定义见`MSG_SCHEMA_REPORT_SHOOT`
  */
-static struct __packed {
-    remote_report_data_t type; /*!< 上报的数据类型: 位置 */
-    float shoot_spd;           /*!< 发射速度 */
-
-    /*!< 发射状态 
-     * bit[7:2] 保留
-     * bit[1]   2006是否推出
-     * bit[0]   是否在发射状态
-     */
-    uint8_t shoot_status;
-} report_shoot = {.type = REMOTE_REPORT_SHOOT};
+static msg_report_shoot_t report_shoot = {.type = REMOTE_REPORT_SHOOT};
+
+/* 上报打包缓冲区, 上报消息的线上长度都不超过`MSG_REMOTE`的最大数据长度 */
+static uint8_t report_buf[msg_schema_MSG_REMOTE_max_len];
 
 #define PUSH_POS  1
 #define PUSH_MSK  (1U << PUSH_POS)
@@ -73,6 +53,8 @@ void remote_report_task(void *pvParameters) {
     UNUSED(pvParameters);
     remote_report_data_queue = xQueueCreate(1, sizeof(remote_report_data_t));
     message_register_send_uart(MSG_REMOTE, &uart4_handle, 50);
+    /* 位置和发射信息经常连着发, 2 ms 内的帧合并成一次发送 */
+    message_set_tx_batch(&uart4_handle, 2, 128);
 
     remote_report_data_t report_data;
 
@@ -104,9 +86,9 @@ void remote_report_task(void *pvParameters) {
                 } else {
                     CLEAR_BIT(report_chassis.chassis_status, HALT_MSK);
                 }
-                message_send_data(MSG_REMOTE, MSG_DATA_CUSTOM,
-                                  (uint8_t *)&report_chassis,
-                                  sizeof(report_chassis));
+                message_send_data(
+                    MSG_REMOTE, MSG_DATA_CUSTOM, report_buf,
+                    msg_report_chassis_pack(&report_chassis, report_buf));
             } break;
 
             case REMOTE_REPORT_SHOOT: {
@@ -122,9 +104,9 @@ void remote_report_task(void *pvParameters) {
                 } else {
                     CLEAR_BIT(report_shoot.shoot_status, SHOOT_MSK);
                 }
-                message_send_data(MSG_REMOTE, MSG_DATA_CUSTOM,
-                                  (uint8_t *)&report_shoot,
-                                  sizeof(report_shoot));
+                message_send_data(
+                    MSG_REMOTE, MSG_DATA_CUSTOM, report_buf,
+                    msg_report_shoot_pack(&report_shoot, report_buf));
             } break;
 
             default: {
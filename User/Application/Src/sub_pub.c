@@ -19,6 +19,8 @@
 
 #include "includes.h"
 #include "message-protocol/msg_protocol.h"
+#include "message-protocol/msg_rpc.h"
+#include "message-protocol/msg_schema.h"
 #include "remote_ctrl/remote_ctrl.h"
 #include "action_position/action_position.h"
 #include "odometry_string/odometry_string.h"
@@ -35,16 +37,8 @@ TaskHandle_t msg_polling_task_handle;
 float *world_yaw; /* 指向全场定位的坐标 */
 
 float g_basket_radius;
-static struct __packed {
-    float chassis_speedx;    /* 底盘speedx */
-    float chassis_speedy;    /* 底盘speedy */
-    float chassis_speedyaw;  /* 底盘speedyaw */
-    float chassis_world_yaw; /* 世界坐标yaw */
-    bool chassis_halt;       /* 底盘停止标志 */
-
-    float friction_speed_5065; /* 摩擦带速度 */
-    uint8_t shoot_flag;        /* 射击标志 */
-} pub_to_slave_data;
+/* 发布给从板的参数, 字段定义见`MSG_SCHEMA_TO_SLAVE` */
+static msg_to_slave_t pub_to_slave_data;
 
 // nuc_pos_data_t g_nuc_pos_data;
 
@@ -117,6 +111,7 @@ typedef enum __attribute((packed)) {
 void sub_pub_task(void *pvParameters) {
     UNUSED(pvParameters);
     serial_flag_t send_nuc_data = SERIAL_STOP_SERVICE;
+    uint8_t to_slave_buf[msg_to_slave_wire_len];
 
     /* 初始化pub_to_slave_data,防止被编译器优化*/
     memset(&pub_to_slave_data, 0, sizeof(pub_to_slave_data));
@@ -125,14 +120,14 @@ void sub_pub_task(void *pvParameters) {
     message_register_send_uart(MSG_TO_SLAVE, &usart2_handle, 128);
     /* F4-小电脑 */
     message_register_send_uart(MSG_NUC, NUC_UART_HANDLE, 32);
+    message_register_send_uart(MSG_RPC, NUC_UART_HANDLE, 64);
 
     while (1) {
         /* 更新world—yaw数据 */
         pub_to_slave_data.chassis_world_yaw = *world_yaw;
         /* 串口发送数据 */
-        message_send_data(MSG_TO_SLAVE, MSG_DATA_CUSTOM,
-                          (uint8_t *)&pub_to_slave_data,
-                          sizeof(pub_to_slave_data));
+        message_send_data(MSG_TO_SLAVE, MSG_DATA_CUSTOM, to_slave_buf,
+                          msg_to_slave_pack(&pub_to_slave_data, to_slave_buf));
 
         vTaskDelay(2);
     }
@@ -147,10 +142,11 @@ nuc_pos_data_t g_nuc_pos_data;
  */
 static void nuc_msg_callback(uint32_t msg_length, uint8_t msg_id_type,
                              uint8_t *msg_data) {
-    UNUSED(msg_length);
     UNUSED(msg_id_type);
-    nuc_pos_data_t temp_data;
-    memcpy(&temp_data, msg_data, sizeof(nuc_pos_data_t));
+    msg_nuc_pos_t temp_data;
+    if (!msg_nuc_pos_unpack(&temp_data, msg_data, msg_length)) {
+        return;
+    }
 
     /* 更新全局变量 */
     g_nuc_pos_data.x = 1000.0f * temp_data.x;
@@ -160,9 +156,66 @@ static void nuc_msg_callback(uint32_t msg_length, uint8_t msg_id_type,
     LED2_TOGGLE();
 }
 
-void msg_polling_task(void *pvParameters) {
-    UNUSED(pvParameters);
+/**
+ * @brief 小电脑 RPC 方法 ID, 需要和小电脑一侧保持一致
+ */
+typedef enum {
+    RPC_GET_CHASSIS_STATE, /* 查询底盘状态 */
+    RPC_CAPTURE_DUMP,      /* 通过 RTT 导出接收抓包 */
+} rpc_method_t;
+
+/**
+ * @brief RPC 方法: 查询底盘状态, 返回发布给从板的底盘和摩擦带参数
+ *
+ * @param[in] args 参数, 无
+ * @param args_len 参数长度
+ * @param[out] ret 返回值
+ * @param[out] ret_len 返回值长度
+ * @return 调用状态
+ */
+static uint8_t rpc_get_chassis_state(const uint8_t *args, uint32_t args_len,
+                                     uint8_t *ret, uint32_t *ret_len) {
+    UNUSED(args);
+    UNUSED(args_len);
+
+    *ret_len = msg_to_slave_pack(&pub_to_slave_data, ret);
+
+    return MSG_RPC_OK;
+}
+
+#if MSG_ENABLE_CAPTURE
+/**
+ * @brief RPC 方法: 通过 RTT 导出接收抓包, 返回导出的记录数 (4 byte 小端)
+ *
+ * @param[in] args 参数, 无
+ * @param args_len 参数长度
+ * @param[out] ret 返回值
+ * @param[out] ret_len 返回值长度
+ * @return 调用状态
+ */
+static uint8_t rpc_capture_dump(const uint8_t *args, uint32_t args_len,
+                                uint8_t *ret, uint32_t *ret_len) {
+    UNUSED(args);
+    UNUSED(args_len);
+
+    uint32_t count = message_capture_dump();
+    ret[0] = (uint8_t)count;
+    ret[1] = (uint8_t)(count >> 8);
+    ret[2] = (uint8_t)(count >> 16);
+    ret[3] = (uint8_t)(count >> 24);
+    *ret_len = 4;
+
+    return MSG_RPC_OK;
+}
+#endif /* MSG_ENABLE_CAPTURE */
 
+/**
+ * @brief 注册遥控器, 小电脑的接收和 RPC 方法
+ *
+ * @note 在轮询任务开始时调用, 主机上的抓包重放工具也调用它, 和固件按同样的
+ *       顺序注册同样的串口和回调
+ */
+void msg_polling_init(void) {
     /* 注册遥控器接收 */
     message_register_polling_uart(MSG_REMOTE, REMOTE_UART_HANDLE, 32, 32);
     /* 注册遥控器接收callback */
@@ -174,18 +227,43 @@ void msg_polling_task(void *pvParameters) {
     /* 注册小电脑接收 */
     message_register_polling_uart(MSG_NUC, NUC_UART_HANDLE, 512, 512);
     message_register_recv_callback(MSG_NUC, nuc_msg_callback);
+    /* 位姿只要最新的一帧, 积压的旧帧直接跳过 */
+    message_set_fifo_policy(MSG_NUC, MSG_FIFO_LATEST_ONLY);
+    /* 小电脑数据直接控制底盘, 加 CRC 校验; 小电脑没升级前按旧协议收发 */
+    /* 协商期间没有校验保护, 小电脑升级以后改成 false */
+    message_set_crc(MSG_NUC, MSG_CRC_32, true);
+
+    /* 小电脑 RPC, 和位姿共用串口, 按帧头 ID 分发 */
+    message_register_polling_uart(MSG_RPC, NUC_UART_HANDLE, 512, 512);
+    /* 没升级的小电脑不一定按 MSG_NUC 的 ID 发送, 没有绑定的 ID 都交给位姿 */
+    message_set_rx_default(MSG_NUC, true);
+    /* RPC 必须带 CRC, 旧小电脑按 RPC 的 ID 发来的位姿帧不会被当成请求 */
+    message_set_crc(MSG_RPC, MSG_CRC_16, false);
+    message_rpc_init();
+    message_rpc_register(RPC_GET_CHASSIS_STATE, rpc_get_chassis_state);
+#if MSG_ENABLE_CAPTURE
+    /* 编译进抓包就是要调试, 直接打开 */
+    message_capture_enable(true);
+    message_rpc_register(RPC_CAPTURE_DUMP, rpc_capture_dump);
+#endif /* MSG_ENABLE_CAPTURE */
+}
+
+void msg_polling_task(void *pvParameters) {
+    UNUSED(pvParameters);
+
+    msg_polling_init();
 
     /* 遥控器上报数据类型 */
     // remote_report_data_t report_data = REMOTE_REPORT_POSITION;
 
     while (1) {
-        message_polling_data();
+        /* 串口收到数据立即唤醒, 超时兜底 */
+        message_polling_wait(10);
+        message_rpc_poll();
         // xQueueSend(remote_report_data_queue, &report_data, 1);
         float delat_x = BASKET_POINT_X - g_nuc_pos_data.x;
         float delat_y = BASKET_POINT_Y - g_nuc_pos_data.y;
 
         g_basket_radius = sqrtf(delat_x * delat_x + delat_y * delat_y);
-
-        vTaskDelay(2);
     }
 }
\ No newline at end of file
@@ -0,0 +1 @@
+/* 主机测试替身, 固件模块头文件包含它, 测试用不到其中的内容 */
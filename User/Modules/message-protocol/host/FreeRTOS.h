@@ -0,0 +1,53 @@
+/**
+ * @file    FreeRTOS.h
+ * @brief   主机测试用的 FreeRTOS 替身, 只实现消息协议用到的部分
+ */
+
+#ifndef __HOST_FREERTOS_H
+#define __HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef void *SemaphoreHandle_t;
+typedef void *TaskHandle_t;
+typedef void *QueueHandle_t;
+typedef long BaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE                       0
+#define pdTRUE                        1
+#define pdPASS                        1
+#define portMAX_DELAY                 0xFFFFFFFFU
+#define pdMS_TO_TICKS(x)              (x)
+#define portYIELD_FROM_ISR(x)         ((void)(x))
+
+/* 互斥量在测试中不需要真的阻塞 */
+#define xSemaphoreCreateMutex()       ((SemaphoreHandle_t)1)
+#define xSemaphoreTake(sem, wait)     ((void)(sem), (void)(wait), pdTRUE)
+#define xSemaphoreGive(sem)           ((void)(sem), pdTRUE)
+#define taskENTER_CRITICAL()          __disable_irq()
+#define taskEXIT_CRITICAL()           __set_PRIMASK(0)
+#define xTaskGetCurrentTaskHandle()   ((TaskHandle_t)1)
+
+/* 软件定时器只记录回调, 由测试调用`host_timer_fire`触发 */
+typedef struct host_timer {
+    void (*callback)(struct host_timer *);
+    void *id;
+} *TimerHandle_t;
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period,
+                           BaseType_t reload, void *id,
+                           void (*callback)(TimerHandle_t));
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period,
+                              TickType_t wait);
+/* 任务通知只计数, `ulTaskNotifyTake`不等待, 没有通知时当作超时返回 0 */
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+/* 延时直接推进系统时间 */
+void vTaskDelay(TickType_t ticks);
+
+#define pvTimerGetTimerID(timer) ((timer)->id)
+
+#endif /* __HOST_FREERTOS_H */
@@ -0,0 +1,16 @@
+/**
+ * @file    SEGGER_RTT.h
+ * @brief   主机测试用的 RTT 替身, 没有调试器, 写入全部丢弃
+ */
+
+#ifndef __HOST_SEGGER_RTT_H
+#define __HOST_SEGGER_RTT_H
+
+#define SEGGER_RTT_MODE_NO_BLOCK_SKIP 0
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned index, const char *name, void *buf,
+                              unsigned size, unsigned flags);
+unsigned SEGGER_RTT_GetAvailWriteSpace(unsigned index);
+unsigned SEGGER_RTT_Write(unsigned index, const void *data, unsigned len);
+
+#endif /* __HOST_SEGGER_RTT_H */
@@ -0,0 +1,80 @@
+/**
+ * @file    bsp.h
+ * @brief   主机测试用的板级支持包替身, 只声明消息协议用到的部分
+ */
+
+#ifndef __HOST_BSP_H
+#define __HOST_BSP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define UNUSED(x) ((void)(x))
+#define __packed  __attribute__((packed))
+
+#define HAL_OK    0
+
+typedef struct {
+    int id;
+    void *hdmatx;
+    void *hdmarx;
+} UART_HandleTypeDef;
+
+typedef void (*uart_rx_event_callback_t)(UART_HandleTypeDef *);
+typedef void (*uart_tx_event_callback_t)(UART_HandleTypeDef *);
+
+typedef struct {
+    const uint8_t *data;
+    uint32_t len;
+} uart_rx_span_t;
+
+uint32_t uart_dmarx_peek(UART_HandleTypeDef *huart, uart_rx_span_t span[2]);
+uint8_t uart_dmarx_consume(UART_HandleTypeDef *huart, uint32_t len);
+uint32_t uart_dmarx_read(UART_HandleTypeDef *huart, void *buf, size_t len);
+uint8_t uart_dmarx_register_event_callback(UART_HandleTypeDef *huart,
+                                           uart_rx_event_callback_t callback);
+uint32_t uart_dmatx_write(UART_HandleTypeDef *huart, const void *data,
+                          size_t len);
+uint32_t uart_dmatx_send(UART_HandleTypeDef *huart);
+uint8_t uart_dmatx_register_cplt_callback(UART_HandleTypeDef *huart,
+                                          uart_tx_event_callback_t callback);
+int HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *data, uint16_t len,
+                      uint32_t timeout);
+int HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *data,
+                          uint16_t len);
+uint32_t HAL_GetTick(void);
+
+/* 固件代码用到的串口句柄, 只用来区分串口 */
+extern UART_HandleTypeDef usart2_handle;
+extern UART_HandleTypeDef uart4_handle;
+extern UART_HandleTypeDef uart5_handle;
+
+/* LED 只记录翻转次数, 由`host_led_count`读取 */
+void host_led_toggle(uint32_t led);
+#define LED1_TOGGLE() host_led_toggle(1)
+#define LED2_TOGGLE() host_led_toggle(2)
+
+/* 关中断用一把全局锁模拟, 模拟的中断也要拿这把锁 */
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+
+typedef struct {
+    volatile uint32_t CYCCNT, CTRL;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_core_debug;
+extern uint32_t SystemCoreClock;
+
+#define DWT                        (&host_dwt)
+#define CoreDebug                  (&host_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk 1
+#define DWT_CTRL_CYCCNTENA_Msk     1
+
+#endif /* __HOST_BSP_H */
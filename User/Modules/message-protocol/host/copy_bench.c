@@ -0,0 +1,232 @@
+/**
+ * @file    copy_bench.c
+ * @brief   接收路径每帧复制次数和解析速度, 在主机上运行
+ *
+ * @note 按小电脑的发送方式生成位姿帧 (12 字节数据, CRC-32, 内容随机, 包含需要
+ *       转义的字节), 串口和 FIFO 大小与`sub_pub.c`相同, 每次写进模拟 DMA
+ *       接收缓冲区的字节数不固定, 帧头会落在 FIFO 的任意位置, 由
+ *       `message_polling_data`解析分发.
+ *
+ *       改动前出队时跨过 FIFO 末尾的帧先整帧复制到`recv_buf`再回调, 改动后
+ *       写入 FIFO 开头的字节同时写一份镜像, 回调直接拿到 FIFO 内的指针.
+ *       两种方式都统计: 从 DMA 缓冲区写入 FIFO 的字节, 镜像区字节, 跨尾的帧
+ *       和改动前要复制的字节. "改动前"的速度是在回调里补上原来的复制得到的,
+ *       镜像写入仍然在, 所以比真实的改动前略慢.
+ *
+ *       包含`msg_protocol.c`以便读取 FIFO 的位置.
+ */
+
+#include "../msg_protocol.c"
+
+#include "host_stubs.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_FRAMES     100000U
+#define POSE_DATA_LEN    12U
+/* 和`sub_pub.c`中小电脑串口的设置相同 */
+#define DMA_RX_BUF_SIZE  512U
+#define RX_FIFO_SIZE     512U
+/* 每次轮询最多写入的字节数, 921600 波特率 2 ms 约 184 字节 */
+#define BENCH_CHUNK_MAX  184U
+#define BENCH_TRIALS     5U
+
+static UART_HandleTypeDef bench_uart = {1, (void *)1, (void *)1};
+
+/* 编码好的位姿帧, 即线上的数据 */
+static uint8_t bench_wire[BENCH_FRAMES * MSG_FRAME_MAX_LEN(POSE_DATA_LEN)];
+static uint32_t bench_wire_len;
+static uint32_t bench_seed = 1;
+
+/* 改动前用的接收缓冲区 */
+static uint8_t bench_recv_buf[MSG_FIFO_ELEMENT_MAX_LEN];
+static bool bench_old_copy;
+/* 上一帧出队后的队头 */
+static uint32_t bench_head;
+
+static struct {
+    uint32_t frames;      /*!< 回调的帧数 */
+    uint32_t bad;         /*!< 内容不对的帧数 */
+    uint32_t wrapped;     /*!< 跨过 FIFO 末尾的帧数 */
+    uint64_t old_copy;    /*!< 改动前复制到`recv_buf`的字节数 */
+    uint64_t fifo_write;  /*!< 写入 FIFO 的字节数 */
+    uint64_t mirror;      /*!< 写入镜像区的字节数 */
+    uint64_t poll_ns;     /*!< 解析时间 */
+} bench;
+
+static uint32_t bench_rand(void) {
+    bench_seed = bench_seed * 1103515245U + 12345U;
+    return bench_seed >> 8;
+}
+
+/**
+ * @brief 单调时钟 (ns)
+ */
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief DMA 发送完成, 数据放到线上
+ */
+static void bench_sink(const uint8_t *data, uint32_t len) {
+    memcpy(&bench_wire[bench_wire_len], data, len);
+    bench_wire_len += len;
+}
+
+/**
+ * @brief 第`seq`帧位姿, 前 4 字节是序号
+ */
+static void bench_pose(uint8_t *data, uint32_t seq) {
+    for (uint32_t i = 0; i < POSE_DATA_LEN; ++i) {
+        data[i] = (uint8_t)bench_rand();
+    }
+    memcpy(data, &seq, sizeof(seq));
+}
+
+static void bench_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    msg_fifo_t *fifo = msg_list[MSG_NUC]->rx_port->fifo;
+    /* 回调前这一帧已经出队, 元素在上一次的队头 */
+    uint32_t start = bench_head & fifo->mask;
+    uint32_t element_len = fifo->head - bench_head;
+    uint32_t first = fifo->size - start;
+    uint32_t seq;
+
+    UNUSED(id_type);
+
+    bench_head = fifo->head;
+    memcpy(&seq, data, sizeof(seq));
+    if ((len != POSE_DATA_LEN) || (seq != bench.frames)) {
+        ++bench.bad;
+    }
+    ++bench.frames;
+
+    if (element_len <= first) {
+        return;
+    }
+
+    /* 跨过末尾, 改动前整个元素分两段复制到`recv_buf` */
+    ++bench.wrapped;
+    bench.old_copy += element_len;
+    if (bench_old_copy) {
+        memcpy(bench_recv_buf, &fifo->buf[start], first);
+        memcpy(&bench_recv_buf[first], fifo->buf, element_len - first);
+    }
+}
+
+/**
+ * @brief FIFO 写入位置从`from`到`to`时写入镜像区的字节数
+ */
+static uint32_t bench_mirror_bytes(const msg_fifo_t *fifo, uint32_t from,
+                                   uint32_t to) {
+    uint32_t count = 0;
+
+    for (uint32_t pos = from; pos != to; ++pos) {
+        count += ((pos & fifo->mask) < fifo->mirror_len);
+    }
+    return count;
+}
+
+/**
+ * @brief 把线上的数据全部喂给解析器
+ *
+ * @param old_copy 是否补上改动前的复制
+ */
+static void bench_run(bool old_copy) {
+    msg_fifo_t *fifo;
+    uint32_t pos = 0, len, tail;
+    uint64_t t0;
+
+    memset(&bench, 0, sizeof(bench));
+    bench_old_copy = old_copy;
+    bench_seed = 7;
+    bench_head = msg_list[MSG_NUC]->rx_port->fifo->head;
+
+    while (pos < bench_wire_len) {
+        len = 1U + bench_rand() % BENCH_CHUNK_MAX;
+        if (len > bench_wire_len - pos) {
+            len = bench_wire_len - pos;
+        }
+        host_uart_rx_dma(&bench_uart, &bench_wire[pos], len, false);
+        pos += len;
+
+        fifo = msg_list[MSG_NUC]->rx_port->fifo;
+        tail = fifo->tail;
+        t0 = bench_now_ns();
+        message_polling_data();
+        bench.poll_ns += bench_now_ns() - t0;
+        bench.fifo_write += fifo->tail - tail;
+        bench.mirror += bench_mirror_bytes(fifo, tail, fifo->tail);
+    }
+}
+
+/**
+ * @brief 输出一种方式的结果
+ *
+ * @param copy_bytes FIFO 以外额外写入的字节数
+ * @param copies 复制次数
+ * @param poll_ns 最快一次的解析时间
+ */
+static void bench_print(const char *name, uint64_t copy_bytes,
+                        uint64_t copies, uint64_t poll_ns) {
+    double frames = bench.frames;
+
+    printf("%-8s %10.2f %10.2f %10.3f %10.2f %10.1f\n", name,
+           (double)bench.fifo_write / frames, (double)copy_bytes / frames,
+           (double)copies / frames,
+           (double)(bench.fifo_write + copy_bytes) / frames,
+           (double)bench_wire_len * 1000.0 / (double)poll_ns);
+}
+
+int main(void) {
+    uint8_t pose[POSE_DATA_LEN];
+    uint64_t before_ns = UINT64_MAX, after_ns = UINT64_MAX;
+    int res = 0;
+
+    host_uart_rx_ring(DMA_RX_BUF_SIZE);
+    message_register_send_uart(MSG_NUC, &bench_uart, 0);
+    message_register_polling_uart(MSG_NUC, &bench_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_recv_callback(MSG_NUC, bench_callback);
+    message_set_crc(MSG_NUC, MSG_CRC_32, false);
+
+    for (uint32_t i = 0; i < BENCH_FRAMES; ++i) {
+        bench_pose(pose, i);
+        if (message_send_data(MSG_NUC, MSG_DATA_CUSTOM, pose,
+                              POSE_DATA_LEN) != 0) {
+            printf("send failed\n");
+            return 1;
+        }
+        host_uart_tx_isr(&bench_uart, bench_sink);
+    }
+
+    /* 先跑一遍预热, 再交替测量, 各取最快的一次 */
+    bench_run(false);
+    for (uint32_t i = 0; i < BENCH_TRIALS; ++i) {
+        bench_run(true);
+        res |= (bench.frames != BENCH_FRAMES) || (bench.bad != 0);
+        before_ns = (bench.poll_ns < before_ns) ? bench.poll_ns : before_ns;
+
+        bench_run(false);
+        res |= (bench.frames != BENCH_FRAMES) || (bench.bad != 0);
+        after_ns = (bench.poll_ns < after_ns) ? bench.poll_ns : after_ns;
+    }
+
+    printf("%u frames, %.2f bytes per frame on the wire, %u wrap the FIFO, "
+           "dma overrun %u\n\n",
+           (unsigned)bench.frames, (double)bench_wire_len / bench.frames,
+           (unsigned)bench.wrapped, (unsigned)host_uart_rx_overrun());
+    printf("%-8s %10s %10s %10s %10s %10s\n", "", "fifo B/f", "extra B/f",
+           "copies/f", "total B/f", "MB/s");
+    bench_print("before", bench.old_copy, bench.wrapped, before_ns);
+    /* 镜像是逐字节写入时顺带写的, 不是一次复制 */
+    bench_print("after", bench.mirror, 0, after_ns);
+
+    res |= (host_uart_rx_overrun() != 0);
+
+    return res;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file    crc_bench.c
+ * @brief   CRC 计算速度测试, 在主机上运行
+ *
+ * @note 先用标准校验值 ("123456789") 检查两种 CRC 的结果, 然后测量不同数据
+ *       长度下每字节的计算时间, 最后在串口自发自收的条件下比较一帧位姿
+ *       (32 字节) 不带 CRC, 带 CRC-16 和 CRC-32 时编码加解析的时间.
+ */
+
+#include "msg_protocol.h"
+#include "host_stubs.h"
+#include "crc/crc.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_BYTES      (64U * 1024U * 1024U)
+#define BENCH_FRAMES     200000U
+#define POSE_DATA_LEN    32U
+#define DMA_RX_BUF_SIZE  4096U
+
+static UART_HandleTypeDef bench_uart = {1, (void *)1, (void *)1};
+
+static uint32_t bench_recv;
+static volatile uint32_t bench_sink;
+
+/**
+ * @brief 单调时钟 (ns)
+ */
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    UNUSED(len);
+    UNUSED(id_type);
+    UNUSED(data);
+    ++bench_recv;
+}
+
+/**
+ * @brief DMA 发送完成, 数据直接写进接收缓冲区
+ */
+static void bench_loopback(const uint8_t *data, uint32_t len) {
+    host_uart_rx_dma(&bench_uart, data, len, false);
+}
+
+/**
+ * @brief 标准校验值
+ *
+ * @return 0: 正确; 1: 错误
+ */
+static int bench_check(void) {
+    static const char check[] = "123456789";
+    uint16_t crc16 = crc16_calc(CRC16_INIT, check, 9);
+    uint32_t crc32 = crc32_calc(CRC32_INIT, check, 9);
+    /* 分段计算和一次计算结果相同 */
+    uint32_t crc32_split = crc32_calc(crc32_calc(CRC32_INIT, check, 3),
+                                      check + 3, 6);
+
+    printf("check: crc16 0x%04X, crc32 0x%08X\n", crc16, crc32);
+    return (crc16 != 0x29B1U) || (crc32 != 0x0376E6E7U) ||
+           (crc32_split != crc32);
+}
+
+/**
+ * @brief 按`len`字节一段计算, 共计算`BENCH_BYTES`字节
+ */
+static void bench_raw(uint32_t len) {
+    static uint8_t data[4096];
+    uint32_t rounds = BENCH_BYTES / len;
+    uint64_t t0, t16, t32;
+    uint32_t acc = 0;
+
+    for (uint32_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i * 131U + 7U);
+    }
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < rounds; ++i) {
+        acc += crc16_calc(CRC16_INIT, data, len);
+    }
+    t16 = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < rounds; ++i) {
+        acc += crc32_calc(CRC32_INIT, data, len);
+    }
+    t32 = bench_now_ns() - t0;
+    bench_sink = acc;
+
+    printf("%4u B: crc16 %6.1f MB/s %.2f ns/B, crc32 %6.1f MB/s %.2f ns/B\n",
+           len, (double)BENCH_BYTES * 1000.0 / t16,
+           (double)t16 / BENCH_BYTES, (double)BENCH_BYTES * 1000.0 / t32,
+           (double)t32 / BENCH_BYTES);
+}
+
+/**
+ * @brief 自发自收`BENCH_FRAMES`帧位姿
+ *
+ * @return 每帧编码加解析的时间 (ns), 没有全部收到返回 0
+ */
+static double bench_frames(msg_crc_t crc) {
+    uint8_t pose[POSE_DATA_LEN];
+    uint64_t t0, t;
+
+    message_set_crc(MSG_NUC, crc, false);
+    memset(pose, 0x5A, sizeof(pose));
+    bench_recv = 0;
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_FRAMES; ++i) {
+        memcpy(pose, &i, sizeof(i));
+        message_send_data(MSG_NUC, MSG_DATA_CUSTOM, pose, POSE_DATA_LEN);
+        host_uart_tx_isr(&bench_uart, bench_loopback);
+        message_polling_data();
+    }
+    t = bench_now_ns() - t0;
+
+    return (bench_recv == BENCH_FRAMES) ? (double)t / BENCH_FRAMES : 0.0;
+}
+
+int main(void) {
+    double none, c16, c32;
+
+    if (bench_check() != 0) {
+        printf("crc check value mismatch\n");
+        return 1;
+    }
+
+    bench_raw(8);
+    bench_raw(32);
+    bench_raw(4096);
+
+    host_uart_rx_ring(DMA_RX_BUF_SIZE);
+    message_register_send_uart(MSG_NUC, &bench_uart, 0);
+    message_register_polling_uart(MSG_NUC, &bench_uart, DMA_RX_BUF_SIZE,
+                                  1024);
+    message_register_recv_callback(MSG_NUC, bench_callback);
+
+    none = bench_frames(MSG_CRC_NONE);
+    c16 = bench_frames(MSG_CRC_16);
+    c32 = bench_frames(MSG_CRC_32);
+    printf("32 B frame send + parse: none %.0f ns, crc16 %.0f ns, "
+           "crc32 %.0f ns\n",
+           none, c16, c32);
+
+    if ((none == 0.0) || (c16 == 0.0) || (c32 == 0.0) ||
+        (host_uart_rx_overrun() != 0)) {
+        printf("frames lost\n");
+        return 1;
+    }
+
+    return 0;
+}
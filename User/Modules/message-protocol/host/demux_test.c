@@ -0,0 +1,269 @@
+/**
+ * @file    demux_test.c
+ * @brief   多个消息 ID 共用一个串口的测试, 在主机上运行
+ *
+ * @note 和小电脑的串口一样, 位姿 (CRC-32), RPC (CRC-16) 和遥控器三个 ID
+ *       注册同一个接收串口. 三个 ID 的帧随机交错, 数据长度随机, 再夹杂一些
+ *       没有绑定到这个串口的 ID (发给从板的帧), 编码后按随机长度分段写进
+ *       模拟的 DMA 缓冲区, 每段轮询一次. 检查:
+ *
+ *       - 三个 ID 共用一个接收端口;
+ *       - 每个 ID 按顺序收到自己的每一帧, 内容正确, 不会收到别的 ID 的帧;
+ *       - 回调拿到的指针在接收队列内, 没有再复制;
+ *       - 未绑定的 ID 计入`recv_unknown`, 没有默认 ID 时丢弃, 设置默认 ID
+ *         后交给它并计入`recv_fallback`.
+ *
+ *       包含`msg_protocol.c`以便读取接收端口.
+ */
+
+#include "../msg_protocol.c"
+
+#include "host_stubs.h"
+
+#include <stdio.h>
+
+#define TEST_FRAMES      3000U
+#define DMA_RX_BUF_SIZE  1024U
+#define RX_FIFO_SIZE     1024U
+/* 每次轮询最多写入的字节数, 921600 波特率 2 ms 约 184 字节 */
+#define TEST_CHUNK_MAX   184U
+/* 每多少帧夹一帧未绑定的 ID */
+#define TEST_FOREIGN_GAP 10U
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+static UART_HandleTypeDef test_uart = {1, (void *)1, (void *)1};
+
+/* 绑定到串口的 ID */
+static const msg_id_t test_ids[] = {MSG_NUC, MSG_RPC, MSG_REMOTE};
+static const char *const test_names[] = {"nuc", "rpc", "remote"};
+#define TEST_ID_NUM (sizeof(test_ids) / sizeof(test_ids[0]))
+
+static uint8_t test_wire[TEST_FRAMES * 2U * MSG_FRAME_MAX_LEN(64U)];
+static uint32_t test_wire_len;
+static uint32_t test_seed = 1;
+
+/**
+ * @brief 每个 ID 发送和收到的情况
+ */
+static struct {
+    uint32_t sent;      /*!< 发出的帧数 */
+    uint32_t recv;      /*!< 收到的帧数 */
+    uint32_t bad;       /*!< 长度或内容不对的帧数 */
+    uint32_t copied;    /*!< 指针不在接收队列内的帧数 */
+} test_stat[MSG_ID_RESERVE_LEN];
+
+static uint32_t test_rand(void) {
+    test_seed = test_seed * 1103515245U + 12345U;
+    return test_seed >> 8;
+}
+
+/**
+ * @brief 第`seq`帧的内容, 只和 ID 和序号有关
+ *
+ * @param[out] data 数据, 前 2 字节是序号
+ * @return 数据长度, 2 ~ 最大长度
+ */
+static uint32_t test_fill(msg_id_t id, uint32_t seq, uint8_t *data) {
+    uint32_t x = (seq + 1U) * 2654435761U ^ ((uint32_t)id << 24);
+    uint32_t len = 2U + x % (msg_max_data_len[id] - 1U);
+
+    for (uint32_t i = 0; i < len; ++i) {
+        x = x * 1103515245U + 12345U;
+        data[i] = (uint8_t)(x >> 24);
+    }
+    data[0] = (uint8_t)seq;
+    data[1] = (uint8_t)(seq >> 8);
+    return len;
+}
+
+static void test_sink(const uint8_t *data, uint32_t len) {
+    memcpy(&test_wire[test_wire_len], data, len);
+    test_wire_len += len;
+}
+
+static void test_send(msg_id_t id) {
+    uint8_t data[64];
+    uint32_t len = test_fill(id, test_stat[id].sent, data);
+
+    CHECK(message_send_data(id, MSG_DATA_CUSTOM, data, len) == 0);
+    host_uart_tx_isr(&test_uart, test_sink);
+    ++test_stat[id].sent;
+}
+
+/**
+ * @brief 检查一帧, `id`是回调注册的 ID
+ */
+static void test_check(msg_id_t id, uint32_t len, uint8_t id_type,
+                       uint8_t *data) {
+    msg_fifo_t *fifo = msg_list[id]->rx_port->fifo;
+    uint8_t expect[64];
+    uint32_t expect_len = test_fill(id, test_stat[id].recv, expect);
+
+    if (((id_type >> 4) != (id & 0x0FU)) || (len != expect_len) ||
+        (memcmp(data, expect, len) != 0)) {
+        ++test_stat[id].bad;
+    }
+    if ((data < fifo->buf) ||
+        (data + len > &fifo->buf[fifo->size + fifo->mirror_len])) {
+        ++test_stat[id].copied;
+    }
+    ++test_stat[id].recv;
+}
+
+static void test_nuc_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    test_check(MSG_NUC, len, id_type, data);
+}
+
+static void test_rpc_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    test_check(MSG_RPC, len, id_type, data);
+}
+
+static void test_remote_callback(uint32_t len, uint8_t id_type,
+                                 uint8_t *data) {
+    test_check(MSG_REMOTE, len, id_type, data);
+}
+
+/**
+ * @brief 按随机长度分段写进 DMA 缓冲区, 每段轮询一次
+ */
+static void test_deliver(void) {
+    uint32_t pos = 0, len;
+
+    while (pos < test_wire_len) {
+        len = 1U + test_rand() % TEST_CHUNK_MAX;
+        if (len > test_wire_len - pos) {
+            len = test_wire_len - pos;
+        }
+        host_uart_rx_dma(&test_uart, &test_wire[pos], len, true);
+        pos += len;
+        message_polling_data();
+    }
+    test_wire_len = 0;
+}
+
+/**
+ * @brief 三个 ID 共用一个接收端口
+ */
+static void test_port(void) {
+    msg_rx_port_t *port = msg_list[MSG_NUC]->rx_port;
+    uint32_t ports = 0;
+
+    CHECK(port != NULL);
+    CHECK(msg_list[MSG_RPC]->rx_port == port);
+    CHECK(msg_list[MSG_REMOTE]->rx_port == port);
+    CHECK(msg_list[MSG_TO_SLAVE]->rx_port == NULL);
+    CHECK(port->msg_num == TEST_ID_NUM);
+    /* 绑定了多个 ID, 没有设置就没有默认 ID */
+    CHECK(port->fallback == NULL);
+
+    for (uint32_t i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        ports += (msg_rx_port_list[i] != NULL);
+    }
+    CHECK(ports == 1);
+}
+
+/**
+ * @brief 随机交错的三个 ID, 夹杂未绑定的 ID
+ */
+static void test_interleaved(void) {
+    msg_rx_port_t *port = msg_list[MSG_NUC]->rx_port;
+    uint32_t foreign = 0;
+
+    for (uint32_t i = 0; i < TEST_FRAMES; ++i) {
+        test_send(test_ids[test_rand() % TEST_ID_NUM]);
+        if (test_rand() % TEST_FOREIGN_GAP == 0) {
+            test_send(MSG_TO_SLAVE);
+            ++foreign;
+        }
+    }
+    test_deliver();
+
+    printf("%-10s %6s %6s %6s %6s\n", "id", "sent", "recv", "bad", "copied");
+    for (uint32_t i = 0; i < TEST_ID_NUM; ++i) {
+        msg_id_t id = test_ids[i];
+
+        printf("%-10s %6u %6u %6u %6u\n", test_names[i],
+               (unsigned)test_stat[id].sent, (unsigned)test_stat[id].recv,
+               (unsigned)test_stat[id].bad, (unsigned)test_stat[id].copied);
+        CHECK(test_stat[id].sent > TEST_FRAMES / TEST_ID_NUM / 2U);
+        CHECK(test_stat[id].recv == test_stat[id].sent);
+        CHECK(test_stat[id].bad == 0);
+        CHECK(test_stat[id].copied == 0);
+        CHECK(msg_list[id]->recv_success == test_stat[id].sent);
+    }
+    printf("unbound    %6u %6u\n", (unsigned)foreign,
+           (unsigned)port->recv_unknown);
+
+    CHECK(port->recv_unknown == foreign);
+    CHECK(port->recv_fallback == 0);
+    CHECK(port->recv_error == 0);
+    CHECK(port->recv_crc_error == 0);
+    CHECK(port->fifo_overflow == 0);
+    CHECK(host_uart_rx_overrun() == 0);
+}
+
+/**
+ * @brief 设置默认 ID 后, 未绑定的 ID 交给它
+ */
+static void test_fallback(void) {
+    msg_rx_port_t *port = msg_list[MSG_REMOTE]->rx_port;
+    uint32_t unknown = port->recv_unknown;
+    uint32_t remote = test_stat[MSG_REMOTE].recv;
+    uint32_t bad = test_stat[MSG_REMOTE].bad;
+
+    message_set_rx_default(MSG_REMOTE, true);
+    CHECK(port->fallback == msg_list[MSG_REMOTE]);
+
+    test_send(MSG_TO_SLAVE);
+    test_deliver();
+
+    CHECK(port->recv_unknown == unknown + 1U);
+    CHECK(port->recv_fallback == 1);
+    /* 交给遥控器的回调, 内容是发给从板的, 所以按遥控器检查是错的 */
+    CHECK(test_stat[MSG_REMOTE].recv == remote + 1U);
+    CHECK(test_stat[MSG_REMOTE].bad == bad + 1U);
+
+    message_set_rx_default(MSG_REMOTE, false);
+    CHECK(port->fallback == NULL);
+}
+
+int main(void) {
+    host_uart_rx_ring(DMA_RX_BUF_SIZE);
+
+    message_register_send_uart(MSG_NUC, &test_uart, 0);
+    message_register_send_uart(MSG_RPC, &test_uart, 0);
+    message_register_send_uart(MSG_REMOTE, &test_uart, 0);
+    message_register_send_uart(MSG_TO_SLAVE, &test_uart, 0);
+
+    message_register_polling_uart(MSG_NUC, &test_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_polling_uart(MSG_RPC, &test_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_polling_uart(MSG_REMOTE, &test_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_recv_callback(MSG_NUC, test_nuc_callback);
+    message_register_recv_callback(MSG_RPC, test_rpc_callback);
+    message_register_recv_callback(MSG_REMOTE, test_remote_callback);
+    message_set_crc(MSG_NUC, MSG_CRC_32, false);
+    message_set_crc(MSG_RPC, MSG_CRC_16, false);
+
+    test_port();
+    test_interleaved();
+    test_fallback();
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,474 @@
+/**
+ * @file    host_stubs.c
+ * @brief   主机测试用的串口, DMA, 中断替身
+ *
+ * @note 关中断用一把全局锁模拟. `HAL_UART_Transmit_DMA`只记录要发送的
+ *       数据, 测试线程调用`host_uart_tx_isr`模拟发送完成中断: 拿到锁,
+ *       把数据交给测试, 再调用注册的发送完成回调.
+ *       接收端从`host_uart_rx_feed`喂进来的数据中读取, 或者调用
+ *       `host_uart_rx_ring`设置 DMA 循环缓冲区, 由`host_uart_rx_dma`模拟 DMA
+ *       写入, 和驱动一样会被套圈. 线性数据可以用`host_uart_rx_select`
+ *       指定只给一个串口.
+ */
+
+#include "bsp.h"
+#include "FreeRTOS.h"
+#include "SEGGER_RTT.h"
+#include "host_stubs.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+DWT_Type host_dwt;
+CoreDebug_Type host_core_debug;
+uint32_t SystemCoreClock = 168000000U;
+
+UART_HandleTypeDef usart2_handle = {2, (void *)1, (void *)1};
+UART_HandleTypeDef uart4_handle = {4, (void *)1, (void *)1};
+UART_HandleTypeDef uart5_handle = {5, (void *)1, (void *)1};
+
+static uint32_t host_led[4];
+
+void host_led_toggle(uint32_t led) {
+    ++host_led[led & 3U];
+}
+
+uint32_t host_led_count(uint32_t led) {
+    return host_led[led & 3U];
+}
+
+/*******************************************************************************
+ * @defgroup 中断
+ * @{
+ */
+
+static pthread_mutex_t host_irq_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local uint32_t host_irq_masked;
+
+uint32_t __get_PRIMASK(void) {
+    return host_irq_masked;
+}
+
+void __disable_irq(void) {
+    if (!host_irq_masked) {
+        pthread_mutex_lock(&host_irq_lock);
+        host_irq_masked = 1;
+    }
+}
+
+void __set_PRIMASK(uint32_t primask) {
+    if (!primask && host_irq_masked) {
+        host_irq_masked = 0;
+        pthread_mutex_unlock(&host_irq_lock);
+    }
+}
+
+/**
+ * @}
+ */
+
+/*******************************************************************************
+ * @defgroup 时间
+ * @{
+ */
+
+static atomic_uint host_tick;
+
+uint32_t HAL_GetTick(void) {
+    return atomic_load(&host_tick);
+}
+
+void host_tick_advance(uint32_t ms) {
+    atomic_fetch_add(&host_tick, ms);
+    host_dwt.CYCCNT += ms * (SystemCoreClock / 1000U);
+}
+
+static TimerHandle_t host_timer;
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period,
+                           BaseType_t reload, void *id,
+                           void (*callback)(TimerHandle_t)) {
+    UNUSED(name);
+    UNUSED(period);
+    UNUSED(reload);
+
+    TimerHandle_t timer = (TimerHandle_t)calloc(1, sizeof(*timer));
+    if (timer == NULL) {
+        return NULL;
+    }
+
+    timer->callback = callback;
+    timer->id = id;
+    host_timer = timer;
+    return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait) {
+    UNUSED(timer);
+    UNUSED(wait);
+    return pdPASS;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period,
+                              TickType_t wait) {
+    UNUSED(timer);
+    UNUSED(period);
+    UNUSED(wait);
+    return pdPASS;
+}
+
+static atomic_uint host_notify_value;
+static atomic_uint host_notify_gives;
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken) {
+    UNUSED(task);
+    atomic_fetch_add(&host_notify_value, 1);
+    atomic_fetch_add(&host_notify_gives, 1);
+    *woken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait) {
+    UNUSED(wait);
+
+    if (clear) {
+        return atomic_exchange(&host_notify_value, 0);
+    }
+
+    uint32_t value = atomic_load(&host_notify_value);
+    while ((value != 0) &&
+           !atomic_compare_exchange_weak(&host_notify_value, &value,
+                                         value - 1)) {
+    }
+    return value;
+}
+
+uint32_t host_task_notify_pending(void) {
+    return atomic_load(&host_notify_value);
+}
+
+uint32_t host_task_notify_gives(void) {
+    return atomic_load(&host_notify_gives);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    host_tick_advance(ticks);
+}
+
+void host_timer_fire(void) {
+    if (host_timer != NULL) {
+        host_timer->callback(host_timer);
+    }
+}
+
+/**
+ * @}
+ */
+
+/*******************************************************************************
+ * @defgroup 串口发送
+ * @{
+ */
+
+static uart_tx_event_callback_t host_tx_cplt;
+static atomic_bool host_tx_busy;
+static const uint8_t *host_tx_data;
+static uint16_t host_tx_len;
+static bool host_tx_foreign;
+static bool host_tx_foreign_pending;
+static uint32_t host_tx_foreign_count;
+static atomic_uint host_tx_refused;
+
+uint8_t uart_dmatx_register_cplt_callback(UART_HandleTypeDef *huart,
+                                          uart_tx_event_callback_t callback) {
+    if (huart->hdmatx == NULL) {
+        return 1;
+    }
+
+    host_tx_cplt = callback;
+    return 0;
+}
+
+int HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *data,
+                          uint16_t len) {
+    bool idle = false;
+    UNUSED(huart);
+
+    if (!atomic_compare_exchange_strong(&host_tx_busy, &idle, true)) {
+        /* HAL_BUSY */
+        atomic_fetch_add(&host_tx_refused, 1);
+        return 2;
+    }
+
+    host_tx_data = data;
+    host_tx_len = len;
+    host_tx_foreign = false;
+    return HAL_OK;
+}
+
+int HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *data, uint16_t len,
+                      uint32_t timeout) {
+    UNUSED(huart);
+    UNUSED(data);
+    UNUSED(len);
+    UNUSED(timeout);
+    return HAL_OK;
+}
+
+/**
+ * @brief 串口驱动自己的 DMA 发送 (例如`uart_printf`), 串口忙时和驱动一样
+ *        留到发送完成中断里再启动
+ */
+static bool host_uart_foreign_start(UART_HandleTypeDef *huart) {
+    static uint8_t foreign[] = "printf\r\n";
+
+    if (HAL_UART_Transmit_DMA(huart, foreign, sizeof(foreign) - 1) != HAL_OK) {
+        host_tx_foreign_pending = true;
+        return false;
+    }
+
+    host_tx_foreign = true;
+    host_tx_foreign_pending = false;
+    ++host_tx_foreign_count;
+    return true;
+}
+
+void host_uart_foreign_tx(UART_HandleTypeDef *huart) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    host_uart_foreign_start(huart);
+    __set_PRIMASK(primask);
+}
+
+uint32_t host_uart_foreign_count(void) {
+    return host_tx_foreign_count;
+}
+
+bool host_uart_tx_isr(UART_HandleTypeDef *huart, host_tx_sink_t sink) {
+    if (!atomic_load(&host_tx_busy)) {
+        return false;
+    }
+
+    __disable_irq();
+    if (!host_tx_foreign) {
+        sink(host_tx_data, host_tx_len);
+    }
+
+    /* 和 HAL 一样, 调用回调前串口已经空闲 */
+    atomic_store(&host_tx_busy, false);
+    if (host_tx_cplt != NULL) {
+        host_tx_cplt(huart);
+    }
+    if (host_tx_foreign_pending) {
+        host_uart_foreign_start(huart);
+    }
+    __set_PRIMASK(0);
+
+    return true;
+}
+
+uint32_t host_uart_tx_refused(void) {
+    return atomic_load(&host_tx_refused);
+}
+
+bool host_uart_tx_busy(void) {
+    return atomic_load(&host_tx_busy);
+}
+
+uint32_t uart_dmatx_write(UART_HandleTypeDef *huart, const void *data,
+                          size_t len) {
+    UNUSED(huart);
+    UNUSED(data);
+    return (uint32_t)len;
+}
+
+uint32_t uart_dmatx_send(UART_HandleTypeDef *huart) {
+    UNUSED(huart);
+    return 0;
+}
+
+/**
+ * @}
+ */
+
+/*******************************************************************************
+ * @defgroup 串口接收
+ * @{
+ */
+
+static const uint8_t *host_rx_data;
+static uint32_t host_rx_len;
+static uint32_t host_rx_pos;
+
+/* DMA 循环接收缓冲区, 设置以后取代`host_uart_rx_feed`的线性数据 */
+static uint8_t *host_rx_ring;
+static uint32_t host_rx_ring_size;
+static uint32_t host_rx_dma_ptr;  /* DMA 写到的位置, 不取模 */
+static uint32_t host_rx_read_ptr; /* 读到的位置, 不取模 */
+static uint32_t host_rx_overrun;
+static uart_rx_event_callback_t host_rx_event;
+
+/* 线性数据只给这个串口读, 为`NULL`时所有串口读到同一份 */
+static UART_HandleTypeDef *host_rx_select;
+/* 按注册顺序记录的接收串口, 和抓包记录的端口序号一致 */
+static UART_HandleTypeDef *host_rx_port[8];
+
+void host_uart_rx_feed(const uint8_t *data, uint32_t len) {
+    host_rx_data = data;
+    host_rx_len = len;
+    host_rx_pos = 0;
+}
+
+void host_uart_rx_ring(uint32_t size) {
+    free(host_rx_ring);
+    host_rx_ring = (size != 0) ? (uint8_t *)calloc(1, size) : NULL;
+    host_rx_ring_size = (host_rx_ring != NULL) ? size : 0;
+    host_rx_dma_ptr = 0;
+    host_rx_read_ptr = 0;
+    host_rx_overrun = 0;
+}
+
+void host_uart_rx_dma(UART_HandleTypeDef *huart, const uint8_t *data,
+                      uint32_t len, bool event) {
+    for (uint32_t i = 0; i < len; ++i) {
+        host_rx_ring[host_rx_dma_ptr % host_rx_ring_size] = data[i];
+        ++host_rx_dma_ptr;
+    }
+
+    if (event && (host_rx_event != NULL)) {
+        host_rx_event(huart);
+    }
+}
+
+uint32_t host_uart_rx_overrun(void) {
+    return host_rx_overrun;
+}
+
+void host_uart_rx_select(UART_HandleTypeDef *huart) {
+    host_rx_select = huart;
+}
+
+UART_HandleTypeDef *host_uart_rx_port(uint32_t index) {
+    return (index < 8) ? host_rx_port[index] : NULL;
+}
+
+uint32_t uart_dmarx_peek(UART_HandleTypeDef *huart, uart_rx_span_t span[2]) {
+    span[1].data = NULL;
+    span[1].len = 0;
+
+    if (host_rx_ring == NULL) {
+        if ((host_rx_select != NULL) && (huart != host_rx_select)) {
+            span[0].data = NULL;
+            span[0].len = 0;
+            return 0;
+        }
+
+        span[0].data = host_rx_data + host_rx_pos;
+        span[0].len = host_rx_len - host_rx_pos;
+        return span[0].len;
+    }
+
+    /* 和驱动一样: 被 DMA 套圈时跳到最新位置, 之前的数据丢弃 */
+    uint32_t len = host_rx_dma_ptr - host_rx_read_ptr;
+    if (len > host_rx_ring_size) {
+        ++host_rx_overrun;
+        host_rx_read_ptr = host_rx_dma_ptr;
+        span[0].len = 0;
+        return 0;
+    }
+
+    uint32_t offset = host_rx_read_ptr % host_rx_ring_size;
+    span[0].data = host_rx_ring + offset;
+    span[0].len = (offset + len > host_rx_ring_size)
+                      ? (host_rx_ring_size - offset)
+                      : len;
+    span[1].data = host_rx_ring;
+    span[1].len = len - span[0].len;
+    return len;
+}
+
+uint8_t uart_dmarx_consume(UART_HandleTypeDef *huart, uint32_t len) {
+    if (host_rx_ring == NULL) {
+        if ((host_rx_select != NULL) && (huart != host_rx_select)) {
+            return (len == 0) ? 0 : 3;
+        }
+
+        if (len > host_rx_len - host_rx_pos) {
+            return 3;
+        }
+
+        host_rx_pos += len;
+        return 0;
+    }
+
+    if (len > host_rx_dma_ptr - host_rx_read_ptr) {
+        return 3;
+    }
+
+    host_rx_read_ptr += len;
+    if (host_rx_dma_ptr - host_rx_read_ptr + len > host_rx_ring_size) {
+        /* 解析期间 DMA 覆盖了这段数据 */
+        ++host_rx_overrun;
+        return 2;
+    }
+
+    return 0;
+}
+
+uint32_t uart_dmarx_read(UART_HandleTypeDef *huart, void *buf, size_t len) {
+    uart_rx_span_t span[2];
+    uint32_t n = uart_dmarx_peek(huart, span);
+    uint32_t first;
+
+    if (n > len) {
+        n = (uint32_t)len;
+    }
+
+    first = (span[0].len < n) ? span[0].len : n;
+    memcpy(buf, span[0].data, first);
+    memcpy((uint8_t *)buf + first, span[1].data, n - first);
+    uart_dmarx_consume(huart, n);
+    return n;
+}
+
+uint8_t uart_dmarx_register_event_callback(UART_HandleTypeDef *huart,
+                                           uart_rx_event_callback_t callback) {
+    for (uint32_t i = 0; i < 8; ++i) {
+        if (host_rx_port[i] == huart) {
+            break;
+        }
+
+        if (host_rx_port[i] == NULL) {
+            host_rx_port[i] = huart;
+            break;
+        }
+    }
+
+    host_rx_event = callback;
+    return 0;
+}
+
+/**
+ * @}
+ */
+
+int SEGGER_RTT_ConfigUpBuffer(unsigned index, const char *name, void *buf,
+                              unsigned size, unsigned flags) {
+    UNUSED(index);
+    UNUSED(name);
+    UNUSED(buf);
+    UNUSED(size);
+    UNUSED(flags);
+    return 0;
+}
+
+unsigned SEGGER_RTT_GetAvailWriteSpace(unsigned index) {
+    UNUSED(index);
+    return 0;
+}
+
+unsigned SEGGER_RTT_Write(unsigned index, const void *data, unsigned len) {
+    UNUSED(index);
+    UNUSED(data);
+    return len;
+}
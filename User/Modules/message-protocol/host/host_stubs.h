@@ -0,0 +1,35 @@
+/**
+ * @file    host_stubs.h
+ * @brief   主机测试用替身的控制接口
+ */
+
+#ifndef __HOST_STUBS_H
+#define __HOST_STUBS_H
+
+#include "bsp.h"
+
+/* 发送完成时收到的数据 */
+typedef void (*host_tx_sink_t)(const uint8_t *data, uint32_t len);
+
+void host_tick_advance(uint32_t ms);
+void host_timer_fire(void);
+uint32_t host_task_notify_pending(void);
+uint32_t host_task_notify_gives(void);
+
+bool host_uart_tx_isr(UART_HandleTypeDef *huart, host_tx_sink_t sink);
+bool host_uart_tx_busy(void);
+uint32_t host_uart_tx_refused(void);
+void host_uart_foreign_tx(UART_HandleTypeDef *huart);
+uint32_t host_uart_foreign_count(void);
+
+void host_uart_rx_feed(const uint8_t *data, uint32_t len);
+void host_uart_rx_ring(uint32_t size);
+void host_uart_rx_dma(UART_HandleTypeDef *huart, const uint8_t *data,
+                      uint32_t len, bool event);
+uint32_t host_uart_rx_overrun(void);
+void host_uart_rx_select(UART_HandleTypeDef *huart);
+UART_HandleTypeDef *host_uart_rx_port(uint32_t index);
+
+uint32_t host_led_count(uint32_t led);
+
+#endif /* __HOST_STUBS_H */
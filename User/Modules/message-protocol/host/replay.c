@@ -0,0 +1,281 @@
+/**
+ * @file    replay.c
+ * @brief   在主机上重放`message_capture_dump`导出的抓包记录
+ *
+ * @note 和固件的`sub_pub.c`, `remote_ctrl.c`, `msg_rpc.c`一起编译, 调用
+ *       `msg_polling_init`按固件的顺序注册同样的串口, CRC 设置和接收回调,
+ *       每条记录喂给端口序号对应的串口, 由固件的回调解码到`g_nuc_pos_data`
+ *       和`g_remote_ctrl_data`. 另外给每个 ID 加一个订阅者统计分发的帧数.
+ *       默认重放所有端口, 尽快重放, 输出解析吞吐量; `-p`只重放一个端口;
+ *       `-r`按记录的接收时间 1 倍速重放; `-v`每收到一帧位姿或遥控器数据就
+ *       输出解码结果. 编译配置 (COBS/转义, v3) 要和抓包的固件一致.
+ *
+ *       用法: replay [-r] [-v] [-p 端口序号] 抓包文件
+ */
+
+#include "includes.h"
+#include "msg_protocol.h"
+#include "msg_rpc.h"
+#include "remote_ctrl/remote_ctrl.h"
+#include "host_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* 抓包记录头: 4 byte 接收时间 (ms), 1 byte 端口序号, 2 byte 数据长度 */
+#define REPLAY_HEADER_LEN 7U
+/* 所有端口 */
+#define REPLAY_ALL_PORTS  0xFFFFFFFFU
+
+static uint32_t replay_frames[MSG_ID_RESERVE_LEN];
+static uint64_t replay_data_len[MSG_ID_RESERVE_LEN];
+static uint64_t replay_tx_len;
+static bool replay_verbose;
+
+/**
+ * @brief 输出固件回调解码的结果
+ *
+ * @param msg_id 消息 ID
+ */
+static void replay_show(msg_id_t msg_id) {
+    switch (msg_id) {
+        case MSG_NUC: {
+            printf("%8u ms nuc    x %.1f y %.1f yaw %.3f\n", HAL_GetTick(),
+                   (double)g_nuc_pos_data.x, (double)g_nuc_pos_data.y,
+                   (double)g_nuc_pos_data.yaw);
+        } break;
+
+        case MSG_REMOTE: {
+            printf("%8u ms remote key %u rs %d %d %d %d\n", HAL_GetTick(),
+                   g_remote_ctrl_data.key, g_remote_ctrl_data.rs[0],
+                   g_remote_ctrl_data.rs[1], g_remote_ctrl_data.rs[2],
+                   g_remote_ctrl_data.rs[3]);
+        } break;
+
+        default: {
+        } break;
+    }
+}
+
+/* 每个 ID 一个订阅者, 排在固件的回调后面, 统计分发给这个 ID 的帧 */
+#define REPLAY_COUNTER(id, max_len)                                            \
+    static void replay_count_##id(uint32_t len, uint8_t id_type,               \
+                                  uint8_t *data) {                             \
+        UNUSED(id_type);                                                       \
+        UNUSED(data);                                                          \
+        ++replay_frames[id];                                                   \
+        replay_data_len[id] += len;                                            \
+        if (replay_verbose) {                                                  \
+            replay_show(id);                                                   \
+        }                                                                      \
+    }
+MSG_ID_TABLE(REPLAY_COUNTER)
+#undef REPLAY_COUNTER
+
+/**
+ * @brief 固件的应答等发送数据, 只统计长度
+ */
+static void replay_tx_sink(const uint8_t *data, uint32_t len) {
+    UNUSED(data);
+    replay_tx_len += len;
+}
+
+/**
+ * @brief 读取整个文件
+ *
+ * @param path 文件路径
+ * @param[out] len 文件长度
+ * @return 文件内容, 失败返回`NULL`
+ */
+static uint8_t *replay_load(const char *path, uint32_t *len) {
+    FILE *fp = fopen(path, "rb");
+    uint8_t *buf;
+    long size;
+
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    buf = (uint8_t *)malloc((size_t)size + 1);
+    if ((buf == NULL) || (fread(buf, 1, (size_t)size, fp) != (size_t)size)) {
+        free(buf);
+        fclose(fp);
+        return NULL;
+    }
+
+    fclose(fp);
+    *len = (uint32_t)size;
+    return buf;
+}
+
+/**
+ * @brief 单调时钟 (us)
+ */
+static uint64_t replay_now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+static void replay_usage(const char *name) {
+    printf("usage: %s [-r] [-v] [-p port] capture.bin\n", name);
+    printf("  -r  replay at 1x speed using record timestamps\n");
+    printf("  -v  print every decoded pose and remote frame\n");
+    printf("  -p  receive port index to replay, default all ports\n");
+}
+
+int main(int argc, char *argv[]) {
+    bool realtime = false;
+    uint32_t port = REPLAY_ALL_PORTS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "rvp:")) != -1) {
+        switch (opt) {
+            case 'r': {
+                realtime = true;
+            } break;
+
+            case 'p': {
+                port = (uint32_t)strtoul(optarg, NULL, 0);
+            } break;
+
+            case 'v': {
+                replay_verbose = true;
+            } break;
+
+            default: {
+                replay_usage(argv[0]);
+                return 2;
+            }
+        }
+    }
+
+    if (optind >= argc) {
+        replay_usage(argv[0]);
+        return 2;
+    }
+
+    uint32_t file_len;
+    uint8_t *file = replay_load(argv[optind], &file_len);
+    if (file == NULL) {
+        printf("can not read %s\n", argv[optind]);
+        return 1;
+    }
+
+    /* 和固件的轮询任务一样注册, 再加上统计用的订阅者 */
+    msg_polling_init();
+#define REPLAY_SUBSCRIBE(id, max_len)                                          \
+    message_subscribe(id, replay_count_##id, MSG_TYPE_MASK_ALL);
+    MSG_ID_TABLE(REPLAY_SUBSCRIBE)
+#undef REPLAY_SUBSCRIBE
+
+    uint32_t records = 0, truncated = 0, skipped = 0;
+    uint32_t first_time = 0, last_time = 0;
+    uint64_t bytes = 0, start_us = replay_now_us(), parse_us = 0, t0;
+    uint32_t pos = 0;
+
+    while (pos + REPLAY_HEADER_LEN <= file_len) {
+        const uint8_t *header = &file[pos];
+        uint32_t time = (uint32_t)header[0] | ((uint32_t)header[1] << 8) |
+                        ((uint32_t)header[2] << 16) |
+                        ((uint32_t)header[3] << 24);
+        uint32_t len = (uint32_t)header[5] | ((uint32_t)header[6] << 8);
+
+        if (pos + REPLAY_HEADER_LEN + len > file_len) {
+            /* 导出被打断, 最后一条不完整 */
+            ++truncated;
+            break;
+        }
+
+        UART_HandleTypeDef *huart = host_uart_rx_port(header[4]);
+
+        if (huart == NULL) {
+            /* 固件没有注册这个序号的端口, 抓包和固件版本不一致 */
+            ++skipped;
+        } else if ((port == REPLAY_ALL_PORTS) || (header[4] == port)) {
+            if (records == 0) {
+                first_time = time;
+                last_time = time;
+            }
+
+            if (realtime) {
+                /* 按接收时间等待 */
+                uint64_t due = start_us + (uint64_t)(time - first_time) * 1000U;
+                uint64_t now = replay_now_us();
+                if (due > now) {
+                    usleep((useconds_t)(due - now));
+                }
+            }
+
+            host_tick_advance(time - last_time);
+            last_time = time;
+
+            t0 = replay_now_us();
+            host_uart_rx_select(huart);
+            host_uart_rx_feed(&header[REPLAY_HEADER_LEN], len);
+            message_polling_data();
+            message_rpc_poll();
+            parse_us += replay_now_us() - t0;
+
+            /* 固件发出的 RPC 应答 */
+            while (host_uart_tx_isr(huart, replay_tx_sink)) {
+            }
+
+            ++records;
+            bytes += len;
+        }
+
+        pos += REPLAY_HEADER_LEN + len;
+    }
+
+    uint64_t wall_us = replay_now_us() - start_us;
+    uint32_t frames = 0;
+
+    if (port == REPLAY_ALL_PORTS) {
+        printf("all ports: ");
+    } else {
+        printf("port %u: ", port);
+    }
+    printf("%u records, %llu bytes, capture span %u ms%s\n", records,
+           (unsigned long long)bytes, last_time - first_time,
+           truncated ? ", last record truncated" : "");
+    if (skipped != 0) {
+        printf("  %u records on ports the firmware does not register\n",
+               skipped);
+    }
+
+#define REPLAY_REPORT(id, max_len)                                             \
+    printf("  %-14s %8u frames %10llu data bytes\n", #id, replay_frames[id],  \
+           (unsigned long long)replay_data_len[id]);                          \
+    frames += replay_frames[id];
+    MSG_ID_TABLE(REPLAY_REPORT)
+#undef REPLAY_REPORT
+
+    printf("  wall %.3f ms, parse %.3f ms", (double)wall_us / 1000.0,
+           (double)parse_us / 1000.0);
+    if (parse_us != 0) {
+        printf(", %.2f MB/s, %.0f frames/s",
+               (double)bytes / (double)parse_us,
+               (double)frames * 1000000.0 / (double)parse_us);
+    }
+    printf("\n");
+
+    /* 固件回调解码的最终状态, LED 翻转次数即解码成功的位姿帧数 */
+    printf("  nuc decoded %u, last x %.1f y %.1f yaw %.3f\n", host_led_count(2),
+           (double)g_nuc_pos_data.x, (double)g_nuc_pos_data.y,
+           (double)g_nuc_pos_data.yaw);
+    printf("  remote last key %u rs %d %d %d %d\n", g_remote_ctrl_data.key,
+           g_remote_ctrl_data.rs[0], g_remote_ctrl_data.rs[1],
+           g_remote_ctrl_data.rs[2], g_remote_ctrl_data.rs[3]);
+    printf("  rpc reply %llu bytes\n", (unsigned long long)replay_tx_len);
+
+    free(file);
+    return 0;
+}
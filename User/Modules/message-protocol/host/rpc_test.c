@@ -0,0 +1,393 @@
+/**
+ * @file    rpc_test.c
+ * @brief   RPC 自发自收测试和往返时间, 在主机上运行
+ *
+ * @note 串口自发自收, 同一端既调用又被调用. 串口设置和`sub_pub.c`相同:
+ *       位姿和 RPC 共用串口, 位姿是默认 ID, RPC 必须带 CRC-16. 发出的帧先
+ *       放到线上, 由测试决定什么时候, 以什么速度写进模拟的 DMA 缓冲区.
+ *
+ *       - 往返: 不同参数长度的请求, 方法原样返回参数, 检查完成回调的状态和
+ *         返回值, 并测量主机上一次往返 (两帧编码和解析) 的时间;
+ *       - 线路: 921600 波特率 (每毫秒 92 字节), 每 100 us 轮询一次, 统计
+ *         从调用到完成回调的往返时间;
+ *       - 没有方法, 等待表满, 超时和超时后才到的响应;
+ *       - 默认路由: 旧小电脑按未绑定的 ID 发来的位姿交给位姿, 按 RPC 的 ID
+ *         发来的不带 CRC 的帧丢弃, 不会被当成请求执行.
+ *
+ *       包含`msg_protocol.c`以便读取接收端口的统计.
+ */
+
+#include "../msg_protocol.c"
+
+#include "host_stubs.h"
+#include "msg_rpc.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define DMA_RX_BUF_SIZE  512U
+#define RX_FIFO_SIZE     512U
+#define RPC_ECHO         1U
+#define RPC_MISSING      2U
+#define BENCH_CALLS      100000U
+/* 921600 波特率, 10 bit 一个字节 */
+#define LINE_BYTES_PER_MS 92U
+#define LINE_STEP_US     100U
+#define LINE_CALLS       200U
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+static UART_HandleTypeDef test_uart = {1, (void *)1, (void *)1};
+
+/* 已经发出, 还在线上的数据 */
+static uint8_t wire[65536];
+static uint32_t wire_head;
+static uint32_t wire_tail;
+
+static uint32_t test_pose_count;
+static uint64_t test_now_us;
+
+/**
+ * @brief 一次调用的结果
+ */
+typedef struct {
+    uint32_t done;       /*!< 完成回调次数 */
+    uint8_t status;      /*!< 调用状态 */
+    uint8_t ret[MSG_RPC_DATA_MAX_LEN]; /*!< 返回值 */
+    uint32_t ret_len;    /*!< 返回值长度 */
+    uint64_t start_us;   /*!< 调用时间 (模拟时间) */
+    uint64_t rtt_us;     /*!< 往返时间 (模拟时间) */
+} test_call_t;
+
+/**
+ * @brief 单调时钟 (ns)
+ */
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static uint8_t test_echo(const uint8_t *args, uint32_t args_len, uint8_t *ret,
+                         uint32_t *ret_len) {
+    memcpy(ret, args, args_len);
+    *ret_len = args_len;
+    return MSG_RPC_OK;
+}
+
+static void test_done(uint8_t status, const uint8_t *ret, uint32_t ret_len,
+                      void *user_data) {
+    test_call_t *call = (test_call_t *)user_data;
+
+    ++call->done;
+    call->status = status;
+    call->ret_len = ret_len;
+    if (ret != NULL) {
+        memcpy(call->ret, ret, ret_len);
+    }
+    call->rtt_us = test_now_us - call->start_us;
+}
+
+static void test_pose_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    UNUSED(len);
+    UNUSED(id_type);
+    UNUSED(data);
+    ++test_pose_count;
+}
+
+/**
+ * @brief DMA 发送完成, 数据放到线上
+ */
+static void test_sink(const uint8_t *data, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        wire[wire_tail++ % sizeof(wire)] = data[i];
+    }
+}
+
+/**
+ * @brief 把线上的数据最多`len`字节写进 DMA 缓冲区
+ */
+static void test_wire_to_rx(uint32_t len) {
+    uint8_t byte;
+
+    if (len > wire_tail - wire_head) {
+        len = wire_tail - wire_head;
+    }
+    for (uint32_t i = 0; i < len; ++i) {
+        byte = wire[wire_head++ % sizeof(wire)];
+        host_uart_rx_dma(&test_uart, &byte, 1, false);
+    }
+}
+
+/**
+ * @brief 发送完成并把线上的数据全部收到, 直到没有新的帧
+ */
+static void test_flush(void) {
+    while (host_uart_tx_isr(&test_uart, test_sink) ||
+           (wire_head != wire_tail)) {
+        test_wire_to_rx(UINT32_MAX);
+        message_polling_data();
+    }
+}
+
+/**
+ * @brief 丢掉线上和发送中的数据
+ */
+static void test_drop(void) {
+    while (host_uart_tx_isr(&test_uart, test_sink)) {
+    }
+    wire_head = wire_tail;
+}
+
+/**
+ * @brief 不同参数长度的请求, 原样返回
+ */
+static void test_roundtrip(void) {
+    static const uint32_t lens[] = {0, 1, 16, MSG_RPC_DATA_MAX_LEN};
+    uint8_t args[MSG_RPC_DATA_MAX_LEN];
+    test_call_t call;
+
+    for (uint32_t i = 0; i < sizeof(args); ++i) {
+        /* 包含结束符和转义符 */
+        args[i] = (uint8_t)(MSG_EOF + i * 8U);
+    }
+
+    for (uint32_t i = 0; i < sizeof(lens) / sizeof(lens[0]); ++i) {
+        memset(&call, 0, sizeof(call));
+        CHECK(message_rpc_call(RPC_ECHO, args, lens[i], 100, test_done,
+                               &call) == 0);
+        test_flush();
+
+        CHECK(call.done == 1);
+        CHECK(call.status == MSG_RPC_OK);
+        CHECK(call.ret_len == lens[i]);
+        CHECK(memcmp(call.ret, args, lens[i]) == 0);
+    }
+
+    CHECK(message_rpc_call(RPC_ECHO, args, MSG_RPC_DATA_MAX_LEN + 1U, 100,
+                           test_done, &call) == 1);
+    CHECK(message_rpc_call(RPC_ECHO, NULL, 1, 100, test_done, &call) == 1);
+    CHECK(msg_rpc_stat.done_count == msg_rpc_stat.call_count);
+    CHECK(msg_rpc_stat.serve_count == msg_rpc_stat.call_count);
+
+    /* 不关心结果的调用不占等待表, 响应没人等 */
+    CHECK(message_rpc_call(RPC_ECHO, args, 1, 100, NULL, NULL) == 0);
+    test_flush();
+    CHECK(msg_rpc_stat.serve_count == msg_rpc_stat.call_count);
+    CHECK(msg_rpc_stat.unknown_count == 1);
+}
+
+/**
+ * @brief 主机上一次往返的时间: 请求编码, 解析, 执行, 响应编码, 解析
+ */
+static void test_bench(void) {
+    uint8_t args[16] = {0};
+    test_call_t call;
+    uint64_t t0;
+
+    memset(&call, 0, sizeof(call));
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < BENCH_CALLS; ++i) {
+        message_rpc_call(RPC_ECHO, args, sizeof(args), 100, test_done, &call);
+        test_flush();
+    }
+    t0 = bench_now_ns() - t0;
+
+    CHECK(call.done == BENCH_CALLS);
+    printf("host: %.2f us per round trip, 16 byte args\n",
+           (double)t0 / 1000.0 / BENCH_CALLS);
+}
+
+/**
+ * @brief 921600 波特率下从调用到完成回调的时间
+ *
+ * @param args_len 参数长度
+ */
+static void test_line(uint32_t args_len) {
+    static test_call_t calls[LINE_CALLS];
+    uint8_t args[MSG_RPC_DATA_MAX_LEN] = {0};
+    uint64_t sum = 0, max = 0;
+    uint32_t line_bytes = 0, sent_bytes;
+
+    memset(calls, 0, sizeof(calls));
+    for (uint32_t i = 0; i < LINE_CALLS; ++i) {
+        calls[i].start_us = test_now_us;
+        CHECK(message_rpc_call(RPC_ECHO, args, args_len, 100, test_done,
+                               &calls[i]) == 0);
+
+        while (calls[i].done == 0) {
+            test_now_us += LINE_STEP_US;
+            if (test_now_us % 1000U == 0) {
+                host_tick_advance(1);
+            }
+
+            /* 线上的数据发完了才开始下一次 DMA 发送 */
+            if (wire_head == wire_tail) {
+                host_uart_tx_isr(&test_uart, test_sink);
+            }
+            sent_bytes = (uint32_t)(test_now_us * LINE_BYTES_PER_MS / 1000U);
+            test_wire_to_rx(sent_bytes - line_bytes);
+            line_bytes = sent_bytes;
+
+            message_polling_data();
+            message_rpc_poll();
+        }
+
+        CHECK(calls[i].status == MSG_RPC_OK);
+        sum += calls[i].rtt_us;
+        max = (calls[i].rtt_us > max) ? calls[i].rtt_us : max;
+
+        /* 线上空闲以后再发下一个 */
+        test_flush();
+        line_bytes = (uint32_t)(test_now_us * LINE_BYTES_PER_MS / 1000U);
+    }
+
+    printf("line: %2u byte args, rtt avg %.0f us, max %u us\n",
+           (unsigned)args_len, (double)sum / LINE_CALLS, (unsigned)max);
+    /* 两帧在线上的时间加上轮询间隔 */
+    CHECK(max <= 2U * (MSG_FRAME_MAX_LEN(MSG_RPC_HEADER_LEN + args_len) *
+                       1000U / LINE_BYTES_PER_MS + 2U * LINE_STEP_US));
+}
+
+/**
+ * @brief 没有方法, 等待表满, 超时和迟到的响应
+ */
+static void test_errors(void) {
+    static test_call_t calls[MSG_RPC_PENDING_MAX + 1];
+    uint32_t timeout = msg_rpc_stat.timeout_count;
+    uint32_t unknown = msg_rpc_stat.unknown_count;
+
+    memset(calls, 0, sizeof(calls));
+
+    /* 没有方法 */
+    CHECK(message_rpc_call(RPC_MISSING, NULL, 0, 100, test_done, &calls[0]) ==
+          0);
+    test_flush();
+    CHECK(calls[0].done == 1);
+    CHECK(calls[0].status == MSG_RPC_ERR_METHOD);
+
+    /* 等待表满, 请求都已发出, 响应还没回来. 一次轮询执行的请求不超过发送
+     * 队列长度, 响应才不会被丢掉 */
+    memset(calls, 0, sizeof(calls));
+    for (uint32_t i = 0; i < MSG_RPC_PENDING_MAX; ++i) {
+        CHECK(message_rpc_call(RPC_ECHO, NULL, 0, 10, test_done, &calls[i]) ==
+              0);
+        while (host_uart_tx_isr(&test_uart, test_sink)) {
+        }
+    }
+    CHECK(message_rpc_call(RPC_ECHO, NULL, 0, 10, test_done,
+                           &calls[MSG_RPC_PENDING_MAX]) == 2);
+
+    /* 请求被执行了, 但是响应超时才到 */
+    test_wire_to_rx(UINT32_MAX);
+    message_polling_data();
+    host_tick_advance(9);
+    message_rpc_poll();
+    CHECK(msg_rpc_stat.timeout_count == timeout);
+    host_tick_advance(1);
+    message_rpc_poll();
+    CHECK(msg_rpc_stat.timeout_count == timeout + MSG_RPC_PENDING_MAX);
+    for (uint32_t i = 0; i < MSG_RPC_PENDING_MAX; ++i) {
+        CHECK(calls[i].done == 1);
+        CHECK(calls[i].status == MSG_RPC_ERR_TIMEOUT);
+        CHECK(calls[i].ret_len == 0);
+    }
+
+    test_flush();
+    CHECK(msg_rpc_stat.unknown_count == unknown + MSG_RPC_PENDING_MAX);
+    for (uint32_t i = 0; i < MSG_RPC_PENDING_MAX; ++i) {
+        CHECK(calls[i].done == 1);
+    }
+
+    /* 请求丢了, 超时 */
+    memset(calls, 0, sizeof(calls));
+    CHECK(message_rpc_call(RPC_ECHO, NULL, 0, 10, test_done, &calls[0]) == 0);
+    test_drop();
+    host_tick_advance(10);
+    message_rpc_poll();
+    CHECK(calls[0].done == 1);
+    CHECK(calls[0].status == MSG_RPC_ERR_TIMEOUT);
+}
+
+/**
+ * @brief 默认路由: 旧小电脑不带 CRC, 按其他 ID 发来的位姿交给位姿, 按 RPC
+ *        的 ID 发来的帧不会被当成请求
+ */
+static void test_default_route(void) {
+    msg_rx_port_t *port = msg_list[MSG_RPC]->rx_port;
+    uint8_t request[MSG_RPC_HEADER_LEN + 4U] = {0};
+    uint8_t pose[12] = {0};
+    uint32_t pose_count = test_pose_count;
+    uint32_t fallback = port->recv_fallback;
+    uint32_t serve = msg_rpc_stat.serve_count;
+    uint32_t rpc_error = msg_list[MSG_RPC]->recv_error;
+
+    CHECK(port->fallback == msg_list[MSG_NUC]);
+
+    /* 旧小电脑按遥控器的 ID 发位姿 */
+    message_register_send_uart(MSG_REMOTE, &test_uart, 0);
+    CHECK(message_send_data(MSG_REMOTE, MSG_DATA_CUSTOM, pose,
+                            sizeof(pose)) == 0);
+    test_flush();
+    CHECK(test_pose_count == pose_count + 1U);
+    CHECK(port->recv_fallback == fallback + 1U);
+
+    /* 按 RPC 的 ID 发来的不带 CRC 的帧, 内容恰好像一个请求 */
+    message_set_crc(MSG_RPC, MSG_CRC_NONE, false);
+    request[3] = RPC_ECHO;
+    CHECK(message_send_data(MSG_RPC, MSG_DATA_CUSTOM, request,
+                            sizeof(request)) == 0);
+    while (host_uart_tx_isr(&test_uart, test_sink)) {
+    }
+    message_set_crc(MSG_RPC, MSG_CRC_16, false);
+    test_flush();
+
+    CHECK(msg_rpc_stat.serve_count == serve);
+    CHECK(msg_list[MSG_RPC]->recv_error == rpc_error + 1U);
+    CHECK(test_pose_count == pose_count + 1U);
+    CHECK(port->recv_fallback == fallback + 1U);
+}
+
+int main(void) {
+    host_uart_rx_ring(DMA_RX_BUF_SIZE);
+
+    /* 和`sub_pub.c`相同 */
+    message_register_send_uart(MSG_NUC, &test_uart, 0);
+    message_register_send_uart(MSG_RPC, &test_uart, 0);
+    message_register_polling_uart(MSG_NUC, &test_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_recv_callback(MSG_NUC, test_pose_callback);
+    message_register_polling_uart(MSG_RPC, &test_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_set_rx_default(MSG_NUC, true);
+    message_set_crc(MSG_RPC, MSG_CRC_16, false);
+    CHECK(message_rpc_init() == 0);
+    CHECK(message_rpc_register(RPC_ECHO, test_echo) == 0);
+    CHECK(message_rpc_register(MSG_RPC_METHOD_MAX, test_echo) == 1);
+
+    test_roundtrip();
+    test_errors();
+    test_default_route();
+    test_bench();
+    test_line(0);
+    test_line(16);
+    test_line(MSG_RPC_DATA_MAX_LEN);
+
+    CHECK(host_uart_rx_overrun() == 0);
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
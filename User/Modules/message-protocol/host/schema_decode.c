@@ -0,0 +1,200 @@
+/**
+ * @file    schema_decode.c
+ * @brief   小电脑一侧的消息解码, 在主机上运行
+ *
+ * @note 定义`MSG_SCHEMA_HOST`后只包含`msg_schema.h`, 不依赖消息协议和固件
+ *       头文件, 和小电脑一侧的用法相同. 不带参数时自检: 每个消息打包再解包
+ *       结果一致, 线上格式和原来的`__packed`结构体逐字节相同, 长度不对的
+ *       数据不解包. 带参数时按消息名解码一帧数据内容 (十六进制).
+ *
+ *       用法: schema_decode [消息名 十六进制数据]
+ */
+
+#define MSG_SCHEMA_HOST
+#include "msg_schema.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* 按字段类型输出 */
+#define SCHEMA_PRINT_u8(v)  printf("%u", (unsigned)(v))
+#define SCHEMA_PRINT_i8(v)  printf("%d", (int)(v))
+#define SCHEMA_PRINT_u16(v) printf("%u", (unsigned)(v))
+#define SCHEMA_PRINT_i16(v) printf("%d", (int)(v))
+#define SCHEMA_PRINT_u32(v) printf("%u", (unsigned)(v))
+#define SCHEMA_PRINT_i32(v) printf("%d", (int)(v))
+#define SCHEMA_PRINT_f32(v) printf("%g", (double)(v))
+
+#define SCHEMA_PRINT_FIELD(type, name)                                         \
+    printf("  %-20s ", #name);                                                 \
+    SCHEMA_PRINT_##type(msg.name);                                             \
+    printf("\n");
+#define SCHEMA_PRINT_FIELD_A(type, name, num)                                  \
+    printf("  %-20s", #name);                                                  \
+    for (uint32_t i = 0; i < (num); ++i) {                                     \
+        printf(" ");                                                           \
+        SCHEMA_PRINT_##type(msg.name[i]);                                      \
+    }                                                                          \
+    printf("\n");
+
+/* 自检用的字段值, 每个字段不同 */
+#define SCHEMA_FILL_FIELD(type, name)                                          \
+    msg.name = (msg_schema_##type##_t)(++seed * 37);
+#define SCHEMA_FILL_FIELD_A(type, name, num)                                   \
+    for (uint32_t i = 0; i < (num); ++i) {                                     \
+        msg.name[i] = (msg_schema_##type##_t)(++seed * 37);                    \
+    }
+
+#define SCHEMA_CMP_FIELD(type, name)                                           \
+    same = same && (out.name == msg.name);
+#define SCHEMA_CMP_FIELD_A(type, name, num)                                    \
+    for (uint32_t i = 0; i < (num); ++i) {                                     \
+        same = same && (out.name[i] == msg.name[i]);                           \
+    }
+
+/**
+ * @brief 每个消息生成解码输出函数和打包/解包自检函数
+ */
+#define SCHEMA_DECODER(name, msg_id, fields)                                   \
+    static bool schema_print_##name(const uint8_t *buf, uint32_t len) {       \
+        msg_##name##_t msg;                                                    \
+        if (!msg_##name##_unpack(&msg, buf, len)) {                            \
+            printf("%s: length %u, expect %u\n", #name, len,                   \
+                   (unsigned)msg_##name##_wire_len);                           \
+            return false;                                                      \
+        }                                                                      \
+        printf("%s (%s, %u bytes)\n", #name, #msg_id, len);                    \
+        fields(SCHEMA_PRINT_FIELD, SCHEMA_PRINT_FIELD_A) return true;          \
+    }                                                                          \
+                                                                               \
+    static bool schema_check_##name(void) {                                    \
+        msg_##name##_t msg, out;                                               \
+        uint8_t buf[msg_##name##_wire_len + 1];                                \
+        uint32_t seed = 0;                                                     \
+        bool same = true;                                                      \
+        memset(&out, 0, sizeof(out));                                          \
+        fields(SCHEMA_FILL_FIELD, SCHEMA_FILL_FIELD_A);                        \
+        if (msg_##name##_pack(&msg, buf) != msg_##name##_wire_len) {           \
+            return false;                                                      \
+        }                                                                      \
+        /* 长度不对不解包, 结构体不变 */                                       \
+        if (msg_##name##_unpack(&out, buf, msg_##name##_wire_len + 1) ||       \
+            msg_##name##_unpack(&out, buf, msg_##name##_wire_len - 1)) {       \
+            return false;                                                      \
+        }                                                                      \
+        if (!msg_##name##_unpack(&out, buf, msg_##name##_wire_len)) {          \
+            return false;                                                      \
+        }                                                                      \
+        fields(SCHEMA_CMP_FIELD, SCHEMA_CMP_FIELD_A) return same;              \
+    }
+MSG_SCHEMA_TABLE(SCHEMA_DECODER)
+#undef SCHEMA_DECODER
+
+/* 原来的`__packed`结构体, 线上格式以它为准 */
+typedef struct __attribute__((packed)) {
+    float chassis_speedx;
+    float chassis_speedy;
+    float chassis_speedyaw;
+    float chassis_world_yaw;
+    uint8_t chassis_halt;
+    float friction_speed_5065;
+    uint8_t shoot_flag;
+} legacy_to_slave_t;
+
+typedef struct __attribute__((packed)) {
+    float x;
+    float y;
+    float yaw;
+} legacy_nuc_pos_t;
+
+/**
+ * @brief 打包结果和原来的结构体逐字节比较 (主机是小端)
+ *
+ * @return 是否一致
+ */
+static bool schema_check_legacy(void) {
+    legacy_to_slave_t legacy_slave = {1.5f, -2.25f, 0.125f, 3.0f,
+                                      1,    6000.0f, 2};
+    msg_to_slave_t slave = {1.5f, -2.25f, 0.125f, 3.0f, 1, 6000.0f, 2};
+    legacy_nuc_pos_t legacy_pos = {1.25f, -7.5f, 0.5f};
+    msg_nuc_pos_t pos = {1.25f, -7.5f, 0.5f};
+    uint8_t buf[64];
+
+    if ((msg_to_slave_pack(&slave, buf) != sizeof(legacy_slave)) ||
+        (memcmp(buf, &legacy_slave, sizeof(legacy_slave)) != 0)) {
+        return false;
+    }
+
+    if ((msg_nuc_pos_pack(&pos, buf) != sizeof(legacy_pos)) ||
+        (memcmp(buf, &legacy_pos, sizeof(legacy_pos)) != 0)) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 解析十六进制字符串, 可以有空格
+ *
+ * @param str 字符串
+ * @param[out] buf 数据
+ * @param size 缓冲区大小
+ * @return 数据长度
+ */
+static uint32_t schema_parse_hex(const char *str, uint8_t *buf,
+                                 uint32_t size) {
+    uint32_t len = 0;
+    char byte[3] = {0};
+
+    while ((*str != '\0') && (len < size)) {
+        if (*str == ' ') {
+            ++str;
+            continue;
+        }
+
+        if (str[1] == '\0') {
+            break;
+        }
+
+        byte[0] = str[0];
+        byte[1] = str[1];
+        buf[len++] = (uint8_t)strtoul(byte, NULL, 16);
+        str += 2;
+    }
+
+    return len;
+}
+
+int main(int argc, char *argv[]) {
+    uint8_t buf[256];
+    bool ok = true;
+
+    if (argc >= 3) {
+        uint32_t len = schema_parse_hex(argv[2], buf, sizeof(buf));
+
+#define SCHEMA_DECODE(name, msg_id, fields)                                    \
+    if (strcmp(argv[1], #name) == 0) {                                         \
+        return schema_print_##name(buf, len) ? 0 : 1;                          \
+    }
+        MSG_SCHEMA_TABLE(SCHEMA_DECODE)
+#undef SCHEMA_DECODE
+
+        printf("unknown message %s\n", argv[1]);
+        return 2;
+    }
+
+#define SCHEMA_CHECK(name, msg_id, fields)                                     \
+    printf("%-16s %-14s %3u bytes %s\n", #name, #msg_id,                       \
+           (unsigned)msg_##name##_wire_len,                                    \
+           schema_check_##name() ? "ok" : "FAIL");                             \
+    ok = ok && schema_check_##name();
+    MSG_SCHEMA_TABLE(SCHEMA_CHECK)
+#undef SCHEMA_CHECK
+
+    if (!schema_check_legacy()) {
+        printf("wire format differs from the packed structs\n");
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}
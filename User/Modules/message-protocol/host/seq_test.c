@@ -0,0 +1,328 @@
+/**
+ * @file    seq_test.c
+ * @brief   扩展帧头 (序号, 发送时间戳), 丢帧/乱序统计和最新一帧年龄的测试,
+ *          在主机上运行
+ *
+ * @note 串口自发自收: 位姿帧带扩展帧头发送, 每帧单独记下来, 再按测试给的
+ *       顺序写进模拟的 DMA 缓冲区 (跳过的就是丢了, 调换的就是乱序), 检查
+ *       回调收到的帧, 回调中`message_get_frame_info`拿到的序号和发送时间,
+ *       每个 ID 的`recv_lost`, `recv_reorder`以及`message_get_latest_age`.
+ *
+ *       包含`msg_protocol.c`以便读取消息实例的统计和发送序号.
+ */
+
+#include "../msg_protocol.c"
+
+#include "host_stubs.h"
+
+#include <stdio.h>
+
+#define POSE_DATA_LEN    12U
+#define DMA_RX_BUF_SIZE  512U
+#define RX_FIFO_SIZE     512U
+#define TEST_FRAME_NUM   64U
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+static UART_HandleTypeDef test_uart = {1, (void *)1, (void *)1};
+
+/* 发出的帧, 按发送顺序 */
+static struct {
+    uint8_t data[MSG_FRAME_MAX_LEN(POSE_DATA_LEN)];
+    uint32_t len;
+} test_frames[TEST_FRAME_NUM];
+static uint32_t test_sent;
+
+/* 回调收到的帧 */
+static struct {
+    uint32_t count;                  /*!< 回调次数 */
+    uint32_t tag[TEST_FRAME_NUM];    /*!< 数据中的编号 */
+    msg_frame_info_t info[TEST_FRAME_NUM]; /*!< 回调中取到的帧信息 */
+} test_recv;
+
+static void test_sink(const uint8_t *data, uint32_t len) {
+    memcpy(test_frames[test_sent].data, data, len);
+    test_frames[test_sent].len = len;
+    ++test_sent;
+}
+
+/**
+ * @brief 发送一帧, 数据前 4 字节是编号, 和发送顺序相同
+ *
+ * @return 编号
+ */
+static uint32_t test_send(void) {
+    uint8_t pose[POSE_DATA_LEN] = {0};
+    uint32_t tag = test_sent;
+
+    memcpy(pose, &tag, sizeof(tag));
+    CHECK(message_send_data(MSG_NUC, MSG_DATA_CUSTOM, pose, POSE_DATA_LEN) ==
+          0);
+    host_uart_tx_isr(&test_uart, test_sink);
+    return tag;
+}
+
+static void test_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    uint32_t i = test_recv.count;
+
+    UNUSED(id_type);
+    CHECK(len == POSE_DATA_LEN);
+    if (i >= TEST_FRAME_NUM) {
+        return;
+    }
+
+    memcpy(&test_recv.tag[i], data, sizeof(uint32_t));
+    /* 回调中取到的就是这一帧的信息 */
+    CHECK(message_get_frame_info(MSG_NUC, &test_recv.info[i]) == 0);
+    ++test_recv.count;
+}
+
+/**
+ * @brief 按`order`给的编号顺序收到这些帧, 一次轮询
+ */
+static void test_deliver(const uint32_t *order, uint32_t num) {
+    for (uint32_t i = 0; i < num; ++i) {
+        host_uart_rx_dma(&test_uart, test_frames[order[i]].data,
+                         test_frames[order[i]].len, false);
+    }
+    test_recv.count = 0;
+    message_polling_data();
+}
+
+static struct msg_instance *test_msg(void) {
+    return msg_list[MSG_NUC];
+}
+
+/**
+ * @brief 还没收到过: 年龄`UINT32_MAX`, 取不到帧信息
+ */
+static void test_empty(void) {
+    msg_frame_info_t info;
+
+    CHECK(message_get_latest_age(MSG_NUC) == UINT32_MAX);
+    CHECK(message_get_frame_info(MSG_NUC, &info) == 2);
+    CHECK(message_get_frame_info(MSG_NUC, NULL) == 1);
+    CHECK(message_get_frame_info(MSG_ID_RESERVE_LEN, &info) == 1);
+    CHECK(message_get_latest_age(MSG_ID_RESERVE_LEN) == UINT32_MAX);
+}
+
+/**
+ * @brief 按顺序收到, 序号连续, 发送时间是发送时的`HAL_GetTick`
+ */
+static void test_in_order(void) {
+    uint32_t order[4];
+    uint32_t tick0 = HAL_GetTick();
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        order[i] = test_send();
+        host_tick_advance(5);
+    }
+    test_deliver(order, 4);
+
+    CHECK(test_recv.count == 4);
+    for (uint32_t i = 0; i < 4; ++i) {
+        CHECK(test_recv.tag[i] == order[i]);
+        CHECK(test_recv.info[i].ext);
+        CHECK(test_recv.info[i].seq == i);
+        CHECK(test_recv.info[i].send_time == tick0 + i * 5U);
+        CHECK(test_recv.info[i].recv_time == HAL_GetTick());
+    }
+    CHECK(test_msg()->recv_lost == 0);
+    CHECK(test_msg()->recv_reorder == 0);
+
+    /* 年龄按本地接收时间算 */
+    CHECK(message_get_latest_age(MSG_NUC) == 0);
+    host_tick_advance(7);
+    CHECK(message_get_latest_age(MSG_NUC) == 7);
+}
+
+/**
+ * @brief 丢帧: 跳过的序号计入`recv_lost`
+ */
+static void test_lost(void) {
+    uint32_t sent[6], order[3];
+
+    for (uint32_t i = 0; i < 6; ++i) {
+        sent[i] = test_send();
+    }
+
+    /* 丢 1 帧, 再丢 2 帧 */
+    order[0] = sent[0];
+    order[1] = sent[2];
+    order[2] = sent[5];
+    test_deliver(order, 3);
+
+    CHECK(test_recv.count == 3);
+    CHECK(test_msg()->recv_lost == 3);
+    CHECK(test_msg()->recv_reorder == 0);
+    CHECK(test_msg()->recv_seq == test_recv.info[2].seq);
+}
+
+/**
+ * @brief 乱序和重复: 比最新的旧的帧计入`recv_reorder`, 仍然回调, 但不
+ *        改变最新序号
+ */
+static void test_reorder(void) {
+    uint32_t sent[4], order[5];
+    uint32_t lost = test_msg()->recv_lost;
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        sent[i] = test_send();
+    }
+
+    /* 0 2 1 3 3: 先收到 2, 补上 1 是乱序 (已经算过丢失), 再重复 3 */
+    order[0] = sent[0];
+    order[1] = sent[2];
+    order[2] = sent[1];
+    order[3] = sent[3];
+    order[4] = sent[3];
+    test_deliver(order, 5);
+
+    CHECK(test_recv.count == 5);
+    CHECK(test_msg()->recv_lost == lost + 1U);
+    CHECK(test_msg()->recv_reorder == 2);
+    CHECK(test_msg()->recv_seq == test_recv.info[3].seq);
+    /* 帧信息是最后回调的那一帧, 重复的 3 */
+    CHECK(test_recv.info[4].seq == test_recv.info[3].seq);
+}
+
+/**
+ * @brief 序号从 65535 绕回 0 不算丢帧
+ */
+static void test_wrap(void) {
+    uint32_t order[4];
+    uint32_t lost, reorder;
+
+    /* 发送和接收的序号都挪到绕回之前 */
+    atomic_store(&test_msg()->send_seq, UINT16_MAX - 1U);
+    test_msg()->recv_seq = UINT16_MAX - 2U;
+    order[0] = test_send();
+    test_deliver(order, 1);
+    CHECK(test_recv.info[0].seq == UINT16_MAX - 1U);
+    lost = test_msg()->recv_lost;
+    reorder = test_msg()->recv_reorder;
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        order[i] = test_send();
+    }
+    test_deliver(order, 4);
+
+    CHECK(test_recv.count == 4);
+    CHECK(test_recv.info[0].seq == UINT16_MAX);
+    CHECK(test_recv.info[1].seq == 0);
+    CHECK(test_recv.info[3].seq == 2);
+    CHECK(test_msg()->recv_lost == lost);
+    CHECK(test_msg()->recv_reorder == reorder);
+}
+
+/**
+ * @brief 对端重启: 序号退回很多, 超出乱序窗口, 从新序号开始, 不算丢帧
+ *        也不算乱序
+ */
+static void test_restart(void) {
+    uint32_t order[3];
+    uint32_t lost, reorder;
+
+    /* 向后跳 29998, 算丢帧, 这次不管 */
+    atomic_store(&test_msg()->send_seq, 30000U);
+    order[0] = test_send();
+    test_deliver(order, 1);
+    lost = test_msg()->recv_lost;
+    reorder = test_msg()->recv_reorder;
+
+    atomic_store(&test_msg()->send_seq, 0);
+    for (uint32_t i = 0; i < 3; ++i) {
+        order[i] = test_send();
+    }
+    test_deliver(order, 3);
+
+    CHECK(test_recv.count == 3);
+    CHECK(test_msg()->recv_lost == lost);
+    CHECK(test_msg()->recv_reorder == reorder);
+    CHECK(test_msg()->recv_seq == 2);
+
+    /* 窗口以内退回是乱序 */
+    test_deliver(order, 1);
+    CHECK(test_msg()->recv_reorder == reorder + 1U);
+}
+
+/**
+ * @brief 不带扩展帧头的帧: 帧信息中`ext`为假, 不影响序号统计
+ */
+static void test_no_ext(void) {
+    uint32_t order[1];
+    uint32_t lost = test_msg()->recv_lost;
+    uint32_t reorder = test_msg()->recv_reorder;
+    uint16_t seq = test_msg()->recv_seq;
+
+    message_set_header_ext(MSG_NUC, false);
+    order[0] = test_send();
+    test_deliver(order, 1);
+
+    CHECK(test_recv.count == 1);
+    CHECK(!test_recv.info[0].ext);
+    CHECK(test_msg()->recv_lost == lost);
+    CHECK(test_msg()->recv_reorder == reorder);
+    CHECK(test_msg()->recv_seq == seq);
+    /* 不带扩展帧头时用更短的 v2 帧头 */
+    CHECK(test_frames[order[0]].len < test_frames[0].len);
+    message_set_header_ext(MSG_NUC, true);
+}
+
+/**
+ * @brief 只回调最新帧: 跳过的帧也参与序号统计, 帧信息是最新的那一帧
+ */
+static void test_latest_only(void) {
+    uint32_t order[4];
+    uint32_t lost = test_msg()->recv_lost;
+
+    message_set_fifo_policy(MSG_NUC, MSG_FIFO_LATEST_ONLY);
+    for (uint32_t i = 0; i < 4; ++i) {
+        order[i] = test_send();
+    }
+    test_deliver(order, 4);
+
+    CHECK(test_recv.count == 1);
+    CHECK(test_recv.tag[0] == order[3]);
+    CHECK(test_recv.info[0].seq == test_msg()->recv_seq);
+    CHECK(test_msg()->recv_lost == lost);
+    message_set_fifo_policy(MSG_NUC, MSG_FIFO_DROP_OLDEST);
+}
+
+int main(void) {
+    host_uart_rx_ring(DMA_RX_BUF_SIZE);
+    host_tick_advance(1000);
+
+    message_register_send_uart(MSG_NUC, &test_uart, 0);
+    message_register_polling_uart(MSG_NUC, &test_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_recv_callback(MSG_NUC, test_callback);
+    message_set_header_ext(MSG_NUC, true);
+
+    test_empty();
+    test_in_order();
+    test_lost();
+    test_reorder();
+    test_wrap();
+    test_restart();
+    test_no_ext();
+    test_latest_only();
+
+    CHECK(test_sent <= TEST_FRAME_NUM);
+    CHECK(host_uart_rx_overrun() == 0);
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file    stream_4k.c
+ * @brief   4 KB 数据连续收发测试, 在主机上运行
+ *
+ * @note 串口自发自收: 发送队列编码好的帧按 921600 波特率 (每毫秒 92 字节)
+ *       写进模拟的 DMA 循环接收缓冲区, 每毫秒轮询一次. 4 KB 的大帧和 32
+ *       字节的位姿帧交替发送, 检查每一帧按顺序完整收到, 没有被 DMA 套圈,
+ *       并输出有效数据吞吐量和解析速度.
+ *
+ *       需要用`-include host/stream_ids.h`编译, 消息 ID 表里有 4096 字节的 ID.
+ */
+
+#include "msg_protocol.h"
+#include "host_stubs.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define STREAM_FRAMES    200U
+#define STREAM_DATA_LEN  4096U
+#define POSE_DATA_LEN    32U
+/* 921600 波特率, 10 bit 一个字节 */
+#define WIRE_BYTES_PER_MS 92U
+#define DMA_RX_BUF_SIZE  8192U
+#define RX_FIFO_SIZE     16384U
+/* 模拟时间上限, 防止卡死 */
+#define STREAM_TIMEOUT_MS 60000U
+
+static UART_HandleTypeDef stream_uart = {1, (void *)1, (void *)1};
+
+/* 已经发出, 还在线上的数据 */
+static uint8_t wire[65536];
+static uint32_t wire_head;
+static uint32_t wire_tail;
+
+static uint32_t stream_sent;
+static uint32_t stream_recv;
+static uint32_t stream_bad;
+static uint32_t pose_sent;
+static uint32_t pose_recv;
+static uint32_t pose_bad;
+
+/**
+ * @brief 第`seq`个大帧的数据, 混有需要转义的字节
+ */
+static void stream_fill(uint8_t *data, uint32_t seq) {
+    uint32_t x = seq * 2654435761U + 1U;
+
+    for (uint32_t i = 0; i < STREAM_DATA_LEN; ++i) {
+        x = x * 1103515245U + 12345U;
+        data[i] = (uint8_t)(x >> 24);
+    }
+    memcpy(data, &seq, sizeof(seq));
+}
+
+static void stream_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    static uint8_t expect[STREAM_DATA_LEN];
+
+    UNUSED(id_type);
+    stream_fill(expect, stream_recv);
+    if ((len != STREAM_DATA_LEN) || (memcmp(data, expect, len) != 0)) {
+        ++stream_bad;
+    }
+    ++stream_recv;
+}
+
+static void pose_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    uint32_t seq;
+
+    UNUSED(id_type);
+    memcpy(&seq, data, sizeof(seq));
+    if ((len != POSE_DATA_LEN) || (seq != pose_recv)) {
+        ++pose_bad;
+    }
+    ++pose_recv;
+}
+
+/**
+ * @brief DMA 发送完成, 数据放到线上
+ */
+static void stream_sink(const uint8_t *data, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        wire[wire_tail++ % sizeof(wire)] = data[i];
+    }
+}
+
+/**
+ * @brief 单调时钟 (us)
+ */
+static uint64_t stream_now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+int main(void) {
+    static uint8_t data[STREAM_DATA_LEN];
+    uint8_t pose[POSE_DATA_LEN] = {0};
+    uint64_t poll_us = 0, t0;
+    uint32_t ms;
+
+    host_uart_rx_ring(DMA_RX_BUF_SIZE);
+
+    message_register_send_uart(MSG_STREAM, &stream_uart, 0);
+    message_register_send_uart(MSG_POSE, &stream_uart, 0);
+    message_register_polling_uart(MSG_STREAM, &stream_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_polling_uart(MSG_POSE, &stream_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_recv_callback(MSG_STREAM, stream_callback);
+    message_register_recv_callback(MSG_POSE, pose_callback);
+    message_set_crc(MSG_STREAM, MSG_CRC_32, false);
+
+    for (ms = 0; ms < STREAM_TIMEOUT_MS; ++ms) {
+        /* 位姿每 10 ms 一帧, 大帧有空位就发 */
+        if ((ms % 10 == 0) &&
+            (message_send_data(MSG_POSE, MSG_DATA_CUSTOM, pose,
+                               POSE_DATA_LEN) == 0)) {
+            ++pose_sent;
+            memcpy(pose, &pose_sent, sizeof(pose_sent));
+        }
+        while (stream_sent < STREAM_FRAMES) {
+            stream_fill(data, stream_sent);
+            if (message_send_data(MSG_STREAM, MSG_DATA_CUSTOM, data,
+                                  STREAM_DATA_LEN) != 0) {
+                break;
+            }
+            ++stream_sent;
+        }
+
+        /* 线上的数据发完了才开始下一次 DMA 发送 */
+        if (wire_head == wire_tail) {
+            host_uart_tx_isr(&stream_uart, stream_sink);
+        }
+
+        /* 这一毫秒线上到达的数据 */
+        uint32_t len = wire_tail - wire_head;
+        if (len > WIRE_BYTES_PER_MS) {
+            len = WIRE_BYTES_PER_MS;
+        }
+        for (uint32_t i = 0; i < len; ++i) {
+            uint8_t byte = wire[wire_head++ % sizeof(wire)];
+            host_uart_rx_dma(&stream_uart, &byte, 1, false);
+        }
+
+        t0 = stream_now_us();
+        message_polling_data();
+        poll_us += stream_now_us() - t0;
+        host_tick_advance(1);
+
+        if ((stream_recv == STREAM_FRAMES) && (wire_head == wire_tail) &&
+            !host_uart_tx_busy()) {
+            break;
+        }
+    }
+
+    uint64_t payload = (uint64_t)stream_recv * STREAM_DATA_LEN +
+                       (uint64_t)pose_recv * POSE_DATA_LEN;
+
+    printf("stream: recv %u of %u, bad %u; pose: recv %u of %u, bad %u\n",
+           stream_recv, STREAM_FRAMES, stream_bad, pose_recv, pose_sent,
+           pose_bad);
+    printf("simulated %u ms, payload %.1f KB/s of %.1f KB/s line rate, "
+           "dma overrun %u\n",
+           ms, (double)payload / ms, WIRE_BYTES_PER_MS * 1.0,
+           host_uart_rx_overrun());
+    printf("parse %.1f MB/s on host\n",
+           poll_us ? (double)wire_head / poll_us : 0.0);
+
+    if ((stream_recv != STREAM_FRAMES) || (stream_bad != 0) ||
+        (pose_bad != 0) || (pose_recv != pose_sent) ||
+        (host_uart_rx_overrun() != 0)) {
+        return 1;
+    }
+
+    return 0;
+}
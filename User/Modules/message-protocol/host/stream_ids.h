@@ -0,0 +1,15 @@
+/**
+ * @file    stream_ids.h
+ * @brief   大数据流测试用的消息 ID 表, 编译时用`-include`在`msg_protocol.h`
+ *          之前包含
+ */
+
+#ifndef __HOST_STREAM_IDS_H
+#define __HOST_STREAM_IDS_H
+
+/* 地图/路径这类几 KB 的数据, 和位姿共用一个串口 */
+#define MSG_ID_TABLE(X)                                                        \
+    X(MSG_STREAM, 4096)                                                        \
+    X(MSG_POSE, 32)
+
+#endif /* __HOST_STREAM_IDS_H */
@@ -0,0 +1 @@
+/* 主机测试替身, 内容都在 FreeRTOS.h 中 */
@@ -0,0 +1,190 @@
+/**
+ * @file    tx_stress.c
+ * @brief   发送队列多生产者压力测试, 在主机上运行
+ *
+ * @note 多个线程同时`message_send_data`, 主线程模拟 DMA 发送完成中断,
+ *       另一个线程在同一个串口上穿插非队列的 DMA 发送 (模拟`uart_printf`).
+ *       检查收到的每一帧格式正确, 每个生产者的序号连续不丢不乱.
+ *       参数`batch`时打开合并发送, 再起一个线程模拟发送窗口定时器.
+ */
+
+#include "msg_protocol.h"
+#include "host_stubs.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define PRODUCER_NUM    4
+#define FRAMES_PER_TASK 20000U
+#define FRAME_DATA_LEN  8U
+
+static UART_HandleTypeDef stress_uart = {1, (void *)1, (void *)1};
+
+static atomic_int producer_done;
+static atomic_bool stress_finish;
+
+static uint32_t last_seq[PRODUCER_NUM];
+static uint32_t recv_frames;
+static uint32_t bad_frames;
+
+static uint8_t frame_buf[64];
+static uint32_t frame_len;
+static bool frame_escape;
+
+/**
+ * @brief 生产者, 数据为 生产者编号 (1 byte) 和序号 (4 byte), 后面填充
+ *        需要转义的字节
+ */
+static void *stress_producer(void *arg) {
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t data[FRAME_DATA_LEN];
+
+    for (uint32_t seq = 1; seq <= FRAMES_PER_TASK; ++seq) {
+        data[0] = id;
+        memcpy(&data[1], &seq, sizeof(seq));
+        data[5] = MSG_EOF;
+        data[6] = MSG_ESC;
+        data[7] = 0x11;
+
+        /* 队列满时让出去, 等发送完成中断腾出位置 */
+        while (message_send_data(MSG_NUC, MSG_DATA_CUSTOM, data,
+                                 FRAME_DATA_LEN) == 3) {
+            sched_yield();
+        }
+    }
+
+    atomic_fetch_add(&producer_done, 1);
+    return NULL;
+}
+
+/**
+ * @brief 在同一个串口上穿插非队列发起的 DMA 发送
+ */
+static void *stress_foreign(void *arg) {
+    UNUSED(arg);
+
+    while (!atomic_load(&stress_finish)) {
+        host_uart_foreign_tx(&stress_uart);
+        sched_yield();
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 模拟发送窗口定时器任务
+ */
+static void *stress_timer(void *arg) {
+    UNUSED(arg);
+
+    while (!atomic_load(&stress_finish)) {
+        host_timer_fire();
+        sched_yield();
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 检查一帧: 帧头 (2 byte), 数据, 不带 CRC
+ */
+static void stress_check_frame(void) {
+    uint32_t seq;
+    uint8_t id;
+
+    if ((frame_len != 2 + FRAME_DATA_LEN) ||
+        (frame_buf[0] != (uint8_t)((MSG_NUC << 4) | MSG_DATA_CUSTOM)) ||
+        (frame_buf[1] != FRAME_DATA_LEN)) {
+        ++bad_frames;
+        return;
+    }
+
+    id = frame_buf[2];
+    memcpy(&seq, &frame_buf[3], sizeof(seq));
+    if ((id >= PRODUCER_NUM) || (seq != last_seq[id] + 1)) {
+        ++bad_frames;
+        return;
+    }
+
+    last_seq[id] = seq;
+    ++recv_frames;
+}
+
+/**
+ * @brief 发送完成时收到的数据, 去掉转义后按结束符分帧
+ */
+static void stress_sink(const uint8_t *data, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        if ((data[i] == MSG_ESC) && !frame_escape) {
+            frame_escape = true;
+            continue;
+        }
+
+        if (!frame_escape && (data[i] == MSG_EOF)) {
+            stress_check_frame();
+            frame_len = 0;
+            continue;
+        }
+
+        frame_escape = false;
+        if (frame_len < sizeof(frame_buf)) {
+            frame_buf[frame_len] = data[i];
+        }
+        ++frame_len;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    bool batch = (argc > 1) && (strcmp(argv[1], "batch") == 0);
+    pthread_t producer[PRODUCER_NUM], foreign, timer;
+    uint32_t expect = PRODUCER_NUM * FRAMES_PER_TASK;
+    uint32_t last_recv = 0;
+    time_t last_progress = time(NULL);
+
+    message_register_send_uart(MSG_NUC, &stress_uart, 0);
+    if (batch && (message_set_tx_batch(&stress_uart, 1, 256) != 0)) {
+        printf("message_set_tx_batch failed\n");
+        return 1;
+    }
+
+    for (uintptr_t i = 0; i < PRODUCER_NUM; ++i) {
+        pthread_create(&producer[i], NULL, stress_producer, (void *)i);
+    }
+    pthread_create(&foreign, NULL, stress_foreign, NULL);
+    if (batch) {
+        pthread_create(&timer, NULL, stress_timer, NULL);
+    }
+
+    while (recv_frames + bad_frames < expect) {
+        if (!host_uart_tx_isr(&stress_uart, stress_sink)) {
+            sched_yield();
+        }
+
+        if (recv_frames != last_recv) {
+            last_recv = recv_frames;
+            last_progress = time(NULL);
+        } else if (time(NULL) - last_progress > 5) {
+            /* 有帧留在队列里没有人发送 */
+            break;
+        }
+    }
+
+    atomic_store(&stress_finish, true);
+    for (uint32_t i = 0; i < PRODUCER_NUM; ++i) {
+        pthread_join(producer[i], NULL);
+    }
+    pthread_join(foreign, NULL);
+    if (batch) {
+        pthread_join(timer, NULL);
+    }
+
+    printf("%s: recv %u of %u, bad %u, foreign tx %u, refused %u\n",
+           batch ? "batch" : "queue", recv_frames, expect, bad_frames,
+           host_uart_foreign_count(), host_uart_tx_refused());
+
+    return (recv_frames == expect && bad_frames == 0) ? 0 : 1;
+}
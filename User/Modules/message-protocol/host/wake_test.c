@@ -0,0 +1,359 @@
+/**
+ * @file    wake_test.c
+ * @brief   串口接收中断唤醒轮询任务的测试, 在主机上运行
+ *
+ * @note 模拟时间用 DWT 周期计数器表示, 和固件统计延迟用的时间戳相同.
+ *       小电脑按 200 Hz 左右发送位姿帧, 921600 波特率下一帧最后一个字节
+ *       写进模拟的 DMA 循环缓冲区后, 再过一个字节的时间串口 IDLE 中断调用
+ *       驱动的接收事件回调. 比较两种任务写法:
+ *
+ *       - 事件驱动: 收到任务通知后切换到任务, 调用`message_polling_wait`;
+ *       - 固定周期: 原来的`message_polling_data`加`vTaskDelay(2)`.
+ *
+ *       统计每帧从最后一个字节到回调的延迟, 并检查每个端口记录的中断到
+ *       回调的延迟. 另外检查半满中断只收到半帧, 任务晚于多次中断运行, 以及
+ *       没有中断时超时轮询的情况.
+ *
+ *       包含`msg_protocol.c`以便读取端口的统计.
+ */
+
+#include "../msg_protocol.c"
+
+#include "host_stubs.h"
+
+#include <stdio.h>
+
+#define TEST_FRAMES      2000U
+#define POSE_DATA_LEN    12U
+#define DMA_RX_BUF_SIZE  512U
+#define RX_FIFO_SIZE     512U
+/* 921600 波特率, 10 bit 一个字节约 11 us */
+#define BYTE_US          11U
+/* 中断返回到任务开始运行的时间 */
+#define SWITCH_US        2U
+/* 原来的轮询周期 */
+#define POLL_US          2000U
+#define CYCLE_PER_US     (168000000U / 1000000U)
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+static UART_HandleTypeDef test_uart = {1, (void *)1, (void *)1};
+
+/* 编码好的帧 */
+static uint8_t test_frame[MSG_FRAME_MAX_LEN(POSE_DATA_LEN)];
+static uint32_t test_frame_len;
+static uint32_t test_seed = 1;
+
+static struct {
+    uint32_t frames;     /*!< 回调的帧数 */
+    uint32_t bad;        /*!< 序号不对的帧数 */
+    uint64_t last_byte;  /*!< 最新一帧最后一个字节的时间 (us) */
+    uint64_t sum_us;     /*!< 延迟总和 */
+    uint64_t max_us;     /*!< 最大延迟 */
+} test;
+
+static uint64_t test_now_us;
+
+static uint32_t test_rand(void) {
+    test_seed = test_seed * 1103515245U + 12345U;
+    return test_seed >> 8;
+}
+
+/**
+ * @brief 设置模拟时间
+ *
+ * @param us 时间 (us)
+ */
+static void test_at(uint64_t us) {
+    test_now_us = us;
+    host_dwt.CYCCNT = (uint32_t)(us * CYCLE_PER_US);
+}
+
+static void test_sink(const uint8_t *data, uint32_t len) {
+    memcpy(test_frame, data, len);
+    test_frame_len = len;
+}
+
+/**
+ * @brief 编码第`seq`帧位姿
+ */
+static void test_encode(uint32_t seq) {
+    uint8_t pose[POSE_DATA_LEN];
+
+    for (uint32_t i = 0; i < POSE_DATA_LEN; ++i) {
+        pose[i] = (uint8_t)test_rand();
+    }
+    memcpy(pose, &seq, sizeof(seq));
+    message_send_data(MSG_NUC, MSG_DATA_CUSTOM, pose, POSE_DATA_LEN);
+    host_uart_tx_isr(&test_uart, test_sink);
+}
+
+static void test_callback(uint32_t len, uint8_t id_type, uint8_t *data) {
+    uint64_t latency = test_now_us - test.last_byte;
+    uint32_t seq;
+
+    UNUSED(id_type);
+
+    memcpy(&seq, data, sizeof(seq));
+    if ((len != POSE_DATA_LEN) || (seq != test.frames)) {
+        ++test.bad;
+    }
+    ++test.frames;
+
+    test.sum_us += latency;
+    if (latency > test.max_us) {
+        test.max_us = latency;
+    }
+}
+
+/**
+ * @brief 第`seq`帧在`us`收完最后一个字节
+ */
+static void test_frame_bytes(uint32_t seq, uint64_t us) {
+    test_encode(seq);
+    test_at(us);
+    host_uart_rx_dma(&test_uart, test_frame, test_frame_len, false);
+    test.last_byte = us;
+}
+
+/**
+ * @brief 最后一个字节之后一个字节的时间, IDLE 中断
+ *
+ * @return IDLE 中断的时间 (us)
+ */
+static uint64_t test_frame_idle(void) {
+    uint64_t us = test.last_byte + BYTE_US;
+
+    test_at(us);
+    host_uart_rx_dma(&test_uart, NULL, 0, true);
+    return us;
+}
+
+/**
+ * @brief 第`seq`帧在`us`收完最后一个字节, 一个字节的时间后 IDLE 中断
+ *
+ * @return IDLE 中断的时间 (us)
+ */
+static uint64_t test_frame_arrive(uint32_t seq, uint64_t us) {
+    test_frame_bytes(seq, us);
+    return test_frame_idle();
+}
+
+/**
+ * @brief 清零统计, 从`us`开始
+ */
+static void test_reset(uint64_t us) {
+    msg_rx_port_t *port = msg_list[MSG_NUC]->rx_port;
+    uint32_t frames = test.frames;
+
+    memset(&test, 0, sizeof(test));
+    test.frames = frames;
+    port->recv_latency_us = 0;
+    port->max_recv_latency_us = 0;
+    test_at(us);
+}
+
+/**
+ * @brief 任务等通知, 每次中断后切换到任务解析
+ *
+ * @param start 开始时间 (us)
+ * @return 结束时间 (us)
+ */
+static uint64_t test_event(uint64_t start) {
+    msg_rx_port_t *port = msg_list[MSG_NUC]->rx_port;
+    uint32_t gives = host_task_notify_gives();
+    uint32_t first = test.frames;
+    uint64_t us = start, idle;
+
+    test_reset(start);
+    for (uint32_t i = 0; i < TEST_FRAMES; ++i) {
+        us += 4000U + test_rand() % 2000U;
+        idle = test_frame_arrive(first + i, us);
+
+        /* 只有通知才会唤醒任务 */
+        CHECK(host_task_notify_pending() == 1);
+        test_at(idle + SWITCH_US);
+        message_polling_wait(10);
+        CHECK(host_task_notify_pending() == 0);
+        CHECK(port->recv_latency_us == SWITCH_US);
+    }
+
+    printf("%-8s %8u %8u %10.1f %10u %10u\n", "event",
+           (unsigned)(test.frames - first),
+           (unsigned)(host_task_notify_gives() - gives),
+           (double)test.sum_us / TEST_FRAMES, (unsigned)test.max_us,
+           (unsigned)port->max_recv_latency_us);
+
+    CHECK(test.frames - first == TEST_FRAMES);
+    CHECK(host_task_notify_gives() - gives == TEST_FRAMES);
+    CHECK(test.max_us == BYTE_US + SWITCH_US);
+    CHECK(port->max_recv_latency_us == SWITCH_US);
+    return us + POLL_US;
+}
+
+/**
+ * @brief 原来的写法, 每 2 ms 轮询一次, 不管通知
+ *
+ * @param start 开始时间 (us), 是轮询周期的整数倍
+ * @return 结束时间 (us)
+ */
+static uint64_t test_poll(uint64_t start) {
+    msg_rx_port_t *port = msg_list[MSG_NUC]->rx_port;
+    uint32_t first = test.frames;
+    uint32_t polls = 0;
+    uint64_t us = start, next = start;
+
+    test_reset(start);
+    for (uint32_t i = 0; i < TEST_FRAMES; ++i) {
+        us += 4000U + test_rand() % 2000U;
+
+        /* 这一帧之前的轮询 */
+        for (; next < us; next += POLL_US) {
+            test_at(next);
+            message_polling_data();
+            ++polls;
+        }
+
+        /* 最后一个字节和 IDLE 中断之间也可能轮询 */
+        test_frame_bytes(first + i, us);
+        for (; next < us + BYTE_US; next += POLL_US) {
+            test_at(next);
+            message_polling_data();
+            ++polls;
+        }
+        test_frame_idle();
+    }
+    test_at(next);
+    message_polling_data();
+    ++polls;
+
+    printf("%-8s %8u %8u %10.1f %10u %10u\n", "poll 2ms",
+           (unsigned)(test.frames - first), (unsigned)polls,
+           (double)test.sum_us / TEST_FRAMES, (unsigned)test.max_us,
+           (unsigned)port->max_recv_latency_us);
+
+    CHECK(test.frames - first == TEST_FRAMES);
+    CHECK(test.max_us <= POLL_US);
+    CHECK(test.max_us > POLL_US / 2);
+    CHECK(port->max_recv_latency_us < POLL_US);
+    /* 通知没人等, 读掉 */
+    ulTaskNotifyTake(pdTRUE, 0);
+    return next;
+}
+
+/**
+ * @brief 半满中断时帧只收到一半: 不回调, 不记录延迟, IDLE 中断后再回调,
+ *        延迟从 IDLE 中断算起
+ */
+static uint64_t test_half(uint64_t start) {
+    msg_rx_port_t *port = msg_list[MSG_NUC]->rx_port;
+    uint32_t frames = test.frames;
+    uint32_t half;
+
+    test_reset(start);
+    test_encode(frames);
+    half = test_frame_len / 2U;
+
+    host_uart_rx_dma(&test_uart, test_frame, half, true);
+    CHECK(host_task_notify_pending() == 1);
+    test_at(start + SWITCH_US);
+    message_polling_wait(10);
+    CHECK(test.frames == frames);
+    CHECK(port->recv_latency_us == 0);
+
+    test_at(start + 100U);
+    host_uart_rx_dma(&test_uart, test_frame + half, test_frame_len - half,
+                     true);
+    test.last_byte = start + 100U;
+    test_at(start + 100U + 7U);
+    message_polling_wait(10);
+    CHECK(test.frames == frames + 1U);
+    CHECK(port->recv_latency_us == 7U);
+
+    return start + POLL_US;
+}
+
+/**
+ * @brief 任务被更高优先级的任务占住: 两帧的中断都到了才运行, 一次回调
+ *        两帧, 延迟从第一次中断算起
+ */
+static uint64_t test_late(uint64_t start) {
+    msg_rx_port_t *port = msg_list[MSG_NUC]->rx_port;
+    uint32_t frames = test.frames;
+
+    test_reset(start);
+    test_frame_arrive(frames, start);
+    test_frame_arrive(frames + 1U, start + 300U);
+    CHECK(host_task_notify_pending() == 2);
+
+    test_at(start + 1000U);
+    message_polling_wait(10);
+    CHECK(host_task_notify_pending() == 0);
+    CHECK(test.frames == frames + 2U);
+    CHECK(port->recv_latency_us == 1000U - BYTE_US);
+    CHECK(port->max_recv_latency_us == 1000U - BYTE_US);
+
+    return start + POLL_US;
+}
+
+/**
+ * @brief 没有中断, 等待超时后也轮询一次, 不改变延迟统计
+ */
+static uint64_t test_timeout(uint64_t start) {
+    msg_rx_port_t *port = msg_list[MSG_NUC]->rx_port;
+    uint32_t frames = test.frames;
+    uint32_t gives = host_task_notify_gives();
+
+    test_reset(start);
+    port->recv_latency_us = 5U;
+    test_at(start + 10000U);
+    message_polling_wait(10);
+
+    CHECK(host_task_notify_gives() == gives);
+    CHECK(test.frames == frames);
+    CHECK(port->recv_latency_us == 5U);
+
+    return start + 10000U;
+}
+
+int main(void) {
+    uint64_t us = 0;
+
+    host_uart_rx_ring(DMA_RX_BUF_SIZE);
+    message_register_send_uart(MSG_NUC, &test_uart, 0);
+    message_register_polling_uart(MSG_NUC, &test_uart, DMA_RX_BUF_SIZE,
+                                  RX_FIFO_SIZE);
+    message_register_recv_callback(MSG_NUC, test_callback);
+    message_set_crc(MSG_NUC, MSG_CRC_32, false);
+
+    /* 任务第一次等待时记下自己, 之后中断才会通知 */
+    CHECK(msg_polling_task == NULL);
+    message_polling_wait(0);
+    CHECK(msg_polling_task != NULL);
+
+    printf("%-8s %8s %8s %10s %10s %10s\n", "", "frames", "wakeups",
+           "avg us", "max us", "port us");
+    us = test_poll(us);
+    us = test_event(us);
+    us = test_half(us);
+    us = test_late(us);
+    us = test_timeout(us);
+
+    CHECK(test.bad == 0);
+    CHECK(host_uart_rx_overrun() == 0);
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
@@ -2,20 +2,34 @@
  * @file    msg_protocol.c
  * @author  Deadline039
  * @brief   消息协议以及收发
- * @version 2.3
- * @date    2024-03-01
+ * @version 3.7
+ * @date    2026-10-17
  */
 
 #include "msg_protocol.h"
 
+#if MSG_ENABLE_CRC
+#include "crc/crc.h"
+#endif /* MSG_ENABLE_CRC */
+
 #include <string.h>
 #include <stdbool.h>
 
+#if MSG_ENABLE_TX_QUEUE
+#include <stdatomic.h>
+#endif /* MSG_ENABLE_TX_QUEUE */
+
 #if MSG_ENABLE_RTOS
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "task.h"
+#include "timers.h"
 #endif /* MSG_ENABLE_RTOS */
 
+#if MSG_ENABLE_CAPTURE
+#include "SEGGER_RTT.h"
+#endif /* MSG_ENABLE_CAPTURE */
+
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wzero-length-array"
 #endif /* __GNUC__ */
@@ -34,381 +48,2556 @@ static inline uint32_t is_pow_of_2(uint32_t n) {
 
 /**
  * @brief 环形缓冲区
+ *
+ * @note `buf` 实际长度为 `size + mirror_len`, 缓冲区开头的 `mirror_len` 字节
+ *       会同步写到 `buf[size]` 之后. 这样任意一帧即使跨过缓冲区末尾, 从帧头
+ *       开始在内存上也是连续的, 出队时可以直接把 FIFO 内的指针交给回调.
  */
 typedef struct {
     uint32_t size;          /*!< 缓冲区大小 */
     uint32_t mask;          /*!< 大小掩码 */
-    uint8_t frame_len;      /*!< 帧长度 */
+    uint32_t mirror_len;    /*!< 镜像区长度 */
+    uint32_t frame_len;     /*!< 帧长度 */
     bool new_frame;         /*!< 是否是新的一帧 (写长度用) */
     volatile uint32_t head; /*!< 头指针 */
     volatile uint32_t tail; /*!< 尾指针 */
     uint8_t buf[0];         /*!< 缓冲区 */
 } msg_fifo_t;
 
-struct msg_instance {
-    msg_recv_callback_t recv_callback; /*!< 接收回调函数 */
-    UART_HandleTypeDef *send_uart;     /*!< 发送串口句柄 */
-    UART_HandleTypeDef *recv_uart;     /*!< 接收串口句柄 */
+/**
+ * @brief 写入队列中的一个字节, 落在镜像区的同时写入镜像
+ *
+ * @param fifo 队列
+ * @param pos 写入位置 (未取掩码)
+ * @param data 数据
+ */
+static inline void msg_fifo_set(msg_fifo_t *fifo, uint32_t pos, uint8_t data) {
+    pos &= fifo->mask;
+    fifo->buf[pos] = data;
+    if (pos < fifo->mirror_len) {
+        fifo->buf[fifo->size + pos] = data;
+    }
+}
+
+#if MSG_ENABLE_V3
+/**
+ * @brief `MSG_ID_TABLE`中最长的数据, 比它长的帧没有 ID 能收
+ */
+typedef union {
+#define MSG_RX_DATA_DEFINE(id, max_len) uint8_t id##_data[max_len];
+    MSG_ID_TABLE(MSG_RX_DATA_DEFINE)
+#undef MSG_RX_DATA_DEFINE
+} msg_rx_data_t;
+
+/* 队列元素长度占用字节数, v3 帧可能超过 255 字节, 小端两字节 */
+#define MSG_FIFO_LEN_SIZE 2U
+/* 队列元素最大长度: 元素长度, 帧头, 数据, CRC, 结束符. 按声明的最长数据
+ * 计算而不是`MSG_DATA_MAX_LEN`, 镜像区也按它分配 */
+#define MSG_FIFO_ELEMENT_MAX_LEN                                               \
+    (MSG_FIFO_LEN_SIZE + MSG_HEADER_MAX_LEN + sizeof(msg_rx_data_t) +         \
+     MSG_CRC_MAX_LEN + 1U)
+#else /* MSG_ENABLE_V3 */
+#define MSG_FIFO_LEN_SIZE        1U
+#define MSG_FIFO_ELEMENT_MAX_LEN UINT8_MAX
+#endif /* MSG_ENABLE_V3 */
+
+/**
+ * @brief 写入队列元素长度
+ *
+ * @param fifo 队列
+ * @param pos 写入位置 (未取掩码)
+ * @param len 元素长度, 0 为还没存完
+ */
+static inline void msg_fifo_set_len(msg_fifo_t *fifo, uint32_t pos,
+                                    uint32_t len) {
+    msg_fifo_set(fifo, pos, (uint8_t)len);
+#if MSG_ENABLE_V3
+    msg_fifo_set(fifo, pos + 1, (uint8_t)(len >> 8));
+#endif /* MSG_ENABLE_V3 */
+}
+
+/**
+ * @brief 读取队列元素长度
+ *
+ * @param fifo 队列
+ * @param pos 读取位置 (未取掩码)
+ * @return 元素长度
+ */
+static inline uint32_t msg_fifo_get_len(const msg_fifo_t *fifo, uint32_t pos) {
+    const uint8_t *len = &fifo->buf[pos & fifo->mask];
+#if MSG_ENABLE_V3
+    /* 跨尾时第二个字节在镜像区 */
+    return (uint32_t)len[0] | ((uint32_t)len[1] << 8);
+#else  /* MSG_ENABLE_V3 */
+    return len[0];
+#endif /* MSG_ENABLE_V3 */
+}
+
+#if MSG_ENABLE_COBS
+
+/**
+ * @brief 连续写入队列, 落在镜像区的部分同时写入镜像
+ *
+ * @param fifo 队列
+ * @param data 数据
+ * @param len 数据长度
+ * @note 调用前要确认队列空间足够
+ */
+static void msg_fifo_write(msg_fifo_t *fifo, const uint8_t *data,
+                           uint32_t len) {
+    uint32_t pos = fifo->tail & fifo->mask;
+    uint32_t first = fifo->size - pos;
+
+    if (first > len) {
+        first = len;
+    }
+
+    memcpy(&fifo->buf[pos], data, first);
+    memcpy(&fifo->buf[0], data + first, len - first);
+
+    /* 同步镜像区 */
+    if (pos < fifo->mirror_len) {
+        memcpy(&fifo->buf[fifo->size + pos], &fifo->buf[pos],
+               ((fifo->mirror_len - pos) < first) ? (fifo->mirror_len - pos)
+                                                  : first);
+    }
+    if (len != first) {
+        memcpy(&fifo->buf[fifo->size], &fifo->buf[0],
+               (fifo->mirror_len < len - first) ? fifo->mirror_len
+                                                : len - first);
+    }
+
+    fifo->tail += len;
+}
+
+#endif /* MSG_ENABLE_COBS */
+
+#if MSG_ENABLE_TX_QUEUE
+
+/**
+ * @brief 发送队列中一帧的最大长度, 为所有 ID 中最长的一帧
+ */
+typedef union {
+#define MSG_TX_FRAME_DEFINE(id, max_len)                                       \
+    uint8_t id##_frame[MSG_FRAME_MAX_LEN(max_len)];
+    MSG_ID_TABLE(MSG_TX_FRAME_DEFINE)
+#undef MSG_TX_FRAME_DEFINE
+} msg_tx_frame_t;
+
+/**
+ * @brief 发送队列元素
+ */
+typedef struct {
+    atomic_uint_least32_t seq;            /*!< 序号, 用于判断可写/可读 */
+    uint32_t len;                         /*!< 帧长度 */
+    uint8_t data[sizeof(msg_tx_frame_t)]; /*!< 编码好的帧 */
+} msg_tx_slot_t;
+
+/**
+ * @brief 发送队列, 每个串口一个, 多生产者单消费者无锁队列
+ *
+ * @note 生产者 (`message_send_data`) 通过 CAS 抢占`enqueue_pos`预留元素,
+ *       编码完成后写入序号提交. 谁抢到`busy`谁就是消费者, 按顺序启动 DMA
+ *       发送, 发送完成中断里释放元素并接着发送下一帧, 生产者不会等待串口.
+ *       `dma_owned`只在队列的 DMA 发送启动成功后置位, 同一个串口上其他
+ *       传输 (例如`uart_printf`) 的完成中断不会释放元素.
+ */
+typedef struct {
+    UART_HandleTypeDef *huart;         /*!< 发送串口 */
+    atomic_uint_least32_t enqueue_pos; /*!< 生产者位置 */
+    volatile uint32_t dequeue_pos;     /*!< 消费者位置 */
+    atomic_bool busy;                  /*!< 是否正在发送 */
+    volatile bool dma_owned;           /*!< 正在进行的 DMA 是否是队列发起的 */
+    volatile uint32_t cplt_count;      /*!< 发送完成中断次数 */
+
+#if MSG_ENABLE_TX_BATCH
+    uint8_t *batch_buf;                /*!< 批量发送缓冲区, NULL 为不合并 */
+    uint32_t batch_size;               /*!< 批量发送缓冲区大小 */
+    uint32_t batch_len;                /*!< 批量发送缓冲区已用长度 */
+    uint32_t batch_frames;             /*!< 批量发送缓冲区中的帧数 */
+    atomic_uint_least32_t pending_len; /*!< 队列中已提交未合并的长度 */
+    TimerHandle_t batch_timer;         /*!< 发送窗口定时器 */
+#if MSG_ENABLE_STATISTICS
+    uint32_t burst_count;      /*!< 批量发送次数 */
+    uint32_t burst_frames;     /*!< 批量发送的总帧数 */
+    uint32_t max_burst_frames; /*!< 单次批量发送的最大帧数 */
+#endif                         /* MSG_ENABLE_STATISTICS */
+#endif                         /* MSG_ENABLE_TX_BATCH */
+
+    msg_tx_slot_t slots[MSG_TX_QUEUE_LEN]; /*!< 队列元素 */
+} msg_tx_queue_t;
+
+#endif /* MSG_ENABLE_TX_QUEUE */
+
+/**
+ * @brief 帧头信息
+ */
+typedef struct {
+    uint8_t id_type;     /*!< 消息 ID 和数据类型, 同回调参数 */
+    uint8_t msg_id;      /*!< 完整的消息 ID, 用于分发 */
+    bool crc;            /*!< 是否带 CRC */
+    uint32_t header_len; /*!< 帧头长度 */
+    uint32_t data_len;   /*!< 数据长度 */
+#if MSG_ENABLE_HEADER_EXT
+    bool ext;            /*!< 是否带扩展帧头 */
+    uint16_t seq;        /*!< 序号 */
+    uint32_t send_time;  /*!< 发送时间戳 */
+#endif                   /* MSG_ENABLE_HEADER_EXT */
+} msg_header_t;
+
+/**
+ * @brief 订阅者
+ */
+typedef struct {
+    msg_recv_callback_t callback; /*!< 接收回调函数 */
+    uint16_t type_mask;           /*!< 数据类型掩码, 见`MSG_TYPE_MASK` */
+#if MSG_ENABLE_STATISTICS
+    uint32_t call_count;       /*!< 调用次数 */
+    uint32_t exec_time_us;     /*!< 上次执行时间 (us) */
+    uint32_t max_exec_time_us; /*!< 最长执行时间 (us) */
+#endif                         /* MSG_ENABLE_STATISTICS */
+} msg_subscriber_t;
+
+/**
+ * @brief 接收端口, 每个接收串口一个
+ *
+ * @note 同一个串口上的多个消息 ID 共用一个解析器和接收队列, 出队时按帧头中的
+ *       ID 分发到对应的消息实例. 帧头 ID 没有绑定到该串口的帧交给默认 ID:
+ *       串口只绑定了一个 ID 时就是它, 和每个 ID 一个串口时的行为一致; 绑定了
+ *       多个 ID 时为`message_set_rx_default`设置的 ID, 没有设置则丢弃.
+ */
+typedef struct {
+    UART_HandleTypeDef *huart; /*!< 接收串口句柄 */
+    uint32_t recv_max_len;     /*!< 每次轮询最多处理的数据长度 */
+
+#if MSG_ENABLE_COBS
+    uint8_t cobs_code; /*!< 当前 COBS 块剩余字节数, 0 为下一个字节是码字 */
+    bool cobs_zero;    /*!< 下一块开始前是否要还原一个 0x00 */
+#elif defined(MSG_ESC)
+    bool escape; /*!< 是否要将下一个字符转义 */
+#endif           /* MSG_ENABLE_COBS */
+    bool frame_skip; /*!< 丢弃当前帧直到帧结束 */
+
+    msg_fifo_t *fifo;          /*!< 接收队列 */
+    uint32_t fifo_element_len; /*!< 当前队列元素个数 */
+    bool fifo_reset;           /*!< 队列满时清空, 有 ID 设置了`MSG_FIFO_RESET` */
+
+    uint32_t msg_num;              /*!< 绑定的消息 ID 个数 */
+    struct msg_instance *fallback; /*!< 默认 ID 的实例, 没有为 NULL */
 
+#if MSG_ENABLE_STATISTICS
+    uint32_t recv_error; /*!< 帧格式错误计数 */
+#if MSG_ENABLE_CRC
+    uint32_t recv_crc_error; /*!< CRC 校验错误计数 */
+#endif                       /* MSG_ENABLE_CRC */
+    uint32_t recv_unknown;   /*!< 帧头 ID 没有绑定到该串口的帧数 */
+    uint32_t recv_fallback;  /*!< 其中交给默认 ID 的帧数 */
+    uint32_t recv_overrun;   /*!< 处理前数据被 DMA 覆盖的次数 */
+
+    uint32_t max_fifo_element_len; /*!< 最大队列元素个数 */
+    uint32_t fifo_overflow;        /*!< 队列溢出计数 */
+    uint32_t fifo_drop;            /*!< 队列溢出丢弃的完整帧数 */
+
+    volatile uint32_t recv_event_time; /*!< 接收中断时间戳 (周期数, 0 为无) */
+    uint32_t recv_latency_us;          /*!< 中断到回调的延迟 (us) */
+    uint32_t max_recv_latency_us;      /*!< 中断到回调的最大延迟 (us) */
+#endif                                 /* MSG_ENABLE_STATISTICS */
+} msg_rx_port_t;
+
+struct msg_instance {
+    msg_subscriber_t subscriber[MSG_SUBSCRIBER_MAX]; /*!< 订阅者, 按订阅顺序 */
+    uint32_t subscriber_num;                         /*!< 订阅者个数 */
+    UART_HandleTypeDef *send_uart; /*!< 发送串口句柄 */
+    msg_rx_port_t *rx_port;        /*!< 接收端口, 同一个串口共用 */
+
+#if MSG_ENABLE_TX_QUEUE
+    msg_tx_queue_t *tx_queue; /*!< 发送队列, 同一个串口共用 */
+#else                         /* MSG_ENABLE_TX_QUEUE */
     uint8_t *send_buf;     /*!< 发送缓冲区 */
     uint32_t send_buf_len; /*!< 发送缓冲区大小 */
 
 #if MSG_ENABLE_RTOS
     SemaphoreHandle_t send_buf_semp; /*!< 发送缓冲区二值型号量 */
 #endif                               /* MSG_ENABLE_RTOS */
+#endif                               /* MSG_ENABLE_TX_QUEUE */
+
+#if MSG_ENABLE_CRC
+    msg_crc_t crc;       /*!< CRC 校验类型 */
+    bool crc_negotiate;  /*!< 是否协商, 收到对端带 CRC 的帧以后才启用 */
+    bool crc_peer;       /*!< 对端是否发送过带 CRC 的帧 */
+#endif                   /* MSG_ENABLE_CRC */
+
+    msg_fifo_policy_t fifo_policy; /*!< 接收队列策略 */
+    bool rx_default;               /*!< 是否接收串口上未绑定 ID 的帧 */
+    uint8_t *pending;              /*!< 只回调最新帧时, 本次轮询最新的有效帧 */
+    msg_header_t pending_header;   /*!< 最新有效帧的帧头 */
+
+    msg_frame_info_t latest; /*!< 最新一帧信息 */
+    bool latest_valid;       /*!< 是否收到过帧 */
+
+#if MSG_ENABLE_HEADER_EXT
+    bool ext_send; /*!< 发送是否带扩展帧头 */
+#if MSG_ENABLE_TX_QUEUE
+    atomic_uint_least16_t send_seq; /*!< 发送序号, 多个任务可能同时发送 */
+#else                               /* MSG_ENABLE_TX_QUEUE */
+    uint16_t send_seq; /*!< 发送序号 */
+#endif                 /* MSG_ENABLE_TX_QUEUE */
+    bool seq_valid;    /*!< 是否收到过带序号的帧 */
+    uint16_t recv_seq; /*!< 最新接收的序号 */
+#endif                 /* MSG_ENABLE_HEADER_EXT */
+
+#if MSG_ENABLE_STATISTICS
+    uint32_t send_count; /*!< 发送计数 */
+    uint32_t send_drop;  /*!< 发送队列或者串口发送缓冲区满丢弃计数 */
+
+    uint32_t recv_success;    /*!< 接收成功计数 */
+    uint32_t recv_error;      /*!< 要求 CRC 但是没有带的帧数 */
+    uint32_t recv_superseded; /*!< 只回调最新帧时跳过的帧数 */
+#if MSG_ENABLE_HEADER_EXT
+    uint32_t recv_lost;    /*!< 序号不连续, 丢失的帧数 */
+    uint32_t recv_reorder; /*!< 序号乱序或重复的帧数 */
+#endif                     /* MSG_ENABLE_HEADER_EXT */
+#endif                     /* MSG_ENABLE_STATISTICS */
+};
 
-    uint8_t *recv_buf;      /*!< 接收缓冲区 */
-    uint32_t recv_buf_size; /*!< 接收缓冲区大小 */
+struct msg_instance *msg_list[MSG_ID_RESERVE_LEN];
 
-#ifdef MSG_ESC
-    bool escape; /*!< 是否要将下一个字符转义 */
-#endif           /* MSG_ESC */
+#if MSG_ENABLE_CRC
+/* v2 帧头标识字节最高位是 CRC 标志, ID 只有 3 位 */
+#define MSG_V2_ID_NUM 8U
+#else /* MSG_ENABLE_CRC */
+#define MSG_V2_ID_NUM 16U
+#endif /* MSG_ENABLE_CRC */
+
+#if MSG_ENABLE_V3
+/* ID 只有一个字节 */
+typedef char msg_id_len_check[(MSG_ID_RESERVE_LEN <= 256) ? 1 : -1];
+#else  /* MSG_ENABLE_V3 */
+/* v2 帧头 ID 放不下就不能用, 启用 CRC 后表里每个 ID 都要小于 8 */
+#define MSG_V2_ID_CHECK(id, max_len)                                           \
+    typedef char id##_v2_id_check[((id) < MSG_V2_ID_NUM) ? 1 : -1];
+MSG_ID_TABLE(MSG_V2_ID_CHECK)
+#undef MSG_V2_ID_CHECK
+#endif /* MSG_ENABLE_V3 */
+
+/* 每个 ID 声明的最大发送数据长度 */
+static const uint16_t msg_max_data_len[MSG_ID_RESERVE_LEN] = {
+#define MSG_MAX_DATA_LEN(id, max_len) [id] = (max_len),
+    MSG_ID_TABLE(MSG_MAX_DATA_LEN)
+#undef MSG_MAX_DATA_LEN
+};
 
-    msg_fifo_t *fifo;          /*!< 接收缓冲区 */
-    uint32_t fifo_element_len; /*!< 当前队列元素个数 */
+/* 声明的最大数据长度不能超过`MSG_DATA_MAX_LEN` */
+#define MSG_MAX_DATA_LEN_CHECK(id, max_len)                                    \
+    typedef char id##_max_len_check[((max_len) <= MSG_DATA_MAX_LEN) ? 1 : -1];
+MSG_ID_TABLE(MSG_MAX_DATA_LEN_CHECK)
+#undef MSG_MAX_DATA_LEN_CHECK
 
-#if MSG_ENABLE_STATISTICS
-    uint32_t send_count; /*!< 发送计数 */
+#if MSG_ENABLE_TX_QUEUE
 
-    uint32_t recv_success; /*!< 接收成功计数 */
-    uint32_t recv_error;   /*!< 接收错误计数 */
+/* 发送队列, 每个串口一个, 最多每个 ID 用一个串口 */
+static msg_tx_queue_t *msg_tx_queue_list[MSG_ID_RESERVE_LEN];
 
-    uint32_t max_fifo_element_len; /*!< 最大队列元素个数 */
-    uint32_t fifo_overflow;        /*!< 队列溢出清空计数 */
-#endif                             /* MSG_ENABLE_STATISTICS */
+#elif MSG_SEND_BUF_STATIC
+
+/* 每个 ID 的静态发送缓冲区, 大小按最大数据长度全部转义计算 */
+static struct {
+#define MSG_SEND_BUF_DEFINE(id, max_len)                                       \
+    uint8_t id##_buf[MSG_FRAME_MAX_LEN(max_len)];
+    MSG_ID_TABLE(MSG_SEND_BUF_DEFINE)
+#undef MSG_SEND_BUF_DEFINE
+} msg_send_buf;
+
+/* 每个 ID 对应的静态发送缓冲区 */
+static uint8_t *const msg_static_send_buf[MSG_ID_RESERVE_LEN] = {
+#define MSG_SEND_BUF_PTR(id, max_len) [id] = msg_send_buf.id##_buf,
+    MSG_ID_TABLE(MSG_SEND_BUF_PTR)
+#undef MSG_SEND_BUF_PTR
 };
 
-struct msg_instance *msg_list[MSG_ID_RESERVE_LEN];
-static msg_fifo_t *msg_fifo_init(uint32_t fifo_size);
+/* 每个 ID 对应的静态发送缓冲区大小 */
+static const uint32_t msg_static_send_buf_len[MSG_ID_RESERVE_LEN] = {
+#define MSG_SEND_BUF_LEN(id, max_len) [id] = sizeof(msg_send_buf.id##_buf),
+    MSG_ID_TABLE(MSG_SEND_BUF_LEN)
+#undef MSG_SEND_BUF_LEN
+};
+
+#endif /* MSG_ENABLE_TX_QUEUE */
+
+/* 接收端口, 每个串口一个, 最多每个 ID 用一个串口 */
+static msg_rx_port_t *msg_rx_port_list[MSG_ID_RESERVE_LEN];
+
+#if MSG_ENABLE_RTOS
+/* 等待接收的轮询任务, 串口接收中断通过任务通知唤醒 */
+static TaskHandle_t msg_polling_task;
+#endif /* MSG_ENABLE_RTOS */
+
+#if MSG_ENABLE_STATISTICS
 
 /**
- * @brief 注册数据发送句柄
+ * @brief 获取时间戳, 使用 DWT 周期计数器
  *
- * @param msg_id 数据含义
- * @param huart 发送串口句柄
- * @param buf_size 缓冲区大小
+ * @return 时间戳 (CPU 周期数), 不会返回 0
  */
-void message_register_send_uart(msg_id_t msg_id, UART_HandleTypeDef *huart,
-                                uint32_t buf_size) {
-    if (msg_id >= MSG_ID_RESERVE_LEN) {
-        return;
+static inline uint32_t message_get_timestamp(void) {
+    uint32_t cycle = DWT->CYCCNT;
+    return (cycle == 0) ? 1 : cycle;
+}
+
+#endif /* MSG_ENABLE_STATISTICS */
+
+/**
+ * @brief 串口接收事件回调, 在中断中调用
+ *
+ * @param huart 串口句柄
+ */
+static void message_uart_rx_event(UART_HandleTypeDef *huart) {
+#if MSG_ENABLE_STATISTICS
+    for (uint32_t i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        if (msg_rx_port_list[i] == NULL) {
+            break;
+        }
+
+        if (msg_rx_port_list[i]->huart != huart) {
+            continue;
+        }
+
+        /* 只记录上次处理后的第一次中断 */
+        if (msg_rx_port_list[i]->recv_event_time == 0) {
+            msg_rx_port_list[i]->recv_event_time = message_get_timestamp();
+        }
+        break;
     }
+#else  /* MSG_ENABLE_STATISTICS */
+    UNUSED(huart);
+#endif /* MSG_ENABLE_STATISTICS */
 
-    if (msg_list[msg_id] == NULL) {
-        msg_list[msg_id] =
-            (struct msg_instance *)MSG_MALLOC(sizeof(struct msg_instance));
-        memset(msg_list[msg_id], 0, sizeof(struct msg_instance));
+#if MSG_ENABLE_RTOS
+    if (msg_polling_task != NULL) {
+        BaseType_t task_woken = pdFALSE;
+        vTaskNotifyGiveFromISR(msg_polling_task, &task_woken);
+        portYIELD_FROM_ISR(task_woken);
     }
+#endif /* MSG_ENABLE_RTOS */
+}
+static msg_fifo_t *msg_fifo_init(uint32_t fifo_size);
 
-    struct msg_instance *msg = msg_list[msg_id];
+#if MSG_ENABLE_TX_QUEUE
 
-    msg->send_uart = huart;
-    if (msg->send_buf != NULL) {
-        MSG_FREE(msg->send_buf);
+/**
+ * @brief 释放发送队列中最早的一帧, 只能由消费者调用
+ *
+ * @param tx_queue 发送队列
+ */
+static inline void message_tx_release(msg_tx_queue_t *tx_queue) {
+    uint32_t pos = tx_queue->dequeue_pos;
+    msg_tx_slot_t *slot = &tx_queue->slots[pos & (MSG_TX_QUEUE_LEN - 1)];
+
+    /* 序号加上队列长度, 下一轮生产者可以写 */
+    atomic_store_explicit(&slot->seq, pos + MSG_TX_QUEUE_LEN,
+                          memory_order_release);
+    tx_queue->dequeue_pos = pos + 1;
+}
+
+/**
+ * @brief 队列中最早的一帧是否已经提交
+ *
+ * @param tx_queue 发送队列
+ * @return 最早一帧的元素, 没有提交的帧返回`NULL`
+ */
+static inline msg_tx_slot_t *message_tx_peek(msg_tx_queue_t *tx_queue) {
+    uint32_t pos = tx_queue->dequeue_pos;
+    msg_tx_slot_t *slot = &tx_queue->slots[pos & (MSG_TX_QUEUE_LEN - 1)];
+
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != pos + 1) {
+        return NULL;
     }
 
-    msg->send_buf = (uint8_t *)MSG_MALLOC(buf_size);
-    if (msg->send_buf == NULL) {
-        return;
+    return slot;
+}
+
+/**
+ * @brief 启动队列的 DMA 发送, 成功后由发送完成中断释放
+ *
+ * @note 关中断启动, 发送完成中断看到`dma_owned`时传输一定是队列发起的
+ *
+ * @param tx_queue 发送队列
+ * @param data 发送数据
+ * @param len 发送长度
+ * @return 是否启动了 DMA 发送
+ */
+static bool message_tx_dma(msg_tx_queue_t *tx_queue, uint8_t *data,
+                           uint32_t len) {
+    bool started = false;
+
+    if (tx_queue->huart->hdmatx == NULL) {
+        /* 串口还没有初始化, 数据留在队列里 */
+        return false;
     }
 
-    msg->send_buf_len = buf_size;
-#if MSG_ENABLE_RTOS
-    if (msg->send_buf_semp == NULL) {
-        msg->send_buf_semp = xSemaphoreCreateMutex();
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (HAL_UART_Transmit_DMA(tx_queue->huart, data, (uint16_t)len) ==
+        HAL_OK) {
+        tx_queue->dma_owned = true;
+        started = true;
     }
-#endif /* MSG_ENABLE_RTOS */
+    __set_PRIMASK(primask);
+
+    return started;
 }
 
+#if MSG_ENABLE_TX_BATCH
+
 /**
- * @brief 注册接收回调函数指针
+ * @brief 合并已经提交的帧, 缓冲区满或者发送窗口到了就发送, 只能由消费者调用
  *
- * @param msg_id 数据含义
- * @param msg_callback 回调指针
- * @note 如果更换回调函数, 重新调用该函数即可
+ * @param tx_queue 发送队列
+ * @param flush 发送窗口到了, 有数据就发送
+ * @return 发送状态:
+ *  @retval - 0: 启动了 DMA 发送
+ *  @retval - 1: 没有数据或者还没到发送窗口
+ *  @retval - 2: 串口被其他地方占用
  */
-void message_register_recv_callback(msg_id_t msg_id,
-                                    msg_recv_callback_t msg_callback) {
-    if (msg_id >= MSG_ID_RESERVE_LEN) {
-        return;
+static uint8_t message_tx_batch(msg_tx_queue_t *tx_queue, bool flush) {
+    msg_tx_slot_t *slot;
+
+    /* 把已经提交的帧复制到批量发送缓冲区, 复制完就可以释放给生产者 */
+    while ((slot = message_tx_peek(tx_queue)) != NULL) {
+        if (tx_queue->batch_len + slot->len > tx_queue->batch_size) {
+            /* 放不下了, 先发送 */
+            flush = true;
+            break;
+        }
+
+        memcpy(&tx_queue->batch_buf[tx_queue->batch_len], slot->data,
+               slot->len);
+        tx_queue->batch_len += slot->len;
+        ++tx_queue->batch_frames;
+        atomic_fetch_sub(&tx_queue->pending_len, slot->len);
+        message_tx_release(tx_queue);
     }
 
-    if (msg_list[msg_id] == NULL) {
-        msg_list[msg_id] =
-            (struct msg_instance *)MSG_MALLOC(sizeof(struct msg_instance));
-        memset(msg_list[msg_id], 0, sizeof(struct msg_instance));
+    if (tx_queue->batch_len == 0) {
+        return 1;
+    }
+
+    if (tx_queue->batch_len + sizeof(msg_tx_frame_t) > tx_queue->batch_size) {
+        /* 再放不下最长的一帧, 不用等了 */
+        flush = true;
+    }
+
+    if (!flush) {
+        return 1;
+    }
+
+    if (!message_tx_dma(tx_queue, tx_queue->batch_buf, tx_queue->batch_len)) {
+        /* 数据留在缓冲区下次再发 */
+        return 2;
     }
 
-    msg_list[msg_id]->recv_callback = msg_callback;
+#if MSG_ENABLE_STATISTICS
+    ++tx_queue->burst_count;
+    tx_queue->burst_frames += tx_queue->batch_frames;
+    if (tx_queue->batch_frames > tx_queue->max_burst_frames) {
+        tx_queue->max_burst_frames = tx_queue->batch_frames;
+    }
+#endif /* MSG_ENABLE_STATISTICS */
+
+    return 0;
 }
 
+#endif /* MSG_ENABLE_TX_BATCH */
+
 /**
- * @brief 注册数据接口串口句柄
+ * @brief 是否有需要发送的数据
  *
- * @param msg_id 数据含义
- * @param huart 接收串口句柄
- * @param buf_size 串口缓冲区大小
- * @param fifo_size 队列大小 (必须是 2 的幂次方! )
+ * @param tx_queue 发送队列
+ * @param flush 发送窗口到了
+ * @return 是否需要发送
  */
-void message_register_polling_uart(msg_id_t msg_id, UART_HandleTypeDef *huart,
-                                   uint32_t buf_size, uint32_t fifo_size) {
-    if (msg_id >= MSG_ID_RESERVE_LEN) {
-        return;
+static inline bool message_tx_ready(msg_tx_queue_t *tx_queue, bool flush) {
+#if MSG_ENABLE_TX_BATCH
+    if (tx_queue->batch_buf != NULL) {
+        if (flush) {
+            return (tx_queue->batch_len != 0) ||
+                   (message_tx_peek(tx_queue) != NULL);
+        }
+
+        /* 没到发送窗口, 只有缓冲区要满了才发送 */
+        return (message_tx_peek(tx_queue) != NULL) &&
+               (tx_queue->batch_len + atomic_load(&tx_queue->pending_len) +
+                    sizeof(msg_tx_frame_t) >
+                tx_queue->batch_size);
     }
+#else  /* MSG_ENABLE_TX_BATCH */
+    UNUSED(flush);
+#endif /* MSG_ENABLE_TX_BATCH */
 
-    if (is_pow_of_2(fifo_size) == 0) {
-        /* 不是 2 的幂次方 */
+    return message_tx_peek(tx_queue) != NULL;
+}
+
+/**
+ * @brief 启动发送, 已经在发送时直接返回, 由发送完成中断接着发
+ *
+ * @note 串口被其他地方占用时不重试, 由那次传输的发送完成中断或者下一个
+ *       发送窗口接着发送
+ *
+ * @param tx_queue 发送队列
+ * @param flush 批量发送时, 发送窗口到了, 有数据就发送
+ */
+static void message_tx_start(msg_tx_queue_t *tx_queue, bool flush) {
+    msg_tx_slot_t *slot;
+    uint32_t cplt_count;
+    uint8_t res;
+    bool idle;
+
+    while (1) {
+        idle = false;
+        if (!atomic_compare_exchange_strong(&tx_queue->busy, &idle, true)) {
+            /* 其他地方正在发送 */
+            return;
+        }
+
+        cplt_count = tx_queue->cplt_count;
+#if MSG_ENABLE_TX_BATCH
+        if (tx_queue->batch_buf != NULL) {
+            res = message_tx_batch(tx_queue, flush);
+        } else
+#endif /* MSG_ENABLE_TX_BATCH */
+        {
+            slot = message_tx_peek(tx_queue);
+            if (slot == NULL) {
+                res = 1;
+            } else {
+                res = message_tx_dma(tx_queue, slot->data, slot->len) ? 0 : 2;
+            }
+        }
+
+        if (res == 0) {
+            /* 发送完成中断里释放并发送下一帧 */
+            return;
+        }
+
+        atomic_store(&tx_queue->busy, false);
+
+        if (res == 2) {
+            /* 占用串口的传输在持有`busy`期间发完了, 它的发送完成中断没能
+             * 接着发送, 这里再试一次 */
+            if (tx_queue->cplt_count != cplt_count) {
+                continue;
+            }
+            return;
+        }
+
+        /* 释放后再检查一次, 防止释放前刚提交的帧没有人发送 */
+        if (!message_tx_ready(tx_queue, flush)) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 串口发送完成回调, 在中断中调用
+ *
+ * @param huart 串口句柄
+ */
+static void message_uart_tx_cplt(UART_HandleTypeDef *huart) {
+    msg_tx_queue_t *tx_queue;
+
+    for (uint32_t i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        tx_queue = msg_tx_queue_list[i];
+        if ((tx_queue == NULL) || (tx_queue->huart != huart)) {
+            continue;
+        }
+
+        ++tx_queue->cplt_count;
+
+        /* 不是队列发起的传输 (例如`uart_printf`) 时不释放 */
+        if (tx_queue->dma_owned) {
+            tx_queue->dma_owned = false;
+#if MSG_ENABLE_TX_BATCH
+            if (tx_queue->batch_buf != NULL) {
+                /* 合并发送时复制完就已经释放了 */
+                tx_queue->batch_len = 0;
+                tx_queue->batch_frames = 0;
+            } else
+#endif /* MSG_ENABLE_TX_BATCH */
+            {
+                message_tx_release(tx_queue);
+            }
+            atomic_store(&tx_queue->busy, false);
+        }
+
+        message_tx_start(tx_queue, false);
         return;
     }
+}
 
-    if (msg_list[msg_id] == NULL) {
-        msg_list[msg_id] =
-            (struct msg_instance *)MSG_MALLOC(sizeof(struct msg_instance));
-        memset(msg_list[msg_id], 0, sizeof(struct msg_instance));
+/**
+ * @brief 获取串口对应的发送队列, 没有则创建
+ *
+ * @param huart 串口句柄
+ * @return 发送队列, 内存不足或者串口没有开启 DMA 发送返回`NULL`
+ */
+static msg_tx_queue_t *message_tx_queue_get(UART_HandleTypeDef *huart) {
+    uint32_t i;
+
+    for (i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        if (msg_tx_queue_list[i] == NULL) {
+            break;
+        }
+
+        if (msg_tx_queue_list[i]->huart == huart) {
+            return msg_tx_queue_list[i];
+        }
+    }
+
+    if (i == MSG_ID_RESERVE_LEN) {
+        return NULL;
     }
 
-    struct msg_instance *msg = msg_list[msg_id];
-    msg->recv_uart = huart;
-    msg->recv_buf = (uint8_t *)MSG_MALLOC(buf_size);
-    if (msg->recv_buf == NULL) {
-        return;
-    }
-    msg->recv_buf_size = buf_size;
+    msg_tx_queue_t *tx_queue =
+        (msg_tx_queue_t *)MSG_MALLOC(sizeof(msg_tx_queue_t));
+    if (tx_queue == NULL) {
+        return NULL;
+    }
+
+    tx_queue->huart = huart;
+    tx_queue->dequeue_pos = 0;
+    atomic_init(&tx_queue->enqueue_pos, 0);
+    atomic_init(&tx_queue->busy, false);
+    tx_queue->dma_owned = false;
+    tx_queue->cplt_count = 0;
+#if MSG_ENABLE_TX_BATCH
+    tx_queue->batch_buf = NULL;
+    tx_queue->batch_size = 0;
+    tx_queue->batch_len = 0;
+    tx_queue->batch_frames = 0;
+    atomic_init(&tx_queue->pending_len, 0);
+    tx_queue->batch_timer = NULL;
+#if MSG_ENABLE_STATISTICS
+    tx_queue->burst_count = 0;
+    tx_queue->burst_frames = 0;
+    tx_queue->max_burst_frames = 0;
+#endif /* MSG_ENABLE_STATISTICS */
+#endif /* MSG_ENABLE_TX_BATCH */
+    for (uint32_t j = 0; j < MSG_TX_QUEUE_LEN; ++j) {
+        atomic_init(&tx_queue->slots[j].seq, j);
+    }
+
+    if (uart_dmatx_register_cplt_callback(huart, message_uart_tx_cplt) != 0) {
+        /* 没有发送完成中断, 队列发不出去 */
+        MSG_FREE(tx_queue);
+        return NULL;
+    }
+    msg_tx_queue_list[i] = tx_queue;
+
+    return tx_queue;
+}
+
+/**
+ * @brief 在发送队列中预留一帧, 可以多个任务同时调用
+ *
+ * @param tx_queue 发送队列
+ * @param[out] pos 预留的位置, 提交时使用
+ * @return 预留的元素, 队列满返回`NULL`
+ */
+static msg_tx_slot_t *message_tx_reserve(msg_tx_queue_t *tx_queue,
+                                         uint32_t *pos) {
+    uint32_t enqueue_pos =
+        atomic_load_explicit(&tx_queue->enqueue_pos, memory_order_relaxed);
+    msg_tx_slot_t *slot;
+    int32_t diff;
+
+    while (1) {
+        slot = &tx_queue->slots[enqueue_pos & (MSG_TX_QUEUE_LEN - 1)];
+        diff = (int32_t)(atomic_load_explicit(&slot->seq,
+                                              memory_order_acquire) -
+                         enqueue_pos);
+        if (diff == 0) {
+            /* 可写, 抢占位置, 失败时`enqueue_pos`会更新为最新值 */
+            if (atomic_compare_exchange_weak_explicit(
+                    &tx_queue->enqueue_pos, &enqueue_pos, enqueue_pos + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                *pos = enqueue_pos;
+                return slot;
+            }
+        } else if (diff < 0) {
+            /* 队列满 */
+            return NULL;
+        } else {
+            /* 被其他生产者抢先, 重新读取 */
+            enqueue_pos = atomic_load_explicit(&tx_queue->enqueue_pos,
+                                               memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief 提交预留的一帧
+ *
+ * @param slot 预留的元素
+ * @param pos 预留的位置
+ * @param len 帧长度
+ */
+static inline void message_tx_commit(msg_tx_queue_t *tx_queue,
+                                     msg_tx_slot_t *slot, uint32_t pos,
+                                     uint32_t len) {
+    slot->len = len;
+#if MSG_ENABLE_TX_BATCH
+    atomic_fetch_add(&tx_queue->pending_len, len);
+#else  /* MSG_ENABLE_TX_BATCH */
+    UNUSED(tx_queue);
+#endif /* MSG_ENABLE_TX_BATCH */
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+#if MSG_ENABLE_TX_BATCH
+
+/**
+ * @brief 发送窗口定时器回调, 把合并的帧发出去
+ *
+ * @param timer 定时器句柄
+ */
+static void message_tx_batch_timeout(TimerHandle_t timer) {
+    message_tx_start((msg_tx_queue_t *)pvTimerGetTimerID(timer), true);
+}
+
+/**
+ * @brief 设置串口合并发送
+ *
+ * @param huart 发送串口句柄, 需要先用`message_register_send_uart`注册
+ * @param window 发送窗口 (ms), 每个窗口把期间的帧合并成一次 DMA 发送
+ * @param buf_size 批量发送缓冲区大小, 缓冲区满了不等窗口直接发送
+ * @return 设置结果:
+ *  @retval - 0: 成功
+ *  @retval - 1: 串口没有注册发送
+ *  @retval - 2: 串口没有开启 DMA 发送
+ *  @retval - 3: 参数错误, 窗口为 0 或者缓冲区放不下最长的一帧
+ *  @retval - 4: 内存不足或者定时器创建失败
+ * @note 需要在开始发送前设置, 设置后不能取消, 再次调用可以修改发送窗口
+ */
+uint8_t message_set_tx_batch(UART_HandleTypeDef *huart, uint32_t window,
+                             uint32_t buf_size) {
+    msg_tx_queue_t *tx_queue = NULL;
+
+    for (uint32_t i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        if ((msg_tx_queue_list[i] != NULL) &&
+            (msg_tx_queue_list[i]->huart == huart)) {
+            tx_queue = msg_tx_queue_list[i];
+            break;
+        }
+    }
+
+    if (tx_queue == NULL) {
+        return 1;
+    }
+
+    if (huart->hdmatx == NULL) {
+        return 2;
+    }
+
+    if ((window == 0) || (buf_size < sizeof(msg_tx_frame_t))) {
+        return 3;
+    }
+
+    if (tx_queue->batch_buf == NULL) {
+        tx_queue->batch_buf = (uint8_t *)MSG_MALLOC(buf_size);
+        if (tx_queue->batch_buf == NULL) {
+            return 4;
+        }
+        tx_queue->batch_size = buf_size;
+    }
+
+    if (tx_queue->batch_timer == NULL) {
+        tx_queue->batch_timer =
+            xTimerCreate("msg_batch", pdMS_TO_TICKS(window), pdTRUE,
+                         tx_queue, message_tx_batch_timeout);
+        if (tx_queue->batch_timer == NULL) {
+            return 4;
+        }
+    } else {
+        xTimerChangePeriod(tx_queue->batch_timer, pdMS_TO_TICKS(window),
+                           portMAX_DELAY);
+    }
+
+    xTimerStart(tx_queue->batch_timer, portMAX_DELAY);
+    return 0;
+}
+
+#endif /* MSG_ENABLE_TX_BATCH */
+
+#endif /* MSG_ENABLE_TX_QUEUE */
+
+/**
+ * @brief 获取消息实例, 没有就创建
+ *
+ * @param msg_id 数据含义
+ * @return 消息实例, 参数错误或者内存不足返回 NULL
+ */
+static struct msg_instance *message_instance_get(msg_id_t msg_id) {
+    if (msg_id >= MSG_ID_RESERVE_LEN) {
+        return NULL;
+    }
+
+    if (msg_list[msg_id] == NULL) {
+        msg_list[msg_id] =
+            (struct msg_instance *)MSG_MALLOC(sizeof(struct msg_instance));
+        if (msg_list[msg_id] == NULL) {
+            return NULL;
+        }
+        memset(msg_list[msg_id], 0, sizeof(struct msg_instance));
+    }
+
+    return msg_list[msg_id];
+}
+
+/**
+ * @brief 注册数据发送句柄
+ *
+ * @param msg_id 数据含义
+ * @param huart 发送串口句柄
+ * @param buf_size 缓冲区大小, 启用`MSG_ENABLE_TX_QUEUE`或
+ *                 `MSG_SEND_BUF_STATIC`时无效, 使用`MSG_ID_TABLE`中声明的
+ *                 最大数据长度
+ */
+void message_register_send_uart(msg_id_t msg_id, UART_HandleTypeDef *huart,
+                                uint32_t buf_size) {
+    struct msg_instance *msg = message_instance_get(msg_id);
+    if (msg == NULL) {
+        return;
+    }
+
+    msg->send_uart = huart;
+#if MSG_ENABLE_TX_QUEUE
+    UNUSED(buf_size);
+    msg->tx_queue = message_tx_queue_get(huart);
+#elif MSG_SEND_BUF_STATIC
+    UNUSED(buf_size);
+    msg->send_buf = msg_static_send_buf[msg_id];
+    msg->send_buf_len = msg_static_send_buf_len[msg_id];
+#else  /* MSG_SEND_BUF_STATIC */
+    if (msg->send_buf != NULL) {
+        MSG_FREE(msg->send_buf);
+    }
+
+    msg->send_buf = (uint8_t *)MSG_MALLOC(buf_size);
+    if (msg->send_buf == NULL) {
+        return;
+    }
+
+    msg->send_buf_len = buf_size;
+#endif /* MSG_ENABLE_TX_QUEUE */
+#if MSG_ENABLE_RTOS && !MSG_ENABLE_TX_QUEUE
+    if (msg->send_buf_semp == NULL) {
+        msg->send_buf_semp = xSemaphoreCreateMutex();
+    }
+#endif /* MSG_ENABLE_RTOS && !MSG_ENABLE_TX_QUEUE */
+}
+
+/**
+ * @brief 注册接收回调函数指针
+ *
+ * @param msg_id 数据含义
+ * @param msg_callback 回调指针
+ * @note 如果更换回调函数, 重新调用该函数即可. 会清除该 ID 已有的订阅者,
+ *       只保留这一个回调, 接收所有数据类型
+ */
+void message_register_recv_callback(msg_id_t msg_id,
+                                    msg_recv_callback_t msg_callback) {
+    struct msg_instance *msg = message_instance_get(msg_id);
+    if (msg == NULL) {
+        return;
+    }
+
+    msg->subscriber_num = 0;
+    message_subscribe(msg_id, msg_callback, MSG_TYPE_MASK_ALL);
+}
+
+/**
+ * @brief 订阅消息
+ *
+ * @param msg_id 数据含义
+ * @param msg_callback 回调指针
+ * @param type_mask 订阅的数据类型掩码, 如
+ *                  `MSG_TYPE_MASK(MSG_DATA_CUSTOM)`, `MSG_TYPE_MASK_ALL`
+ * @return 订阅状态:
+ * @retval - 0: 成功
+ * @retval - 1: 参数错误
+ * @retval - 2: 订阅者已满
+ * @note 收到消息后按订阅顺序调用. 同一个回调重复订阅只更新掩码.
+ *       订阅和取消订阅不能和轮询同时进行, 请在开始轮询前订阅
+ */
+uint8_t message_subscribe(msg_id_t msg_id, msg_recv_callback_t msg_callback,
+                          uint16_t type_mask) {
+    if (msg_callback == NULL) {
+        return 1;
+    }
+
+    struct msg_instance *msg = message_instance_get(msg_id);
+    if (msg == NULL) {
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < msg->subscriber_num; ++i) {
+        if (msg->subscriber[i].callback == msg_callback) {
+            msg->subscriber[i].type_mask = type_mask;
+            return 0;
+        }
+    }
+
+    if (msg->subscriber_num >= MSG_SUBSCRIBER_MAX) {
+        return 2;
+    }
+
+    msg_subscriber_t *sub = &msg->subscriber[msg->subscriber_num];
+    memset(sub, 0, sizeof(msg_subscriber_t));
+    sub->callback = msg_callback;
+    sub->type_mask = type_mask;
+    ++msg->subscriber_num;
+
+    return 0;
+}
+
+/**
+ * @brief 取消订阅
+ *
+ * @param msg_id 数据含义
+ * @param msg_callback 回调指针
+ * @return 取消订阅状态:
+ * @retval - 0: 成功
+ * @retval - 1: 参数错误
+ * @retval - 2: 没有订阅
+ */
+uint8_t message_unsubscribe(msg_id_t msg_id, msg_recv_callback_t msg_callback) {
+    if (msg_id >= MSG_ID_RESERVE_LEN) {
+        return 1;
+    }
+
+    struct msg_instance *msg = msg_list[msg_id];
+    if (msg == NULL) {
+        return 2;
+    }
+
+    for (uint32_t i = 0; i < msg->subscriber_num; ++i) {
+        if (msg->subscriber[i].callback != msg_callback) {
+            continue;
+        }
+
+        /* 后面的往前移, 保持订阅顺序 */
+        --msg->subscriber_num;
+        memmove(&msg->subscriber[i], &msg->subscriber[i + 1],
+                (msg->subscriber_num - i) * sizeof(msg_subscriber_t));
+        return 0;
+    }
+
+    return 2;
+}
+
+/**
+ * @brief 获取串口对应的接收端口, 没有则创建
+ *
+ * @param huart 接收串口句柄
+ * @param buf_size 每次轮询最多处理的数据长度
+ * @param fifo_size 队列大小
+ * @return 接收端口, 内存不足返回`NULL`
+ * @note 串口已经有接收端口时沿用第一次注册的长度和队列大小
+ */
+static msg_rx_port_t *message_rx_port_get(UART_HandleTypeDef *huart,
+                                          uint32_t buf_size,
+                                          uint32_t fifo_size) {
+    uint32_t i;
+
+    for (i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        if (msg_rx_port_list[i] == NULL) {
+            break;
+        }
+
+        if (msg_rx_port_list[i]->huart == huart) {
+            return msg_rx_port_list[i];
+        }
+    }
+
+    if (i == MSG_ID_RESERVE_LEN) {
+        return NULL;
+    }
+
+    msg_rx_port_t *port = (msg_rx_port_t *)MSG_MALLOC(sizeof(msg_rx_port_t));
+    if (port == NULL) {
+        return NULL;
+    }
+    memset(port, 0, sizeof(msg_rx_port_t));
+
+    port->fifo = msg_fifo_init(fifo_size);
+    if (port->fifo == NULL) {
+        MSG_FREE(port);
+        return NULL;
+    }
+
+    port->huart = huart;
+    port->recv_max_len = buf_size;
+    msg_rx_port_list[i] = port;
+
+    return port;
+}
+
+/**
+ * @brief 重新统计接收端口绑定的消息 ID, 注册和修改策略后调用
+ *
+ * @param port 接收端口
+ */
+static void message_rx_port_update(msg_rx_port_t *port) {
+    struct msg_instance *msg;
+    struct msg_instance *last = NULL;
+
+    port->msg_num = 0;
+    port->fallback = NULL;
+    port->fifo_reset = false;
+
+    for (msg_id_t i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        msg = msg_list[i];
+        if ((msg == NULL) || (msg->rx_port != port)) {
+            continue;
+        }
+
+        ++port->msg_num;
+        last = msg;
+        if (msg->rx_default && (port->fallback == NULL)) {
+            port->fallback = msg;
+        }
+        if (msg->fifo_policy == MSG_FIFO_RESET) {
+            port->fifo_reset = true;
+        }
+    }
+
+    if (port->msg_num == 1) {
+        port->fallback = last;
+    }
+}
+
+/**
+ * @brief 注册数据接口串口句柄
+ *
+ * @param msg_id 数据含义
+ * @param huart 接收串口句柄
+ * @param buf_size 每次轮询最多处理的数据长度, 数据直接在串口 DMA 缓冲区中
+ *                 解析, 不再另外分配接收缓冲区
+ * @param fifo_size 队列大小 (必须是 2 的幂次方! )
+ * @note 多个 ID 可以注册同一个串口, 共用一个解析器和接收队列, 按帧头中的 ID
+ *       分发. 缓冲区和队列大小以第一次注册该串口时为准, 需要按所有 ID 的总
+ *       流量设置
+ */
+void message_register_polling_uart(msg_id_t msg_id, UART_HandleTypeDef *huart,
+                                   uint32_t buf_size, uint32_t fifo_size) {
+    if (is_pow_of_2(fifo_size) == 0) {
+        /* 不是 2 的幂次方 */
+        return;
+    }
+
+    struct msg_instance *msg = message_instance_get(msg_id);
+    if (msg == NULL) {
+        return;
+    }
+
+    msg_rx_port_t *port = message_rx_port_get(huart, buf_size, fifo_size);
+    if (port == NULL) {
+        return;
+    }
+
+    msg_rx_port_t *old_port = msg->rx_port;
+    msg->rx_port = port;
+    if ((old_port != NULL) && (old_port != port)) {
+        /* 换了串口, 原来的端口少了一个 ID */
+        message_rx_port_update(old_port);
+    }
+    message_rx_port_update(port);
+
+#if MSG_ENABLE_STATISTICS
+    /* 打开 DWT 周期计数器, 统计接收延迟用 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif /* MSG_ENABLE_STATISTICS */
+
+    uart_dmarx_register_event_callback(huart, message_uart_rx_event);
+}
+
+/**
+ * @brief 设置消息 ID 为所在接收串口的默认 ID
+ *
+ * @param msg_id 数据含义
+ * @param enable 是否作为默认 ID
+ * @note 帧头 ID 没有绑定到该串口的帧都交给默认 ID, 用来兼容按其他 ID 发送的
+ *       旧对端. 串口只绑定了一个 ID 时它就是默认 ID, 不需要设置. 一个串口上
+ *       有多个 ID 设置时取 ID 最小的
+ */
+void message_set_rx_default(msg_id_t msg_id, bool enable) {
+    struct msg_instance *msg = message_instance_get(msg_id);
+    if (msg == NULL) {
+        return;
+    }
+
+    msg->rx_default = enable;
+    if (msg->rx_port != NULL) {
+        message_rx_port_update(msg->rx_port);
+    }
+}
+
+/**
+ * @brief 设置接收队列策略
+ *
+ * @param msg_id 数据含义
+ * @param policy 接收队列策略:
+ *  @arg - MSG_FIFO_DROP_OLDEST: 队列满时丢弃最旧的完整帧, 保留新数据
+ *  @arg - MSG_FIFO_RESET: 队列满时清空队列, 正在接收的帧也丢弃
+ *  @arg - MSG_FIFO_LATEST_ONLY: 队列满时同`MSG_FIFO_DROP_OLDEST`, 每次轮询
+ *                               只回调队列中最新的有效帧, 旧的帧直接跳过.
+ *                               适合位姿等只关心最新值的消息
+ * @note 多个 ID 共用一个串口时队列也是共用的, 其中一个 ID 设置了
+ *       `MSG_FIFO_RESET`, 队列满时就会清空整个队列
+ */
+void message_set_fifo_policy(msg_id_t msg_id, msg_fifo_policy_t policy) {
+    struct msg_instance *msg = message_instance_get(msg_id);
+    if (msg == NULL) {
+        return;
+    }
+
+    msg->fifo_policy = policy;
+    if (msg->rx_port != NULL) {
+        message_rx_port_update(msg->rx_port);
+    }
+}
+
+#if MSG_ENABLE_HEADER_EXT
+
+/**
+ * @brief 设置消息 ID 发送时是否带扩展帧头
+ *
+ * @param msg_id 数据含义
+ * @param enable 是否带扩展帧头
+ * @note 扩展帧头带 2 byte 序号和 4 byte 发送时间戳 (`HAL_GetTick`), 只能用 v3
+ *       帧头发送, 旧协议的对端无法接收. 接收端不需要设置, 收到就会统计
+ */
+void message_set_header_ext(msg_id_t msg_id, bool enable) {
+    struct msg_instance *msg = message_instance_get(msg_id);
+    if (msg == NULL) {
+        return;
+    }
+
+    msg->ext_send = enable;
+}
+
+#endif /* MSG_ENABLE_HEADER_EXT */
+
+/**
+ * @brief 获取最新一帧的年龄
+ *
+ * @param msg_id 数据含义
+ * @return 收到最新一帧 (回调过的) 到现在的时间 (ms), 没有收到过返回
+ *         `UINT32_MAX`
+ * @note 按本地接收时间计算, 不包含对端到本地的传输延迟
+ */
+uint32_t message_get_latest_age(msg_id_t msg_id) {
+    if (msg_id >= MSG_ID_RESERVE_LEN) {
+        return UINT32_MAX;
+    }
+
+    struct msg_instance *msg = msg_list[msg_id];
+    if ((msg == NULL) || !msg->latest_valid) {
+        return UINT32_MAX;
+    }
+
+    return HAL_GetTick() - msg->latest.recv_time;
+}
+
+/**
+ * @brief 获取最新一帧的信息
+ *
+ * @param msg_id 数据含义
+ * @param[out] info 最新一帧的信息
+ * @return 获取状态:
+ * @retval - 0: 成功
+ * @retval - 1: 参数错误
+ * @retval - 2: 还没有收到过
+ * @note 在接收回调中调用得到的就是当前这一帧的信息
+ */
+uint8_t message_get_frame_info(msg_id_t msg_id, msg_frame_info_t *info) {
+    if ((msg_id >= MSG_ID_RESERVE_LEN) || (info == NULL)) {
+        return 1;
+    }
+
+    struct msg_instance *msg = msg_list[msg_id];
+    if ((msg == NULL) || !msg->latest_valid) {
+        return 2;
+    }
+
+#if MSG_ENABLE_RTOS
+    taskENTER_CRITICAL();
+#endif /* MSG_ENABLE_RTOS */
+    *info = msg->latest;
+#if MSG_ENABLE_RTOS
+    taskEXIT_CRITICAL();
+#endif /* MSG_ENABLE_RTOS */
+
+    return 0;
+}
+
+#if MSG_ENABLE_CRC
+
+/**
+ * @brief 设置消息 ID 的 CRC 校验
+ *
+ * @param msg_id 数据含义
+ * @param crc CRC 类型
+ * @param negotiate 是否协商:
+ *  @arg - false: 发送一直带 CRC, 接收不带 CRC 的帧丢弃
+ *  @arg - true:  收到对端带 CRC 的帧之前按照旧协议收发, 兼容没有 CRC 的对端;
+ *                收到以后发送带 CRC, 接收不带 CRC 的帧丢弃
+ * @note 带 CRC 的帧会在标识字节置位`MSG_CRC_FLAG`, CRC 计算范围为标识, 长度
+ *       和数据, 小端跟在数据后面 (同样转义). 接收时根据帧长度判断 CRC 类型,
+ *       所以接收不依赖这里的设置. 协商需要有一端不使用协商模式, 否则两端都
+ *       不会先发送 CRC.
+ * @note 协商模式下对端升级之前链路没有任何校验保护, 误码的帧照样交给回调.
+ */
+void message_set_crc(msg_id_t msg_id, msg_crc_t crc, bool negotiate) {
+    struct msg_instance *msg = message_instance_get(msg_id);
+    if (msg == NULL) {
+        return;
+    }
+
+    msg->crc = crc;
+    msg->crc_negotiate = negotiate;
+    msg->crc_peer = false;
+}
+
+/**
+ * @brief 当前是否使用 CRC 收发
+ *
+ * @param msg 消息实例
+ * @return 是否使用 CRC
+ */
+static inline bool message_crc_active(struct msg_instance *msg) {
+    return (msg->crc != MSG_CRC_NONE) &&
+           (!msg->crc_negotiate || msg->crc_peer);
+}
+
+/**
+ * @brief 校验带 CRC 的帧
+ *
+ * @param frame 帧, 从标识开始
+ * @param len 帧头和数据长度, CRC 紧跟在后面
+ * @param crc_len CRC 长度
+ * @return 是否通过校验
+ */
+static bool message_crc_check(const uint8_t *frame, uint32_t len,
+                              uint32_t crc_len) {
+    const uint8_t *crc = &frame[len];
+
+    if (crc_len == 2) {
+        uint16_t crc16 = crc16_calc(CRC16_INIT, frame, len);
+        return crc16 == (uint16_t)(crc[0] | (crc[1] << 8));
+    }
+
+    if (crc_len == 4) {
+        uint32_t crc32 = crc32_calc(CRC32_INIT, frame, len);
+        return crc32 == ((uint32_t)crc[0] | ((uint32_t)crc[1] << 8) |
+                         ((uint32_t)crc[2] << 16) | ((uint32_t)crc[3] << 24));
+    }
+
+    return false;
+}
+
+#endif /* MSG_ENABLE_CRC */
+
+#if MSG_ENABLE_COBS
+
+/**
+ * @brief 查找第一个 0x00 字节
+ *
+ * @param data 数据
+ * @param len 数据长度
+ * @return 第一个 0x00 的位置, 没有返回`len`
+ * @note 对齐以后一次检查一个字 (4 字节), 字中有 0x00 字节时
+ *       `(w - 0x01010101) & ~w & 0x80808080`不为 0, 再逐字节确定位置
+ */
+static uint32_t message_find_zero(const uint8_t *data, uint32_t len) {
+    uint32_t i = 0;
+    uint32_t word;
+
+    /* 先逐字节对齐到字边界 */
+    while ((i < len) && (((uintptr_t)&data[i] & 3U) != 0)) {
+        if (data[i] == 0) {
+            return i;
+        }
+        ++i;
+    }
+
+    for (; i + 4 <= len; i += 4) {
+        memcpy(&word, &data[i], sizeof(word));
+        if (((word - 0x01010101U) & ~word & 0x80808080U) != 0) {
+            break;
+        }
+    }
+
+    for (; i < len; ++i) {
+        if (data[i] == 0) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+/**
+ * @brief COBS 编码状态
+ */
+typedef struct {
+    uint8_t *buf;      /*!< 发送缓冲区 */
+    uint32_t idx;      /*!< 写入位置 */
+    uint32_t code_idx; /*!< 当前块码字位置 */
+} msg_cobs_t;
+
+/**
+ * @brief COBS 编码一段数据, 可以分多次写入同一帧
+ *
+ * @param cobs 编码状态
+ * @param data 数据
+ * @param data_len 数据长度
+ * @note 两个 0x00 之间的数据整段复制, 块满 254 字节或遇到 0x00 时回填码字
+ */
+static void message_cobs_put(msg_cobs_t *cobs, const uint8_t *data,
+                             uint32_t data_len) {
+    uint32_t block, run;
+
+    while (data_len != 0) {
+        block = cobs->idx - cobs->code_idx - 1;
+        run = message_find_zero(data, ((254U - block) < data_len)
+                                          ? (254U - block)
+                                          : data_len);
+        memcpy(&cobs->buf[cobs->idx], data, run);
+        cobs->idx += run;
+        data += run;
+        data_len -= run;
+        block += run;
+
+        if ((block != 254U) && (data_len != 0)) {
+            /* 没满就是遇到了 0x00, 结束当前块, 码字为块长度 + 1 */
+            ++data;
+            --data_len;
+        } else if (block != 254U) {
+            continue;
+        }
+
+        /* 块满 (码字 0xFF, 不代表 0x00) 或者遇到 0x00, 开始新的一块 */
+        cobs->buf[cobs->code_idx] = (uint8_t)(block + 1);
+        cobs->code_idx = cobs->idx;
+        ++cobs->idx;
+    }
+}
+
+#else /* MSG_ENABLE_COBS */
+
+/**
+ * @brief 写入一段数据到发送缓冲区, 需要时转义
+ *
+ * @param send_buf 发送缓冲区
+ * @param buf_idx 写入位置
+ * @param data 数据
+ * @param data_len 数据长度
+ * @return 写入后的位置
+ */
+static uint32_t message_put_data(uint8_t *send_buf, uint32_t buf_idx,
+                                 const uint8_t *data, uint32_t data_len) {
+    for (uint32_t data_idx = 0; data_idx < data_len; ++data_idx) {
+#ifdef MSG_ESC
+        if ((data[data_idx] == MSG_EOF) || (data[data_idx] == MSG_ESC)) {
+            /* 转义 */
+            send_buf[buf_idx] = MSG_ESC;
+            ++buf_idx;
+        }
+#endif /* MSG_ESC */
+
+        send_buf[buf_idx] = data[data_idx];
+        ++buf_idx;
+    }
+
+    return buf_idx;
+}
+
+#endif /* MSG_ENABLE_COBS */
+
+/**
+ * @brief 编码帧头
+ *
+ * @param[out] header 帧头, 长度至少为`MSG_HEADER_MAX_LEN`
+ * @param msg_id 数据含义
+ * @param data_type 数据类型
+ * @param data_len 数据长度
+ * @param flag 标识字节的标志位
+ * @return 帧头长度
+ * @note v2 帧头: 标识 (高四位 ID, 低四位类型), 长度.
+ *       v3 帧头: 标识 (低四位`MSG_V3_MARK`), ID, 类型, 长度 (变长编码, 每个
+ *       字节低 7 位有效, 最高位置位说明后面还有一个字节).
+ *       ID 和长度 v2 帧头放得下就用 v2 帧头, 旧协议的对端仍然可以接收.
+ *       扩展帧头 (`flag`带`MSG_EXT_FLAG`) 只能用 v3 帧头, 扩展内容由调用者
+ *       接在后面
+ */
+static uint32_t message_encode_header(uint8_t *header, msg_id_t msg_id,
+                                      msg_type_t data_type, uint32_t data_len,
+                                      uint8_t flag) {
+#if MSG_ENABLE_V3
+    if ((msg_id >= MSG_V2_ID_NUM) || (data_len > UINT8_MAX)
+#if MSG_ENABLE_HEADER_EXT
+        || (flag & MSG_EXT_FLAG)
+#endif /* MSG_ENABLE_HEADER_EXT */
+    ) {
+        header[0] = flag | MSG_V3_MARK;
+        header[1] = (uint8_t)msg_id;
+        header[2] = (uint8_t)data_type;
+        if (data_len < 0x80U) {
+            header[3] = (uint8_t)data_len;
+            return 4;
+        }
+
+        header[3] = (uint8_t)(data_len | 0x80U);
+        header[4] = (uint8_t)(data_len >> 7);
+        return 5;
+    }
+#endif /* MSG_ENABLE_V3 */
+
+    header[0] = flag | (uint8_t)(msg_id << 4) | data_type;
+    header[1] = (uint8_t)data_len;
+    return 2;
+}
+
+/**
+ * @brief 解析帧头
+ *
+ * @param frame 帧, 从标识开始
+ * @param frame_len 帧长度 (不含结束符)
+ * @param[out] header 帧头信息
+ * @return 帧头是否有效
+ */
+static bool message_parse_header(const uint8_t *frame, uint32_t frame_len,
+                                 msg_header_t *header) {
+    uint8_t ident;
+
+    if (frame_len < 2) {
+        return false;
+    }
+
+    ident = frame[0];
+
+#if MSG_ENABLE_CRC
+    header->crc = ((ident & MSG_CRC_FLAG) != 0);
+    ident &= (uint8_t)~MSG_CRC_FLAG;
+#else  /* MSG_ENABLE_CRC */
+    header->crc = false;
+#endif /* MSG_ENABLE_CRC */
+
+#if MSG_ENABLE_HEADER_EXT
+    header->ext = false;
+#endif /* MSG_ENABLE_HEADER_EXT */
+
+#if MSG_ENABLE_V3
+    if ((ident & 0x0FU) == MSG_V3_MARK) {
+#if MSG_ENABLE_HEADER_EXT
+        header->ext = ((ident & MSG_EXT_FLAG) != 0);
+        ident &= (uint8_t)~MSG_EXT_FLAG;
+#endif /* MSG_ENABLE_HEADER_EXT */
+        if ((ident != MSG_V3_MARK) || (frame_len < 4)) {
+            /* 其余标志位保留 */
+            return false;
+        }
+
+        header->msg_id = frame[1];
+        header->id_type = (uint8_t)(frame[1] << 4) | (frame[2] & 0x0FU);
+        header->data_len = frame[3] & 0x7FU;
+        header->header_len = 4;
+        if (frame[3] & 0x80U) {
+            if ((frame_len < 5) || (frame[4] & 0x80U)) {
+                return false;
+            }
+            header->data_len |= (uint32_t)frame[4] << 7;
+            header->header_len = 5;
+        }
+
+#if MSG_ENABLE_HEADER_EXT
+        if (header->ext) {
+            const uint8_t *ext = &frame[header->header_len];
+            if (frame_len < header->header_len + 6) {
+                return false;
+            }
+            header->seq = (uint16_t)(ext[0] | (ext[1] << 8));
+            header->send_time = (uint32_t)ext[2] | ((uint32_t)ext[3] << 8) |
+                                ((uint32_t)ext[4] << 16) |
+                                ((uint32_t)ext[5] << 24);
+            header->header_len += 6;
+        }
+#endif /* MSG_ENABLE_HEADER_EXT */
+
+        return header->data_len <= MSG_DATA_MAX_LEN;
+    }
+#endif /* MSG_ENABLE_V3 */
+
+    header->msg_id = ident >> 4;
+    header->id_type = ident;
+    header->data_len = frame[1];
+    header->header_len = 2;
+    return true;
+}
+
+/**
+ * @brief 编码一帧到发送缓冲区
+ *
+ * @param msg 消息实例
+ * @param[out] send_buf 发送缓冲区, 长度至少为`MSG_FRAME_MAX_LEN(data_len)`
+ * @param msg_id 数据含义
+ * @param data_type 数据类型
+ * @param data 数据内容
+ * @param data_len 发送长度
+ * @return 帧长度
+ */
+static uint32_t message_encode_frame(struct msg_instance *msg,
+                                     uint8_t *send_buf, msg_id_t msg_id,
+                                     msg_type_t data_type, const uint8_t *data,
+                                     uint32_t data_len) {
+#if !MSG_ENABLE_CRC
+    UNUSED(msg);
+#endif /* !MSG_ENABLE_CRC */
+
+    uint8_t header[MSG_HEADER_MAX_LEN];
+    uint32_t header_len;
+    uint8_t flag = 0;
+    uint8_t crc_buf[4];
+    uint32_t crc_len = 0;
+
+#if MSG_ENABLE_CRC
+    bool use_crc = message_crc_active(msg);
+    if (use_crc) {
+        flag = MSG_CRC_FLAG;
+    }
+#endif /* MSG_ENABLE_CRC */
+
+#if MSG_ENABLE_HEADER_EXT
+    if (msg->ext_send) {
+        flag |= MSG_EXT_FLAG;
+    }
+#endif /* MSG_ENABLE_HEADER_EXT */
+
+    header_len =
+        message_encode_header(header, msg_id, data_type, data_len, flag);
+
+#if MSG_ENABLE_HEADER_EXT
+    if (msg->ext_send) {
+        /* 扩展帧头: 序号, 发送时间戳 */
+#if MSG_ENABLE_TX_QUEUE
+        uint16_t seq = (uint16_t)atomic_fetch_add_explicit(
+            &msg->send_seq, 1, memory_order_relaxed);
+#else  /* MSG_ENABLE_TX_QUEUE */
+        uint16_t seq = msg->send_seq++;
+#endif /* MSG_ENABLE_TX_QUEUE */
+        uint32_t send_time = HAL_GetTick();
+
+        header[header_len++] = (uint8_t)seq;
+        header[header_len++] = (uint8_t)(seq >> 8);
+        header[header_len++] = (uint8_t)send_time;
+        header[header_len++] = (uint8_t)(send_time >> 8);
+        header[header_len++] = (uint8_t)(send_time >> 16);
+        header[header_len++] = (uint8_t)(send_time >> 24);
+    }
+#endif /* MSG_ENABLE_HEADER_EXT */
+
+#if MSG_ENABLE_CRC
+    if (use_crc) {
+        /* CRC 包含帧头, 小端发送 */
+        if (msg->crc == MSG_CRC_16) {
+            uint16_t crc16 = crc16_calc(CRC16_INIT, header, header_len);
+            crc16 = crc16_calc(crc16, data, data_len);
+            crc_buf[0] = (uint8_t)crc16;
+            crc_buf[1] = (uint8_t)(crc16 >> 8);
+            crc_len = 2;
+        } else {
+            uint32_t crc32 = crc32_calc(CRC32_INIT, header, header_len);
+            crc32 = crc32_calc(crc32, data, data_len);
+            crc_buf[0] = (uint8_t)crc32;
+            crc_buf[1] = (uint8_t)(crc32 >> 8);
+            crc_buf[2] = (uint8_t)(crc32 >> 16);
+            crc_buf[3] = (uint8_t)(crc32 >> 24);
+            crc_len = 4;
+        }
+    }
+#endif /* MSG_ENABLE_CRC */
+
+#if MSG_ENABLE_COBS
+    msg_cobs_t cobs = {.buf = send_buf, .idx = 1, .code_idx = 0};
+
+    message_cobs_put(&cobs, header, header_len);
+    message_cobs_put(&cobs, data, data_len);
+    message_cobs_put(&cobs, crc_buf, crc_len);
+
+    /* 回填最后一块的码字, 最后一个字节是分隔符 */
+    send_buf[cobs.code_idx] = (uint8_t)(cobs.idx - cobs.code_idx);
+    send_buf[cobs.idx] = 0x00;
+
+    return cobs.idx + 1;
+#else  /* MSG_ENABLE_COBS */
+    /* 长度等帧头字节也可能和结束符相同, 一起转义. 接收端对所有字节去转义,
+     * 旧协议的对端同样可以接收 */
+    uint32_t buf_idx = message_put_data(send_buf, 0, header, header_len);
+
+    /* 复制数据和 CRC 到字节流 */
+    buf_idx = message_put_data(send_buf, buf_idx, data, data_len);
+    buf_idx = message_put_data(send_buf, buf_idx, crc_buf, crc_len);
+
+    /* 最后一个字节, 标记数据末尾 */
+    send_buf[buf_idx] = MSG_EOF;
+    ++buf_idx;
+
+    return buf_idx;
+#endif /* MSG_ENABLE_COBS */
+}
+
+/**
+ * @brief 填充并发送数据, 支持多种类型
+ *
+ * @param msg_id 数据含义
+ * @param data_type 数据类型
+ * @param data 数据内容
+ * @param data_len 发送长度
+ * @return 发送结果:
+ *  @retval - 0: 成功
+ *  @retval - 1: 参数错误, 或者超过声明的最大数据长度
+ *  @retval - 2: 没有注册发送串口
+ *  @retval - 3: 发送队列或者串口发送缓冲区满, 这一帧被丢弃
+ *  @retval - 4: 内存不足
+ * @note 启用`MSG_ENABLE_TX_QUEUE`时只是把帧放进发送队列就返回, 不会等待串口
+ */
+uint8_t message_send_data(msg_id_t msg_id, msg_type_t data_type,
+                          uint8_t *data, uint32_t data_len) {
+    if (data == NULL || data_len == 0 || data_len > MSG_DATA_MAX_LEN) {
+        return 1;
+    }
+
+    if (msg_id >= MSG_ID_RESERVE_LEN) {
+        return 1;
+    }
+
+    if (msg_list[msg_id] == NULL) {
+        return 2;
+    }
+
+    struct msg_instance *msg = msg_list[msg_id];
+
+#if MSG_ENABLE_TX_QUEUE
+    if (msg->send_uart == NULL || msg->tx_queue == NULL) {
+        return 2;
+    }
+
+    if (data_len > msg_max_data_len[msg_id]) {
+        /* 超过声明的最大数据长度 */
+        return 1;
+    }
+
+    uint32_t slot_pos;
+    msg_tx_slot_t *slot = message_tx_reserve(msg->tx_queue, &slot_pos);
+    if (slot == NULL) {
+#if MSG_ENABLE_STATISTICS
+        ++msg->send_drop;
+#endif /* MSG_ENABLE_STATISTICS */
+        return 3;
+    }
+
+    message_tx_commit(msg->tx_queue, slot, slot_pos,
+                      message_encode_frame(msg, slot->data, msg_id, data_type,
+                                           data, data_len));
+    message_tx_start(msg->tx_queue, false);
+
+#if MSG_ENABLE_STATISTICS
+    ++msg->send_count;
+#endif /* MSG_ENABLE_STATISTICS */
+
+#else /* MSG_ENABLE_TX_QUEUE */
+    if (msg->send_uart == NULL || msg->send_buf == NULL) {
+        return 2;
+    }
+
+#if MSG_SEND_BUF_STATIC
+    if (data_len > msg_max_data_len[msg_id]) {
+        /* 超过声明的最大数据长度 */
+        return 1;
+    }
+#endif /* MSG_SEND_BUF_STATIC */
+
+#if MSG_ENABLE_RTOS
+    xSemaphoreTake(msg->send_buf_semp, portMAX_DELAY);
+#endif /* MSG_ENABLE_RTOS */
+
+#if !MSG_SEND_BUF_STATIC
+    if (msg->send_buf_len < MSG_FRAME_MAX_LEN(data_len)) {
+        /* 不够, 扩容到当前数据长度的最坏情况 */
+        uint8_t *new_buf = (uint8_t *)MSG_REALLOC(msg->send_buf,
+                                                  MSG_FRAME_MAX_LEN(data_len));
+        if (new_buf == NULL) {
+#if MSG_ENABLE_RTOS
+            xSemaphoreGive(msg->send_buf_semp);
+#endif /* MSG_ENABLE_RTOS */
+            return 4;
+        }
+
+        msg->send_buf = new_buf;
+        msg->send_buf_len = MSG_FRAME_MAX_LEN(data_len);
+    } else if (MSG_FRAME_MAX_LEN(data_len) * 3 <= msg->send_buf_len) {
+        /* 长度小于 1/3, 缩容到原来的 1/2 */
+        uint8_t *new_buf =
+            (uint8_t *)MSG_REALLOC(msg->send_buf, msg->send_buf_len / 2);
+        if (new_buf == NULL) {
+#if MSG_ENABLE_RTOS
+            xSemaphoreGive(msg->send_buf_semp);
+#endif /* MSG_ENABLE_RTOS */
+            return 4;
+        }
+
+        msg->send_buf = new_buf;
+        msg->send_buf_len = msg->send_buf_len / 2;
+    }
+#endif /* !MSG_SEND_BUF_STATIC */
+
+    uint32_t frame_len = message_encode_frame(msg, msg->send_buf, msg_id,
+                                              data_type, data, data_len);
+
+    if (msg->send_uart->hdmatx != NULL) {
+        if (uart_dmatx_write(msg->send_uart, msg->send_buf, frame_len) == 0) {
+            /* 串口发送缓冲区满, 不等待 */
+#if MSG_ENABLE_STATISTICS
+            ++msg->send_drop;
+#endif /* MSG_ENABLE_STATISTICS */
+#if MSG_ENABLE_RTOS
+            xSemaphoreGive(msg->send_buf_semp);
+#endif /* MSG_ENABLE_RTOS */
+            return 3;
+        }
+        uart_dmatx_send(msg->send_uart);
+    } else {
+        HAL_UART_Transmit(msg->send_uart, msg->send_buf, frame_len, 0xFFFF);
+    }
+
+#if MSG_ENABLE_STATISTICS
+    ++msg->send_count;
+#endif /* MSG_ENABLE_STATISTICS */
+
+#if MSG_ENABLE_RTOS
+    xSemaphoreGive(msg->send_buf_semp);
+#endif /* MSG_ENABLE_RTOS */
+#endif /* MSG_ENABLE_TX_QUEUE */
+
+    return 0;
+}
+
+static void message_data_enqueue(msg_rx_port_t *port, const uint8_t *data,
+                                 uint32_t recv_len);
+static uint32_t message_data_dequeue(msg_rx_port_t *port);
+
+#if MSG_ENABLE_CAPTURE
+
+/* 抓包记录头: 4 byte 接收时间 (ms), 1 byte 接收端口序号, 2 byte 数据长度,
+ * 都是小端, 后面是原始数据 */
+#define MSG_CAPTURE_HEADER_LEN 7U
+/* 导出时 RTT 缓冲区大小 */
+#define MSG_CAPTURE_RTT_SIZE   1024U
+
+typedef char msg_capture_size_check
+    [((MSG_CAPTURE_BUF_SIZE & (MSG_CAPTURE_BUF_SIZE - 1U)) == 0) ? 1 : -1];
+
+/**
+ * @brief 抓包环形缓冲区, 只在轮询任务中访问
+ */
+static struct {
+    bool enable;                           /*!< 是否抓包 */
+    bool rtt_init;                         /*!< RTT 通道是否已经配置 */
+    uint32_t head;                         /*!< 最旧记录位置 */
+    uint32_t tail;                         /*!< 写入位置 */
+    uint32_t drop;                         /*!< 被覆盖或者太长丢弃的记录数 */
+    uint8_t buf[MSG_CAPTURE_BUF_SIZE];     /*!< 缓冲区 */
+    uint8_t rtt_buf[MSG_CAPTURE_RTT_SIZE]; /*!< RTT 上行缓冲区 */
+} msg_capture = {.enable = false};
+
+/**
+ * @brief 从抓包缓冲区复制数据, 处理跨尾
+ *
+ * @param[out] data 数据
+ * @param pos 读取位置 (未取掩码)
+ * @param len 长度
+ */
+static void message_capture_read(uint8_t *data, uint32_t pos, uint32_t len) {
+    uint32_t offset = pos & (MSG_CAPTURE_BUF_SIZE - 1);
+    uint32_t first = MSG_CAPTURE_BUF_SIZE - offset;
+
+    if (first > len) {
+        first = len;
+    }
+
+    memcpy(data, &msg_capture.buf[offset], first);
+    memcpy(data + first, msg_capture.buf, len - first);
+}
+
+/**
+ * @brief 写入抓包缓冲区, 处理跨尾
+ *
+ * @param data 数据
+ * @param len 长度
+ */
+static void message_capture_put(const uint8_t *data, uint32_t len) {
+    uint32_t offset = msg_capture.tail & (MSG_CAPTURE_BUF_SIZE - 1);
+    uint32_t first = MSG_CAPTURE_BUF_SIZE - offset;
+
+    if (first > len) {
+        first = len;
+    }
+
+    memcpy(&msg_capture.buf[offset], data, first);
+    memcpy(msg_capture.buf, data + first, len - first);
+    msg_capture.tail += len;
+}
+
+/**
+ * @brief 读取记录长度
+ *
+ * @param pos 记录位置 (未取掩码)
+ * @return 记录总长度, 包含记录头
+ */
+static uint32_t message_capture_record_len(uint32_t pos) {
+    uint8_t header[MSG_CAPTURE_HEADER_LEN];
+
+    message_capture_read(header, pos, MSG_CAPTURE_HEADER_LEN);
+    return MSG_CAPTURE_HEADER_LEN + (header[5] | (header[6] << 8));
+}
+
+/**
+ * @brief 记录一段接收数据, 空间不够时丢弃最旧的记录
+ *
+ * @param port_idx 接收端口序号, 按第一次注册接收串口的顺序
+ * @param data 数据
+ * @param len 数据长度
+ */
+static void message_capture_write(uint32_t port_idx, const uint8_t *data,
+                                  uint32_t len) {
+    uint8_t header[MSG_CAPTURE_HEADER_LEN];
+    uint32_t time = HAL_GetTick();
+
+    if (!msg_capture.enable) {
+        return;
+    }
+
+    if ((len > UINT16_MAX) ||
+        (MSG_CAPTURE_HEADER_LEN + len > MSG_CAPTURE_BUF_SIZE)) {
+        ++msg_capture.drop;
+        return;
+    }
+
+    while (msg_capture.tail - msg_capture.head + MSG_CAPTURE_HEADER_LEN + len >
+           MSG_CAPTURE_BUF_SIZE) {
+        msg_capture.head += message_capture_record_len(msg_capture.head);
+        ++msg_capture.drop;
+    }
+
+    header[0] = (uint8_t)time;
+    header[1] = (uint8_t)(time >> 8);
+    header[2] = (uint8_t)(time >> 16);
+    header[3] = (uint8_t)(time >> 24);
+    header[4] = (uint8_t)port_idx;
+    header[5] = (uint8_t)len;
+    header[6] = (uint8_t)(len >> 8);
+
+    message_capture_put(header, MSG_CAPTURE_HEADER_LEN);
+    message_capture_put(data, len);
+}
+
+/**
+ * @brief 打开或者关闭接收抓包, 默认关闭
+ *
+ * @param enable 是否抓包
+ */
+void message_capture_enable(bool enable) {
+    msg_capture.enable = enable;
+}
+
+/**
+ * @brief 通过 RTT 导出抓包记录, 导出的记录从缓冲区移除
+ *
+ * @return 导出的记录数, RTT 缓冲区满时剩下的记录留到下次导出
+ * @note 只能在轮询任务中调用. 导出格式同缓冲区: 每条记录 4 byte 接收时间
+ *       (ms), 1 byte 接收端口序号, 2 byte 数据长度 (都是小端), 后面是原始
+ *       数据. 没有连接调试器时不会阻塞
+ */
+uint32_t message_capture_dump(void) {
+    uint8_t record[MSG_CAPTURE_HEADER_LEN + 64U];
+    uint32_t record_len, offset, chunk;
+    uint32_t count = 0;
+
+    if (!msg_capture.rtt_init) {
+        SEGGER_RTT_ConfigUpBuffer(MSG_CAPTURE_RTT_CH, "msg_capture",
+                                  msg_capture.rtt_buf, MSG_CAPTURE_RTT_SIZE,
+                                  SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        msg_capture.rtt_init = true;
+    }
+
+    while (msg_capture.head != msg_capture.tail) {
+        record_len = message_capture_record_len(msg_capture.head);
+        if (SEGGER_RTT_GetAvailWriteSpace(MSG_CAPTURE_RTT_CH) < record_len) {
+            /* 记录不拆开写, 放不下就等下次 */
+            break;
+        }
+
+        for (offset = 0; offset < record_len; offset += chunk) {
+            chunk = record_len - offset;
+            if (chunk > sizeof(record)) {
+                chunk = sizeof(record);
+            }
+            message_capture_read(record, msg_capture.head + offset, chunk);
+            SEGGER_RTT_Write(MSG_CAPTURE_RTT_CH, record, chunk);
+        }
+
+        msg_capture.head += record_len;
+        ++count;
+    }
+
+    return count;
+}
+
+#endif /* MSG_ENABLE_CAPTURE */
+
+/**
+ * @brief 轮询数据, 并调用相应的函数
+ *
+ */
+void message_polling_data(void) {
+    msg_rx_port_t *port;
+    uart_rx_span_t span[2];
+    uint32_t recv_len, span_len, recv_count;
+#if MSG_ENABLE_STATISTICS
+    uint32_t event_time;
+#endif /* MSG_ENABLE_STATISTICS */
+
+    for (uint32_t i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        port = msg_rx_port_list[i];
+        if (port == NULL) {
+            break;
+        }
+
+#if MSG_ENABLE_STATISTICS
+        /* 先取走时间戳, 之后的中断记录到下一次 */
+        event_time = port->recv_event_time;
+        port->recv_event_time = 0;
+#endif /* MSG_ENABLE_STATISTICS */
+
+        /* 先入队再出队, 本次收到的完整帧本次就能处理. 直接在 DMA 缓冲区中
+         * 解析, 绕回时分成两段 */
+        recv_len = uart_dmarx_peek(port->huart, span);
+        if (recv_len > port->recv_max_len) {
+            recv_len = port->recv_max_len;
+        }
+
+        for (uint32_t j = 0, left = recv_len; (j < 2) && (left != 0); ++j) {
+            span_len = (span[j].len < left) ? span[j].len : left;
+#if MSG_ENABLE_CAPTURE
+            message_capture_write(i, span[j].data, span_len);
+#endif /* MSG_ENABLE_CAPTURE */
+            message_data_enqueue(port, span[j].data, span_len);
+            left -= span_len;
+        }
 
-    msg->fifo = msg_fifo_init(fifo_size);
-    if (msg->fifo == NULL) {
-        return;
+        if ((recv_len != 0) &&
+            (uart_dmarx_consume(port->huart, recv_len) == 2)) {
+            /* 解析期间 DMA 覆盖了这段数据, 损坏的帧由校验丢弃 */
+#if MSG_ENABLE_STATISTICS
+            ++port->recv_overrun;
+#endif /* MSG_ENABLE_STATISTICS */
+        }
+
+        recv_count = message_data_dequeue(port);
+
+#if MSG_ENABLE_STATISTICS
+        if ((event_time != 0) && (recv_count != 0)) {
+            port->recv_latency_us = (message_get_timestamp() - event_time) /
+                                    (SystemCoreClock / 1000000U);
+            if (port->recv_latency_us > port->max_recv_latency_us) {
+                port->max_recv_latency_us = port->recv_latency_us;
+            }
+        }
+#else  /* MSG_ENABLE_STATISTICS */
+        UNUSED(recv_count);
+#endif /* MSG_ENABLE_STATISTICS */
     }
 }
 
+#if MSG_ENABLE_RTOS
+
 /**
- * @brief 填充并发送数据, 支持多种类型
+ * @brief 等待串口接收事件后轮询数据
  *
- * @param msg_id 数据含义
- * @param data_type 数据类型
- * @param data 数据内容
- * @param data_len 发送长度
+ * @param timeout 最长等待时间 (ms), 超时后也会轮询一次
+ * @note 串口 IDLE, DMA 半满, 全满中断会通过任务通知唤醒调用该函数的任务, 收到
+ *       数据后可以立即处理, 不需要固定周期轮询. 只能在一个任务中调用.
+ *       串口中断优先级不能高于 `configMAX_SYSCALL_INTERRUPT_PRIORITY`.
  */
-void message_send_data(msg_id_t msg_id, msg_type_t data_type, uint8_t *data,
-                       uint32_t data_len) {
-    if (data == NULL || data_len == 0) {
-        return;
+void message_polling_wait(uint32_t timeout) {
+    if (msg_polling_task == NULL) {
+        msg_polling_task = xTaskGetCurrentTaskHandle();
     }
 
-    if (msg_id >= MSG_ID_RESERVE_LEN) {
-        return;
-    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout));
+    message_polling_data();
+}
 
-    if (msg_list[msg_id] == NULL) {
-        return;
-    }
+#endif /* MSG_ENABLE_RTOS */
 
-    struct msg_instance *msg = msg_list[msg_id];
+/**
+ * @brief 接收队列空间不够时按策略腾出空间
+ *
+ * @param port 接收端口
+ * @param len 需要的空间
+ * @return 是否腾出了足够的空间, 不够时当前帧已经丢弃, 需要丢弃到帧结束
+ * @note 入队和出队在同一个任务中, 这里可以直接移动队头
+ */
+static bool message_fifo_make_room(msg_rx_port_t *port, uint32_t len) {
+    msg_fifo_t *fifo = port->fifo;
+    uint32_t element_len;
 
-    if (msg->send_uart == NULL || msg->send_buf == NULL) {
-        return;
+    if (fifo->tail - fifo->head + len <= fifo->size) {
+        return true;
     }
 
-#if MSG_ENABLE_RTOS
-    xSemaphoreTake(msg->send_buf_semp, portMAX_DELAY);
-#endif /* MSG_ENABLE_RTOS */
+#if MSG_ENABLE_STATISTICS
+    ++port->fifo_overflow;
+#endif /* MSG_ENABLE_STATISTICS */
 
-    if (msg->send_buf_len <= data_len + 3) {
-        /* 不够, 扩容当前数据长度的 2 倍 */
-        uint8_t *new_buf = (uint8_t *)MSG_REALLOC(msg->send_buf, data_len * 2);
-        if (new_buf == NULL) {
-            return;
-        }
+    if (port->fifo_reset) {
+        /* 清空 FIFO, 从头开始存 */
+        fifo->head = 0;
+        fifo->tail = 0;
+        port->fifo_element_len = 0;
+        fifo->frame_len = 0;
+        fifo->new_frame = true;
+        return false;
+    }
 
-        msg->send_buf = new_buf;
-        msg->send_buf_len = data_len * 2;
-    } else if ((data_len + 3) * 3 <= msg->send_buf_len) {
-        /* 长度小于 1/3, 缩容到原来的 1/2 */
-        uint8_t *new_buf =
-            (uint8_t *)MSG_REALLOC(msg->send_buf, msg->send_buf_len / 2);
-        if (new_buf == NULL) {
-            return;
+    /* 从最旧的完整帧开始丢弃, 直到空间足够 */
+    while (fifo->tail - fifo->head + len > fifo->size) {
+        element_len = (fifo->head == fifo->tail)
+                          ? 0
+                          : msg_fifo_get_len(fifo, fifo->head);
+        if (element_len == 0) {
+            /* 只剩下正在接收的这一帧, 一帧比队列还长, 丢弃这一帧 */
+            fifo->tail = fifo->head;
+            fifo->frame_len = 0;
+            fifo->new_frame = true;
+            return false;
         }
 
-        msg->send_buf = new_buf;
-        msg->send_buf_len = msg->send_buf_len / 2;
+        fifo->head += element_len;
+        --port->fifo_element_len;
+#if MSG_ENABLE_STATISTICS
+        ++port->fifo_drop;
+#endif /* MSG_ENABLE_STATISTICS */
     }
 
-    uint8_t *send_buf = (uint8_t *)msg->send_buf;
-    uint32_t buf_idx = 0;
-
-    /* 第一个字节, 高四位标记 ID, 低四位标记数据类型 */
-    send_buf[buf_idx] = (uint8_t)(msg_id << 4) | data_type;
-    ++buf_idx;
-    /* 第二个字节, 标记数据长度 */
-    send_buf[buf_idx] = (uint8_t)data_len;
-    ++buf_idx;
+    return true;
+}
 
-    /* 复制数据到字节流 */
-    for (uint32_t data_idx = 0; data_idx < data_len; ++data_idx) {
-#ifdef MSG_ESC
-        if ((data[data_idx] == MSG_EOF) || (data[data_idx] == MSG_ESC)) {
-            /* 转义 */
-            send_buf[buf_idx] = MSG_ESC;
-            ++buf_idx;
-        }
-#endif /* MSG_ESC */
+#if MSG_ENABLE_COBS
 
-        send_buf[buf_idx] = data[data_idx];
-        ++buf_idx;
+/**
+ * @brief 写入当前帧的一段已解码数据
+ *
+ * @param port 接收端口
+ * @param data 数据
+ * @param len 数据长度
+ */
+static void message_frame_append(msg_rx_port_t *port, const uint8_t *data,
+                                 uint32_t len) {
+    msg_fifo_t *fifo = port->fifo;
+
+    /* 还要留 1 byte 结束符 */
+    if (MSG_FIFO_LEN_SIZE + fifo->frame_len + len + 1 >
+        MSG_FIFO_ELEMENT_MAX_LEN) {
+        port->frame_skip = true;
+        return;
     }
 
-    /* 最后一个字节, 标记数据末尾 */
-    send_buf[buf_idx] = MSG_EOF;
-    ++buf_idx;
-
-    if (msg->send_uart->hdmatx != NULL) {
-        uart_dmatx_write(msg->send_uart, send_buf, buf_idx);
-        uart_dmatx_send(msg->send_uart);
-    } else {
-        HAL_UART_Transmit(msg->send_uart, send_buf, buf_idx, 0xFFFF);
+    if (!message_fifo_make_room(
+            port, (fifo->new_frame ? MSG_FIFO_LEN_SIZE : 0) + len + 1)) {
+        /* 丢弃到下一个分隔符 */
+        port->frame_skip = true;
+        return;
     }
 
-#if MSG_ENABLE_STATISTICS
-    ++msg->send_count;
-#endif /* MSG_ENABLE_STATISTICS */
+    if (fifo->new_frame) {
+        /* 空出元素长度, 长度写 0 */
+        msg_fifo_set_len(fifo, fifo->tail, 0);
+        fifo->tail += MSG_FIFO_LEN_SIZE;
+        fifo->new_frame = false;
+    }
 
-#if MSG_ENABLE_RTOS
-    xSemaphoreGive(msg->send_buf_semp);
-#endif /* MSG_ENABLE_RTOS */
+    msg_fifo_write(fifo, data, len);
+    fifo->frame_len += len;
 }
 
-static void message_data_enqueue(struct msg_instance *msg, uint32_t recv_len);
-static void message_data_dequeue(struct msg_instance *msg);
-
 /**
- * @brief 轮询数据, 并调用相应的函数
+ * @brief 收到分隔符, 结束当前帧
  *
+ * @param port 接收端口
  */
-void message_polling_data(void) {
-    struct msg_instance *msg;
-    uint32_t recv_len;
-    for (msg_id_t i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
-        msg = msg_list[i];
-        if (msg == NULL) {
-            continue;
-        }
+static void message_frame_end(msg_rx_port_t *port) {
+    msg_fifo_t *fifo = port->fifo;
 
-        if (msg->recv_uart == NULL) {
-            continue;
+    if (!fifo->new_frame) {
+        if (port->frame_skip || (port->cobs_code != 0)) {
+            /* 帧太长或者不完整, 退回这一帧 */
+            fifo->tail -= fifo->frame_len + MSG_FIFO_LEN_SIZE;
+#if MSG_ENABLE_STATISTICS
+            ++port->recv_error;
+#endif /* MSG_ENABLE_STATISTICS */
+        } else {
+            /* 补上结束符, 出队和转义模式一样处理 */
+            msg_fifo_set(fifo, fifo->tail, MSG_EOF);
+            ++fifo->tail;
+            ++fifo->frame_len;
+
+            /* 写入帧长度, 算上 FIFO 元素大小 */
+            msg_fifo_set_len(fifo, fifo->tail - fifo->frame_len -
+                                       MSG_FIFO_LEN_SIZE,
+                             fifo->frame_len + MSG_FIFO_LEN_SIZE);
+            ++port->fifo_element_len;
+#if MSG_ENABLE_STATISTICS
+            if (port->fifo_element_len > port->max_fifo_element_len) {
+                port->max_fifo_element_len = port->fifo_element_len;
+            }
+#endif /* MSG_ENABLE_STATISTICS */
         }
 
-        if (msg->fifo == NULL) {
+        fifo->frame_len = 0;
+        fifo->new_frame = true;
+    }
+
+    port->cobs_code = 0;
+    port->cobs_zero = false;
+    port->frame_skip = false;
+}
+
+/**
+ * @brief COBS 解码一段数据 (不含分隔符) 写入队列
+ *
+ * @param port 接收端口
+ * @param data 数据
+ * @param len 数据长度
+ * @note 块内数据整段复制, 帧可以分多次接收
+ */
+static void message_cobs_decode(msg_rx_port_t *port, const uint8_t *data,
+                                uint32_t len) {
+    static const uint8_t zero = 0x00;
+    uint32_t run;
+
+    while ((len != 0) && !port->frame_skip) {
+        if (port->cobs_code == 0) {
+            /* 块的第一个字节是码字, 后面还有块说明上一块结尾是 0x00 */
+            if (port->cobs_zero) {
+                message_frame_append(port, &zero, 1);
+            }
+            port->cobs_zero = (data[0] != 0xFF);
+            port->cobs_code = data[0] - 1;
+            ++data;
+            --len;
             continue;
         }
 
-        message_data_dequeue(msg);
+        run = (port->cobs_code < len) ? port->cobs_code : len;
+        message_frame_append(port, data, run);
+        port->cobs_code -= (uint8_t)run;
+        data += run;
+        len -= run;
+    }
+}
 
-        recv_len =
-            uart_dmarx_read(msg->recv_uart, msg->recv_buf, msg->recv_buf_size);
-        if (recv_len == 0) {
-            continue;
+/**
+ * @brief 消息数据入队
+ * 
+ * @param port 接收端口
+ * @param[in] data 接收到的数据
+ * @param recv_len 接收到的数据长度
+ */
+static void message_data_enqueue(msg_rx_port_t *port, const uint8_t *data,
+                                 uint32_t recv_len) {
+    uint32_t seg_len;
+
+    while (recv_len != 0) {
+        /* 按字查找分隔符, 分隔符之前的一段整体解码 */
+        seg_len = message_find_zero(data, recv_len);
+        message_cobs_decode(port, data, seg_len);
+        if (seg_len == recv_len) {
+            /* 帧还没收完 */
+            break;
         }
 
-        message_data_enqueue(msg, recv_len);
+        message_frame_end(port);
+        data += seg_len + 1;
+        recv_len -= seg_len + 1;
     }
 }
 
+#else /* MSG_ENABLE_COBS */
+
 /**
  * @brief 消息数据入队
  * 
- * @param msg 消息实例
+ * @param port 接收端口
+ * @param[in] data 接收到的数据
  * @param recv_len 接收到的数据长度
  */
-static void message_data_enqueue(struct msg_instance *msg, uint32_t recv_len) {
-    msg_fifo_t *fifo = msg->fifo;
+static void message_data_enqueue(msg_rx_port_t *port, const uint8_t *data,
+                                 uint32_t recv_len) {
+    msg_fifo_t *fifo = port->fifo;
+    bool frame_end;
+
     for (uint32_t i = 0; i < recv_len; ++i) {
 #ifdef MSG_ESC
-        if ((msg->recv_buf[i] == MSG_ESC) && (msg->escape == false)) {
+        if ((data[i] == MSG_ESC) && (port->escape == false)) {
             /* 遇到转义, 跳过这一字节到下一字节 */
-            msg->escape = true;
+            port->escape = true;
             continue;
         }
+
+        /* 被转义的字符不是结束符 */
+        frame_end = !port->escape && (data[i] == MSG_EOF);
+        port->escape = false;
+#else  /* MSG_ESC */
+        frame_end = (data[i] == MSG_EOF);
 #endif /* MSG_ESC */
+
+        if (!port->frame_skip) {
+            port->frame_skip = !message_fifo_make_room(
+            port, (fifo->new_frame ? MSG_FIFO_LEN_SIZE : 0) + 1);
+        }
+
+        if (port->frame_skip) {
+            /* 当前帧已丢弃, 到结束符为止 */
+            port->frame_skip = !frame_end;
+            continue;
+        }
+
         if (fifo->new_frame) {
-            /* 空一个字节写长度, 长度写 0 */
-            fifo->buf[fifo->tail & fifo->mask] = 0;
-            ++fifo->tail;
+            /* 空出元素长度, 长度写 0 */
+            msg_fifo_set_len(fifo, fifo->tail, 0);
+            fifo->tail += MSG_FIFO_LEN_SIZE;
             fifo->new_frame = false;
         }
 
         /* 将数据写入队列 */
-        fifo->buf[fifo->tail & fifo->mask] = msg->recv_buf[i];
+        msg_fifo_set(fifo, fifo->tail, data[i]);
         ++fifo->tail;
         ++fifo->frame_len;
 
-        if (fifo->size == (fifo->tail - fifo->head)) {
-            /* FIFO 已满, 先覆盖旧数据, 有新的帧直接清空 FIFO, 从头开始存 */
-            fifo->head = 0;
-            fifo->tail = 0;
-            msg->fifo_element_len = 0;
-            fifo->frame_len = 0;
+        if (frame_end) {
+            if (fifo->frame_len + MSG_FIFO_LEN_SIZE > MSG_FIFO_ELEMENT_MAX_LEN) {
+                /* 帧太长, 长度写不下, 退回这一帧 */
+                fifo->tail -= fifo->frame_len + MSG_FIFO_LEN_SIZE;
 #if MSG_ENABLE_STATISTICS
-            ++msg->fifo_overflow;
+                ++port->recv_error;
 #endif /* MSG_ENABLE_STATISTICS */
+            } else {
+                /* 写入上帧长度, 算上 FIFO 元素大小 */
+                msg_fifo_set_len(fifo,
+                                 fifo->tail - fifo->frame_len -
+                                     MSG_FIFO_LEN_SIZE,
+                                 fifo->frame_len + MSG_FIFO_LEN_SIZE);
+                ++port->fifo_element_len;
+            }
+
+            /* 帧长度清零 */
+            fifo->frame_len = 0;
+
+            /* 下次空出元素长度写 */
+            fifo->new_frame = true;
         }
 
-#ifdef MSG_ESC
-        if (msg->escape) {
-            msg->escape = false;
-            /* 这是被转义的字符, 避免执行到下面的结束标识被当成结束符处理 */
-            continue;
+#if MSG_ENABLE_STATISTICS
+        if (port->fifo_element_len > port->max_fifo_element_len) {
+            port->max_fifo_element_len = port->fifo_element_len;
         }
-#endif /* MSG_ESC */
+#endif /* MSG_ENABLE_STATISTICS */
+    }
+}
 
-        if (msg->recv_buf[i] == MSG_EOF) {
-            /* 写入上帧长度, 算上 FIFO 元素大小 */
-            fifo->buf[(fifo->tail - fifo->frame_len - 1) & fifo->mask] =
-                fifo->frame_len + 1;
+#endif /* MSG_ENABLE_COBS */
 
-            /* 帧长度清零 */
-            fifo->frame_len = 0;
+#if MSG_ENABLE_HEADER_EXT
 
-            /* 下次空出一个字节写 */
-            fifo->new_frame = true;
+/* 序号落后最新序号这么多以内算乱序, 再多认为对端重启了, 从新序号开始 */
+#define MSG_SEQ_REORDER_WINDOW 256U
+
+/**
+ * @brief 检查扩展帧头中的序号, 统计丢帧和乱序
+ *
+ * @param msg 消息实例
+ * @param header 帧头信息
+ */
+static void message_seq_check(struct msg_instance *msg,
+                              const msg_header_t *header) {
+    uint16_t diff;
+
+    if (!header->ext) {
+        return;
+    }
+
+    if (!msg->seq_valid) {
+        msg->seq_valid = true;
+        msg->recv_seq = header->seq;
+        return;
+    }
+
+    diff = (uint16_t)(header->seq - msg->recv_seq);
+    if ((diff == 0) || (diff > UINT16_MAX - MSG_SEQ_REORDER_WINDOW)) {
+        /* 重复或者比最新的帧旧 */
+#if MSG_ENABLE_STATISTICS
+        ++msg->recv_reorder;
+#endif /* MSG_ENABLE_STATISTICS */
+        return;
+    }
+
+#if MSG_ENABLE_STATISTICS
+    if (diff <= UINT16_MAX / 2) {
+        msg->recv_lost += diff - 1U;
+    }
+#endif /* MSG_ENABLE_STATISTICS */
+    msg->recv_seq = header->seq;
+}
+
+#endif /* MSG_ENABLE_HEADER_EXT */
+
+/**
+ * @brief 记录最新一帧的信息, 在回调之前调用
+ *
+ * @param msg 消息实例
+ * @param header 帧头信息
+ */
+static void message_set_latest(struct msg_instance *msg,
+                               const msg_header_t *header) {
+#if !MSG_ENABLE_HEADER_EXT
+    UNUSED(header);
+#endif /* !MSG_ENABLE_HEADER_EXT */
+
+#if MSG_ENABLE_RTOS
+    /* 其他任务会读取 */
+    taskENTER_CRITICAL();
+#endif /* MSG_ENABLE_RTOS */
+    msg->latest.recv_time = HAL_GetTick();
+#if MSG_ENABLE_HEADER_EXT
+    msg->latest.ext = header->ext;
+    msg->latest.seq = header->seq;
+    msg->latest.send_time = header->send_time;
+#endif /* MSG_ENABLE_HEADER_EXT */
+    msg->latest_valid = true;
+#if MSG_ENABLE_RTOS
+    taskEXIT_CRITICAL();
+#endif /* MSG_ENABLE_RTOS */
+}
+
+/**
+ * @brief 按订阅顺序调用订阅者
+ *
+ * @param msg 消息实例
+ * @param header 帧头信息
+ * @param data 数据
+ */
+static void message_dispatch(struct msg_instance *msg,
+                             const msg_header_t *header, uint8_t *data) {
+    uint16_t type_bit = MSG_TYPE_MASK(header->id_type & 0x0FU);
+    msg_subscriber_t *sub;
+#if MSG_ENABLE_STATISTICS
+    uint32_t start;
+#endif /* MSG_ENABLE_STATISTICS */
 
-            ++msg->fifo_element_len;
+    for (uint32_t i = 0; i < msg->subscriber_num; ++i) {
+        sub = &msg->subscriber[i];
+        if ((sub->type_mask & type_bit) == 0) {
+            continue;
         }
 
 #if MSG_ENABLE_STATISTICS
-        if (msg->fifo_element_len > msg->max_fifo_element_len) {
-            msg->max_fifo_element_len = msg->fifo_element_len;
+        start = message_get_timestamp();
+#endif /* MSG_ENABLE_STATISTICS */
+
+        sub->callback(header->data_len, header->id_type, data);
+
+#if MSG_ENABLE_STATISTICS
+        ++sub->call_count;
+        sub->exec_time_us =
+            (message_get_timestamp() - start) / (SystemCoreClock / 1000000U);
+        if (sub->exec_time_us > sub->max_exec_time_us) {
+            sub->max_exec_time_us = sub->exec_time_us;
         }
 #endif /* MSG_ENABLE_STATISTICS */
     }
 }
 
 /**
- * @brief 消息数据出队并调用回调函数
+ * @brief 按帧头中的 ID 找到接收这一帧的消息实例
  *
- * @param msg 消息实例
+ * @param port 接收端口
+ * @param header 帧头信息
+ * @return 消息实例, ID 没有绑定到该串口时为默认 ID 的实例, 没有默认 ID 返回
+ *         `NULL`
+ */
+static struct msg_instance *message_rx_route(msg_rx_port_t *port,
+                                             const msg_header_t *header) {
+    struct msg_instance *msg = NULL;
+
+    if (header->msg_id < MSG_ID_RESERVE_LEN) {
+        msg = msg_list[header->msg_id];
+    }
+
+    if ((msg != NULL) && (msg->rx_port == port)) {
+        return msg;
+    }
+
+#if MSG_ENABLE_STATISTICS
+    ++port->recv_unknown;
+    if (port->fallback != NULL) {
+        ++port->recv_fallback;
+    }
+#endif /* MSG_ENABLE_STATISTICS */
+
+    return port->fallback;
+}
+
+/**
+ * @brief 消息数据出队, 按 ID 分发并调用回调函数
+ *
+ * @param port 接收端口
+ * @return 回调的帧数
  */
-static void message_data_dequeue(struct msg_instance *msg) {
-    if (msg->fifo_element_len == 0) {
+static uint32_t message_data_dequeue(msg_rx_port_t *port) {
+    if (port->fifo_element_len == 0) {
         /* 队列中没有元素 */
-        return;
+        return 0;
     }
 
-    msg_fifo_t *fifo = msg->fifo;
-    uint8_t frame_len;
-    /* 回调消息 ID & type */
-    uint8_t call_id_type;
-    /* 回调消息数据 */
-    uint8_t *call_data;
-    /* 回调消息长度 */
-    uint32_t call_len;
-    /* 实际在缓冲区的位置指针 */
-    uint32_t head, tail;
+    msg_fifo_t *fifo = port->fifo;
+    struct msg_instance *msg;
+    uint32_t frame_len;
+    /* 实际在缓冲区的位置指针, 帧在镜像区的保证下是连续的 */
+    uint8_t *frame;
+    /* 帧头和数据长度, CRC 长度 */
+    uint32_t body_len, crc_len;
+    msg_header_t header;
+    uint32_t recv_count = 0;
+    /* 是否有只回调最新帧的 ID 还没回调 */
+    bool pending = false;
 
     /* 队空条件: head == tail */
     while (fifo->head != fifo->tail) {
         /* 头存储的是帧长度 */
-        frame_len = fifo->buf[fifo->head & fifo->mask];
+        frame_len = msg_fifo_get_len(fifo, fifo->head);
         if (frame_len == 0) {
             /* 最后一帧还没存完, 存完才会写长度, 已经结束了, 跳出循环 */
             break;
@@ -417,64 +2606,115 @@ static void message_data_dequeue(struct msg_instance *msg) {
         if (fifo->head > fifo->tail) {
             /* 正常不可能头比尾还大 */
 #if MSG_ENABLE_STATISTICS
-            ++msg->recv_error;
+            ++port->recv_error;
 #endif /* MSG_ENABLE_STATISTICS */
             break;
         }
 
-        head = fifo->head & fifo->mask;
-        tail = (fifo->head + frame_len) & fifo->mask;
+        frame = &fifo->buf[fifo->head & fifo->mask] + MSG_FIFO_LEN_SIZE;
+
+        /* 先出队, 下面处理这一帧的过程中不会再入队, 数据不会被覆盖 */
+        fifo->head += frame_len;
+        --port->fifo_element_len;
 
-        /* 验证数据包长度与实际接收长度是否一致, 数据包第二个字节是长度
-         * 1 byte 标识, 1 byte 长度, 1 byte 结束符, 1 byte FIFO 元素大小
-         * 总共 4 byte. */
-        if ((frame_len - 4) != fifo->buf[(fifo->head + 2) & fifo->mask]) {
+        /* 验证帧头中的长度与实际接收长度是否一致, 去掉 FIFO 元素大小和
+         * 1 byte 结束符, 多出来的是 CRC */
+        body_len = frame_len - MSG_FIFO_LEN_SIZE - 1;
+        if (!message_parse_header(frame, body_len, &header) ||
+            (body_len < header.header_len + header.data_len)) {
             /* 不一致, 出队到下一个 */
-            fifo->head += frame_len;
-            --msg->fifo_element_len;
 #if MSG_ENABLE_STATISTICS
-            ++msg->recv_error;
+            ++port->recv_error;
 #endif /* MSG_ENABLE_STATISTICS */
             continue;
         }
 
-        if (tail < head) {
-            /* 数据在头尾, 分成两段, 直接复制到`recv_buf` (下一次读取就覆盖了) */
-            if (frame_len <= msg->recv_buf_size) {
-                /* 复制前半段 */
-                memcpy(msg->recv_buf, &fifo->buf[head], fifo->size - head);
-                /* 复制后半段 */
-                memcpy(&msg->recv_buf[fifo->size - head], &fifo->buf[0], tail);
-                call_id_type = msg->recv_buf[1];
-                call_len = frame_len - 4;
-                call_data = &msg->recv_buf[3];
-            } else {
-                /* 空间不够, 不复制, 出队到下一个 */
-                fifo->head += frame_len;
-                --msg->fifo_element_len;
+        crc_len = body_len - header.header_len - header.data_len;
+
+#if MSG_ENABLE_CRC
+        /* 先校验再分发, 帧头中的 ID 出错时不会送到其他 ID */
+        if (header.crc &&
+            !message_crc_check(frame, header.header_len + header.data_len,
+                               crc_len)) {
 #if MSG_ENABLE_STATISTICS
-                ++msg->recv_error;
+            ++port->recv_crc_error;
 #endif /* MSG_ENABLE_STATISTICS */
-                continue;
+            continue;
+        }
+
+        if (!header.crc && (crc_len != 0)) {
+#else  /* MSG_ENABLE_CRC */
+        if (crc_len != 0) {
+#endif /* MSG_ENABLE_CRC */
+#if MSG_ENABLE_STATISTICS
+            ++port->recv_error;
+#endif /* MSG_ENABLE_STATISTICS */
+            continue;
+        }
+
+        msg = message_rx_route(port, &header);
+        if (msg == NULL) {
+            continue;
+        }
+
+#if MSG_ENABLE_CRC
+        if (header.crc) {
+            msg->crc_peer = true;
+        } else if (message_crc_active(msg)) {
+            /* 要求 CRC 但是没有带 */
+#if MSG_ENABLE_STATISTICS
+            ++msg->recv_error;
+#endif /* MSG_ENABLE_STATISTICS */
+            continue;
+        }
+#endif /* MSG_ENABLE_CRC */
+
+#if MSG_ENABLE_HEADER_EXT
+        message_seq_check(msg, &header);
+#endif /* MSG_ENABLE_HEADER_EXT */
+
+        if (msg->fifo_policy == MSG_FIFO_LATEST_ONLY) {
+            /* 先记下来, 后面还有有效帧就跳过这一帧 */
+#if MSG_ENABLE_STATISTICS
+            if (msg->pending != NULL) {
+                ++msg->recv_superseded;
             }
+#endif /* MSG_ENABLE_STATISTICS */
+            msg->pending = &frame[header.header_len];
+            msg->pending_header = header;
+            pending = true;
         } else {
-            /* 完整的一帧没有被截断 */
-            call_id_type = fifo->buf[(fifo->head + 1) & fifo->mask];
-            call_len = fifo->buf[(fifo->head + 2) & fifo->mask];
-            call_data = &fifo->buf[(fifo->head + 3) & fifo->mask];
+            message_set_latest(msg, &header);
+            message_dispatch(msg, &header, &frame[header.header_len]);
+            ++recv_count;
+#if MSG_ENABLE_STATISTICS
+            ++msg->recv_success;
+#endif /* MSG_ENABLE_STATISTICS */
         }
+    }
+
+    if (!pending) {
+        return recv_count;
+    }
 
-        if (msg->recv_callback) {
-            msg->recv_callback(call_len, call_id_type, call_data);
+    /* 已经出队, 但是下次入队前数据不会被覆盖 */
+    for (msg_id_t i = 0; i < MSG_ID_RESERVE_LEN; ++i) {
+        msg = msg_list[i];
+        if ((msg == NULL) || (msg->rx_port != port) ||
+            (msg->pending == NULL)) {
+            continue;
         }
+
+        message_set_latest(msg, &msg->pending_header);
+        message_dispatch(msg, &msg->pending_header, msg->pending);
+        msg->pending = NULL;
+        ++recv_count;
 #if MSG_ENABLE_STATISTICS
         ++msg->recv_success;
 #endif /* MSG_ENABLE_STATISTICS */
-
-        /* 出队到下一个 */
-        fifo->head += frame_len;
-        --msg->fifo_element_len;
     }
+
+    return recv_count;
 }
 
 /**
@@ -484,15 +2724,22 @@ static void message_data_dequeue(struct msg_instance *msg) {
  * @return 消息队列
  */
 static msg_fifo_t *msg_fifo_init(uint32_t fifo_size) {
-    msg_fifo_t *fifo = (msg_fifo_t *)MSG_MALLOC(sizeof(msg_fifo_t) + fifo_size);
+    /* 镜像区最多需要一个最长的队列元素 */
+    uint32_t mirror_len = (fifo_size < MSG_FIFO_ELEMENT_MAX_LEN)
+                              ? fifo_size
+                              : MSG_FIFO_ELEMENT_MAX_LEN;
+    msg_fifo_t *fifo = (msg_fifo_t *)MSG_MALLOC(sizeof(msg_fifo_t) +
+                                                fifo_size + mirror_len);
     if (fifo == NULL) {
         return NULL;
     }
 
     fifo->size = fifo_size;
     fifo->mask = fifo_size - 1;
+    fifo->mirror_len = mirror_len;
     fifo->head = 0;
     fifo->tail = 0;
+    fifo->frame_len = 0;
     fifo->new_frame = true;
 
     return fifo;
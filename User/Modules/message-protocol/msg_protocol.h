@@ -2,12 +2,12 @@
  * @file    msg_protocol.h
  * @author  Deadline039
  * @brief   消息协议
- * @version 2.3
- * @date    2024-03-01
+ * @version 3.7
+ * @date    2026-10-17
  *
  *****************************************************************************
  *                             ##### 如何使用 ####
- * (#) 在`msg_id_t`枚举中添加要使用的数据通信类型
+ * (#) 在`MSG_ID_TABLE`中添加要使用的数据通信类型以及最大发送数据长度
  *
  * (#) 发送
  *      (##) 调用`message_register_send_uart`注册串口消息通讯句柄, 发送将会
@@ -17,16 +17,33 @@
  *      (##) `message_send_data`函数需要指定消息 ID (`msg_id_t`), 消息数据
  *           类型 (`msg_type_t), `data`(数据指针, 也就是要发送的数据), 
  *           以及`data_len`, 数据长度
+ *      (##) 可以调用`message_set_crc`为消息 ID 加上 CRC 校验, 收发共用设置
  * (#) 接收
- *      (##) 调用`message_register_polling_uart`添加消息 ID 对应的轮询串口
+ *      (##) 调用`message_register_polling_uart`添加消息 ID 对应的轮询串口.
+ *           多个 ID 可以注册同一个串口, 共用一个接收队列, 按帧头中的 ID 分发.
+ *           按其他 ID 发送的旧对端用`message_set_rx_default`指定默认 ID
  *      (##) 调用`message_register_recv_callback`注册接收回调函数, 当收到消息
  *           以后会调用回调函数.
+ *      (##) 多个模块都要接收同一个 ID 时调用`message_subscribe`添加订阅者,
+ *           按订阅顺序调用, 可以按数据类型过滤
  *      (##) 需要持续调用`message_polling_data`来轮询消息, 可以放到 RTOS 的一个任
  *           务或者定时器里. 当收到消息后根据`msg_id_t`来调用相应的回调函数
  *      (##) 回调函数参数形式必须是void func(uint32_t, uint8_t, uint8_t*)
  *           第一个参数是消息长度, 第二个参数是消息标识 (高四位是 ID, 低四位是数据类型)
- *           第三个参数是数据区内容, 无返回值
+ *           第三个参数是数据区内容, 无返回值. 数据区指针直接指向接收队列,
+ *           仅在回调期间有效, 需要保存的数据请在回调内复制出来
  *      (##) `message_polling_data`仅支持DMA接收
+ *      (##) 接收队列满时默认丢弃最旧的完整帧, 状态类消息可以调用
+ *           `message_set_fifo_policy`设置只回调最新的一帧
+ *      (##) `message_get_latest_age`返回最新一帧到现在的时间, 可以用来判断
+ *           数据是否过时. `message_get_frame_info`返回最新一帧的序号和发送
+ *           时间戳 (对端用`message_set_header_ext`打开扩展帧头)
+ *      (##) 使用 RTOS 时可以在任务中循环调用`message_polling_wait`, 串口收到
+ *           数据后中断会唤醒任务立即处理, 串口中断优先级需要能调用 FreeRTOS
+ *           的 FromISR 函数
+ *      (##) 启用`MSG_ENABLE_CAPTURE`后调用`message_capture_enable`打开抓包,
+ *           接收到的原始数据会带时间戳存进抓包缓冲区, 在轮询任务中调用
+ *           `message_capture_dump`通过 RTT 导出
  ******************************************************************************
  *    Date    | Version |   Author    | Version Info
  * -----------+---------+-------------+----------------------------------------
@@ -35,6 +52,21 @@
  * 2025-04-20 |   2.1   | Deadline039 | 添加转义
  * 2025-04-26 |   2.2   | Deadline039 | 修复缩容扩容错误
  * 2025-05-10 |   2.3   | Deadline039 | 改用环形队列接收消息
+ * 2026-10-17 |   2.4   | agent       | 队列尾部镜像, 跨尾帧回调不再复制
+ * 2026-10-17 |   2.5   | agent       | 接收中断唤醒轮询任务, 统计接收延迟
+ * 2026-10-17 |   2.6   | agent       | 静态发送缓冲区, 发送时不再申请内存
+ * 2026-10-17 |   2.7   | agent       | 添加可选 CRC 校验
+ * 2026-10-17 |   2.8   | agent       | 添加无锁发送队列, 发送不再等待串口
+ * 2026-10-17 |   2.9   | agent       | 添加合并发送
+ * 2026-10-17 |   2.10  | agent       | 添加可选 COBS 编码
+ * 2026-10-17 |   3.0   | agent       | v3 帧头, 一字节 ID, 变长数据长度
+ * 2026-10-17 |   3.1   | agent       | 接收队列溢出丢弃最旧帧, 只保留最新帧
+ * 2026-10-17 |   3.2   | agent       | 扩展帧头, 序号和发送时间戳
+ * 2026-10-17 |   3.3   | agent       | 每个 ID 多个订阅者, 按数据类型过滤
+ * 2026-10-17 |   3.4   | agent       | 每个串口一个解析器, 按帧头 ID 分发
+ * 2026-10-17 |   3.5   | agent       | 接收抓包, 通过 RTT 导出
+ * 2026-10-17 |   3.6   | agent       | 直接在串口 DMA 缓冲区中解析
+ * 2026-10-17 |   3.7   | agent       | 接收串口默认 ID, 兼容按其他 ID 发送的对端
  */
 
 #ifndef __MSG_PROTOCOL_H
@@ -42,12 +74,33 @@
 
 #include <bsp.h>
 
+#include <stdbool.h>
 #include <stdlib.h>
 
+/* COBS 编码, 启用后用 COBS 编码代替结束符和转义, 帧之间用 0x00 分隔, 每
+ * 254 字节最多多 1 字节开销, 收发双方必须一致 */
+#define MSG_ENABLE_COBS       0
+
 /* 帧结束标志 (End Of Frame), 注意需要避开数据头标识和长度 */
 #define MSG_EOF               0x7F
+#if !MSG_ENABLE_COBS
 /* 转义标识 (Escape), 注意需要避开头标识和长度 */
 #define MSG_ESC               0x8F
+#endif /* !MSG_ENABLE_COBS */
+
+/* v3 帧头, 启用后消息 ID 用一个字节, 数据长度用变长编码, 数据可以超过
+ * 255 字节. 能用 v2 帧头的帧仍然按 v2 发送, 接收时自动识别两种帧头 */
+#define MSG_ENABLE_V3         1
+/* 扩展帧头, 需要启用 v3. 启用后可以用`message_set_header_ext`让 ID 发送时
+ * 带上序号和发送时间戳, 接收端统计丢帧, 乱序 */
+#define MSG_ENABLE_HEADER_EXT (1 && MSG_ENABLE_V3)
+
+/* 最大数据长度, 启用 v3 时不能超过 16383 (两字节变长编码) */
+#if MSG_ENABLE_V3
+#define MSG_DATA_MAX_LEN      4096U
+#else /* MSG_ENABLE_V3 */
+#define MSG_DATA_MAX_LEN      255U
+#endif /* MSG_ENABLE_V3 */
 
 /* 线程安全处理, 启用后会使用互斥信号量来管理全局变量, 仅支持 FreeRTOS. */
 #define MSG_ENABLE_RTOS       1
@@ -55,22 +108,137 @@
 /* 始能统计, 启用后统计接收成功错误计数, 队列最大深度等信息 */
 #define MSG_ENABLE_STATISTICS 1
 
+/* CRC 校验, 启用后可以为每个 ID 单独设置 CRC 校验, 见`message_set_crc` */
+#define MSG_ENABLE_CRC        1
+
+/* 发送队列, 启用后每个串口一个无锁发送队列, 发送只编码入队不等待串口, 由
+ * DMA 发送完成中断接着发送下一帧. 启用后`MSG_SEND_BUF_STATIC`无效 */
+#define MSG_ENABLE_TX_QUEUE   1
+/* 发送队列长度 (帧数), 必须是 2 的幂次方 */
+#define MSG_TX_QUEUE_LEN      8
+
+/* 合并发送, 需要启用发送队列和 RTOS. 启用后可以用`message_set_tx_batch`让
+ * 串口在一个发送窗口内的帧合并成一次 DMA 发送 */
+#define MSG_ENABLE_TX_BATCH   (1 && MSG_ENABLE_TX_QUEUE && MSG_ENABLE_RTOS)
+
+/* 静态发送缓冲区, 启用后每个 ID 按`MSG_ID_TABLE`中的最大数据长度静态分配
+ * 发送缓冲区 (按全部转义计算), 发送时不再扩容缩容 */
+#define MSG_SEND_BUF_STATIC   1
+
+/* 接收抓包, 启用后把每个接收串口收到的原始数据带时间戳存进环形缓冲区,
+ * 满了丢弃最旧的记录, 可以用`message_capture_dump`通过 RTT 导出. 占用
+ * `MSG_CAPTURE_BUF_SIZE`加 1K RTT 缓冲区的内存, 调试时再打开 */
+#define MSG_ENABLE_CAPTURE    0
+/* 抓包缓冲区大小, 必须是 2 的幂次方 */
+#define MSG_CAPTURE_BUF_SIZE  4096U
+/* 导出用的 RTT 通道, 0 是终端, 1 是 SystemView */
+#define MSG_CAPTURE_RTT_CH    2
+
+/* 每个 ID 最多订阅者个数, 静态分配 */
+#define MSG_SUBSCRIBER_MAX    4
+
 /* 内存分配相关 */
 #define MSG_MALLOC(x)         malloc(x)
 #define MSG_REALLOC(p, x)     realloc(p, x)
 #define MSG_FREE(p)           free(p)
 
+/**
+ * @brief 消息 ID 表, 格式为 X(消息 ID, 最大发送数据长度)
+ * @note 最大数据长度不能超过`MSG_DATA_MAX_LEN`. 不启用 v3 时消息 ID 只有 4 位.
+ *       发送队列每一格和接收队列的镜像区都按表中最长的数据分配, 加入很长
+ *       的 ID 会让每个串口都多占内存. 主机测试在包含本文件前定义自己的表
+ */
+#ifndef MSG_ID_TABLE
+#define MSG_ID_TABLE(X)                                                        \
+    X(MSG_REMOTE, 16)                                                          \
+    X(MSG_TO_SLAVE, 32)                                                        \
+    X(MSG_NUC, 32)                                                             \
+    X(MSG_RPC, 64)
+#endif /* MSG_ID_TABLE */
+
 /**
  * @brief 数据含义
  */
 typedef enum {
-    MSG_REMOTE,
-    MSG_TO_SLAVE,
-    MSG_NUC,
+#define MSG_ID_ENUM(id, max_len) id,
+    MSG_ID_TABLE(MSG_ID_ENUM)
+#undef MSG_ID_ENUM
 
     MSG_ID_RESERVE_LEN /*!< 保留位, 用于定义数据长度 */
 } msg_id_t;
 
+#if MSG_ENABLE_V3
+/* 标识字节低四位为该值说明是 v3 帧头, 数据类型不能使用该值 */
+#define MSG_V3_MARK                 0x0FU
+#if MSG_ENABLE_HEADER_EXT
+/* v3 帧头标识字节中的扩展标志, 置位说明长度后面是 2 byte 序号和 4 byte 发送
+ * 时间戳 (ms), 都是小端 */
+#define MSG_EXT_FLAG                0x10U
+/* 帧头最大长度: 1 byte 标识, 1 byte ID, 1 byte 类型, 2 byte 长度, 6 byte 扩展 */
+#define MSG_HEADER_MAX_LEN          11U
+#else /* MSG_ENABLE_HEADER_EXT */
+/* 帧头最大长度: 1 byte 标识, 1 byte ID, 1 byte 类型, 2 byte 长度 */
+#define MSG_HEADER_MAX_LEN          5U
+#endif /* MSG_ENABLE_HEADER_EXT */
+#else  /* MSG_ENABLE_V3 */
+/* 帧头长度: 1 byte 标识, 1 byte 长度 */
+#define MSG_HEADER_MAX_LEN          2U
+#endif /* MSG_ENABLE_V3 */
+
+#if MSG_ENABLE_CRC
+/* 标识字节最高位为 CRC 标志, 置位说明数据后面带有 CRC, v2 帧头消息 ID 只能
+ * 用 3 位 */
+#define MSG_CRC_FLAG                0x80U
+/* CRC 最大长度 */
+#define MSG_CRC_MAX_LEN             4U
+#else /* MSG_ENABLE_CRC */
+#define MSG_CRC_MAX_LEN             0U
+#endif /* MSG_ENABLE_CRC */
+
+/* 一帧最大长度: 帧头, 数据和 CRC (最坏每个字节都转义), 1 byte 结束符.
+ * COBS 编码每 254 字节加 1 byte 码字, 最后 1 byte 分隔符 */
+#if MSG_ENABLE_COBS
+#define MSG_FRAME_MAX_LEN(data_len)                                            \
+    (2U + MSG_HEADER_MAX_LEN + (data_len) + MSG_CRC_MAX_LEN +                  \
+     (MSG_HEADER_MAX_LEN + (data_len) + MSG_CRC_MAX_LEN) / 254U)
+#elif defined(MSG_ESC)
+#define MSG_FRAME_MAX_LEN(data_len)                                            \
+    (1U + 2U * (MSG_HEADER_MAX_LEN + (data_len) + MSG_CRC_MAX_LEN))
+#else /* MSG_ENABLE_COBS */
+#define MSG_FRAME_MAX_LEN(data_len)                                            \
+    (1U + MSG_HEADER_MAX_LEN + (data_len) + MSG_CRC_MAX_LEN)
+#endif /* MSG_ENABLE_COBS */
+
+/**
+ * @brief CRC 校验类型
+ */
+typedef enum {
+    MSG_CRC_NONE, /*!< 不校验 */
+    MSG_CRC_16,   /*!< CRC-16/CCITT-FALSE */
+    MSG_CRC_32    /*!< CRC-32/MPEG-2, 与 STM32 硬件 CRC 一致 */
+} msg_crc_t;
+
+/**
+ * @brief 接收队列策略
+ */
+typedef enum {
+    MSG_FIFO_DROP_OLDEST, /*!< 队列满时丢弃最旧的完整帧 (默认) */
+    MSG_FIFO_RESET,       /*!< 队列满时清空队列, 3.0 及以前的行为 */
+    MSG_FIFO_LATEST_ONLY  /*!< 每次轮询只回调最新的一帧, 适合状态类消息 */
+} msg_fifo_policy_t;
+
+/**
+ * @brief 最新一帧的信息
+ */
+typedef struct {
+    uint32_t recv_time; /*!< 本地接收时间 (ms) */
+#if MSG_ENABLE_HEADER_EXT
+    bool ext;           /*!< 是否带扩展帧头, 不带时下面两项无效 */
+    uint16_t seq;       /*!< 序号 */
+    uint32_t send_time; /*!< 发送端时间戳 (ms), 发送端时钟 */
+#endif                  /* MSG_ENABLE_HEADER_EXT */
+} msg_frame_info_t;
+
 /**
  * @brief 数据类型
  */
@@ -87,7 +255,7 @@ typedef enum {
     MSG_DATA_FP64,
     MSG_DATA_STRING,
     MSG_DATA_CUSTOM, /*!< 自定义数据类型 */
-    /*!< 可以在下面加自定义的数据类型 */
+    /*!< 可以在下面加自定义的数据类型, 不能超过 0x0E, 0x0F 保留给 v3 帧头 */
 
 } msg_type_t;
 
@@ -95,23 +263,59 @@ typedef enum {
  * @brief 回调函数指针定义
  *
  * @param msg_length 消息帧长度
- * @param msg_id_type 消息 ID 和数据类型 (高四位为 ID, 低四位为数据类型)
+ * @param msg_id_type 消息 ID 和数据类型 (高四位为 ID, 低四位为数据类型),
+ *                    v3 帧的 ID 超过 4 位时只保留低 4 位
  * @param[in] msg_data 消息数据接收区
  */
 typedef void (*msg_recv_callback_t)(uint32_t /* msg_length */,
                                     uint8_t /* msg_id_type */,
                                     uint8_t * /* msg_data */);
 
+/* 订阅数据类型掩码, 第 n 位对应数据类型 n */
+#define MSG_TYPE_MASK(type) ((uint16_t)(1U << (type)))
+/* 订阅所有数据类型 */
+#define MSG_TYPE_MASK_ALL   0xFFFFU
+
 void message_register_send_uart(msg_id_t msg_id, UART_HandleTypeDef *huart,
                                 uint32_t buf_size);
 void message_register_recv_callback(msg_id_t msg_id,
                                     msg_recv_callback_t msg_callback);
+uint8_t message_subscribe(msg_id_t msg_id, msg_recv_callback_t msg_callback,
+                          uint16_t type_mask);
+uint8_t message_unsubscribe(msg_id_t msg_id, msg_recv_callback_t msg_callback);
 void message_register_polling_uart(msg_id_t msg_id, UART_HandleTypeDef *huart,
                                    uint32_t buf_size, uint32_t fifo_size);
 
-void message_send_data(msg_id_t msg_id, msg_type_t data_type, uint8_t *data,
-                       uint32_t data_len);
+void message_set_rx_default(msg_id_t msg_id, bool enable);
+void message_set_fifo_policy(msg_id_t msg_id, msg_fifo_policy_t policy);
+
+#if MSG_ENABLE_CRC
+void message_set_crc(msg_id_t msg_id, msg_crc_t crc, bool negotiate);
+#endif /* MSG_ENABLE_CRC */
+
+#if MSG_ENABLE_HEADER_EXT
+void message_set_header_ext(msg_id_t msg_id, bool enable);
+#endif /* MSG_ENABLE_HEADER_EXT */
+
+uint32_t message_get_latest_age(msg_id_t msg_id);
+uint8_t message_get_frame_info(msg_id_t msg_id, msg_frame_info_t *info);
+
+#if MSG_ENABLE_TX_BATCH
+uint8_t message_set_tx_batch(UART_HandleTypeDef *huart, uint32_t window,
+                             uint32_t buf_size);
+#endif /* MSG_ENABLE_TX_BATCH */
+
+uint8_t message_send_data(msg_id_t msg_id, msg_type_t data_type,
+                          uint8_t *data, uint32_t data_len);
 
 void message_polling_data(void);
 
+#if MSG_ENABLE_CAPTURE
+void message_capture_enable(bool enable);
+uint32_t message_capture_dump(void);
+#endif /* MSG_ENABLE_CAPTURE */
+#if MSG_ENABLE_RTOS
+void message_polling_wait(uint32_t timeout);
+#endif /* MSG_ENABLE_RTOS */
+
 #endif /* __MSG_PROTOCOL_H */
@@ -0,0 +1,357 @@
+/**
+ * @file    msg_rpc.c
+ * @author  agent
+ * @brief   基于消息协议的请求/响应调用
+ * @version 1.0
+ * @date    2026-10-17
+ */
+
+#include "msg_rpc.h"
+
+#include <string.h>
+
+#if MSG_ENABLE_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#endif /* MSG_ENABLE_RTOS */
+
+/* 帧头加上最长的参数不能超过`MSG_RPC`声明的最大数据长度 */
+#define MSG_RPC_LEN_CHECK(id, max_len)                                         \
+    typedef char id##_rpc_len_check                                            \
+        [((id) != MSG_RPC) ||                                                  \
+                 (MSG_RPC_HEADER_LEN + MSG_RPC_DATA_MAX_LEN <= (max_len))      \
+             ? 1                                                               \
+             : -1];
+MSG_ID_TABLE(MSG_RPC_LEN_CHECK)
+#undef MSG_RPC_LEN_CHECK
+
+/**
+ * @brief 帧类型
+ */
+typedef enum {
+    MSG_RPC_REQUEST = 0x00U, /*!< 请求 */
+    MSG_RPC_RESPONSE = 0x01U /*!< 响应 */
+} msg_rpc_kind_t;
+
+/**
+ * @brief 等待响应的请求
+ */
+typedef struct {
+    bool used;           /*!< 是否在等待 */
+    uint16_t seq;        /*!< 序号 */
+    uint8_t method;      /*!< 方法 */
+    uint32_t start_time; /*!< 发送时间 (ms) */
+    uint32_t timeout;    /*!< 超时时间 (ms) */
+    msg_rpc_done_t done; /*!< 完成回调 */
+    void *user_data;     /*!< 用户数据 */
+} msg_rpc_pending_t;
+
+/* 方法表, 下标为方法 ID */
+static msg_rpc_method_t msg_rpc_method[MSG_RPC_METHOD_MAX];
+
+/* 等待响应的请求, 调用端任务和轮询任务都会访问 */
+static msg_rpc_pending_t msg_rpc_pending[MSG_RPC_PENDING_MAX];
+
+/* 下一个请求的序号 */
+static uint16_t msg_rpc_seq;
+
+/* 响应发送缓冲区, 只在轮询任务中使用 */
+static uint8_t msg_rpc_ret_buf[MSG_RPC_HEADER_LEN + MSG_RPC_DATA_MAX_LEN];
+
+#if MSG_ENABLE_STATISTICS
+msg_rpc_stat_t msg_rpc_stat;
+#endif /* MSG_ENABLE_STATISTICS */
+
+/**
+ * @brief 进入临界区, 保护等待表
+ */
+static inline void message_rpc_lock(void) {
+#if MSG_ENABLE_RTOS
+    taskENTER_CRITICAL();
+#endif /* MSG_ENABLE_RTOS */
+}
+
+/**
+ * @brief 退出临界区
+ */
+static inline void message_rpc_unlock(void) {
+#if MSG_ENABLE_RTOS
+    taskEXIT_CRITICAL();
+#endif /* MSG_ENABLE_RTOS */
+}
+
+/**
+ * @brief 填充 RPC 帧头
+ *
+ * @param[out] buf 缓冲区
+ * @param kind 帧类型
+ * @param seq 序号
+ * @param method 方法
+ * @param status 状态, 请求为 0
+ */
+static void message_rpc_put_header(uint8_t *buf, msg_rpc_kind_t kind,
+                                   uint16_t seq, uint8_t method,
+                                   uint8_t status) {
+    buf[0] = (uint8_t)kind;
+    buf[1] = (uint8_t)seq;
+    buf[2] = (uint8_t)(seq >> 8);
+    buf[3] = method;
+    buf[4] = status;
+}
+
+/**
+ * @brief 处理请求, 调用方法并发送响应
+ *
+ * @param seq 序号
+ * @param method 方法
+ * @param args 参数
+ * @param args_len 参数长度
+ */
+static void message_rpc_serve(uint16_t seq, uint8_t method, const uint8_t *args,
+                              uint32_t args_len) {
+    uint32_t ret_len = 0;
+    uint8_t status = MSG_RPC_ERR_METHOD;
+
+    if ((method < MSG_RPC_METHOD_MAX) && (msg_rpc_method[method] != NULL)) {
+        status = msg_rpc_method[method](
+            args, args_len, &msg_rpc_ret_buf[MSG_RPC_HEADER_LEN], &ret_len);
+        if (ret_len > MSG_RPC_DATA_MAX_LEN) {
+            /* 方法写越界了, 不发送返回值 */
+            ret_len = 0;
+            status = MSG_RPC_ERR_ARGS;
+        }
+    }
+
+    message_rpc_put_header(msg_rpc_ret_buf, MSG_RPC_RESPONSE, seq, method,
+                           status);
+    message_send_data(MSG_RPC, MSG_DATA_CUSTOM, msg_rpc_ret_buf,
+                      MSG_RPC_HEADER_LEN + ret_len);
+
+#if MSG_ENABLE_STATISTICS
+    ++msg_rpc_stat.serve_count;
+#endif /* MSG_ENABLE_STATISTICS */
+}
+
+/**
+ * @brief 处理响应, 找到对应的请求并调用完成回调
+ *
+ * @param seq 序号
+ * @param method 方法
+ * @param status 调用状态
+ * @param ret 返回值
+ * @param ret_len 返回值长度
+ */
+static void message_rpc_complete(uint16_t seq, uint8_t method, uint8_t status,
+                                 const uint8_t *ret, uint32_t ret_len) {
+    msg_rpc_pending_t pending = {.used = false};
+
+    message_rpc_lock();
+    for (uint32_t i = 0; i < MSG_RPC_PENDING_MAX; ++i) {
+        if (msg_rpc_pending[i].used && (msg_rpc_pending[i].seq == seq) &&
+            (msg_rpc_pending[i].method == method)) {
+            pending = msg_rpc_pending[i];
+            msg_rpc_pending[i].used = false;
+            break;
+        }
+    }
+    message_rpc_unlock();
+
+    if (!pending.used) {
+        /* 已经超时或者不是本端发出的请求 */
+#if MSG_ENABLE_STATISTICS
+        ++msg_rpc_stat.unknown_count;
+#endif /* MSG_ENABLE_STATISTICS */
+        return;
+    }
+
+#if MSG_ENABLE_STATISTICS
+    ++msg_rpc_stat.done_count;
+    msg_rpc_stat.rtt_ms = HAL_GetTick() - pending.start_time;
+    if (msg_rpc_stat.rtt_ms > msg_rpc_stat.max_rtt_ms) {
+        msg_rpc_stat.max_rtt_ms = msg_rpc_stat.rtt_ms;
+    }
+#endif /* MSG_ENABLE_STATISTICS */
+
+    if (pending.done != NULL) {
+        pending.done(status, ret, ret_len, pending.user_data);
+    }
+}
+
+/**
+ * @brief `MSG_RPC`接收回调
+ *
+ * @param msg_length 消息帧长度
+ * @param msg_id_type 消息 ID 和数据类型
+ * @param[in] msg_data 消息数据接收区
+ */
+static void message_rpc_recv(uint32_t msg_length, uint8_t msg_id_type,
+                             uint8_t *msg_data) {
+    UNUSED(msg_id_type);
+
+    if (msg_length < MSG_RPC_HEADER_LEN) {
+        return;
+    }
+
+    uint16_t seq = (uint16_t)(msg_data[1] | (msg_data[2] << 8));
+    uint8_t method = msg_data[3];
+
+    switch (msg_data[0]) {
+        case MSG_RPC_REQUEST: {
+            message_rpc_serve(seq, method, &msg_data[MSG_RPC_HEADER_LEN],
+                              msg_length - MSG_RPC_HEADER_LEN);
+        } break;
+
+        case MSG_RPC_RESPONSE: {
+            message_rpc_complete(seq, method, msg_data[4],
+                                 &msg_data[MSG_RPC_HEADER_LEN],
+                                 msg_length - MSG_RPC_HEADER_LEN);
+        } break;
+
+        default: {
+        } break;
+    }
+}
+
+/**
+ * @brief 初始化, 订阅`MSG_RPC`
+ *
+ * @return 初始化状态:
+ * @retval - 0: 成功
+ * @retval - 1: 订阅失败, 内存不足或者订阅者已满
+ * @note 请求和响应使用同一个消息 ID, 两端都可以既调用又被调用
+ */
+uint8_t message_rpc_init(void) {
+    if (message_subscribe(MSG_RPC, message_rpc_recv,
+                          MSG_TYPE_MASK(MSG_DATA_CUSTOM)) != 0) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 注册方法
+ *
+ * @param method 方法 ID
+ * @param handler 方法, `NULL`为取消注册
+ * @return 注册状态:
+ * @retval - 0: 成功
+ * @retval - 1: 方法 ID 超出范围
+ */
+uint8_t message_rpc_register(uint8_t method, msg_rpc_method_t handler) {
+    if (method >= MSG_RPC_METHOD_MAX) {
+        return 1;
+    }
+
+    msg_rpc_method[method] = handler;
+    return 0;
+}
+
+/**
+ * @brief 发送请求, 不等待响应
+ *
+ * @param method 方法 ID
+ * @param args 参数, 可以为`NULL`
+ * @param args_len 参数长度, 不超过`MSG_RPC_DATA_MAX_LEN`
+ * @param timeout 超时时间 (ms)
+ * @param done 完成回调, 收到响应或者超时时在轮询任务中调用. `NULL`为不关心
+ *             结果, 不占用等待表
+ * @param user_data 传给完成回调的用户数据
+ * @return 调用状态:
+ * @retval - 0: 成功, 请求已发出
+ * @retval - 1: 参数错误
+ * @retval - 2: 等待响应的请求已满
+ * @retval - 3: 发送失败, 不会调用完成回调
+ * @note 可以在任意任务中调用, 不能在中断中调用
+ */
+uint8_t message_rpc_call(uint8_t method, const uint8_t *args, uint32_t args_len,
+                         uint32_t timeout, msg_rpc_done_t done,
+                         void *user_data) {
+    uint8_t buf[MSG_RPC_HEADER_LEN + MSG_RPC_DATA_MAX_LEN];
+    msg_rpc_pending_t *pending = NULL;
+    uint16_t seq;
+
+    if ((args_len > MSG_RPC_DATA_MAX_LEN) ||
+        ((args == NULL) && (args_len != 0))) {
+        return 1;
+    }
+
+    message_rpc_lock();
+    seq = msg_rpc_seq++;
+    if (done != NULL) {
+        for (uint32_t i = 0; i < MSG_RPC_PENDING_MAX; ++i) {
+            if (!msg_rpc_pending[i].used) {
+                pending = &msg_rpc_pending[i];
+                break;
+            }
+        }
+
+        if (pending == NULL) {
+            message_rpc_unlock();
+            return 2;
+        }
+
+        /* 先登记再发送, 响应可能在发送返回之前就被轮询任务处理 */
+        pending->used = true;
+        pending->seq = seq;
+        pending->method = method;
+        pending->start_time = HAL_GetTick();
+        pending->timeout = timeout;
+        pending->done = done;
+        pending->user_data = user_data;
+    }
+    message_rpc_unlock();
+
+    message_rpc_put_header(buf, MSG_RPC_REQUEST, seq, method, 0);
+    if (args_len != 0) {
+        memcpy(&buf[MSG_RPC_HEADER_LEN], args, args_len);
+    }
+
+    if (message_send_data(MSG_RPC, MSG_DATA_CUSTOM, buf,
+                          MSG_RPC_HEADER_LEN + args_len) != 0) {
+        if (pending != NULL) {
+            message_rpc_lock();
+            pending->used = false;
+            message_rpc_unlock();
+        }
+        return 3;
+    }
+
+#if MSG_ENABLE_STATISTICS
+    ++msg_rpc_stat.call_count;
+#endif /* MSG_ENABLE_STATISTICS */
+
+    return 0;
+}
+
+/**
+ * @brief 检查超时, 超时的请求调用完成回调
+ *
+ * @note 在轮询任务中调用, 例如每次`message_polling_wait`之后
+ */
+void message_rpc_poll(void) {
+    msg_rpc_pending_t expired;
+
+    for (uint32_t i = 0; i < MSG_RPC_PENDING_MAX; ++i) {
+        expired.used = false;
+
+        /* 在临界区内取时间, 其他任务刚登记的请求不会被误判超时 */
+        message_rpc_lock();
+        if (msg_rpc_pending[i].used &&
+            (HAL_GetTick() - msg_rpc_pending[i].start_time >=
+             msg_rpc_pending[i].timeout)) {
+            expired = msg_rpc_pending[i];
+            msg_rpc_pending[i].used = false;
+        }
+        message_rpc_unlock();
+
+        if (!expired.used) {
+            continue;
+        }
+
+#if MSG_ENABLE_STATISTICS
+        ++msg_rpc_stat.timeout_count;
+#endif /* MSG_ENABLE_STATISTICS */
+        expired.done(MSG_RPC_ERR_TIMEOUT, NULL, 0, expired.user_data);
+    }
+}
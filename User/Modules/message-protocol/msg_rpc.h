@@ -0,0 +1,108 @@
+/**
+ * @file    msg_rpc.h
+ * @author  agent
+ * @brief   基于消息协议的请求/响应调用
+ * @version 1.0
+ * @date    2026-10-17
+ *
+ *****************************************************************************
+ *                             ##### 如何使用 ####
+ * (#) 给`MSG_RPC`注册发送串口和接收串口, 然后调用`message_rpc_init`
+ *
+ * (#) 被调用端
+ *      (##) 调用`message_rpc_register`注册方法, 收到请求后在轮询任务中调用
+ *           方法, 把返回值和状态发回去
+ *
+ * (#) 调用端
+ *      (##) 调用`message_rpc_call`发送请求, 不会等待响应. 收到响应或者超时后
+ *           在轮询任务中调用完成回调
+ *      (##) 需要在轮询任务中持续调用`message_rpc_poll`检查超时
+ *
+ * (#) 帧格式 (`MSG_RPC`的数据区, 类型`MSG_DATA_CUSTOM`):
+ *     1 byte 请求/响应, 2 byte 序号 (小端), 1 byte 方法, 1 byte 状态,
+ *     后面是参数或返回值. 响应带回请求的序号和方法, 调用端按序号找到对应的
+ *     请求
+ *
+ *****************************************************************************
+ *    Date    | Version |   Author    | Version Info
+ * -----------+---------+-------------+----------------------------------------
+ * 2026-10-17 |   1.0   | agent       | 初版
+ */
+
+#ifndef __MSG_RPC_H
+#define __MSG_RPC_H
+
+#include "msg_protocol.h"
+
+/* 同时等待响应的请求个数 */
+#define MSG_RPC_PENDING_MAX  8
+/* 方法个数, 方法 ID 为 0 ~ MSG_RPC_METHOD_MAX - 1 */
+#define MSG_RPC_METHOD_MAX   16
+
+/* RPC 帧头长度: 1 byte 请求/响应, 2 byte 序号, 1 byte 方法, 1 byte 状态 */
+#define MSG_RPC_HEADER_LEN   5U
+/* 参数和返回值最大长度, 加上帧头不能超过`MSG_ID_TABLE`中`MSG_RPC`的长度 */
+#define MSG_RPC_DATA_MAX_LEN 59U
+
+/**
+ * @brief 调用状态, 0x00 ~ 0xEF 由方法自己定义
+ */
+typedef enum {
+    MSG_RPC_OK = 0x00U,          /*!< 成功 */
+    MSG_RPC_ERR_METHOD = 0xF0U,  /*!< 被调用端没有该方法 */
+    MSG_RPC_ERR_ARGS = 0xF1U,    /*!< 参数错误, 方法可以返回 */
+    MSG_RPC_ERR_TIMEOUT = 0xFFU, /*!< 超时没有收到响应 (调用端产生) */
+} msg_rpc_status_t;
+
+/**
+ * @brief 方法
+ *
+ * @param[in] args 参数
+ * @param args_len 参数长度
+ * @param[out] ret 返回值, 最长`MSG_RPC_DATA_MAX_LEN`
+ * @param[out] ret_len 返回值长度, 调用前为 0
+ * @return 调用状态, 见`msg_rpc_status_t`
+ * @note 在轮询任务中调用, 不要阻塞
+ */
+typedef uint8_t (*msg_rpc_method_t)(const uint8_t * /* args */,
+                                    uint32_t /* args_len */,
+                                    uint8_t * /* ret */,
+                                    uint32_t * /* ret_len */);
+
+/**
+ * @brief 调用完成回调
+ *
+ * @param status 调用状态, 见`msg_rpc_status_t`
+ * @param[in] ret 返回值, 仅在回调期间有效, 超时为`NULL`
+ * @param ret_len 返回值长度
+ * @param user_data 调用时传入的用户数据
+ * @note 在轮询任务中调用
+ */
+typedef void (*msg_rpc_done_t)(uint8_t /* status */, const uint8_t * /* ret */,
+                               uint32_t /* ret_len */, void * /* user_data */);
+
+#if MSG_ENABLE_STATISTICS
+/**
+ * @brief 调用统计
+ */
+typedef struct {
+    uint32_t call_count;    /*!< 发出的请求数 */
+    uint32_t done_count;    /*!< 收到响应的请求数 */
+    uint32_t timeout_count; /*!< 超时的请求数 */
+    uint32_t unknown_count; /*!< 没有对应请求的响应数, 如超时后才到 */
+    uint32_t serve_count;   /*!< 处理的请求数 */
+    uint32_t rtt_ms;        /*!< 上次往返时间 (ms) */
+    uint32_t max_rtt_ms;    /*!< 最长往返时间 (ms) */
+} msg_rpc_stat_t;
+
+extern msg_rpc_stat_t msg_rpc_stat;
+#endif /* MSG_ENABLE_STATISTICS */
+
+uint8_t message_rpc_init(void);
+uint8_t message_rpc_register(uint8_t method, msg_rpc_method_t handler);
+uint8_t message_rpc_call(uint8_t method, const uint8_t *args, uint32_t args_len,
+                         uint32_t timeout, msg_rpc_done_t done,
+                         void *user_data);
+void message_rpc_poll(void);
+
+#endif /* __MSG_RPC_H */
@@ -0,0 +1,265 @@
+/**
+ * @file    msg_schema.h
+ * @author  agent
+ * @brief   消息数据定义, 生成结构体和打包/解包函数
+ * @version 1.0
+ * @date    2026-10-17
+ *
+ *****************************************************************************
+ *                             ##### 如何使用 ####
+ * (#) 在`MSG_SCHEMA_TABLE`中添加消息, 格式为 X(消息名, 消息 ID, 字段表).
+ *     字段表格式为 F(类型, 字段名) 或 A(类型, 字段名, 个数), 类型为
+ *     u8, i8, u16, i16, u32, i32, f32
+ *
+ * (#) 每个消息生成:
+ *      (##) `msg_<消息名>_t`: 结构体, 自然对齐, 可以直接访问浮点字段
+ *      (##) `msg_<消息名>_wire_len`: 线上长度, 各字段长度之和, 没有填充
+ *      (##) `msg_<消息名>_pack`: 按字段顺序小端打包, 返回线上长度
+ *      (##) `msg_<消息名>_unpack`: 长度不一致返回`false`, 不修改结构体
+ *
+ * (#) 线上格式和原来的`__packed`结构体 (小端) 一致, 没升级的对端不受影响
+ *
+ * (#) 这个文件只依赖标准头文件, 小电脑一侧定义`MSG_SCHEMA_HOST`后直接包含,
+ *     用同一份定义解包, 两端不会不一致
+ *
+ *****************************************************************************
+ *    Date    | Version |   Author    | Version Info
+ * -----------+---------+-------------+----------------------------------------
+ * 2026-10-17 |   1.0   | agent       | 初版
+ */
+
+#ifndef __MSG_SCHEMA_H
+#define __MSG_SCHEMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef MSG_SCHEMA_HOST
+#include "msg_protocol.h"
+#endif /* MSG_SCHEMA_HOST */
+
+/* 遥控器 -> 主控: 按键和摇杆 */
+#define MSG_SCHEMA_REMOTE_CTRL(F, A)                                           \
+    F(u8, key) /* 按键值 */                                                    \
+    A(i8, rs, 4) /* 摇杆, 左 x, 左 y, 右 x, 右 y */
+
+/* 小电脑 -> 主控: 位姿 */
+#define MSG_SCHEMA_NUC_POS(F, A)                                               \
+    F(f32, x)   /* x 坐标 (m) */                                               \
+    F(f32, y)   /* y 坐标 (m) */                                               \
+    F(f32, yaw) /* 航向角 */
+
+/* 主控 -> 遥控器: 位置信息上报 */
+#define MSG_SCHEMA_REPORT_CHASSIS(F, A)                                        \
+    F(u8, type)          /* 上报的数据类型, `REMOTE_REPORT_POSITION` */        \
+    F(i16, x)            /* x 坐标 */                                          \
+    F(i16, y)            /* y 坐标 */                                          \
+    F(i16, yaw)          /* yaw 坐标 */                                        \
+    F(u8, point_index)   /* 目标点序列号 */                                    \
+    F(u8, chassis_status) /* 底盘状态, bit2 自锁, bit1 自瞄, bit0 世界坐标系 */
+
+/* 主控 -> 遥控器: 发射信息上报 */
+#define MSG_SCHEMA_REPORT_SHOOT(F, A)                                          \
+    F(u8, type)        /* 上报的数据类型, `REMOTE_REPORT_SHOOT` */             \
+    F(f32, shoot_spd)  /* 发射速度 */                                          \
+    F(u8, shoot_status) /* 发射状态, bit1 2006 是否推出, bit0 是否在发射 */
+
+/* 主控 -> 从板: 底盘和摩擦带参数 */
+#define MSG_SCHEMA_TO_SLAVE(F, A)                                              \
+    F(f32, chassis_speedx)      /* 底盘 speedx */                              \
+    F(f32, chassis_speedy)      /* 底盘 speedy */                              \
+    F(f32, chassis_speedyaw)    /* 底盘 speedyaw */                            \
+    F(f32, chassis_world_yaw)   /* 世界坐标 yaw */                             \
+    F(u8, chassis_halt)         /* 底盘停止标志 */                             \
+    F(f32, friction_speed_5065) /* 摩擦带速度 */                               \
+    F(u8, shoot_flag)           /* 射击标志 */
+
+/**
+ * @brief 消息定义表, 格式为 X(消息名, 消息 ID, 字段表)
+ */
+#define MSG_SCHEMA_TABLE(X)                                                    \
+    X(remote_ctrl, MSG_REMOTE, MSG_SCHEMA_REMOTE_CTRL)                         \
+    X(nuc_pos, MSG_NUC, MSG_SCHEMA_NUC_POS)                                    \
+    X(report_chassis, MSG_REMOTE, MSG_SCHEMA_REPORT_CHASSIS)                   \
+    X(report_shoot, MSG_REMOTE, MSG_SCHEMA_REPORT_SHOOT)                       \
+    X(to_slave, MSG_TO_SLAVE, MSG_SCHEMA_TO_SLAVE)
+
+/* 字段类型对应的 C 类型和线上长度 */
+typedef uint8_t msg_schema_u8_t;
+typedef int8_t msg_schema_i8_t;
+typedef uint16_t msg_schema_u16_t;
+typedef int16_t msg_schema_i16_t;
+typedef uint32_t msg_schema_u32_t;
+typedef int32_t msg_schema_i32_t;
+typedef float msg_schema_f32_t;
+
+#define MSG_SCHEMA_SIZE_u8  1U
+#define MSG_SCHEMA_SIZE_i8  1U
+#define MSG_SCHEMA_SIZE_u16 2U
+#define MSG_SCHEMA_SIZE_i16 2U
+#define MSG_SCHEMA_SIZE_u32 4U
+#define MSG_SCHEMA_SIZE_i32 4U
+#define MSG_SCHEMA_SIZE_f32 4U
+
+/* 浮点数按 IEEE 754 单精度传输 */
+typedef char msg_schema_f32_check[(sizeof(float) == 4) ? 1 : -1];
+
+/**
+ * @brief 小端写入, 逐字节访问, 不要求对齐
+ *
+ * @param p 写入位置
+ * @param value 数据
+ * @return 下一个写入位置
+ */
+static inline uint8_t *msg_schema_put_u8(uint8_t *p, uint8_t value) {
+    p[0] = value;
+    return p + 1;
+}
+
+static inline uint8_t *msg_schema_put_u16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+static inline uint8_t *msg_schema_put_u32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+static inline uint8_t *msg_schema_put_i8(uint8_t *p, int8_t value) {
+    return msg_schema_put_u8(p, (uint8_t)value);
+}
+
+static inline uint8_t *msg_schema_put_i16(uint8_t *p, int16_t value) {
+    return msg_schema_put_u16(p, (uint16_t)value);
+}
+
+static inline uint8_t *msg_schema_put_i32(uint8_t *p, int32_t value) {
+    return msg_schema_put_u32(p, (uint32_t)value);
+}
+
+static inline uint8_t *msg_schema_put_f32(uint8_t *p, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return msg_schema_put_u32(p, bits);
+}
+
+/**
+ * @brief 小端读取, 逐字节访问, 不要求对齐
+ *
+ * @param p 读取位置, 读取后后移
+ * @return 数据
+ */
+static inline uint8_t msg_schema_get_u8(const uint8_t **p) {
+    uint8_t value = (*p)[0];
+    *p += 1;
+    return value;
+}
+
+static inline uint16_t msg_schema_get_u16(const uint8_t **p) {
+    uint16_t value = (uint16_t)((*p)[0] | ((*p)[1] << 8));
+    *p += 2;
+    return value;
+}
+
+static inline uint32_t msg_schema_get_u32(const uint8_t **p) {
+    uint32_t value = (uint32_t)(*p)[0] | ((uint32_t)(*p)[1] << 8) |
+                     ((uint32_t)(*p)[2] << 16) | ((uint32_t)(*p)[3] << 24);
+    *p += 4;
+    return value;
+}
+
+static inline int8_t msg_schema_get_i8(const uint8_t **p) {
+    return (int8_t)msg_schema_get_u8(p);
+}
+
+static inline int16_t msg_schema_get_i16(const uint8_t **p) {
+    return (int16_t)msg_schema_get_u16(p);
+}
+
+static inline int32_t msg_schema_get_i32(const uint8_t **p) {
+    return (int32_t)msg_schema_get_u32(p);
+}
+
+static inline float msg_schema_get_f32(const uint8_t **p) {
+    uint32_t bits = msg_schema_get_u32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/* 结构体成员 */
+#define MSG_SCHEMA_MEMBER(type, name)        msg_schema_##type##_t name;
+#define MSG_SCHEMA_MEMBER_A(type, name, num) msg_schema_##type##_t name[num];
+
+/* 线上长度 */
+#define MSG_SCHEMA_SIZE(type, name)          +MSG_SCHEMA_SIZE_##type
+#define MSG_SCHEMA_SIZE_A(type, name, num)   +MSG_SCHEMA_SIZE_##type *(num)
+
+/* 打包 */
+#define MSG_SCHEMA_PACK(type, name)                                            \
+    p = msg_schema_put_##type(p, msg->name);
+#define MSG_SCHEMA_PACK_A(type, name, num)                                     \
+    for (uint32_t i = 0; i < (num); ++i) {                                     \
+        p = msg_schema_put_##type(p, msg->name[i]);                            \
+    }
+
+/* 解包 */
+#define MSG_SCHEMA_UNPACK(type, name)                                          \
+    msg->name = msg_schema_get_##type(&p);
+#define MSG_SCHEMA_UNPACK_A(type, name, num)                                   \
+    for (uint32_t i = 0; i < (num); ++i) {                                     \
+        msg->name[i] = msg_schema_get_##type(&p);                              \
+    }
+
+#define MSG_SCHEMA_DEFINE(name, msg_id, fields)                                \
+    typedef struct {                                                           \
+        fields(MSG_SCHEMA_MEMBER, MSG_SCHEMA_MEMBER_A)                         \
+    } msg_##name##_t;                                                          \
+                                                                               \
+    enum {                                                                     \
+        msg_##name##_wire_len = 0 fields(MSG_SCHEMA_SIZE, MSG_SCHEMA_SIZE_A)   \
+    };                                                                         \
+                                                                               \
+    static inline uint32_t msg_##name##_pack(const msg_##name##_t *msg,        \
+                                             uint8_t *buf) {                   \
+        uint8_t *p = buf;                                                      \
+        fields(MSG_SCHEMA_PACK, MSG_SCHEMA_PACK_A) return (uint32_t)(p - buf); \
+    }                                                                          \
+                                                                               \
+    static inline bool msg_##name##_unpack(msg_##name##_t *msg,                \
+                                           const uint8_t *buf, uint32_t len) { \
+        const uint8_t *p = buf;                                                \
+        if (len != msg_##name##_wire_len) {                                    \
+            return false;                                                      \
+        }                                                                      \
+        fields(MSG_SCHEMA_UNPACK, MSG_SCHEMA_UNPACK_A) return true;            \
+    }
+
+MSG_SCHEMA_TABLE(MSG_SCHEMA_DEFINE)
+
+#ifndef MSG_SCHEMA_HOST
+/* 线上长度不能超过消息 ID 声明的最大数据长度 */
+enum {
+#define MSG_SCHEMA_ID_MAX_LEN(id, max_len)                                     \
+    msg_schema_##id##_max_len = (max_len),
+    MSG_ID_TABLE(MSG_SCHEMA_ID_MAX_LEN)
+#undef MSG_SCHEMA_ID_MAX_LEN
+};
+
+#define MSG_SCHEMA_LEN_CHECK(name, msg_id, fields)                             \
+    typedef char msg_##name##_len_check                                        \
+        [((uint32_t)msg_##name##_wire_len <=                                   \
+          (uint32_t)msg_schema_##msg_id##_max_len)                             \
+             ? 1                                                               \
+             : -1];
+MSG_SCHEMA_TABLE(MSG_SCHEMA_LEN_CHECK)
+#undef MSG_SCHEMA_LEN_CHECK
+#endif /* MSG_SCHEMA_HOST */
+
+#endif /* __MSG_SCHEMA_H */
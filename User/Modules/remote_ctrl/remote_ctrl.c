@@ -34,12 +34,12 @@ static remote_key_callback_t key_callback[18][REMOTE_KEY_EVENT_NUM];
 void remote_receive_callback(uint32_t msg_length, uint8_t msg_type,
                              uint8_t *msg_data) {
     static uint8_t last_key = 0;
-    if (msg_length != 5 || msg_type != MSG_DATA_UINT8) {
+    if (msg_type != MSG_DATA_UINT8) {
+        return;
+    }
+    if (!msg_remote_ctrl_unpack(&g_remote_ctrl_data, msg_data, msg_length)) {
         return;
     }
-    remote_ctrl_data_t *p_msg_data;
-    p_msg_data = (remote_ctrl_data_t *)msg_data;
-    memcpy(&g_remote_ctrl_data, p_msg_data, sizeof(g_remote_ctrl_data));
 
     static uint32_t start_time = 0;
     if (HAL_GetTick() - start_time > 500) {
@@ -11,6 +11,7 @@
 
 #include <bsp.h>
 #include "message-protocol/msg_protocol.h"
+#include "message-protocol/msg_schema.h"
 
 /**
  * @brief 遥控器键盘事件
@@ -31,12 +32,9 @@ typedef enum {
 typedef void (*remote_key_callback_t)(uint8_t key, remote_key_event_t event);
 
 /**
- * @brief 遥控器数据
+ * @brief 遥控器数据, 字段定义见`MSG_SCHEMA_REMOTE_CTRL`
  */
-typedef struct __packed {
-    uint8_t key;  /*!< 按键值 */
-    int8_t rs[4]; /*!< 摇杆, 左 x, 左 y, 右 x, 右 y */
-} remote_ctrl_data_t;
+typedef msg_remote_ctrl_t remote_ctrl_data_t;
 
 extern remote_ctrl_data_t g_remote_ctrl_data;
 
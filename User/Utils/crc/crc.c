@@ -0,0 +1,313 @@
+/**
+ * @file    crc.c
+ * @author  agent
+ * @brief   查表法 CRC 校验
+ * @version 1.0
+ * @date    2026-10-17
+ */
+
+#include "crc.h"
+
+/* CRC-16/CCITT-FALSE 查找表 */
+static const uint16_t crc16_table[256] = {
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+    0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU,
+    0x1231U, 0x0210U, 0x3273U, 0x2252U, 0x52B5U, 0x4294U, 0x72F7U, 0x62D6U,
+    0x9339U, 0x8318U, 0xB37BU, 0xA35AU, 0xD3BDU, 0xC39CU, 0xF3FFU, 0xE3DEU,
+    0x2462U, 0x3443U, 0x0420U, 0x1401U, 0x64E6U, 0x74C7U, 0x44A4U, 0x5485U,
+    0xA56AU, 0xB54BU, 0x8528U, 0x9509U, 0xE5EEU, 0xF5CFU, 0xC5ACU, 0xD58DU,
+    0x3653U, 0x2672U, 0x1611U, 0x0630U, 0x76D7U, 0x66F6U, 0x5695U, 0x46B4U,
+    0xB75BU, 0xA77AU, 0x9719U, 0x8738U, 0xF7DFU, 0xE7FEU, 0xD79DU, 0xC7BCU,
+    0x48C4U, 0x58E5U, 0x6886U, 0x78A7U, 0x0840U, 0x1861U, 0x2802U, 0x3823U,
+    0xC9CCU, 0xD9EDU, 0xE98EU, 0xF9AFU, 0x8948U, 0x9969U, 0xA90AU, 0xB92BU,
+    0x5AF5U, 0x4AD4U, 0x7AB7U, 0x6A96U, 0x1A71U, 0x0A50U, 0x3A33U, 0x2A12U,
+    0xDBFDU, 0xCBDCU, 0xFBBFU, 0xEB9EU, 0x9B79U, 0x8B58U, 0xBB3BU, 0xAB1AU,
+    0x6CA6U, 0x7C87U, 0x4CE4U, 0x5CC5U, 0x2C22U, 0x3C03U, 0x0C60U, 0x1C41U,
+    0xEDAEU, 0xFD8FU, 0xCDECU, 0xDDCDU, 0xAD2AU, 0xBD0BU, 0x8D68U, 0x9D49U,
+    0x7E97U, 0x6EB6U, 0x5ED5U, 0x4EF4U, 0x3E13U, 0x2E32U, 0x1E51U, 0x0E70U,
+    0xFF9FU, 0xEFBEU, 0xDFDDU, 0xCFFCU, 0xBF1BU, 0xAF3AU, 0x9F59U, 0x8F78U,
+    0x9188U, 0x81A9U, 0xB1CAU, 0xA1EBU, 0xD10CU, 0xC12DU, 0xF14EU, 0xE16FU,
+    0x1080U, 0x00A1U, 0x30C2U, 0x20E3U, 0x5004U, 0x4025U, 0x7046U, 0x6067U,
+    0x83B9U, 0x9398U, 0xA3FBU, 0xB3DAU, 0xC33DU, 0xD31CU, 0xE37FU, 0xF35EU,
+    0x02B1U, 0x1290U, 0x22F3U, 0x32D2U, 0x4235U, 0x5214U, 0x6277U, 0x7256U,
+    0xB5EAU, 0xA5CBU, 0x95A8U, 0x8589U, 0xF56EU, 0xE54FU, 0xD52CU, 0xC50DU,
+    0x34E2U, 0x24C3U, 0x14A0U, 0x0481U, 0x7466U, 0x6447U, 0x5424U, 0x4405U,
+    0xA7DBU, 0xB7FAU, 0x8799U, 0x97B8U, 0xE75FU, 0xF77EU, 0xC71DU, 0xD73CU,
+    0x26D3U, 0x36F2U, 0x0691U, 0x16B0U, 0x6657U, 0x7676U, 0x4615U, 0x5634U,
+    0xD94CU, 0xC96DU, 0xF90EU, 0xE92FU, 0x99C8U, 0x89E9U, 0xB98AU, 0xA9ABU,
+    0x5844U, 0x4865U, 0x7806U, 0x6827U, 0x18C0U, 0x08E1U, 0x3882U, 0x28A3U,
+    0xCB7DU, 0xDB5CU, 0xEB3FU, 0xFB1EU, 0x8BF9U, 0x9BD8U, 0xABBBU, 0xBB9AU,
+    0x4A75U, 0x5A54U, 0x6A37U, 0x7A16U, 0x0AF1U, 0x1AD0U, 0x2AB3U, 0x3A92U,
+    0xFD2EU, 0xED0FU, 0xDD6CU, 0xCD4DU, 0xBDAAU, 0xAD8BU, 0x9DE8U, 0x8DC9U,
+    0x7C26U, 0x6C07U, 0x5C64U, 0x4C45U, 0x3CA2U, 0x2C83U, 0x1CE0U, 0x0CC1U,
+    0xEF1FU, 0xFF3EU, 0xCF5DU, 0xDF7CU, 0xAF9BU, 0xBFBAU, 0x8FD9U, 0x9FF8U,
+    0x6E17U, 0x7E36U, 0x4E55U, 0x5E74U, 0x2E93U, 0x3EB2U, 0x0ED1U, 0x1EF0U,
+};
+
+/* CRC-32/MPEG-2 slice-by-4 查找表, `crc32_table[0]`为单字节查找表,
+ * `crc32_table[k]`为该字节后面再跟 k 个 0 字节的 CRC */
+static const uint32_t crc32_table[4][256] = {
+    {
+        0x00000000U, 0x04C11DB7U, 0x09823B6EU, 0x0D4326D9U, 0x130476DCU,
+        0x17C56B6BU, 0x1A864DB2U, 0x1E475005U, 0x2608EDB8U, 0x22C9F00FU,
+        0x2F8AD6D6U, 0x2B4BCB61U, 0x350C9B64U, 0x31CD86D3U, 0x3C8EA00AU,
+        0x384FBDBDU, 0x4C11DB70U, 0x48D0C6C7U, 0x4593E01EU, 0x4152FDA9U,
+        0x5F15ADACU, 0x5BD4B01BU, 0x569796C2U, 0x52568B75U, 0x6A1936C8U,
+        0x6ED82B7FU, 0x639B0DA6U, 0x675A1011U, 0x791D4014U, 0x7DDC5DA3U,
+        0x709F7B7AU, 0x745E66CDU, 0x9823B6E0U, 0x9CE2AB57U, 0x91A18D8EU,
+        0x95609039U, 0x8B27C03CU, 0x8FE6DD8BU, 0x82A5FB52U, 0x8664E6E5U,
+        0xBE2B5B58U, 0xBAEA46EFU, 0xB7A96036U, 0xB3687D81U, 0xAD2F2D84U,
+        0xA9EE3033U, 0xA4AD16EAU, 0xA06C0B5DU, 0xD4326D90U, 0xD0F37027U,
+        0xDDB056FEU, 0xD9714B49U, 0xC7361B4CU, 0xC3F706FBU, 0xCEB42022U,
+        0xCA753D95U, 0xF23A8028U, 0xF6FB9D9FU, 0xFBB8BB46U, 0xFF79A6F1U,
+        0xE13EF6F4U, 0xE5FFEB43U, 0xE8BCCD9AU, 0xEC7DD02DU, 0x34867077U,
+        0x30476DC0U, 0x3D044B19U, 0x39C556AEU, 0x278206ABU, 0x23431B1CU,
+        0x2E003DC5U, 0x2AC12072U, 0x128E9DCFU, 0x164F8078U, 0x1B0CA6A1U,
+        0x1FCDBB16U, 0x018AEB13U, 0x054BF6A4U, 0x0808D07DU, 0x0CC9CDCAU,
+        0x7897AB07U, 0x7C56B6B0U, 0x71159069U, 0x75D48DDEU, 0x6B93DDDBU,
+        0x6F52C06CU, 0x6211E6B5U, 0x66D0FB02U, 0x5E9F46BFU, 0x5A5E5B08U,
+        0x571D7DD1U, 0x53DC6066U, 0x4D9B3063U, 0x495A2DD4U, 0x44190B0DU,
+        0x40D816BAU, 0xACA5C697U, 0xA864DB20U, 0xA527FDF9U, 0xA1E6E04EU,
+        0xBFA1B04BU, 0xBB60ADFCU, 0xB6238B25U, 0xB2E29692U, 0x8AAD2B2FU,
+        0x8E6C3698U, 0x832F1041U, 0x87EE0DF6U, 0x99A95DF3U, 0x9D684044U,
+        0x902B669DU, 0x94EA7B2AU, 0xE0B41DE7U, 0xE4750050U, 0xE9362689U,
+        0xEDF73B3EU, 0xF3B06B3BU, 0xF771768CU, 0xFA325055U, 0xFEF34DE2U,
+        0xC6BCF05FU, 0xC27DEDE8U, 0xCF3ECB31U, 0xCBFFD686U, 0xD5B88683U,
+        0xD1799B34U, 0xDC3ABDEDU, 0xD8FBA05AU, 0x690CE0EEU, 0x6DCDFD59U,
+        0x608EDB80U, 0x644FC637U, 0x7A089632U, 0x7EC98B85U, 0x738AAD5CU,
+        0x774BB0EBU, 0x4F040D56U, 0x4BC510E1U, 0x46863638U, 0x42472B8FU,
+        0x5C007B8AU, 0x58C1663DU, 0x558240E4U, 0x51435D53U, 0x251D3B9EU,
+        0x21DC2629U, 0x2C9F00F0U, 0x285E1D47U, 0x36194D42U, 0x32D850F5U,
+        0x3F9B762CU, 0x3B5A6B9BU, 0x0315D626U, 0x07D4CB91U, 0x0A97ED48U,
+        0x0E56F0FFU, 0x1011A0FAU, 0x14D0BD4DU, 0x19939B94U, 0x1D528623U,
+        0xF12F560EU, 0xF5EE4BB9U, 0xF8AD6D60U, 0xFC6C70D7U, 0xE22B20D2U,
+        0xE6EA3D65U, 0xEBA91BBCU, 0xEF68060BU, 0xD727BBB6U, 0xD3E6A601U,
+        0xDEA580D8U, 0xDA649D6FU, 0xC423CD6AU, 0xC0E2D0DDU, 0xCDA1F604U,
+        0xC960EBB3U, 0xBD3E8D7EU, 0xB9FF90C9U, 0xB4BCB610U, 0xB07DABA7U,
+        0xAE3AFBA2U, 0xAAFBE615U, 0xA7B8C0CCU, 0xA379DD7BU, 0x9B3660C6U,
+        0x9FF77D71U, 0x92B45BA8U, 0x9675461FU, 0x8832161AU, 0x8CF30BADU,
+        0x81B02D74U, 0x857130C3U, 0x5D8A9099U, 0x594B8D2EU, 0x5408ABF7U,
+        0x50C9B640U, 0x4E8EE645U, 0x4A4FFBF2U, 0x470CDD2BU, 0x43CDC09CU,
+        0x7B827D21U, 0x7F436096U, 0x7200464FU, 0x76C15BF8U, 0x68860BFDU,
+        0x6C47164AU, 0x61043093U, 0x65C52D24U, 0x119B4BE9U, 0x155A565EU,
+        0x18197087U, 0x1CD86D30U, 0x029F3D35U, 0x065E2082U, 0x0B1D065BU,
+        0x0FDC1BECU, 0x3793A651U, 0x3352BBE6U, 0x3E119D3FU, 0x3AD08088U,
+        0x2497D08DU, 0x2056CD3AU, 0x2D15EBE3U, 0x29D4F654U, 0xC5A92679U,
+        0xC1683BCEU, 0xCC2B1D17U, 0xC8EA00A0U, 0xD6AD50A5U, 0xD26C4D12U,
+        0xDF2F6BCBU, 0xDBEE767CU, 0xE3A1CBC1U, 0xE760D676U, 0xEA23F0AFU,
+        0xEEE2ED18U, 0xF0A5BD1DU, 0xF464A0AAU, 0xF9278673U, 0xFDE69BC4U,
+        0x89B8FD09U, 0x8D79E0BEU, 0x803AC667U, 0x84FBDBD0U, 0x9ABC8BD5U,
+        0x9E7D9662U, 0x933EB0BBU, 0x97FFAD0CU, 0xAFB010B1U, 0xAB710D06U,
+        0xA6322BDFU, 0xA2F33668U, 0xBCB4666DU, 0xB8757BDAU, 0xB5365D03U,
+        0xB1F740B4U,
+    },
+    {
+        0x00000000U, 0xD219C1DCU, 0xA0F29E0FU, 0x72EB5FD3U, 0x452421A9U,
+        0x973DE075U, 0xE5D6BFA6U, 0x37CF7E7AU, 0x8A484352U, 0x5851828EU,
+        0x2ABADD5DU, 0xF8A31C81U, 0xCF6C62FBU, 0x1D75A327U, 0x6F9EFCF4U,
+        0xBD873D28U, 0x10519B13U, 0xC2485ACFU, 0xB0A3051CU, 0x62BAC4C0U,
+        0x5575BABAU, 0x876C7B66U, 0xF58724B5U, 0x279EE569U, 0x9A19D841U,
+        0x4800199DU, 0x3AEB464EU, 0xE8F28792U, 0xDF3DF9E8U, 0x0D243834U,
+        0x7FCF67E7U, 0xADD6A63BU, 0x20A33626U, 0xF2BAF7FAU, 0x8051A829U,
+        0x524869F5U, 0x6587178FU, 0xB79ED653U, 0xC5758980U, 0x176C485CU,
+        0xAAEB7574U, 0x78F2B4A8U, 0x0A19EB7BU, 0xD8002AA7U, 0xEFCF54DDU,
+        0x3DD69501U, 0x4F3DCAD2U, 0x9D240B0EU, 0x30F2AD35U, 0xE2EB6CE9U,
+        0x9000333AU, 0x4219F2E6U, 0x75D68C9CU, 0xA7CF4D40U, 0xD5241293U,
+        0x073DD34FU, 0xBABAEE67U, 0x68A32FBBU, 0x1A487068U, 0xC851B1B4U,
+        0xFF9ECFCEU, 0x2D870E12U, 0x5F6C51C1U, 0x8D75901DU, 0x41466C4CU,
+        0x935FAD90U, 0xE1B4F243U, 0x33AD339FU, 0x04624DE5U, 0xD67B8C39U,
+        0xA490D3EAU, 0x76891236U, 0xCB0E2F1EU, 0x1917EEC2U, 0x6BFCB111U,
+        0xB9E570CDU, 0x8E2A0EB7U, 0x5C33CF6BU, 0x2ED890B8U, 0xFCC15164U,
+        0x5117F75FU, 0x830E3683U, 0xF1E56950U, 0x23FCA88CU, 0x1433D6F6U,
+        0xC62A172AU, 0xB4C148F9U, 0x66D88925U, 0xDB5FB40DU, 0x094675D1U,
+        0x7BAD2A02U, 0xA9B4EBDEU, 0x9E7B95A4U, 0x4C625478U, 0x3E890BABU,
+        0xEC90CA77U, 0x61E55A6AU, 0xB3FC9BB6U, 0xC117C465U, 0x130E05B9U,
+        0x24C17BC3U, 0xF6D8BA1FU, 0x8433E5CCU, 0x562A2410U, 0xEBAD1938U,
+        0x39B4D8E4U, 0x4B5F8737U, 0x994646EBU, 0xAE893891U, 0x7C90F94DU,
+        0x0E7BA69EU, 0xDC626742U, 0x71B4C179U, 0xA3AD00A5U, 0xD1465F76U,
+        0x035F9EAAU, 0x3490E0D0U, 0xE689210CU, 0x94627EDFU, 0x467BBF03U,
+        0xFBFC822BU, 0x29E543F7U, 0x5B0E1C24U, 0x8917DDF8U, 0xBED8A382U,
+        0x6CC1625EU, 0x1E2A3D8DU, 0xCC33FC51U, 0x828CD898U, 0x50951944U,
+        0x227E4697U, 0xF067874BU, 0xC7A8F931U, 0x15B138EDU, 0x675A673EU,
+        0xB543A6E2U, 0x08C49BCAU, 0xDADD5A16U, 0xA83605C5U, 0x7A2FC419U,
+        0x4DE0BA63U, 0x9FF97BBFU, 0xED12246CU, 0x3F0BE5B0U, 0x92DD438BU,
+        0x40C48257U, 0x322FDD84U, 0xE0361C58U, 0xD7F96222U, 0x05E0A3FEU,
+        0x770BFC2DU, 0xA5123DF1U, 0x189500D9U, 0xCA8CC105U, 0xB8679ED6U,
+        0x6A7E5F0AU, 0x5DB12170U, 0x8FA8E0ACU, 0xFD43BF7FU, 0x2F5A7EA3U,
+        0xA22FEEBEU, 0x70362F62U, 0x02DD70B1U, 0xD0C4B16DU, 0xE70BCF17U,
+        0x35120ECBU, 0x47F95118U, 0x95E090C4U, 0x2867ADECU, 0xFA7E6C30U,
+        0x889533E3U, 0x5A8CF23FU, 0x6D438C45U, 0xBF5A4D99U, 0xCDB1124AU,
+        0x1FA8D396U, 0xB27E75ADU, 0x6067B471U, 0x128CEBA2U, 0xC0952A7EU,
+        0xF75A5404U, 0x254395D8U, 0x57A8CA0BU, 0x85B10BD7U, 0x383636FFU,
+        0xEA2FF723U, 0x98C4A8F0U, 0x4ADD692CU, 0x7D121756U, 0xAF0BD68AU,
+        0xDDE08959U, 0x0FF94885U, 0xC3CAB4D4U, 0x11D37508U, 0x63382ADBU,
+        0xB121EB07U, 0x86EE957DU, 0x54F754A1U, 0x261C0B72U, 0xF405CAAEU,
+        0x4982F786U, 0x9B9B365AU, 0xE9706989U, 0x3B69A855U, 0x0CA6D62FU,
+        0xDEBF17F3U, 0xAC544820U, 0x7E4D89FCU, 0xD39B2FC7U, 0x0182EE1BU,
+        0x7369B1C8U, 0xA1707014U, 0x96BF0E6EU, 0x44A6CFB2U, 0x364D9061U,
+        0xE45451BDU, 0x59D36C95U, 0x8BCAAD49U, 0xF921F29AU, 0x2B383346U,
+        0x1CF74D3CU, 0xCEEE8CE0U, 0xBC05D333U, 0x6E1C12EFU, 0xE36982F2U,
+        0x3170432EU, 0x439B1CFDU, 0x9182DD21U, 0xA64DA35BU, 0x74546287U,
+        0x06BF3D54U, 0xD4A6FC88U, 0x6921C1A0U, 0xBB38007CU, 0xC9D35FAFU,
+        0x1BCA9E73U, 0x2C05E009U, 0xFE1C21D5U, 0x8CF77E06U, 0x5EEEBFDAU,
+        0xF33819E1U, 0x2121D83DU, 0x53CA87EEU, 0x81D34632U, 0xB61C3848U,
+        0x6405F994U, 0x16EEA647U, 0xC4F7679BU, 0x79705AB3U, 0xAB699B6FU,
+        0xD982C4BCU, 0x0B9B0560U, 0x3C547B1AU, 0xEE4DBAC6U, 0x9CA6E515U,
+        0x4EBF24C9U,
+    },
+    {
+        0x00000000U, 0x01D8AC87U, 0x03B1590EU, 0x0269F589U, 0x0762B21CU,
+        0x06BA1E9BU, 0x04D3EB12U, 0x050B4795U, 0x0EC56438U, 0x0F1DC8BFU,
+        0x0D743D36U, 0x0CAC91B1U, 0x09A7D624U, 0x087F7AA3U, 0x0A168F2AU,
+        0x0BCE23ADU, 0x1D8AC870U, 0x1C5264F7U, 0x1E3B917EU, 0x1FE33DF9U,
+        0x1AE87A6CU, 0x1B30D6EBU, 0x19592362U, 0x18818FE5U, 0x134FAC48U,
+        0x129700CFU, 0x10FEF546U, 0x112659C1U, 0x142D1E54U, 0x15F5B2D3U,
+        0x179C475AU, 0x1644EBDDU, 0x3B1590E0U, 0x3ACD3C67U, 0x38A4C9EEU,
+        0x397C6569U, 0x3C7722FCU, 0x3DAF8E7BU, 0x3FC67BF2U, 0x3E1ED775U,
+        0x35D0F4D8U, 0x3408585FU, 0x3661ADD6U, 0x37B90151U, 0x32B246C4U,
+        0x336AEA43U, 0x31031FCAU, 0x30DBB34DU, 0x269F5890U, 0x2747F417U,
+        0x252E019EU, 0x24F6AD19U, 0x21FDEA8CU, 0x2025460BU, 0x224CB382U,
+        0x23941F05U, 0x285A3CA8U, 0x2982902FU, 0x2BEB65A6U, 0x2A33C921U,
+        0x2F388EB4U, 0x2EE02233U, 0x2C89D7BAU, 0x2D517B3DU, 0x762B21C0U,
+        0x77F38D47U, 0x759A78CEU, 0x7442D449U, 0x714993DCU, 0x70913F5BU,
+        0x72F8CAD2U, 0x73206655U, 0x78EE45F8U, 0x7936E97FU, 0x7B5F1CF6U,
+        0x7A87B071U, 0x7F8CF7E4U, 0x7E545B63U, 0x7C3DAEEAU, 0x7DE5026DU,
+        0x6BA1E9B0U, 0x6A794537U, 0x6810B0BEU, 0x69C81C39U, 0x6CC35BACU,
+        0x6D1BF72BU, 0x6F7202A2U, 0x6EAAAE25U, 0x65648D88U, 0x64BC210FU,
+        0x66D5D486U, 0x670D7801U, 0x62063F94U, 0x63DE9313U, 0x61B7669AU,
+        0x606FCA1DU, 0x4D3EB120U, 0x4CE61DA7U, 0x4E8FE82EU, 0x4F5744A9U,
+        0x4A5C033CU, 0x4B84AFBBU, 0x49ED5A32U, 0x4835F6B5U, 0x43FBD518U,
+        0x4223799FU, 0x404A8C16U, 0x41922091U, 0x44996704U, 0x4541CB83U,
+        0x47283E0AU, 0x46F0928DU, 0x50B47950U, 0x516CD5D7U, 0x5305205EU,
+        0x52DD8CD9U, 0x57D6CB4CU, 0x560E67CBU, 0x54679242U, 0x55BF3EC5U,
+        0x5E711D68U, 0x5FA9B1EFU, 0x5DC04466U, 0x5C18E8E1U, 0x5913AF74U,
+        0x58CB03F3U, 0x5AA2F67AU, 0x5B7A5AFDU, 0xEC564380U, 0xED8EEF07U,
+        0xEFE71A8EU, 0xEE3FB609U, 0xEB34F19CU, 0xEAEC5D1BU, 0xE885A892U,
+        0xE95D0415U, 0xE29327B8U, 0xE34B8B3FU, 0xE1227EB6U, 0xE0FAD231U,
+        0xE5F195A4U, 0xE4293923U, 0xE640CCAAU, 0xE798602DU, 0xF1DC8BF0U,
+        0xF0042777U, 0xF26DD2FEU, 0xF3B57E79U, 0xF6BE39ECU, 0xF766956BU,
+        0xF50F60E2U, 0xF4D7CC65U, 0xFF19EFC8U, 0xFEC1434FU, 0xFCA8B6C6U,
+        0xFD701A41U, 0xF87B5DD4U, 0xF9A3F153U, 0xFBCA04DAU, 0xFA12A85DU,
+        0xD743D360U, 0xD69B7FE7U, 0xD4F28A6EU, 0xD52A26E9U, 0xD021617CU,
+        0xD1F9CDFBU, 0xD3903872U, 0xD24894F5U, 0xD986B758U, 0xD85E1BDFU,
+        0xDA37EE56U, 0xDBEF42D1U, 0xDEE40544U, 0xDF3CA9C3U, 0xDD555C4AU,
+        0xDC8DF0CDU, 0xCAC91B10U, 0xCB11B797U, 0xC978421EU, 0xC8A0EE99U,
+        0xCDABA90CU, 0xCC73058BU, 0xCE1AF002U, 0xCFC25C85U, 0xC40C7F28U,
+        0xC5D4D3AFU, 0xC7BD2626U, 0xC6658AA1U, 0xC36ECD34U, 0xC2B661B3U,
+        0xC0DF943AU, 0xC10738BDU, 0x9A7D6240U, 0x9BA5CEC7U, 0x99CC3B4EU,
+        0x981497C9U, 0x9D1FD05CU, 0x9CC77CDBU, 0x9EAE8952U, 0x9F7625D5U,
+        0x94B80678U, 0x9560AAFFU, 0x97095F76U, 0x96D1F3F1U, 0x93DAB464U,
+        0x920218E3U, 0x906BED6AU, 0x91B341EDU, 0x87F7AA30U, 0x862F06B7U,
+        0x8446F33EU, 0x859E5FB9U, 0x8095182CU, 0x814DB4ABU, 0x83244122U,
+        0x82FCEDA5U, 0x8932CE08U, 0x88EA628FU, 0x8A839706U, 0x8B5B3B81U,
+        0x8E507C14U, 0x8F88D093U, 0x8DE1251AU, 0x8C39899DU, 0xA168F2A0U,
+        0xA0B05E27U, 0xA2D9ABAEU, 0xA3010729U, 0xA60A40BCU, 0xA7D2EC3BU,
+        0xA5BB19B2U, 0xA463B535U, 0xAFAD9698U, 0xAE753A1FU, 0xAC1CCF96U,
+        0xADC46311U, 0xA8CF2484U, 0xA9178803U, 0xAB7E7D8AU, 0xAAA6D10DU,
+        0xBCE23AD0U, 0xBD3A9657U, 0xBF5363DEU, 0xBE8BCF59U, 0xBB8088CCU,
+        0xBA58244BU, 0xB831D1C2U, 0xB9E97D45U, 0xB2275EE8U, 0xB3FFF26FU,
+        0xB19607E6U, 0xB04EAB61U, 0xB545ECF4U, 0xB49D4073U, 0xB6F4B5FAU,
+        0xB72C197DU,
+    },
+    {
+        0x00000000U, 0xDC6D9AB7U, 0xBC1A28D9U, 0x6077B26EU, 0x7CF54C05U,
+        0xA098D6B2U, 0xC0EF64DCU, 0x1C82FE6BU, 0xF9EA980AU, 0x258702BDU,
+        0x45F0B0D3U, 0x999D2A64U, 0x851FD40FU, 0x59724EB8U, 0x3905FCD6U,
+        0xE5686661U, 0xF7142DA3U, 0x2B79B714U, 0x4B0E057AU, 0x97639FCDU,
+        0x8BE161A6U, 0x578CFB11U, 0x37FB497FU, 0xEB96D3C8U, 0x0EFEB5A9U,
+        0xD2932F1EU, 0xB2E49D70U, 0x6E8907C7U, 0x720BF9ACU, 0xAE66631BU,
+        0xCE11D175U, 0x127C4BC2U, 0xEAE946F1U, 0x3684DC46U, 0x56F36E28U,
+        0x8A9EF49FU, 0x961C0AF4U, 0x4A719043U, 0x2A06222DU, 0xF66BB89AU,
+        0x1303DEFBU, 0xCF6E444CU, 0xAF19F622U, 0x73746C95U, 0x6FF692FEU,
+        0xB39B0849U, 0xD3ECBA27U, 0x0F812090U, 0x1DFD6B52U, 0xC190F1E5U,
+        0xA1E7438BU, 0x7D8AD93CU, 0x61082757U, 0xBD65BDE0U, 0xDD120F8EU,
+        0x017F9539U, 0xE417F358U, 0x387A69EFU, 0x580DDB81U, 0x84604136U,
+        0x98E2BF5DU, 0x448F25EAU, 0x24F89784U, 0xF8950D33U, 0xD1139055U,
+        0x0D7E0AE2U, 0x6D09B88CU, 0xB164223BU, 0xADE6DC50U, 0x718B46E7U,
+        0x11FCF489U, 0xCD916E3EU, 0x28F9085FU, 0xF49492E8U, 0x94E32086U,
+        0x488EBA31U, 0x540C445AU, 0x8861DEEDU, 0xE8166C83U, 0x347BF634U,
+        0x2607BDF6U, 0xFA6A2741U, 0x9A1D952FU, 0x46700F98U, 0x5AF2F1F3U,
+        0x869F6B44U, 0xE6E8D92AU, 0x3A85439DU, 0xDFED25FCU, 0x0380BF4BU,
+        0x63F70D25U, 0xBF9A9792U, 0xA31869F9U, 0x7F75F34EU, 0x1F024120U,
+        0xC36FDB97U, 0x3BFAD6A4U, 0xE7974C13U, 0x87E0FE7DU, 0x5B8D64CAU,
+        0x470F9AA1U, 0x9B620016U, 0xFB15B278U, 0x277828CFU, 0xC2104EAEU,
+        0x1E7DD419U, 0x7E0A6677U, 0xA267FCC0U, 0xBEE502ABU, 0x6288981CU,
+        0x02FF2A72U, 0xDE92B0C5U, 0xCCEEFB07U, 0x108361B0U, 0x70F4D3DEU,
+        0xAC994969U, 0xB01BB702U, 0x6C762DB5U, 0x0C019FDBU, 0xD06C056CU,
+        0x3504630DU, 0xE969F9BAU, 0x891E4BD4U, 0x5573D163U, 0x49F12F08U,
+        0x959CB5BFU, 0xF5EB07D1U, 0x29869D66U, 0xA6E63D1DU, 0x7A8BA7AAU,
+        0x1AFC15C4U, 0xC6918F73U, 0xDA137118U, 0x067EEBAFU, 0x660959C1U,
+        0xBA64C376U, 0x5F0CA517U, 0x83613FA0U, 0xE3168DCEU, 0x3F7B1779U,
+        0x23F9E912U, 0xFF9473A5U, 0x9FE3C1CBU, 0x438E5B7CU, 0x51F210BEU,
+        0x8D9F8A09U, 0xEDE83867U, 0x3185A2D0U, 0x2D075CBBU, 0xF16AC60CU,
+        0x911D7462U, 0x4D70EED5U, 0xA81888B4U, 0x74751203U, 0x1402A06DU,
+        0xC86F3ADAU, 0xD4EDC4B1U, 0x08805E06U, 0x68F7EC68U, 0xB49A76DFU,
+        0x4C0F7BECU, 0x9062E15BU, 0xF0155335U, 0x2C78C982U, 0x30FA37E9U,
+        0xEC97AD5EU, 0x8CE01F30U, 0x508D8587U, 0xB5E5E3E6U, 0x69887951U,
+        0x09FFCB3FU, 0xD5925188U, 0xC910AFE3U, 0x157D3554U, 0x750A873AU,
+        0xA9671D8DU, 0xBB1B564FU, 0x6776CCF8U, 0x07017E96U, 0xDB6CE421U,
+        0xC7EE1A4AU, 0x1B8380FDU, 0x7BF43293U, 0xA799A824U, 0x42F1CE45U,
+        0x9E9C54F2U, 0xFEEBE69CU, 0x22867C2BU, 0x3E048240U, 0xE26918F7U,
+        0x821EAA99U, 0x5E73302EU, 0x77F5AD48U, 0xAB9837FFU, 0xCBEF8591U,
+        0x17821F26U, 0x0B00E14DU, 0xD76D7BFAU, 0xB71AC994U, 0x6B775323U,
+        0x8E1F3542U, 0x5272AFF5U, 0x32051D9BU, 0xEE68872CU, 0xF2EA7947U,
+        0x2E87E3F0U, 0x4EF0519EU, 0x929DCB29U, 0x80E180EBU, 0x5C8C1A5CU,
+        0x3CFBA832U, 0xE0963285U, 0xFC14CCEEU, 0x20795659U, 0x400EE437U,
+        0x9C637E80U, 0x790B18E1U, 0xA5668256U, 0xC5113038U, 0x197CAA8FU,
+        0x05FE54E4U, 0xD993CE53U, 0xB9E47C3DU, 0x6589E68AU, 0x9D1CEBB9U,
+        0x4171710EU, 0x2106C360U, 0xFD6B59D7U, 0xE1E9A7BCU, 0x3D843D0BU,
+        0x5DF38F65U, 0x819E15D2U, 0x64F673B3U, 0xB89BE904U, 0xD8EC5B6AU,
+        0x0481C1DDU, 0x18033FB6U, 0xC46EA501U, 0xA419176FU, 0x78748DD8U,
+        0x6A08C61AU, 0xB6655CADU, 0xD612EEC3U, 0x0A7F7474U, 0x16FD8A1FU,
+        0xCA9010A8U, 0xAAE7A2C6U, 0x768A3871U, 0x93E25E10U, 0x4F8FC4A7U,
+        0x2FF876C9U, 0xF395EC7EU, 0xEF171215U, 0x337A88A2U, 0x530D3ACCU,
+        0x8F60A07BU,
+    },
+};
+
+/**
+ * @brief 计算 CRC-16/CCITT-FALSE
+ *
+ * @param crc 初值, 第一次计算传入`CRC16_INIT`
+ * @param data 数据
+ * @param len 数据长度
+ * @return CRC 结果
+ */
+uint16_t crc16_calc(uint16_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (len--) {
+        crc = (uint16_t)(crc << 8) ^ crc16_table[(crc >> 8) ^ *p++];
+    }
+
+    return crc;
+}
+
+/**
+ * @brief 计算 CRC-32/MPEG-2, 与 STM32 硬件 CRC 结果一致
+ *
+ * @param crc 初值, 第一次计算传入`CRC32_INIT`
+ * @param data 数据
+ * @param len 数据长度
+ * @return CRC 结果
+ */
+uint32_t crc32_calc(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    /* 每次处理 4 字节, 按大端组成一个字, 不要求数据对齐 */
+    while (len >= 4) {
+        crc ^= ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+               ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+        crc = crc32_table[3][crc >> 24] ^ crc32_table[2][(crc >> 16) & 0xFF] ^
+              crc32_table[1][(crc >> 8) & 0xFF] ^ crc32_table[0][crc & 0xFF];
+        p += 4;
+        len -= 4;
+    }
+
+    /* 剩余不足 4 字节逐字节处理 */
+    while (len--) {
+        crc = (crc << 8) ^ crc32_table[0][(crc >> 24) ^ *p++];
+    }
+
+    return crc;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file    crc.h
+ * @author  agent
+ * @brief   查表法 CRC 校验
+ * @version 1.0
+ * @date    2026-10-17
+ *
+ ******************************************************************************
+ * (#) CRC-16 使用 CRC-16/CCITT-FALSE (多项式 0x1021, 初值 0xFFFF, 不反转,
+ *     无结果异或)
+ * (#) CRC-32 使用 CRC-32/MPEG-2 (多项式 0x04C11DB7, 初值 0xFFFFFFFF, 不反转,
+ *     无结果异或), 与 STM32 硬件 CRC 单元一致: 字节流按大端每 4 字节组成一个
+ *     字 (即`__REV(*(uint32_t *)p)`) 依次写入`CRC->DR`, 得到相同的结果.
+ *     软件实现使用 slice-by-4, 每次处理 4 个字节
+ * (#) 分段计算时, 把上一段的结果作为下一段的`crc`参数传入即可
+ ******************************************************************************
+ *    Date    | Version |   Author    | Version Info
+ * -----------+---------+-------------+----------------------------------------
+ * 2026-10-17 |   1.0   | agent       | 初版
+ */
+
+#ifndef __CRC_H
+#define __CRC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRC16_INIT 0xFFFFU
+#define CRC32_INIT 0xFFFFFFFFU
+
+uint16_t crc16_calc(uint16_t crc, const void *data, size_t len);
+uint32_t crc32_calc(uint32_t crc, const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __CRC_H */
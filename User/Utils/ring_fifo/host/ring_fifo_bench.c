@@ -0,0 +1,194 @@
+/**
+ * @file    ring_fifo_bench.c
+ * @brief   环形 FIFO 的吞吐量, 在主机上运行
+ *
+ * @note 64 KB 的流模式 FIFO, 按 16, 256, 4096 字节一块测量:
+ *
+ *       - 单线程`ring_fifo_write`写一块再`ring_fifo_read`读出, 源和目标与
+ *         FIFO 低 2 位相同时按字拷贝, 错开 1 字节时逐字节拷贝 (和 microlib
+ *         的`memcpy`一样);
+ *       - 单线程`reserve`/`commit`直接写入, `peek`/`release`直接读 (求和),
+ *         没有中间缓冲区;
+ *       - 两个线程, 生产者写, 消费者读, 满或空时让出 CPU.
+ *
+ *       吞吐量按写入 FIFO 的字节数计算, 每种取 5 次中最快的一次. 结果是
+ *       主机上的速度, 只用来比较几种方式, 单片机上要按主频和总线换算.
+ */
+
+#include "ring_fifo/ring_fifo.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FIFO_SIZE  (64U << 10)
+#define BENCH_BYTES      (256U << 20)
+#define BENCH_TRIALS     5U
+
+/* 源和目标多留 4 字节用来错开 */
+static uint8_t bench_src[4096 + 4] __attribute__((aligned(4)));
+static uint8_t bench_dst[4096 + 4] __attribute__((aligned(4)));
+static volatile uint32_t bench_sink;
+
+/**
+ * @brief 两线程测量的参数
+ */
+typedef struct {
+    ring_fifo_t *ring;
+    uint32_t chunk;   /*!< 每次读写的长度   */
+    uint32_t bytes;   /*!< 读出的字节数     */
+} bench_pair_t;
+
+/**
+ * @brief 单调时钟 (ns)
+ */
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 单线程写一块读一块
+ *
+ * @param offset 源和目标相对 FIFO 错开的字节数
+ */
+static uint64_t bench_copy(ring_fifo_t *ring, uint32_t chunk,
+                           uint32_t offset) {
+    uint64_t t0 = bench_now_ns();
+
+    for (uint32_t n = 0; n < BENCH_BYTES; n += chunk) {
+        ring_fifo_write(ring, &bench_src[offset], chunk);
+        ring_fifo_read(ring, &bench_dst[offset], chunk);
+    }
+
+    return bench_now_ns() - t0;
+}
+
+/**
+ * @brief 单线程直接写入和直接读
+ */
+static uint64_t bench_zero_copy(ring_fifo_t *ring, uint32_t chunk) {
+    uint64_t t0 = bench_now_ns();
+    uint32_t sum = 0, len;
+    void *wp;
+    const void *rp;
+
+    for (uint32_t n = 0; n < BENCH_BYTES; n += chunk) {
+        /* 块长是 FIFO 大小的约数, 连续空间总是够 */
+        len = ring_fifo_reserve(ring, &wp);
+        len = (len > chunk) ? chunk : len;
+        memcpy(wp, bench_src, len);
+        ring_fifo_commit(ring, len);
+
+        len = ring_fifo_peek(ring, &rp);
+        for (uint32_t i = 0; i < len; i += 4) {
+            sum += *(const uint32_t *)((const uint8_t *)rp + i);
+        }
+        ring_fifo_release(ring, len);
+    }
+    bench_sink = sum;
+
+    return bench_now_ns() - t0;
+}
+
+static void *bench_producer(void *arg) {
+    bench_pair_t *pair = arg;
+
+    for (uint32_t n = 0; n < BENCH_BYTES;) {
+        uint32_t len = ring_fifo_write(pair->ring, bench_src, pair->chunk);
+
+        n += len;
+        if (len == 0) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *bench_consumer(void *arg) {
+    bench_pair_t *pair = arg;
+    uint8_t buf[4096];
+
+    while (pair->bytes < BENCH_BYTES) {
+        uint32_t len = ring_fifo_read(pair->ring, buf, pair->chunk);
+
+        pair->bytes += len;
+        if (len == 0) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 两个线程, 一个写一个读
+ */
+static uint64_t bench_threads(ring_fifo_t *ring, uint32_t chunk) {
+    bench_pair_t pair = {.ring = ring, .chunk = chunk, .bytes = 0};
+    pthread_t p, c;
+    uint64_t t0 = bench_now_ns();
+
+    pthread_create(&c, NULL, bench_consumer, &pair);
+    pthread_create(&p, NULL, bench_producer, &pair);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+
+    return bench_now_ns() - t0;
+}
+
+/**
+ * @brief 吞吐量 (GB/s)
+ */
+static double bench_gbps(uint64_t ns) {
+    return (double)BENCH_BYTES / (double)ns;
+}
+
+int main(void) {
+    static const uint32_t chunks[] = {16, 256, 4096};
+    ring_fifo_t *ring = ring_fifo_init(NULL, BENCH_FIFO_SIZE, RF_TYPE_STREAM);
+    uint64_t best[4], ns;
+
+    for (uint32_t i = 0; i < sizeof(bench_src); ++i) {
+        bench_src[i] = (uint8_t)i;
+    }
+
+    printf("%6s %10s %10s %10s %10s\n", "chunk", "aligned", "unaligned",
+           "zero-copy", "2 threads");
+    for (uint32_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+        for (uint32_t k = 0; k < 4; ++k) {
+            best[k] = UINT64_MAX;
+        }
+
+        for (uint32_t t = 0; t < BENCH_TRIALS; ++t) {
+            ns = bench_copy(ring, chunks[c], 0);
+            best[0] = (ns < best[0]) ? ns : best[0];
+            ns = bench_copy(ring, chunks[c], 1);
+            best[1] = (ns < best[1]) ? ns : best[1];
+            ns = bench_zero_copy(ring, chunks[c]);
+            best[2] = (ns < best[2]) ? ns : best[2];
+            ns = bench_threads(ring, chunks[c]);
+            best[3] = (ns < best[3]) ? ns : best[3];
+        }
+
+        printf("%6u %10.2f %10.2f %10.2f %10.2f\n", (unsigned)chunks[c],
+               bench_gbps(best[0]), bench_gbps(best[1]), bench_gbps(best[2]),
+               bench_gbps(best[3]));
+    }
+
+    /* 最后一次按字节拷贝的是 4096 字节, 错开 1 字节 */
+    if (!ring_fifo_is_empty(ring) ||
+        (memcmp(&bench_dst[1], &bench_src[1], 4096) != 0)) {
+        printf("data mismatch\n");
+        return 1;
+    }
+
+    ring_fifo_destroy(ring);
+    return 0;
+}
@@ -0,0 +1,412 @@
+/**
+ * @file    ring_fifo_test.c
+ * @brief   环形 FIFO 的测试, 在主机上运行
+ *
+ * @note 单线程部分检查:
+ *
+ *       - 源和目标地址低 2 位的各种组合, 各种长度, 跨过缓冲区末尾的读写结果
+ *         正确, 不写出界;
+ *       - `reserve`/`commit`和`peek`/`release`给出的连续空间和数据;
+ *       - 帧模式放不下整帧时不写, 缓冲区不够时不读.
+ *
+ *       两线程部分模拟中断和任务: 生产者线程和驱动的接收中断一样从不等待,
+ *       放不下就只写能写的 (流模式) 或丢掉整帧 (帧模式); 消费者线程逐字节
+ *       检查. 缓冲区只有 256 字节, 读写双方不停地绕回和追上对方. 流模式的
+ *       数据是连续的序号, 生产者只按写入的长度前进, 所以消费者看到的数据
+ *       必须是连续的; 帧模式每帧带序号和长度, 序号只能增加.
+ */
+
+#include "ring_fifo/ring_fifo.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TORTURE_FIFO_SIZE 256U
+#define TORTURE_BYTES     (64U << 20)
+#define TORTURE_FRAMES    2000000U
+
+static uint32_t test_fail;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            printf("%s:%d: %s\n", __FILE__, __LINE__, #cond);                  \
+            ++test_fail;                                                       \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief 流中第`i`个字节
+ */
+static uint8_t test_byte(uint32_t i) {
+    return (uint8_t)((i * 2654435761U) >> 24);
+}
+
+static uint32_t test_rand(uint32_t *seed) {
+    *seed = *seed * 1103515245U + 12345U;
+    return *seed >> 8;
+}
+
+/**
+ * @brief 各种对齐和长度的读写, 包括跨过末尾
+ */
+static void test_copy(void) {
+    uint8_t mem[64 + 8];
+    uint8_t src[80], dst[80 + 8];
+    ring_fifo_t *ring;
+
+    for (uint32_t i = 0; i < sizeof(src); ++i) {
+        src[i] = test_byte(i);
+    }
+
+    /* 缓冲区后面放哨兵, 检查不写出界 */
+    for (uint32_t start = 0; start < 64; start += 5) {
+        for (uint32_t s_off = 0; s_off < 4; ++s_off) {
+            for (uint32_t d_off = 0; d_off < 4; ++d_off) {
+                for (uint32_t len = 0; len <= 60; len += 3) {
+                    memset(mem, 0xEE, sizeof(mem));
+                    memset(dst, 0xEE, sizeof(dst));
+                    ring = ring_fifo_init(mem, 64, RF_TYPE_STREAM);
+                    ring->head = ring->tail = start;
+
+                    CHECK(ring_fifo_write(ring, &src[s_off], len) == len);
+                    CHECK(ring_fifo_count(ring) == len);
+                    CHECK(ring_fifo_read(ring, &dst[d_off], 80) == len);
+                    CHECK(memcmp(&dst[d_off], &src[s_off], len) == 0);
+                    CHECK(dst[d_off + len] == 0xEE);
+                    CHECK((d_off == 0) || (dst[d_off - 1] == 0xEE));
+                    for (uint32_t i = 64; i < sizeof(mem); ++i) {
+                        CHECK(mem[i] == 0xEE);
+                    }
+                    ring_fifo_destroy(ring);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 流模式写满, 读空, 以及连续空间的直接读写
+ */
+static void test_stream(void) {
+    uint8_t mem[16], buf[32];
+    void *wp;
+    const void *rp;
+    ring_fifo_t *ring = ring_fifo_init(mem, sizeof(mem), RF_TYPE_STREAM);
+
+    CHECK(ring_fifo_init(mem, 12, RF_TYPE_STREAM) == NULL);
+    CHECK(ring_fifo_is_empty(ring));
+
+    for (uint32_t i = 0; i < sizeof(buf); ++i) {
+        buf[i] = (uint8_t)i;
+    }
+    CHECK(ring_fifo_write(ring, buf, 20) == 16);
+    CHECK(ring_fifo_is_full(ring));
+    CHECK(ring_fifo_write(ring, buf, 1) == 0);
+    CHECK(ring_fifo_reserve(ring, &wp) == 0);
+
+    CHECK(ring_fifo_read(ring, buf, 10) == 10);
+    CHECK(buf[9] == 9);
+    CHECK(ring_fifo_avail(ring) == 10);
+
+    /* tail 绕回到开头, 连续空间到 head 为止 */
+    CHECK(ring_fifo_reserve(ring, &wp) == 10);
+    CHECK(wp == &mem[0]);
+    CHECK(ring_fifo_read(ring, buf, 6) == 6);
+    CHECK(ring_fifo_is_empty(ring));
+    CHECK(ring_fifo_reserve(ring, &wp) == 16);
+
+    /* 连续空间到末尾为止, 提交前读不到 */
+    ring->head = ring->tail = 12;
+    CHECK(ring_fifo_reserve(ring, &wp) == 4);
+    CHECK(wp == &mem[12]);
+    memcpy(wp, "abcd", 4);
+    CHECK(ring_fifo_count(ring) == 0);
+    ring_fifo_commit(ring, 4);
+    CHECK(ring_fifo_reserve(ring, &wp) == 12);
+    CHECK(wp == &mem[0]);
+    memcpy(wp, "ef", 2);
+    ring_fifo_commit(ring, 2);
+
+    /* 连续数据到末尾为止, 释放前不会被覆盖 */
+    CHECK(ring_fifo_peek(ring, &rp) == 4);
+    CHECK(memcmp(rp, "abcd", 4) == 0);
+    CHECK(ring_fifo_avail(ring) == 10);
+    ring_fifo_release(ring, 3);
+    CHECK(ring_fifo_peek(ring, &rp) == 1);
+    ring_fifo_release(ring, 1);
+    CHECK(ring_fifo_peek(ring, &rp) == 2);
+    CHECK(memcmp(rp, "ef", 2) == 0);
+    ring_fifo_release(ring, 2);
+    CHECK(ring_fifo_peek(ring, &rp) == 0);
+
+    ring_fifo_destroy(ring);
+}
+
+/**
+ * @brief 帧模式整帧写入和读出, 帧长跨过末尾时跳过尾部
+ */
+static void test_frame(void) {
+    uint8_t buf[16];
+    void *wp;
+    const void *rp;
+    ring_fifo_t *ring = ring_fifo_init(NULL, 30, RF_TYPE_FRAME);
+
+    CHECK(ring->size == 32);
+    CHECK(ring_fifo_reserve(ring, &wp) == 0);
+    CHECK(ring_fifo_peek(ring, &rp) == 0);
+
+    /* 帧长 4 字节加数据 */
+    CHECK(ring_fifo_write(ring, "0123456789", 10) == 10);
+    CHECK(ring_fifo_write(ring, "abcdefghij", 10) == 10);
+    CHECK(ring_fifo_write(ring, "x", 5) == 0);
+    CHECK(ring_fifo_read(ring, buf, 5) == 0);
+    CHECK(ring_fifo_read(ring, buf, sizeof(buf)) == 10);
+    CHECK(memcmp(buf, "0123456789", 10) == 0);
+
+    /* tail 在 28, 帧长不跨过末尾 */
+    CHECK(ring_fifo_write(ring, "ABCDEF", 6) == 6);
+    CHECK(ring_fifo_read(ring, buf, sizeof(buf)) == 10);
+    CHECK(memcmp(buf, "abcdefghij", 10) == 0);
+    CHECK(ring_fifo_read(ring, buf, sizeof(buf)) == 6);
+    CHECK(memcmp(buf, "ABCDEF", 6) == 0);
+
+    /* tail 在 38 (6), 写到 30 后剩 2 字节放不下帧长, 跳过 */
+    CHECK(ring_fifo_write(ring, "0123456789abcdef", 14) == 14);
+    CHECK(ring_fifo_read(ring, buf, sizeof(buf)) == 14);
+    CHECK(ring_fifo_write(ring, "uvw", 3) == 3);
+    CHECK(ring_fifo_read(ring, buf, sizeof(buf)) == 3);
+    CHECK(memcmp(buf, "uvw", 3) == 0);
+    CHECK(ring_fifo_is_empty(ring));
+
+    ring_fifo_destroy(ring);
+}
+
+/**
+ * @brief 两线程测试中一种读写方式的状态
+ */
+typedef struct {
+    ring_fifo_t *ring;
+    bool zero_copy_write; /*!< 生产者用`reserve`/`commit`          */
+    bool zero_copy_read;  /*!< 消费者用`peek`/`release`            */
+    uint32_t total;       /*!< 流模式的字节数或帧模式的帧数         */
+    uint32_t produced;    /*!< 生产者写入的字节数或帧数             */
+    uint32_t full;        /*!< 生产者遇到放不下的次数              */
+    uint32_t dropped;     /*!< 帧模式丢掉的帧数                     */
+    uint32_t consumed;    /*!< 消费者读出的字节数或帧数             */
+    uint32_t bad;         /*!< 不对的字节或帧                       */
+    bool done;            /*!< 生产者结束, 原子读写                 */
+} torture_t;
+
+/**
+ * @brief 流模式生产者, 像中断一样从不等待, 写不下的部分不写
+ */
+static void *torture_stream_producer(void *arg) {
+    torture_t *t = arg;
+    uint8_t chunk[128];
+    uint32_t seq = 0, seed = 1, len, wlen;
+    void *wp;
+
+    while (seq < t->total) {
+        len = 1U + test_rand(&seed) % sizeof(chunk);
+        if (len > t->total - seq) {
+            len = t->total - seq;
+        }
+
+        if (t->zero_copy_write) {
+            wlen = ring_fifo_reserve(t->ring, &wp);
+            wlen = (wlen > len) ? len : wlen;
+            for (uint32_t i = 0; i < wlen; ++i) {
+                ((uint8_t *)wp)[i] = test_byte(seq + i);
+            }
+            ring_fifo_commit(t->ring, wlen);
+        } else {
+            for (uint32_t i = 0; i < len; ++i) {
+                chunk[i] = test_byte(seq + i);
+            }
+            wlen = ring_fifo_write(t->ring, chunk, len);
+        }
+
+        seq += wlen;
+        if (wlen < len) {
+            ++t->full;
+            sched_yield();
+        }
+    }
+
+    t->produced = seq;
+    __atomic_store_n(&t->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief 流模式消费者, 检查数据连续
+ */
+static void *torture_stream_consumer(void *arg) {
+    torture_t *t = arg;
+    uint8_t buf[97];
+    uint32_t seq = 0, len;
+    const void *rp;
+    const uint8_t *data;
+
+    while (seq < t->total) {
+        if (t->zero_copy_read) {
+            len = ring_fifo_peek(t->ring, &rp);
+            data = rp;
+        } else {
+            len = ring_fifo_read(t->ring, buf, sizeof(buf));
+            data = buf;
+        }
+
+        for (uint32_t i = 0; i < len; ++i) {
+            t->bad += (data[i] != test_byte(seq + i));
+        }
+        if (t->zero_copy_read) {
+            ring_fifo_release(t->ring, len);
+        }
+
+        seq += len;
+        if (len == 0) {
+            sched_yield();
+        }
+    }
+
+    t->consumed = seq;
+    return NULL;
+}
+
+/**
+ * @brief 帧模式生产者, 放不下整帧就丢掉
+ */
+static void *torture_frame_producer(void *arg) {
+    torture_t *t = arg;
+    uint8_t frame[64];
+    uint32_t seed = 7, len;
+
+    for (uint32_t seq = 0; seq < t->total; ++seq) {
+        len = 5U + test_rand(&seed) % (sizeof(frame) - 4U);
+        memcpy(frame, &seq, sizeof(seq));
+        for (uint32_t i = 4; i < len; ++i) {
+            frame[i] = test_byte(seq + i);
+        }
+        frame[4] = (uint8_t)len;
+
+        if (ring_fifo_write(t->ring, frame, len) == len) {
+            ++t->produced;
+        } else {
+            ++t->dropped;
+            sched_yield();
+        }
+    }
+
+    __atomic_store_n(&t->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief 帧模式消费者, 检查每帧完整, 序号增加
+ */
+static void *torture_frame_consumer(void *arg) {
+    torture_t *t = arg;
+    uint8_t frame[64];
+    uint32_t len, seq, last = 0;
+    bool first = true;
+
+    for (;;) {
+        bool done = __atomic_load_n(&t->done, __ATOMIC_ACQUIRE);
+
+        len = ring_fifo_read(t->ring, frame, sizeof(frame));
+        if (len == 0) {
+            if (done) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+
+        memcpy(&seq, frame, sizeof(seq));
+        bool good = (len >= 5) && (frame[4] == len) && (first || (seq > last));
+        for (uint32_t i = 5; good && (i < len); ++i) {
+            good = (frame[i] == test_byte(seq + i));
+        }
+        t->bad += !good;
+        ++t->consumed;
+        last = seq;
+        first = false;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 两个线程跑一种读写方式
+ */
+static void torture_run(const char *name, torture_t *t, void *(*producer)(void *),
+                        void *(*consumer)(void *)) {
+    pthread_t p, c;
+
+    pthread_create(&c, NULL, consumer, t);
+    pthread_create(&p, NULL, producer, t);
+    pthread_join(p, NULL);
+    pthread_join(c, NULL);
+
+    printf("%-16s %10u %10u %10u %10u %6u\n", name, (unsigned)t->produced,
+           (unsigned)t->consumed, (unsigned)t->full, (unsigned)t->dropped,
+           (unsigned)t->bad);
+    CHECK(t->bad == 0);
+    CHECK(t->consumed == t->produced);
+    CHECK(ring_fifo_is_empty(t->ring));
+}
+
+static void test_torture(void) {
+    static const struct {
+        const char *name;
+        bool zero_copy_write;
+        bool zero_copy_read;
+    } modes[] = {
+        {"write/read", false, false},
+        {"write/peek", false, true},
+        {"reserve/read", true, false},
+        {"reserve/peek", true, true},
+    };
+    torture_t t;
+
+    printf("%-16s %10s %10s %10s %10s %6s\n", "", "produced", "consumed",
+           "full", "dropped", "bad");
+    for (uint32_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+        memset(&t, 0, sizeof(t));
+        t.ring = ring_fifo_init(NULL, TORTURE_FIFO_SIZE, RF_TYPE_STREAM);
+        t.zero_copy_write = modes[i].zero_copy_write;
+        t.zero_copy_read = modes[i].zero_copy_read;
+        t.total = TORTURE_BYTES;
+        torture_run(modes[i].name, &t, torture_stream_producer,
+                    torture_stream_consumer);
+        CHECK(t.produced == TORTURE_BYTES);
+        ring_fifo_destroy(t.ring);
+    }
+
+    memset(&t, 0, sizeof(t));
+    t.ring = ring_fifo_init(NULL, TORTURE_FIFO_SIZE, RF_TYPE_FRAME);
+    t.total = TORTURE_FRAMES;
+    torture_run("frame", &t, torture_frame_producer, torture_frame_consumer);
+    CHECK(t.produced + t.dropped == TORTURE_FRAMES);
+    CHECK(t.produced != 0);
+    ring_fifo_destroy(t.ring);
+}
+
+int main(void) {
+    test_copy();
+    test_stream();
+    test_frame();
+    test_torture();
+
+    if (test_fail != 0) {
+        return 1;
+    }
+
+    printf("ok\n");
+    return 0;
+}
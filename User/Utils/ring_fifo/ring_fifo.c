@@ -2,14 +2,12 @@
  * @file    ring_fifo.c
  * @author  mcdx
  * @brief   环形FIFO
- * @version 1.0
- * @date    2021-10-22
+ * @version 1.1
+ * @date    2026-10-17
  */
 
 #include "ring_fifo.h"
 
-#include <string.h>
-
 #define min(a, b)      ((a) > (b) ? (b) : (a))
 #define fifo_max_depth (0xffffffff >> 1)
 
@@ -17,6 +15,57 @@ static inline uint32_t is_pow_of_2(uint32_t n) {
     return (0 != n) && (0 == (n & (n - 1)));
 }
 
+/* 读取对方修改的指针, 之后对缓冲区的访问不会提前到读取之前 */
+static inline uint32_t load_acquire(const volatile uint32_t *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+/* 更新自己的指针, 之前对缓冲区的访问不会推迟到更新之后 */
+static inline void store_release(volatile uint32_t *p, uint32_t val) {
+    __atomic_store_n(p, val, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief    拷贝数据, 地址低2位相同时按字拷贝
+ * @note     microlib的memcpy逐字节拷贝, 中断里拷贝大块数据太慢
+ */
+static void fifo_copy(void *dst, const void *src, uint32_t len) {
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+
+    if (0 == (((uintptr_t)d ^ (uintptr_t)s) & 3U)) {
+        /* 先拷贝到字对齐 */
+        while ((0 != ((uintptr_t)d & 3U)) && (0 != len)) {
+            *d++ = *s++;
+            --len;
+        }
+
+        uint32_t *dw = (uint32_t *)d;
+        const uint32_t *sw = (const uint32_t *)s;
+
+        while (len >= 16) {
+            dw[0] = sw[0];
+            dw[1] = sw[1];
+            dw[2] = sw[2];
+            dw[3] = sw[3];
+            dw += 4;
+            sw += 4;
+            len -= 16;
+        }
+        while (len >= 4) {
+            *dw++ = *sw++;
+            len -= 4;
+        }
+
+        d = (uint8_t *)dw;
+        s = (const uint8_t *)sw;
+    }
+
+    while (0 != len--) {
+        *d++ = *s++;
+    }
+}
+
 static inline uint32_t pow2gt(uint32_t x) {
     --x;
 
@@ -80,17 +129,19 @@ void ring_fifo_destroy(ring_fifo_t *ring) {
 
 uint32_t ring_fifo_write(ring_fifo_t *ring, const void *buf, uint32_t len) {
     uint32_t wlen;
+    uint32_t tail;
     uint32_t unused;
     uint32_t off, l;
     uint32_t frame_off, skip;
 
-    unused = ring->size - (ring->tail - ring->head);
+    tail = ring->tail;
+    unused = ring->size - (tail - load_acquire(&ring->head));
     switch (ring->type) {
         case RF_TYPE_FRAME:
             frame_off = sizeof(uint32_t);
             skip = 0;
-            if (ring->size - (ring->tail & ring->mask) < frame_off) {
-                skip = ring->size - (ring->tail & ring->mask);
+            if (ring->size - (tail & ring->mask) < frame_off) {
+                skip = ring->size - (tail & ring->mask);
                 /* 跳过尾部[1, frame_off - 1]字节 */
                 frame_off += skip;
             }
@@ -103,8 +154,8 @@ uint32_t ring_fifo_write(ring_fifo_t *ring, const void *buf, uint32_t len) {
                 return 0;
             }
             /* 写入帧长 */
-            *(uint32_t *)((uint8_t *)ring->buf +
-                          ((ring->tail + skip) & ring->mask)) = wlen;
+            *(uint32_t *)((uint8_t *)ring->buf + ((tail + skip) & ring->mask)) =
+                wlen;
             break;
         default: /* RF_TYPE_STREAM */
             frame_off = 0;
@@ -116,29 +167,31 @@ uint32_t ring_fifo_write(ring_fifo_t *ring, const void *buf, uint32_t len) {
     }
 
     /* 计算写入位置 */
-    off = (ring->tail + frame_off) & ring->mask;
+    off = (tail + frame_off) & ring->mask;
     l = min(wlen, ring->size - off);
-    memcpy((uint8_t *)ring->buf + off, buf, l);
-    memcpy(ring->buf, (uint8_t *)buf + l, wlen - l);
+    fifo_copy((uint8_t *)ring->buf + off, buf, l);
+    fifo_copy(ring->buf, (const uint8_t *)buf + l, wlen - l);
 
-    ring->tail += wlen + frame_off;
+    store_release(&ring->tail, tail + wlen + frame_off);
 
     return wlen;
 }
 
 uint32_t ring_fifo_read(ring_fifo_t *ring, void *buf, uint32_t len) {
     uint32_t rlen;
+    uint32_t head;
     uint32_t used;
     uint32_t off, l;
     uint32_t frame_off, skip;
 
-    used = ring->tail - ring->head;
+    head = ring->head;
+    used = load_acquire(&ring->tail) - head;
     switch (ring->type) {
         case RF_TYPE_FRAME:
             frame_off = sizeof(uint32_t);
             skip = 0;
-            if (ring->size - (ring->head & ring->mask) < frame_off) {
-                skip = ring->size - (ring->head & ring->mask);
+            if (ring->size - (head & ring->mask) < frame_off) {
+                skip = ring->size - (head & ring->mask);
                 /* 跳过尾部[1, frame_off - 1]字节 */
                 frame_off += skip;
             }
@@ -147,7 +200,7 @@ uint32_t ring_fifo_read(ring_fifo_t *ring, void *buf, uint32_t len) {
             }
             /* 读取帧长 */
             rlen = *(uint32_t *)((uint8_t *)ring->buf +
-                                 ((ring->head + skip) & ring->mask));
+                                 ((head + skip) & ring->mask));
             /* 给定的缓冲区小于要读出的帧长 */
             if (len < rlen) {
                 return 0;
@@ -163,28 +216,73 @@ uint32_t ring_fifo_read(ring_fifo_t *ring, void *buf, uint32_t len) {
     }
 
     /* 计算读取位置 */
-    off = (ring->head + frame_off) & ring->mask;
+    off = (head + frame_off) & ring->mask;
     l = min(rlen, ring->size - off);
-    memcpy(buf, (uint8_t *)ring->buf + off, l);
-    memcpy((uint8_t *)buf + l, ring->buf, rlen - l);
+    fifo_copy(buf, (uint8_t *)ring->buf + off, l);
+    fifo_copy((uint8_t *)buf + l, ring->buf, rlen - l);
 
-    ring->head += rlen + frame_off;
+    store_release(&ring->head, head + rlen + frame_off);
 
     return rlen;
 }
 
+uint32_t ring_fifo_reserve(ring_fifo_t *ring, void **buf) {
+    uint32_t tail, off;
+    uint32_t unused;
+
+    if (RF_TYPE_STREAM != ring->type) {
+        return 0;
+    }
+
+    tail = ring->tail;
+    unused = ring->size - (tail - load_acquire(&ring->head));
+    off = tail & ring->mask;
+
+    *buf = (uint8_t *)ring->buf + off;
+
+    return min(unused, ring->size - off);
+}
+
+void ring_fifo_commit(ring_fifo_t *ring, uint32_t len) {
+    store_release(&ring->tail, ring->tail + len);
+}
+
+uint32_t ring_fifo_peek(ring_fifo_t *ring, const void **buf) {
+    uint32_t head, off;
+    uint32_t used;
+
+    if (RF_TYPE_STREAM != ring->type) {
+        return 0;
+    }
+
+    head = ring->head;
+    used = load_acquire(&ring->tail) - head;
+    off = head & ring->mask;
+
+    *buf = (const uint8_t *)ring->buf + off;
+
+    return min(used, ring->size - off);
+}
+
+void ring_fifo_release(ring_fifo_t *ring, uint32_t len) {
+    store_release(&ring->head, ring->head + len);
+}
+
 uint32_t ring_fifo_is_full(ring_fifo_t *ring) {
-    return ring->size == (ring->tail - ring->head);
+    return ring->size == ring_fifo_count(ring);
 }
 
 uint32_t ring_fifo_is_empty(ring_fifo_t *ring) {
-    return ring->tail == ring->head;
+    return 0 == ring_fifo_count(ring);
 }
 
 uint32_t ring_fifo_avail(ring_fifo_t *ring) {
-    return ring->size - (ring->tail - ring->head);
+    return ring->size - ring_fifo_count(ring);
 }
 
 uint32_t ring_fifo_count(ring_fifo_t *ring) {
-    return ring->tail - ring->head;
+    /* 先读 head, 保证 tail 不小于 head */
+    uint32_t head = load_acquire(&ring->head);
+
+    return load_acquire(&ring->tail) - head;
 }
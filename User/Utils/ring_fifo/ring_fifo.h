@@ -2,8 +2,12 @@
  * @file    ring_fifo.h
  * @author  mcdx
  * @brief   环形FIFO
- * @version 1.0
- * @date    2021-10-22
+ * @version 1.1
+ * @date    2026-10-17
+ *
+ * 单生产者单消费者 (SPSC) 无锁, 生产者只写 tail, 消费者只写 head.
+ * 读取对方指针使用获取语义, 更新自己的指针使用释放语义, 保证对方看到指针
+ * 变化时数据已经写入/读出. 一端在中断中, 另一端在任务中可以直接使用.
  */
 
 #ifndef __RING_FIFO_H
@@ -24,8 +28,8 @@ enum ring_fifo_type {
 
 /* 环形缓冲区结构 */
 typedef struct {
-    volatile uint32_t head; /* 消费者指针 */
-    volatile uint32_t tail; /* 生产者指针 */
+    volatile uint32_t head; /* 消费者指针, 只有消费者修改 */
+    volatile uint32_t tail; /* 生产者指针, 只有生产者修改 */
 
     uint32_t size; /* 缓冲区的大小 */
     uint32_t mask; /* 缓冲区的大小掩码 */
@@ -73,6 +77,40 @@ uint32_t ring_fifo_write(ring_fifo_t *ring, const void *buf, uint32_t len);
  */
 uint32_t ring_fifo_read(ring_fifo_t *ring, void *buf, uint32_t len);
 
+/**
+ * @brief    获取可以直接写入的连续空间(单生产者无锁, 仅RF_TYPE_STREAM)
+ * @param[in]    ring    环形缓冲区句柄
+ * @param[out]   buf     连续空间的起始地址
+ * @retval   执行结果
+ * -         连续空间的长度(byte), 到缓冲区末尾为止, 0为已满或类型不支持
+ * @note     写入后调用ring_fifo_commit提交, 提交前消费者看不到这些数据
+ */
+uint32_t ring_fifo_reserve(ring_fifo_t *ring, void **buf);
+
+/**
+ * @brief    提交ring_fifo_reserve得到的空间中已经写入的数据
+ * @param[in]    ring    环形缓冲区句柄
+ * @param[in]    len     写入的长度(byte), 不能超过ring_fifo_reserve的返回值
+ */
+void ring_fifo_commit(ring_fifo_t *ring, uint32_t len);
+
+/**
+ * @brief    获取可以直接读取的连续数据(单消费者无锁, 仅RF_TYPE_STREAM)
+ * @param[in]    ring    环形缓冲区句柄
+ * @param[out]   buf     连续数据的起始地址
+ * @retval   执行结果
+ * -         连续数据的长度(byte), 到缓冲区末尾为止, 0为空或类型不支持
+ * @note     处理完后调用ring_fifo_release释放, 释放前生产者不会覆盖这些数据
+ */
+uint32_t ring_fifo_peek(ring_fifo_t *ring, const void **buf);
+
+/**
+ * @brief    释放ring_fifo_peek得到的数据
+ * @param[in]    ring    环形缓冲区句柄
+ * @param[in]    len     处理完的长度(byte), 不能超过ring_fifo_peek的返回值
+ */
+void ring_fifo_release(ring_fifo_t *ring, uint32_t len);
+
 /**
  * @brief    环形缓冲区是否为满
  * @param[in]    ring    环形缓冲区句柄